@@ -0,0 +1,241 @@
+/*
+ * Host side benchmarks of the ATT request path
+ *
+ * Drives server<>::l2cap_input() with typical request mixes and reports the time and (if the
+ * platform provides a hardware instruction counter) the number of executed instructions per request.
+ *
+ * usage: att_benchmarks [number of rounds per request mix]
+ */
+
+// test_servers.hpp uses Boost.Test assertions in its request helpers
+#define BOOST_TEST_NO_MAIN
+#include <boost/test/included/unit_test.hpp>
+#include "test_servers.hpp"
+#include "hardware_counter.hpp"
+
+#include <bluetoe/server.hpp>
+#include <bluetoe/link_state.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using pdu = std::vector< std::uint8_t >;
+
+    struct request_mix
+    {
+        std::string         name;
+        std::vector< pdu >  requests;
+    };
+
+    /*
+     * handles of the attributes of a server, that are used to build the request mixes
+     *
+     * A write_handle of 0 denotes a server without writable characteristic; the write
+     * mixes are skipped for such a server, as they would only measure the error response.
+     */
+    struct server_layout
+    {
+        std::uint16_t read_handle;
+        std::uint16_t blob_handle;
+        std::uint16_t blob_offset;
+        std::uint16_t write_handle;
+        std::size_t   write_size;
+    };
+
+    std::uint8_t low( std::uint16_t value )
+    {
+        return static_cast< std::uint8_t >( value & 0xff );
+    }
+
+    std::uint8_t high( std::uint16_t value )
+    {
+        return static_cast< std::uint8_t >( value >> 8 );
+    }
+
+    std::vector< request_mix > request_mixes( const server_layout& layout )
+    {
+        std::vector< request_mix > mixes = {
+            { "discovery", {
+                { 0x10, 0x01, 0x00, 0xff, 0xff, 0x00, 0x28 },  // Read By Group Type: primary services
+                { 0x08, 0x01, 0x00, 0xff, 0xff, 0x03, 0x28 },  // Read By Type: characteristic declarations
+                { 0x04, 0x01, 0x00, 0xff, 0xff }               // Find Information
+            } },
+            { "read", {
+                { 0x0A, low( layout.read_handle ), high( layout.read_handle ) }
+            } },
+            { "read blob", {
+                { 0x0C, low( layout.blob_handle ), high( layout.blob_handle ), low( layout.blob_offset ), high( layout.blob_offset ) }
+            } }
+        };
+
+        if ( layout.write_handle == 0 )
+            return mixes;
+
+        const pdu write_value( layout.write_size, 0x42 );
+
+        pdu write_request = { 0x12, low( layout.write_handle ), high( layout.write_handle ) };
+        write_request.insert( write_request.end(), write_value.begin(), write_value.end() );
+
+        pdu prepare_write_request = { 0x16, low( layout.write_handle ), high( layout.write_handle ), 0x00, 0x00 };
+        prepare_write_request.insert( prepare_write_request.end(), write_value.begin(), write_value.end() );
+
+        mixes.push_back( { "write", {
+            write_request
+        } } );
+
+        mixes.push_back( { "prepare/execute", {
+            prepare_write_request,
+            { 0x18, 0x01 }
+        } } );
+
+        return mixes;
+    }
+
+    /*
+     * A server with more services and characteristics than the servers from the unit tests,
+     * in the order of magnitude of typical products.
+     */
+    std::uint8_t  long_value[ 64 ];
+    std::uint32_t writable_value;
+
+    template < std::uint16_t Service >
+    using fixed_service = bluetoe::service<
+        bluetoe::service_uuid16< Service >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid16< Service + 1 >,
+            bluetoe::fixed_uint32_value< Service + 1 >
+        >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid16< Service + 2 >,
+            bluetoe::fixed_uint32_value< Service + 2 >
+        >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid16< Service + 3 >,
+            bluetoe::fixed_uint32_value< Service + 3 >
+        >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC70000 + Service >,
+            bluetoe::fixed_uint32_value< Service + 4 >
+        >
+    >;
+
+    using large_server = bluetoe::server<
+        fixed_service< 0xB000 >,
+        fixed_service< 0xB010 >,
+        fixed_service< 0xB020 >,
+        bluetoe::service<
+            bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC7B030 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0xB031 >,
+                bluetoe::bind_characteristic_value< decltype( long_value ), &long_value >
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0xB032 >,
+                bluetoe::bind_characteristic_value< decltype( writable_value ), &writable_value >
+            >
+        >
+    >;
+
+    volatile std::size_t sink;
+
+    template < class Server >
+    void run_benchmark( const char* server_name, const server_layout& layout, std::size_t rounds, benchmarks::hardware_counter& counter )
+    {
+        using server_t     = bluetoe::extend_server< Server, bluetoe::shared_write_queue< 128 > >;
+        using connection_t = typename server_t::template channel_data_t< bluetoe::details::link_state >;
+
+        server_t     server;
+        connection_t connection;
+
+        for ( const auto& mix : request_mixes( layout ) )
+        {
+            std::uint8_t output[ bluetoe::details::default_att_mtu_size ];
+
+            const auto run = [&]( std::size_t count )
+            {
+                for ( std::size_t round = 0; round != count; ++round )
+                {
+                    for ( const auto& request : mix.requests )
+                    {
+                        std::size_t out_size = sizeof( output );
+                        server.l2cap_input( request.data(), request.size(), output, out_size, connection );
+                        sink = sink + out_size;
+                    }
+                }
+            };
+
+            // warm up caches and lazily calculated values
+            run( 1 );
+
+            counter.start();
+            const auto start = std::chrono::steady_clock::now();
+
+            run( rounds );
+
+            const auto stop         = std::chrono::steady_clock::now();
+            const auto instructions = counter.stop();
+
+            const double requests = static_cast< double >( rounds * mix.requests.size() );
+            const double ns       = static_cast< double >( std::chrono::duration_cast< std::chrono::nanoseconds >( stop - start ).count() );
+
+            std::cout << std::left
+                      << std::setw( 26 ) << server_name
+                      << std::setw( 18 ) << mix.name
+                      << std::right << std::fixed << std::setprecision( 1 )
+                      << std::setw( 12 ) << ns / requests;
+
+            if ( counter.available() )
+                std::cout << std::setw( 16 ) << static_cast< double >( instructions ) / requests;
+            else
+                std::cout << std::setw( 16 ) << "n/a";
+
+            std::cout << '\n';
+        }
+    }
+}
+
+int main( int argc, char** argv )
+{
+    const std::size_t rounds = argc > 1
+        ? static_cast< std::size_t >( std::strtoul( argv[ 1 ], nullptr, 10 ) )
+        : 100000;
+
+    if ( rounds == 0 )
+    {
+        std::cerr << "usage: " << argv[ 0 ] << " [rounds]\n";
+        return 1;
+    }
+
+    benchmarks::hardware_counter counter( benchmarks::hardware_counter::event::instructions );
+
+    std::cout << std::left
+              << std::setw( 26 ) << "server"
+              << std::setw( 18 ) << "request mix"
+              << std::right
+              << std::setw( 12 ) << "ns/request"
+              << std::setw( 16 ) << "instr/request" << '\n';
+
+    // service at 0x0001, characteristic declaration at 0x0002, value at 0x0003 (not writable)
+    run_benchmark< test::small_temperature_service >(
+        "small_temperature_service", { 0x0003, 0x0003, 0x0001, 0x0000, 0 }, rounds, counter );
+
+    // values at 0x0003, 0x0005 and 0x0007
+    run_benchmark< test::three_apes_service >(
+        "three_apes_service", { 0x0005, 0x0003, 0x0000, 0x0007, 1 }, rounds, counter );
+
+    // 3 x 9 attributes for the fixed services, long value at 0x001E, writable value at 0x0020
+    run_benchmark< large_server >(
+        "large_server", { 0x0003, 0x001E, 0x0016, 0x0020, 4 }, rounds, counter );
+
+    if ( !counter.available() )
+        std::cout << "\nhardware instruction counter not available\n";
+
+    return 0;
+}
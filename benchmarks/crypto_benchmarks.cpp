@@ -0,0 +1,221 @@
+/*
+ * Host side benchmarks of the software link layer encryption
+ *
+ * Measures the AES-128 block cipher and the AES-CCM of bluetoe::link_layer::software_encryption and reports
+ * the time and (if the platform provides a hardware cycle counter) the number of CPU cycles per payload octet.
+ * For the CCM, the costs are given with the key stream calculated on demand, for the calculation of the key stream
+ * by prepare() and for the remaining work, when the key stream was prepared in advance (the critical path between
+ * receiving a PDU and transmitting the response). Resolving a private address is measured for an address, that
+ * is not in the cache of the resolving list (one AES per IRK) and for a cached address.
+ *
+ * usage: crypto_benchmarks [number of rounds per measurement]
+ */
+
+#include "hardware_counter.hpp"
+
+#include <bluetoe/aes.hpp>
+#include <bluetoe/software_encryption.hpp>
+#include <bluetoe/default_pdu_layout.hpp>
+#include <bluetoe/resolving_list.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+    using layout     = bluetoe::link_layer::default_pdu_layout;
+    using encryption = bluetoe::link_layer::software_encryption< layout >;
+
+    const std::uint8_t key[ 16 ] = {
+        0xBF, 0x01, 0xFB, 0x9D, 0x4E, 0xF3, 0xBC, 0x36,
+        0xD8, 0x74, 0xF5, 0x39, 0x41, 0x38, 0x68, 0x4C
+    };
+
+    volatile std::uint8_t sink;
+
+    void measure( const std::string& name, std::size_t octets, std::size_t rounds,
+        benchmarks::hardware_counter& counter, const std::function< void () >& operation )
+    {
+        // warm up caches
+        operation();
+
+        counter.start();
+        const auto start = std::chrono::steady_clock::now();
+
+        for ( std::size_t round = 0; round != rounds; ++round )
+            operation();
+
+        const auto stop   = std::chrono::steady_clock::now();
+        const auto cycles = counter.stop();
+
+        const double total_octets = static_cast< double >( rounds * octets );
+        const double ns           = static_cast< double >( std::chrono::duration_cast< std::chrono::nanoseconds >( stop - start ).count() );
+
+        std::cout << std::left
+                  << std::setw( 34 ) << name
+                  << std::right << std::setw( 8 ) << octets
+                  << std::fixed << std::setprecision( 1 )
+                  << std::setw( 12 ) << ns / static_cast< double >( rounds )
+                  << std::setprecision( 2 )
+                  << std::setw( 12 ) << ns / total_octets;
+
+        if ( counter.available() )
+            std::cout << std::setw( 14 ) << static_cast< double >( cycles ) / total_octets;
+        else
+            std::cout << std::setw( 14 ) << "n/a";
+
+        std::cout << '\n';
+    }
+
+    struct ll_pdus
+    {
+        explicit ll_pdus( std::size_t size )
+        {
+            layout::header( plain, static_cast< std::uint16_t >( 0x02 | ( size << 8 ) ) );
+            layout::header( received, static_cast< std::uint16_t >( 0x02 | ( ( size + encryption::mic_size ) << 8 ) ) );
+
+            for ( std::size_t i = 0; i != sizeof( plain ) - 2; ++i )
+            {
+                plain[ i + 2 ]    = static_cast< std::uint8_t >( i );
+                received[ i + 2 ] = static_cast< std::uint8_t >( i * 3 );
+            }
+
+            transmit = bluetoe::link_layer::write_buffer{ plain, layout::data_channel_pdu_memory_size( size ) };
+        }
+
+        std::uint8_t                        plain[ 2 + 251 ];
+        std::uint8_t                        encrypted[ 2 + 251 ];
+        // the MIC of this PDU never matches. decrypt() deciphers the payload in place nevertheless, so every round after
+        // the first one decrypts the garbage that the previous round left behind. The costs do not depend on the content.
+        std::uint8_t                        received[ 2 + 251 ];
+        bluetoe::link_layer::write_buffer   transmit;
+    };
+
+    void run_ccm_benchmarks( std::size_t size, std::size_t rounds, benchmarks::hardware_counter& counter )
+    {
+        encryption engine;
+        engine.setup_session( key, 0xACBDCEDFE0F10213, 0xBADCAB24, 0x0213243546576879, 0xDEAFBABE );
+        engine.start_receive_encrypted();
+        engine.start_transmit_encrypted();
+
+        ll_pdus pdus( size );
+
+        const bluetoe::link_layer::read_buffer encrypted{ pdus.encrypted, sizeof( pdus.encrypted ) };
+        const bluetoe::link_layer::read_buffer received{ pdus.received, sizeof( pdus.received ) };
+
+        // a new packet counter requires a new key stream
+        measure( "ll encrypt (on demand)", size, rounds, counter, [&]{
+            engine.increment_transmit_packet_counter();
+            sink = engine.encrypt( pdus.transmit, encrypted ).buffer[ 2 ];
+        } );
+
+        measure( "ll decrypt (on demand)", size, rounds, counter, [&]{
+            engine.increment_receive_packet_counter();
+            sink = engine.decrypt( received );
+        } );
+
+        measure( "ll prepare() both directions", size, rounds, counter, [&]{
+            engine.increment_transmit_packet_counter();
+            engine.increment_receive_packet_counter();
+            engine.prepare( size, size );
+        } );
+
+        // with an unchanged packet counter, the key stream is already prepared
+        measure( "ll encrypt (prepared)", size, rounds, counter, [&]{
+            sink = engine.encrypt( pdus.transmit, encrypted ).buffer[ 2 ];
+        } );
+
+        measure( "ll decrypt (prepared)", size, rounds, counter, [&]{
+            sink = engine.decrypt( received );
+        } );
+    }
+
+    struct no_radio {};
+
+    template < std::size_t Size >
+    struct resolving_list : bluetoe::link_layer::resolving_list< Size >::template impl< no_radio, resolving_list< Size > > {};
+
+    void run_resolving_list_benchmarks( std::size_t rounds, benchmarks::hardware_counter& counter )
+    {
+        static constexpr std::size_t size = 16;
+
+        resolving_list< size > list;
+
+        for ( std::size_t entry = 0; entry != size; ++entry )
+        {
+            bluetoe::details::identity_resolving_key_t irk;
+            irk.fill( static_cast< std::uint8_t >( entry ) );
+
+            list.add_to_resolving_list( bluetoe::link_layer::public_device_address( {
+                static_cast< std::uint8_t >( entry ), 0, 0, 0, 0, 0 } ), irk );
+        }
+
+        // resolvable, but matches none of the IRKs; a new address every round defeats the cache
+        std::uint32_t prand = 0;
+
+        measure( "resolve RPA (16 IRKs, not cached)", 6, rounds, counter, [&]{
+            ++prand;
+            sink = list.resolve_address( bluetoe::link_layer::random_device_address( {
+                0x01, 0x02, 0x03,
+                static_cast< std::uint8_t >( prand ), static_cast< std::uint8_t >( prand >> 8 ), 0x40 } ) ).first;
+        } );
+
+        const bluetoe::link_layer::random_device_address cached( { 0x01, 0x02, 0x03, 0x04, 0x05, 0x46 } );
+
+        measure( "resolve RPA (16 IRKs, cached)", 6, rounds, counter, [&]{
+            sink = list.resolve_address( cached ).first;
+        } );
+    }
+}
+
+int main( int argc, char** argv )
+{
+    const std::size_t rounds = argc > 1
+        ? static_cast< std::size_t >( std::strtoul( argv[ 1 ], nullptr, 10 ) )
+        : 100000;
+
+    if ( rounds == 0 )
+    {
+        std::cerr << "usage: " << argv[ 0 ] << " [rounds]\n";
+        return 1;
+    }
+
+    benchmarks::hardware_counter counter( benchmarks::hardware_counter::event::cycles );
+
+    std::cout << std::left
+              << std::setw( 34 ) << "operation"
+              << std::right
+              << std::setw( 8 )  << "octets"
+              << std::setw( 12 ) << "ns/op"
+              << std::setw( 12 ) << "ns/octet"
+              << std::setw( 14 ) << "cycles/octet" << '\n';
+
+    std::uint8_t block[ 16 ] = { 0 };
+
+    measure( "aes128_encrypt() (key expansion)", sizeof( block ), rounds, counter, [&]{
+        bluetoe::details::aes128_encrypt( key, block, block );
+    } );
+
+    const bluetoe::details::aes128 cipher( key );
+
+    measure( "aes128::encrypt()", sizeof( block ), rounds, counter, [&]{
+        cipher.encrypt( block, block );
+    } );
+
+    sink = block[ 0 ];
+
+    for ( const std::size_t size : { 27u, 247u } )
+        run_ccm_benchmarks( size, rounds, counter );
+
+    run_resolving_list_benchmarks( rounds, counter );
+
+    if ( !counter.available() )
+        std::cout << "\nhardware cycle counter not available\n";
+
+    return 0;
+}
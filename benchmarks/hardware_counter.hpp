@@ -0,0 +1,95 @@
+#ifndef BLUETOE_BENCHMARKS_HARDWARE_COUNTER_HPP
+#define BLUETOE_BENCHMARKS_HARDWARE_COUNTER_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#if defined( __linux__ )
+#   include <linux/perf_event.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#endif
+
+namespace benchmarks {
+
+    /*
+     * counts hardware events (executed instructions or CPU cycles) in user space of the calling thread
+     */
+    class hardware_counter
+    {
+    public:
+        enum class event {
+            instructions,
+            cycles
+        };
+
+        explicit hardware_counter( event counted )
+            : fd_( -1 )
+        {
+#if defined( __linux__ )
+            perf_event_attr attr;
+            std::memset( &attr, 0, sizeof( attr ) );
+
+            attr.type           = PERF_TYPE_HARDWARE;
+            attr.size           = sizeof( attr );
+            attr.config         = counted == event::instructions ? PERF_COUNT_HW_INSTRUCTIONS : PERF_COUNT_HW_CPU_CYCLES;
+            attr.disabled       = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+
+            fd_ = static_cast< int >( syscall( __NR_perf_event_open, &attr, 0, -1, -1, 0 ) );
+#else
+            static_cast< void >( counted );
+#endif
+        }
+
+        ~hardware_counter()
+        {
+#if defined( __linux__ )
+            if ( fd_ >= 0 )
+                close( fd_ );
+#endif
+        }
+
+        hardware_counter( const hardware_counter& ) = delete;
+        hardware_counter& operator=( const hardware_counter& ) = delete;
+
+        bool available() const
+        {
+            return fd_ >= 0;
+        }
+
+        void start()
+        {
+#if defined( __linux__ )
+            if ( fd_ >= 0 )
+            {
+                ioctl( fd_, PERF_EVENT_IOC_RESET, 0 );
+                ioctl( fd_, PERF_EVENT_IOC_ENABLE, 0 );
+            }
+#endif
+        }
+
+        std::uint64_t stop()
+        {
+            std::uint64_t count = 0;
+
+#if defined( __linux__ )
+            if ( fd_ >= 0 )
+            {
+                ioctl( fd_, PERF_EVENT_IOC_DISABLE, 0 );
+
+                if ( read( fd_, &count, sizeof( count ) ) != sizeof( count ) )
+                    count = 0;
+            }
+#endif
+            return count;
+        }
+
+    private:
+        int fd_;
+    };
+}
+
+#endif
@@ -0,0 +1,672 @@
+/*
+ * Deterministic, host based simulation of a connection between a simulated central and the
+ * link layer, driven by the test radio
+ *
+ * Every scenario connects a simulated central to a link_layer<> with a server, that streams
+ * notifications over a configurable connection interval, packet loss rate and PHY. Every set of
+ * scenarios runs against several link layer configurations, that differ in the ATT MTU, the link
+ * layer buffer sizes and the support for data length extension. The
+ * central negotiates the data length and the PHY with the link layer, enables the notifications and
+ * then receives notifications for the simulated time. For every scenario, the goodput (ATT
+ * notification values per second), the notification latency percentiles and the utilisation of
+ * the connection events are reported.
+ *
+ * The test radio does not model time on air: the length of a connection event is limited by the
+ * number of PDUs, that fit into the connection interval and the times of reception are calculated
+ * from the sizes of the exchanged PDUs and the PHY, used by the link layer.
+ *
+ * usage: link_simulation [simulated seconds per scenario]
+ */
+
+// test_radio.cpp uses Boost.Test assertions in its check functions
+#define BOOST_TEST_NO_MAIN
+#include <boost/test/included/unit_test.hpp>
+#include "test_radio.hpp"
+
+#include <bluetoe/link_layer.hpp>
+#include <bluetoe/server.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // a value, that fills a notification with the largest MTU
+    static constexpr std::size_t stream_value_size = 244;
+
+    std::uint8_t stream_value_0[ stream_value_size ];
+    std::uint8_t stream_value_1[ stream_value_size ];
+    std::uint8_t stream_value_2[ stream_value_size ];
+    std::uint8_t stream_value_3[ stream_value_size ];
+
+    std::uint8_t* const stream_values[] = { stream_value_0, stream_value_1, stream_value_2, stream_value_3 };
+    static constexpr std::size_t number_of_streams = sizeof( stream_values ) / sizeof( stream_values[ 0 ] );
+
+    template < std::uint16_t UUID, std::uint8_t (&Value)[ stream_value_size ] >
+    using stream_characteristic = bluetoe::characteristic<
+        bluetoe::characteristic_uuid16< UUID >,
+        bluetoe::bind_characteristic_value< std::uint8_t[ stream_value_size ], &Value >,
+        bluetoe::no_write_access,
+        bluetoe::notify
+    >;
+
+    /*
+     * Service at 0x0001, the n-th characteristic has its value at 0x0003 + 3n and its CCCD at 0x0004 + 3n
+     */
+    template < std::uint16_t Mtu >
+    using stream_server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0xB100 >,
+            stream_characteristic< 0xB101, stream_value_0 >,
+            stream_characteristic< 0xB102, stream_value_1 >,
+            stream_characteristic< 0xB103, stream_value_2 >,
+            stream_characteristic< 0xB104, stream_value_3 >
+        >,
+        bluetoe::no_gap_service_for_gatt_servers,
+        bluetoe::max_mtu_size< Mtu >
+    >;
+
+    template < typename Server >
+    bool notify_stream( Server& server, std::size_t stream )
+    {
+        switch ( stream )
+        {
+        case 0: return server.notify( stream_value_0 );
+        case 1: return server.notify( stream_value_1 );
+        case 2: return server.notify( stream_value_2 );
+        default: return server.notify( stream_value_3 );
+        }
+    }
+
+    enum class phy {
+        le_1m,
+        le_2m
+    };
+
+    const char* phy_name( phy p )
+    {
+        return p == phy::le_2m ? "2M" : "1M";
+    }
+
+    struct scenario
+    {
+        std::string     name;
+        std::uint16_t   interval;       // in 1.25ms
+        unsigned        loss_permille;  // of the PDUs send by the link layer
+        phy             used_phy;
+        std::uint32_t   sample_period;  // in µs; 0: all streams are notified at every connection event
+    };
+
+    struct report
+    {
+        double          goodput;        // kbit/s
+        std::uint64_t   delivered;
+        std::uint64_t   superseded;
+        std::uint64_t   retransmissions;
+        std::uint32_t   latency_p50;    // µs
+        std::uint32_t   latency_p90;
+        std::uint32_t   latency_p99;
+        std::uint32_t   latency_max;
+        double          utilisation;    // %
+    };
+
+    static constexpr std::uint32_t t_ifs = 150;
+
+    // time on air of a PDU with the given payload size in µs
+    std::uint32_t air_time( std::size_t payload, bluetoe::link_layer::details::phy_ll_encoding::phy_ll_encoding_t encoding )
+    {
+        // preamble, access address, header and CRC
+        return encoding == bluetoe::link_layer::details::phy_ll_encoding::le_2m_phy
+            ? static_cast< std::uint32_t >( ( 2 + 4 + 2 + payload + 3 ) * 4 )
+            : static_cast< std::uint32_t >( ( 1 + 4 + 2 + payload + 3 ) * 8 );
+    }
+
+    std::uint8_t low( std::uint16_t value )
+    {
+        return static_cast< std::uint8_t >( value & 0xff );
+    }
+
+    std::uint8_t high( std::uint16_t value )
+    {
+        return static_cast< std::uint8_t >( value >> 8 );
+    }
+
+    std::uint32_t percentile( const std::vector< std::uint32_t >& sorted, unsigned percent )
+    {
+        if ( sorted.empty() )
+            return 0;
+
+        // nearest rank
+        const std::size_t rank = ( sorted.size() * percent + 99 ) / 100;
+
+        return sorted[ std::max< std::size_t >( rank, 1 ) - 1 ];
+    }
+
+    /*
+     * The simulated central: called at the start of every connection event, it evaluates the PDUs,
+     * that the link layer send in the previous connection events, answers link layer control procedures,
+     * sends at max one PDU per connection event and plays the role of the application, that produces
+     * the notified data.
+     */
+    template < class LinkLayer >
+    class central
+    {
+    public:
+        central( LinkLayer& link_layer, const scenario& s, std::uint16_t max_payload, std::uint32_t duration, std::uint32_t seed )
+            : link_layer_( link_layer )
+            , scenario_( s )
+            , max_payload_( max_payload )
+            , duration_( duration )
+            , random_( seed )
+            , processed_events_( 0 )
+            , processed_pdus_( 0 )
+            , next_expected_sequence_number_( false )
+            , att_request_outstanding_( false )
+            , peripheral_payload_( 27 )
+            , phy_update_requested_( s.used_phy == phy::le_1m )
+            , streaming_( false )
+            , streaming_start_( 0 )
+            , next_sample_( 0 )
+            , sequence_( 0 )
+            , superseded_( 0 )
+            , delivered_( 0 )
+            , delivered_bytes_( 0 )
+            , retransmissions_( 0 )
+            , streaming_events_( 0 )
+            , streaming_air_time_( 0 )
+        {
+            // ATT_EXCHANGE_MTU_REQ
+            l2cap_pdu( { 0x02, low( 247 ), high( 247 ) } );
+
+            if ( !phy_update_requested_ )
+                outbox_.push_back( { 0x03, 0x03, 0x16, 0x02, 0x02 } );   // LL_PHY_REQ: 2M
+
+            // enable notifications of all streams
+            for ( std::size_t stream = 0; stream != number_of_streams; ++stream )
+                l2cap_pdu( { 0x12, low( cccd_handle( stream ) ), high( cccd_handle( stream ) ), 0x01, 0x00 } );
+
+            link_layer_.simulate_pdu_loss( [this]() -> bool {
+                const bool lost = random_() % 1000 < scenario_.loss_permille;
+                lost_.push_back( lost );
+
+                return lost;
+            } );
+
+            update_event_length();
+        }
+
+        test::pdu_list_t connection_event()
+        {
+            const auto& events = link_layer_.connection_events();
+            const auto& event  = events.back();
+
+            if ( events.size() == 1 )
+                first_anchor_ = event.schedule_time + event.start_receive;
+
+            const std::uint32_t anchor = ( event.schedule_time + event.start_receive - first_anchor_ ).usec();
+
+            // the current connection event has no data yet
+            evaluate_events( events.size() - 1 );
+
+            test::pdu_list_t result;
+
+            // like every ATT client, the central has only one ATT request outstanding
+            const auto next = std::find_if( outbox_.begin(), outbox_.end(), [this]( const test::pdu_t& pdu ) {
+                return ( pdu[ 0 ] & 0x03 ) == 0x03 || !att_request_outstanding_;
+            } );
+
+            if ( next != outbox_.end() )
+            {
+                att_request_outstanding_ = att_request_outstanding_ || ( ( *next )[ 0 ] & 0x03 ) != 0x03;
+                result.push_back( *next );
+                outbox_.erase( next );
+            }
+            else if ( outbox_.empty() && !att_request_outstanding_ && !streaming_ )
+            {
+                streaming_       = true;
+                streaming_start_ = anchor;
+                next_sample_     = anchor;
+            }
+
+            if ( streaming_ && anchor < duration_ )
+                produce_samples( anchor );
+
+            // on hardware, link_layer::run() returns after every connection event
+            link_layer_.wake_up();
+
+            return result;
+        }
+
+        report evaluate()
+        {
+            evaluate_events( link_layer_.connection_events().size() );
+
+            std::sort( latencies_.begin(), latencies_.end() );
+
+            const double streaming_time = static_cast< double >( duration_ - streaming_start_ );
+            const double interval       = static_cast< double >( scenario_.interval ) * 1250.0;
+
+            return report{
+                static_cast< double >( delivered_bytes_ ) * 8.0 * 1000.0 / streaming_time,
+                delivered_,
+                superseded_,
+                retransmissions_,
+                percentile( latencies_, 50 ),
+                percentile( latencies_, 90 ),
+                percentile( latencies_, 99 ),
+                latencies_.empty() ? 0 : latencies_.back(),
+                streaming_events_ == 0
+                    ? 0.0
+                    : static_cast< double >( streaming_air_time_ ) * 100.0 / ( static_cast< double >( streaming_events_ ) * interval )
+            };
+        }
+
+    private:
+        static std::uint16_t cccd_handle( std::size_t stream )
+        {
+            return static_cast< std::uint16_t >( 0x0004 + 3 * stream );
+        }
+
+        static std::uint16_t value_handle( std::size_t stream )
+        {
+            return static_cast< std::uint16_t >( 0x0003 + 3 * stream );
+        }
+
+        void l2cap_pdu( std::initializer_list< std::uint8_t > att )
+        {
+            std::vector< std::uint8_t > pdu = {
+                0x02, static_cast< std::uint8_t >( att.size() + 4 ),
+                low( static_cast< std::uint16_t >( att.size() ) ), high( static_cast< std::uint16_t >( att.size() ) ),
+                0x04, 0x00 };
+
+            pdu.insert( pdu.end(), att.begin(), att.end() );
+            outbox_.push_back( pdu );
+        }
+
+        /*
+         * The link layer fills its transmit buffer between two connection events, so the
+         * samples, that the application produces until the next connection event, are notified here.
+         */
+        void produce_samples( std::uint32_t anchor )
+        {
+            if ( scenario_.sample_period == 0 )
+            {
+                for ( std::size_t stream = 0; stream != number_of_streams; ++stream )
+                    produce_sample( stream, anchor );
+            }
+            else
+            {
+                const std::uint32_t next_anchor = anchor + scenario_.interval * 1250u;
+
+                for ( ; next_sample_ < next_anchor; next_sample_ += scenario_.sample_period )
+                    produce_sample( 0, next_sample_ );
+            }
+        }
+
+        // writes the next sequence number into the value of the stream
+        void produce_sample( std::size_t stream, std::uint32_t time )
+        {
+            const std::uint32_t sequence = sequence_++;
+            produced_at_.push_back( time );
+
+            std::uint8_t* const value = stream_values[ stream ];
+            bluetoe::details::write_32bit( value, sequence );
+
+            if ( !notify_stream( link_layer_, stream ) )
+                ++superseded_;
+        }
+
+        void evaluate_events( std::size_t count )
+        {
+            const auto& events = link_layer_.connection_events();
+
+            for ( ; processed_events_ < count; ++processed_events_ )
+                evaluate_event( events[ processed_events_ ] );
+        }
+
+        void evaluate_event( const test::connection_event& event )
+        {
+            const std::uint32_t anchor = ( event.schedule_time + event.start_receive - first_anchor_ ).usec();
+            std::uint32_t       time   = anchor;
+
+            for ( std::size_t index = 0; index != event.transmitted_data.size(); ++index )
+            {
+                const auto& received    = event.received_data[ index ];
+                const auto& transmitted = event.transmitted_data[ index ];
+
+                // without a receive buffer in the link layer, the received PDU is not recorded
+                time += air_time( std::max< std::size_t >( received.size(), 2 ) - 2, event.receiving_encoding ) + t_ifs
+                      + air_time( transmitted.size() - 2, event.transmission_encoding ) + t_ifs;
+
+                const bool lost = processed_pdus_ < lost_.size() && lost_[ processed_pdus_ ];
+                ++processed_pdus_;
+
+                const bool sequence_number = ( transmitted[ 0 ] & 0x08 ) != 0;
+
+                if ( lost || sequence_number != next_expected_sequence_number_ )
+                {
+                    // a lost PDU with data will be retransmitted
+                    if ( lost && transmitted.size() > 2 )
+                        ++retransmissions_;
+
+                    continue;
+                }
+
+                next_expected_sequence_number_ = !next_expected_sequence_number_;
+                evaluate_pdu( transmitted.data, time );
+            }
+
+            if ( streaming_ && anchor >= streaming_start_ && anchor < duration_ )
+            {
+                ++streaming_events_;
+                streaming_air_time_ += time - anchor;
+            }
+        }
+
+        void evaluate_pdu( const std::vector< std::uint8_t >& pdu, std::uint32_t time )
+        {
+            const std::uint8_t llid = pdu[ 0 ] & 0x03;
+
+            if ( llid == 0x03 && pdu.size() > 2 )
+            {
+                evaluate_control_pdu( pdu );
+            }
+            else if ( llid == 0x02 && pdu.size() >= 4 )
+            {
+                l2cap_input_.assign( pdu.begin() + 2, pdu.end() );
+                l2cap_input_complete( time );
+            }
+            else if ( llid == 0x01 && pdu.size() > 2 && !l2cap_input_.empty() )
+            {
+                l2cap_input_.insert( l2cap_input_.end(), pdu.begin() + 2, pdu.end() );
+                l2cap_input_complete( time );
+            }
+        }
+
+        void evaluate_control_pdu( const std::vector< std::uint8_t >& pdu )
+        {
+            const std::uint8_t opcode = pdu[ 2 ];
+
+            // LL_LENGTH_REQ
+            if ( opcode == 0x14 && pdu.size() >= 11 )
+            {
+                const std::uint16_t peripheral_tx = static_cast< std::uint16_t >( pdu[ 7 ] | ( pdu[ 8 ] << 8 ) );
+                peripheral_payload_ = std::min( peripheral_tx, max_payload_ );
+
+                outbox_.insert( outbox_.begin(), {
+                    0x03, 0x09, 0x15,
+                    low( max_payload_ ), high( max_payload_ ), 0x48, 0x08,
+                    low( max_payload_ ), high( max_payload_ ), 0x48, 0x08 } );
+
+                update_event_length();
+            }
+            // LL_PHY_RSP
+            else if ( opcode == 0x17 && !phy_update_requested_ )
+            {
+                phy_update_requested_ = true;
+
+                // the index of the event is the connection event counter, as there is no peripheral latency
+                const auto instance = static_cast< std::uint16_t >( link_layer_.connection_events().size() + 6 );
+                outbox_.insert( outbox_.begin(), { 0x03, 0x05, 0x18, 0x02, 0x02, low( instance ), high( instance ) } );
+            }
+        }
+
+        void l2cap_input_complete( std::uint32_t time )
+        {
+            const std::size_t size = static_cast< std::size_t >( l2cap_input_[ 0 ] | ( l2cap_input_[ 1 ] << 8 ) ) + 4;
+
+            if ( l2cap_input_.size() < size )
+                return;
+
+            const bool att          = l2cap_input_[ 2 ] == 0x04 && l2cap_input_[ 3 ] == 0x00 && size > 4;
+            const bool notification = att && size >= 4 + 3 + 4 && l2cap_input_[ 4 ] == 0x1B;
+
+            // ATT_ERROR_RSP, ATT_EXCHANGE_MTU_RSP, ATT_WRITE_RSP
+            if ( att && ( l2cap_input_[ 4 ] == 0x01 || l2cap_input_[ 4 ] == 0x03 || l2cap_input_[ 4 ] == 0x13 ) )
+                att_request_outstanding_ = false;
+
+            if ( notification )
+            {
+                const std::uint32_t sequence = bluetoe::details::read_32bit( &l2cap_input_[ 7 ] );
+
+                ++delivered_;
+                delivered_bytes_ += size - 4 - 3;
+
+                if ( sequence < produced_at_.size() && time <= duration_ )
+                    latencies_.push_back( time - produced_at_[ sequence ] );
+            }
+
+            l2cap_input_.clear();
+        }
+
+        // limits the number of PDUs per connection event to the number of exchanges with the largest PDUs, that fit into the interval
+        void update_event_length()
+        {
+            const auto encoding = scenario_.used_phy == phy::le_2m
+                ? bluetoe::link_layer::details::phy_ll_encoding::le_2m_phy
+                : bluetoe::link_layer::details::phy_ll_encoding::le_1m_phy;
+
+            const std::uint32_t exchange = air_time( 0, encoding ) + t_ifs + air_time( peripheral_payload_, encoding ) + t_ifs;
+            const std::uint32_t interval = scenario_.interval * 1250u;
+
+            link_layer_.max_pdus_per_connection_event( std::max< std::uint32_t >( 1, ( interval - t_ifs ) / exchange ) );
+        }
+
+    private:
+        LinkLayer&                  link_layer_;
+        const scenario              scenario_;
+        const std::uint16_t         max_payload_;
+        const std::uint32_t         duration_;
+        std::minstd_rand            random_;
+
+        std::vector< test::pdu_t >  outbox_;
+        std::vector< bool >         lost_;
+        std::size_t                 processed_events_;
+        std::size_t                 processed_pdus_;
+        bool                        next_expected_sequence_number_;
+        bool                        att_request_outstanding_;
+        std::vector< std::uint8_t > l2cap_input_;
+
+        bluetoe::link_layer::delta_time first_anchor_;
+        std::uint16_t               peripheral_payload_;
+        bool                        phy_update_requested_;
+
+        bool                        streaming_;
+        std::uint32_t               streaming_start_;
+        std::uint32_t               next_sample_;
+        std::uint32_t               sequence_;
+        std::vector< std::uint32_t > produced_at_;
+
+        std::uint64_t               superseded_;
+        std::uint64_t               delivered_;
+        std::uint64_t               delivered_bytes_;
+        std::uint64_t               retransmissions_;
+        std::vector< std::uint32_t > latencies_;
+        std::uint64_t               streaming_events_;
+        std::uint64_t               streaming_air_time_;
+    };
+
+    std::vector< std::uint8_t > connection_request( std::uint16_t interval )
+    {
+        return {
+            0xc5, 0x22,                         // header
+            0x3c, 0x1c, 0x62, 0x92, 0xf0, 0x48, // InitA: 48:f0:92:62:1c:3c (random)
+            0x47, 0x11, 0x08, 0x15, 0x0f, 0xc0, // AdvA:  c0:0f:15:08:11:47 (random)
+            0x5a, 0xb3, 0x9a, 0xaf,             // Access Address
+            0x08, 0x81, 0xf6,                   // CRC Init
+            0x01,                               // transmit window size
+            0x00, 0x00,                         // window offset
+            low( interval ), high( interval ),  // interval
+            0x00, 0x00,                         // peripheral latency
+            0x90, 0x01,                         // connection timeout (4s)
+            0xff, 0xff, 0xff, 0xff, 0x1f,       // used channel map
+            0xaa                                // hop increment and sleep clock accuracy (10 and 50ppm)
+        };
+    }
+
+    template < class LinkLayer >
+    report simulate( const scenario& s, std::uint16_t max_payload, std::uint32_t seconds )
+    {
+        const std::uint32_t duration = seconds * 1000000u;
+        const std::uint32_t interval = s.interval * 1250u;
+
+        std::unique_ptr< LinkLayer > link_layer( new LinkLayer );
+        central< LinkLayer >         simulated_central( *link_layer, s, max_payload, duration, 0x47110815 );
+
+        link_layer->respond_to( 37, connection_request( s.interval ) );
+        link_layer->end_of_simulation( bluetoe::link_layer::delta_time( duration + 1000000u ) );
+
+        const std::size_t events = duration / interval + 1;
+
+        for ( std::size_t event = 0; event != events; ++event )
+        {
+            link_layer->add_connection_event_respond( test::connection_event_response(
+                std::function< test::pdu_list_t () >( [&simulated_central]() {
+                    return simulated_central.connection_event();
+                } ) ) );
+        }
+
+        for ( std::size_t before = 0; link_layer->connection_events().size() < events; )
+        {
+            before = link_layer->connection_events().size();
+            link_layer->run();
+
+            if ( link_layer->connection_events().size() == before )
+                break;
+        }
+
+        return simulated_central.evaluate();
+    }
+
+    /*
+     * A link layer configuration: the ATT MTU of the server, the size of the transmit and receive buffers
+     * and the largest link layer payload, the central negotiates. A payload larger than 27 requires the
+     * data length extension in the Options.
+     */
+    template < std::uint16_t Mtu, std::size_t BufferSize, std::uint16_t MaxPayload, typename ... Options >
+    struct configuration
+    {
+        using link_layer = bluetoe::link_layer::link_layer<
+            stream_server< Mtu >, test::radio_with_2mbit,
+            bluetoe::link_layer::buffer_sizes< BufferSize, BufferSize >,
+            Options... >;
+
+        static constexpr std::uint16_t  mtu         = Mtu;
+        static constexpr std::size_t    buffer_size = BufferSize;
+        static constexpr std::uint16_t  max_payload = MaxPayload;
+    };
+
+    // the default configuration of the link layer
+    using mtu_23                    = configuration< 23, 61, 27 >;
+
+    // large notifications, fragmented into PDUs of the default size
+    using mtu_247                   = configuration< 247, 1024, 27 >;
+
+    using mtu_247_dle               = configuration< 247, 1024, 251, bluetoe::link_layer::data_length_extension<> >;
+
+    // the transmit buffer holds two notifications at most
+    using mtu_247_dle_small_buffers = configuration< 247, 512, 251, bluetoe::link_layer::data_length_extension<> >;
+
+    void print( const scenario& s, std::uint16_t mtu, std::size_t buffer_size, std::uint16_t max_payload, const report& r )
+    {
+        const auto ms = []( std::uint32_t usec ) {
+            return static_cast< double >( usec ) / 1000.0;
+        };
+
+        std::cout << std::left
+                  << std::setw( 12 ) << s.name
+                  << std::right << std::fixed
+                  << std::setw( 7 ) << std::setprecision( 2 ) << s.interval * 1.25
+                  << std::setw( 6 ) << std::setprecision( 1 ) << s.loss_permille / 10.0
+                  << std::setw( 4 ) << phy_name( s.used_phy )
+                  << std::setw( 5 ) << mtu
+                  << std::setw( 6 ) << buffer_size
+                  << std::setw( 5 ) << max_payload
+                  << std::setw( 10 ) << std::setprecision( 1 ) << r.goodput
+                  << std::setw( 9 ) << r.delivered
+                  << std::setw( 9 ) << r.superseded
+                  << std::setw( 8 ) << r.retransmissions
+                  << std::setw( 8 ) << std::setprecision( 2 ) << ms( r.latency_p50 )
+                  << std::setw( 8 ) << ms( r.latency_p90 )
+                  << std::setw( 8 ) << ms( r.latency_p99 )
+                  << std::setw( 8 ) << ms( r.latency_max )
+                  << std::setw( 7 ) << std::setprecision( 1 ) << r.utilisation
+                  << '\n';
+    }
+
+    template < class Configuration >
+    void simulate_configuration( const std::vector< scenario >& scenarios, std::uint32_t seconds )
+    {
+        for ( const auto& s : scenarios )
+        {
+            print( s, Configuration::mtu, Configuration::buffer_size, Configuration::max_payload,
+                simulate< typename Configuration::link_layer >( s, Configuration::max_payload, seconds ) );
+        }
+    }
+}
+
+int main( int argc, char** argv )
+{
+    const std::uint32_t seconds = argc > 1
+        ? static_cast< std::uint32_t >( std::strtoul( argv[ 1 ], nullptr, 10 ) )
+        : 10;
+
+    if ( seconds == 0 || seconds > 3600 )
+    {
+        std::cerr << "usage: " << argv[ 0 ] << " [simulated seconds per scenario]\n";
+        return 1;
+    }
+
+    std::cout << std::left
+              << std::setw( 12 ) << "scenario"
+              << std::right
+              << std::setw( 7 ) << "ms"
+              << std::setw( 6 ) << "loss%"
+              << std::setw( 4 ) << "phy"
+              << std::setw( 5 ) << "mtu"
+              << std::setw( 6 ) << "buf"
+              << std::setw( 5 ) << "pdu"
+              << std::setw( 10 ) << "kbit/s"
+              << std::setw( 9 ) << "notified"
+              << std::setw( 9 ) << "supersed"
+              << std::setw( 8 ) << "retrans"
+              << std::setw( 8 ) << "p50 ms"
+              << std::setw( 8 ) << "p90 ms"
+              << std::setw( 8 ) << "p99 ms"
+              << std::setw( 8 ) << "max ms"
+              << std::setw( 7 ) << "util%" << '\n';
+
+    // notifications of all streams at every connection event
+    const std::vector< scenario > saturated = {
+        { "saturated", 6,  0,   phy::le_1m, 0 },
+        { "saturated", 24, 0,   phy::le_1m, 0 },
+        { "saturated", 24, 50,  phy::le_1m, 0 },
+        { "saturated", 24, 0,   phy::le_2m, 0 },
+        { "saturated", 24, 100, phy::le_2m, 0 }
+    };
+
+    // a single stream, sampled every 10ms
+    const std::vector< scenario > sampled = {
+        { "sampled", 6,  0,   phy::le_1m, 10000 },
+        { "sampled", 24, 0,   phy::le_1m, 10000 },
+        { "sampled", 40, 0,   phy::le_1m, 10000 },
+        { "sampled", 24, 100, phy::le_1m, 10000 }
+    };
+
+    simulate_configuration< mtu_23 >( saturated, seconds );
+    simulate_configuration< mtu_247 >( saturated, seconds );
+    simulate_configuration< mtu_247_dle >( saturated, seconds );
+    simulate_configuration< mtu_247_dle_small_buffers >( saturated, seconds );
+
+    simulate_configuration< mtu_23 >( sampled, seconds );
+    simulate_configuration< mtu_247_dle >( sampled, seconds );
+
+    return 0;
+}
@@ -8,12 +8,67 @@
 #include <bluetoe/meta_types.hpp>
 
 #include <algorithm>
+#include <iterator>
 
 namespace bluetoe {
 
     namespace details {
         struct list_of_16_bit_service_uuids_tag {};
         struct list_of_128_bit_service_uuids_tag {};
+
+        template < typename List, std::size_t Size, std::size_t Space,
+            std::size_t Count = ( Space < 4 ? 0 : ( ( Space - 2 ) / 2 < Size ? ( Space - 2 ) / 2 : Size ) ),
+            typename = make_index_sequence< 2 * Count > >
+        struct uuid16_list_advertising_data;
+
+        template < typename List, std::size_t Size, std::size_t Space, std::size_t Count, std::size_t ... Is >
+        struct uuid16_list_advertising_data< List, Size, Space, Count, index_sequence< Is... > >
+        {
+            using type = byte_sequence<
+                static_cast< std::uint8_t >( 1 + 2 * Count ),
+                Count == Size
+                    ? bits( gap_types::complete_service_uuids_16 )
+                    : bits( gap_types::incomplete_service_uuids_16 ),
+                static_cast< std::uint8_t >( List::values_[ Is / 2 ] >> ( 8 * ( Is % 2 ) ) )... >;
+        };
+
+        template < typename List, std::size_t Size, std::size_t Space >
+        struct uuid16_list_advertising_data< List, Size, Space, 0, index_sequence<> >
+        {
+            using type = byte_sequence<>;
+        };
+
+        template < typename UUID, typename = make_index_sequence< sizeof( UUID::bytes ) > >
+        struct uuid_bytes;
+
+        template < typename UUID, std::size_t ... Is >
+        struct uuid_bytes< UUID, index_sequence< Is... > >
+        {
+            using type = byte_sequence< UUID::bytes[ Is ]... >;
+        };
+
+        template < std::size_t Space, typename ... UUID128 >
+        struct uuid128_list_advertising_data
+        {
+            static constexpr std::size_t uuid_size = 16;
+            static constexpr std::size_t count     = Space < 2 + uuid_size
+                ? 0
+                : ( ( Space - 2 ) / uuid_size < sizeof...( UUID128 ) ? ( Space - 2 ) / uuid_size : sizeof...( UUID128 ) );
+
+            using uuids = typename concat_byte_sequences< typename uuid_bytes< UUID128 >::type... >::type;
+
+            using type = typename select_type< count == 0,
+                byte_sequence<>,
+                typename concat_byte_sequences<
+                    byte_sequence<
+                        static_cast< std::uint8_t >( 1 + uuid_size * count ),
+                        count == sizeof...( UUID128 )
+                            ? bits( gap_types::complete_service_uuids_128 )
+                            : bits( gap_types::incomplete_service_uuids_128 ) >,
+                    typename first_bytes< uuids, uuid_size * count >::type
+                >::type
+            >::type;
+        };
     }
 
     /**
@@ -57,6 +112,10 @@ namespace bluetoe {
             return begin;
         }
 
+        template < std::size_t Space >
+        using static_advertising_data = typename details::uuid16_list_advertising_data<
+            list_of_16_bit_service_uuids< UUID16... >, sizeof...( UUID16 ), Space >::type;
+
         static constexpr std::uint16_t values_[ sizeof ...(UUID16) ] = { UUID16::as_16bit()...};
         /** @endcond */
     };
@@ -78,6 +137,9 @@ namespace bluetoe {
         {
             return begin;
         }
+
+        template < std::size_t >
+        using static_advertising_data = details::byte_sequence<>;
     };
 
     template < typename ... UUID16 >
@@ -96,6 +158,9 @@ namespace bluetoe {
         {
             return begin;
         }
+
+        template < std::size_t >
+        using static_advertising_data = details::byte_sequence<>;
         /** @endcond */
     };
 
@@ -153,6 +218,9 @@ namespace bluetoe {
 
             return begin;
         }
+
+        template < std::size_t Space >
+        using static_advertising_data = typename details::uuid128_list_advertising_data< Space, UUID128... >::type;
         /** @endcond */
     };
 
@@ -169,6 +237,9 @@ namespace bluetoe {
         static constexpr std::uint8_t* advertising_data( std::uint8_t* begin, std::uint8_t* ) {
             return begin;
         }
+
+        template < std::size_t >
+        using static_advertising_data = details::byte_sequence<>;
     };
     /** @endcond */
 
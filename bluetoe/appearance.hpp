@@ -2,6 +2,8 @@
 #define BLUETOE_APPEARANCE_HPP
 
 #include <bluetoe/meta_types.hpp>
+#include <bluetoe/meta_tools.hpp>
+#include <bluetoe/codes.hpp>
 
 namespace bluetoe {
 
@@ -180,6 +182,15 @@ namespace bluetoe {
 
             return begin;
         }
+
+        template < typename Adv, std::size_t Space >
+        using static_advertising_data = typename details::select_type< ( Space >= 4u ),
+            details::byte_sequence<
+                3u,
+                bits( details::gap_types::appearance ),
+                static_cast< std::uint8_t >( Adv::value & 0xff ),
+                static_cast< std::uint8_t >( Adv::value >> 8 ) >,
+            details::byte_sequence<> >::type;
         /** @endcond */
     };
 
@@ -196,6 +207,9 @@ namespace bluetoe {
         {
             return begin;
         }
+
+        template < typename, std::size_t >
+        using static_advertising_data = details::byte_sequence<>;
     };
     /** @endcond */
 }
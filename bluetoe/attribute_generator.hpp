@@ -16,7 +16,7 @@ namespace details {
     struct generate_attribute;
 
     /**
-     * generate a const static array of attributes out of a list of tuples, containing the parameter to generate an attribute
+     * generate the list of attribute generators out of a list of tuples, containing the parameter to generate an attribute
      *
      *  Attributes: A std::tuple, containing a tuple for every attribute to generate.
      *
@@ -30,28 +30,14 @@ namespace details {
     template < typename CCCDIndices,std::size_t ClientCharacteristicIndex, typename Service, typename Server, typename ... Options >
     struct generate_attribute_list< std::tuple<>, CCCDIndices, ClientCharacteristicIndex, Service, Server, std::tuple< Options... > >
     {
-        static const attribute attribute_at( std::size_t )
-        {
-            assert( !"should not happen" );
-            return attribute();
-        }
+        using generators = std::tuple<>;
     };
 
     template < typename ... Attributes, typename ... CCCDIndices, std::size_t ClientCharacteristicIndex, typename Service, typename Server, typename ... Options >
     struct generate_attribute_list< std::tuple< Attributes... >, std::tuple< CCCDIndices... >, ClientCharacteristicIndex, Service, Server, std::tuple< Options... > >
     {
-        static const attribute attribute_at( std::size_t index )
-        {
-            return attributes[ index ];
-        }
-
-        static const attribute attributes[ sizeof ...(Attributes) ];
-    };
-
-    template < typename ... Attributes, typename ... CCCDIndices, std::size_t ClientCharacteristicIndex, typename Service, typename Server, typename ... Options >
-    const attribute generate_attribute_list< std::tuple< Attributes... >, std::tuple< CCCDIndices... >, ClientCharacteristicIndex, Service, Server, std::tuple< Options... > >::attributes[ sizeof ...(Attributes) ] =
-    {
-        generate_attribute< Attributes, std::tuple< CCCDIndices... >, ClientCharacteristicIndex, Service, Server, Options... >::attr...
+        // the types, that generate the attributes; each provides a constexpr attr member
+        using generators = std::tuple< generate_attribute< Attributes, std::tuple< CCCDIndices... >, ClientCharacteristicIndex, Service, Server, Options... >... >;
     };
 
     template < typename OptionsList, typename MetaTypeList, typename OptionsDefault = std::tuple<> >
@@ -83,17 +69,39 @@ namespace details {
         attribute_generation_parameters get_attribute_generation_parameters() { return attribute_generation_parameters(); }
 
         template < std::size_t ClientCharacteristicIndex, typename Service, typename Server >
-        static const attribute attribute_at( std::size_t index )
-        {
-            return generate_attribute_list<
+        using attribute_generators = typename generate_attribute_list<
                 attribute_generation_parameters,
                 CCCDIndices,
                 ClientCharacteristicIndex,
                 Service,
                 Server,
                 OptionsList
-            >::attribute_at( index );
-        }
+            >::generators;
+    };
+
+    /**
+     * a flat, compile time generated table of attributes.
+     *
+     * Generators: A std::tuple of generate_attribute<> instances, in the order of the resulting attributes.
+     *
+     * As every generator provides its attribute as constant expression, the table can be placed in ROM and
+     * looking up an attribute by index is a single indexed load.
+     */
+    template < typename Generators >
+    struct attribute_table;
+
+    template < typename ... Generators >
+    struct attribute_table< std::tuple< Generators... > >
+    {
+        static constexpr std::size_t size = sizeof ...(Generators);
+
+        static const attribute attributes[ sizeof ...(Generators) ];
+    };
+
+    template < typename ... Generators >
+    constexpr attribute attribute_table< std::tuple< Generators... > >::attributes[ sizeof ...(Generators) ] =
+    {
+        Generators::attr...
     };
 
     /** @endcond */
@@ -85,6 +85,9 @@ namespace bluetoe {
         static constexpr std::uint16_t invalid_attribute_handle = 0;
         static constexpr std::size_t   invalid_attribute_index  = ~0;
 
+        template < typename Characteristic >
+        struct sum_by_attributes;
+
         /*
          * select one of attribute_handle< H > or attribute_handle< H, B, C >
          */
@@ -139,42 +142,20 @@ namespace bluetoe {
             static constexpr std::size_t value_position       = 1;
             static constexpr std::size_t cccd_position        = 2;
 
-            static std::uint16_t characteristic_attribute_handle_by_index( std::size_t index )
+            // all mapping functions are constexpr, so that handle_index_mapping can generate tables at compile time
+            static constexpr std::uint16_t characteristic_attribute_handle_by_index( std::size_t index )
             {
-                const std::size_t relative_index = index - StartIndex;
-
-                assert( relative_index < characteristic_t::number_of_attributes );
-
-                switch ( relative_index )
-                {
-                    case declaration_position:
-                        return attribute_handles_t::declaration_handle;
-                        break;
-
-                    case value_position:
-                        return attribute_handles_t::value_handle;
-                        break;
-
-                    case cccd_position:
-                        return attribute_handles_t::cccd_handle;
-                        break;
-                }
-
-                return relative_index - cccd_position + attribute_handles_t::cccd_handle;
+                return index - StartIndex == declaration_position ? attribute_handles_t::declaration_handle
+                     : index - StartIndex == value_position       ? attribute_handles_t::value_handle
+                     : static_cast< std::uint16_t >( index - StartIndex - cccd_position + attribute_handles_t::cccd_handle );
             }
 
-            static std::size_t characteristic_attribute_index_by_handle( std::uint16_t handle )
+            static constexpr std::size_t characteristic_attribute_index_by_handle( std::uint16_t handle )
             {
-                if ( handle <= attribute_handles_t::declaration_handle )
-                    return StartIndex + declaration_position;
-
-                if ( handle <= attribute_handles_t::value_handle )
-                    return StartIndex + value_position;
-
-                if ( handle <= attribute_handles_t::cccd_handle )
-                    return StartIndex + cccd_position;
-
-                return StartIndex + cccd_position + handle - attribute_handles_t::cccd_handle;
+                return handle <= attribute_handles_t::declaration_handle ? StartIndex + declaration_position
+                     : handle <= attribute_handles_t::value_handle       ? StartIndex + value_position
+                     : handle <= attribute_handles_t::cccd_handle        ? StartIndex + cccd_position
+                     : StartIndex + cccd_position + handle - attribute_handles_t::cccd_handle;
             }
         };
 
@@ -184,12 +165,12 @@ namespace bluetoe {
         template < std::uint16_t StartHandle, std::uint16_t StartIndex >
         struct interate_characteristic_index_mappings< StartHandle, StartIndex, std::tuple<> >
         {
-            static std::uint16_t attribute_handle_by_index( std::size_t )
+            static constexpr std::uint16_t attribute_handle_by_index( std::size_t )
             {
                 return invalid_attribute_handle;
             }
 
-            static std::size_t attribute_index_by_handle( std::uint16_t )
+            static constexpr std::size_t attribute_index_by_handle( std::uint16_t )
             {
                 return invalid_attribute_index;
             }
@@ -214,20 +195,18 @@ namespace bluetoe {
 
             using next = characteristic_index_mapping< StartHandle, StartIndex, Options... >;
 
-            static std::uint16_t attribute_handle_by_index( std::size_t index )
+            static constexpr std::uint16_t attribute_handle_by_index( std::size_t index )
             {
-                if ( index < next::end_index )
-                    return next::characteristic_attribute_handle_by_index( index );
-
-                return next_characteristic_mapping< StartHandle, StartIndex, std::tuple< Chars... >, Options... >::attribute_handle_by_index( index );
+                return index < next::end_index
+                    ? next::characteristic_attribute_handle_by_index( index )
+                    : next_characteristic_mapping< StartHandle, StartIndex, std::tuple< Chars... >, Options... >::attribute_handle_by_index( index );
             }
 
-            static std::size_t attribute_index_by_handle( std::uint16_t handle )
+            static constexpr std::size_t attribute_index_by_handle( std::uint16_t handle )
             {
-                if ( handle < next::end_handle )
-                    return next::characteristic_attribute_index_by_handle( handle );
-
-                return next_characteristic_mapping< StartHandle, StartIndex, std::tuple< Chars... >, Options... >::attribute_index_by_handle( handle );
+                return handle < next::end_handle
+                    ? next::characteristic_attribute_index_by_handle( handle )
+                    : next_characteristic_mapping< StartHandle, StartIndex, std::tuple< Chars... >, Options... >::attribute_index_by_handle( handle );
             }
         };
 
@@ -260,20 +239,18 @@ namespace bluetoe {
             static constexpr std::uint16_t end_handle   = next_char_mapping< StartHandle, StartIndex, Options... >::last_characteristic_end_handle;
             static constexpr std::uint16_t end_index    = StartIndex + service_t::number_of_attributes;
 
-            static std::uint16_t characteristic_handle_by_index( std::size_t index )
+            static constexpr std::uint16_t characteristic_handle_by_index( std::size_t index )
             {
-                if ( index == StartIndex )
-                    return service_handle;
-
-                return next_char_mapping< StartHandle, StartIndex, Options... >::attribute_handle_by_index( index );
+                return index == StartIndex
+                    ? service_handle
+                    : next_char_mapping< StartHandle, StartIndex, Options... >::attribute_handle_by_index( index );
             }
 
-            static std::size_t characteristic_first_index_by_handle( std::uint16_t handle )
+            static constexpr std::size_t characteristic_first_index_by_handle( std::uint16_t handle )
             {
-                if ( handle <= service_handle )
-                    return StartIndex;
-
-                return next_char_mapping< StartHandle, StartIndex, Options... >::attribute_index_by_handle( handle );
+                return handle <= service_handle
+                    ? StartIndex
+                    : next_char_mapping< StartHandle, StartIndex, Options... >::attribute_index_by_handle( handle );
             }
         };
 
@@ -286,12 +263,12 @@ namespace bluetoe {
         template < std::uint16_t StartHandle, std::uint16_t StartIndex >
         struct interate_service_index_mappings< StartHandle, StartIndex, std::tuple<> >
         {
-            static std::uint16_t service_handle_by_index( std::size_t )
+            static constexpr std::uint16_t service_handle_by_index( std::size_t )
             {
                 return invalid_attribute_handle;
             }
 
-            static std::size_t service_first_index_by_handle( std::uint16_t )
+            static constexpr std::size_t service_first_index_by_handle( std::uint16_t )
             {
                 return invalid_attribute_index;
             }
@@ -309,20 +286,122 @@ namespace bluetoe {
             : service_index_mapping< StartHandle, StartIndex, Options... >
             , next_service_mapping< StartHandle, StartIndex, std::tuple< Services... >, Options... >
         {
-            static std::uint16_t service_handle_by_index( std::size_t index )
+            static constexpr std::uint16_t service_handle_by_index( std::size_t index )
             {
-                if ( index < service_index_mapping< StartHandle, StartIndex, Options... >::end_index )
-                    return service_index_mapping< StartHandle, StartIndex, Options... >::characteristic_handle_by_index( index );
+                return index < service_index_mapping< StartHandle, StartIndex, Options... >::end_index
+                    ? service_index_mapping< StartHandle, StartIndex, Options... >::characteristic_handle_by_index( index )
+                    : next_service_mapping< StartHandle, StartIndex, std::tuple< Services... >, Options... >::service_handle_by_index( index );
+            }
+
+            static constexpr std::size_t service_first_index_by_handle( std::uint16_t handle )
+            {
+                return handle < service_index_mapping< StartHandle, StartIndex, Options... >::end_handle
+                    ? service_index_mapping< StartHandle, StartIndex, Options... >::characteristic_first_index_by_handle( handle )
+                    : next_service_mapping< StartHandle, StartIndex, std::tuple< Services... >, Options... >::service_first_index_by_handle( handle );
+            }
+        };
 
-                return next_service_mapping< StartHandle, StartIndex, std::tuple< Services... >, Options... >::service_handle_by_index( index );
+        /*
+         * Strategies to map between attribute index and handle at runtime. All of them are based on the
+         * constexpr mapping functions of interate_service_index_mappings, but do not iterate over all services
+         * and characteristics for every lookup.
+         */
+
+        /*
+         * Handles without gaps: The handle of index I is FirstHandle + I; no table needed.
+         */
+        template < typename Iterator, std::size_t NumberOfAttributes, std::uint16_t FirstHandle >
+        struct contiguous_handle_mapping
+        {
+            static std::uint16_t handle_by_index( std::size_t index )
+            {
+                return index < NumberOfAttributes
+                    ? static_cast< std::uint16_t >( FirstHandle + index )
+                    : invalid_attribute_handle;
             }
 
-            static std::size_t service_first_index_by_handle( std::uint16_t handle )
+            static std::size_t first_index_by_handle( std::uint16_t handle )
             {
-                if ( handle < service_index_mapping< StartHandle, StartIndex, Options... >::end_handle )
-                    return service_index_mapping< StartHandle, StartIndex, Options... >::characteristic_first_index_by_handle( handle );
+                if ( handle <= FirstHandle )
+                    return 0;
+
+                const std::size_t index = handle - FirstHandle;
 
-                return next_service_mapping< StartHandle, StartIndex, std::tuple< Services... >, Options... >::service_first_index_by_handle( handle );
+                return index < NumberOfAttributes
+                    ? index
+                    : invalid_attribute_index;
+            }
+        };
+
+        /*
+         * Handles with gaps: Table with the handle of every index. As the handles are sorted,
+         * the index of a handle is found by a binary search.
+         */
+        template < typename Iterator, typename Indices >
+        struct sorted_handle_table;
+
+        template < typename Iterator, std::size_t ... Is >
+        struct sorted_handle_table< Iterator, index_sequence< Is... > >
+        {
+            static const std::uint16_t handles[ sizeof...( Is ) ];
+        };
+
+        template < typename Iterator, std::size_t ... Is >
+        constexpr std::uint16_t sorted_handle_table< Iterator, index_sequence< Is... > >::handles[ sizeof...( Is ) ] = {
+            Iterator::service_handle_by_index( Is )...
+        };
+
+        template < typename Iterator, std::size_t NumberOfAttributes >
+        struct binary_search_handle_mapping
+        {
+            using table = sorted_handle_table< Iterator, make_index_sequence< NumberOfAttributes > >;
+
+            static std::uint16_t handle_by_index( std::size_t index )
+            {
+                return index < NumberOfAttributes
+                    ? table::handles[ index ]
+                    : invalid_attribute_handle;
+            }
+
+            static std::size_t first_index_by_handle( std::uint16_t handle )
+            {
+                const std::uint16_t* const end   = &table::handles[ 0 ] + NumberOfAttributes;
+                const std::uint16_t* const found = std::lower_bound( &table::handles[ 0 ], end, handle );
+
+                return found == end
+                    ? invalid_attribute_index
+                    : static_cast< std::size_t >( found - &table::handles[ 0 ] );
+            }
+        };
+
+        /*
+         * Handles with a few gaps: Additional table with the first index for every handle
+         * up to the largest handle.
+         */
+        template < typename Iterator, typename Handles >
+        struct handle_to_index_table;
+
+        template < typename Iterator, std::size_t ... Hs >
+        struct handle_to_index_table< Iterator, index_sequence< Hs... > >
+        {
+            static const std::uint16_t indices[ sizeof...( Hs ) ];
+        };
+
+        template < typename Iterator, std::size_t ... Hs >
+        constexpr std::uint16_t handle_to_index_table< Iterator, index_sequence< Hs... > >::indices[ sizeof...( Hs ) ] = {
+            static_cast< std::uint16_t >( Iterator::service_first_index_by_handle( Hs ) )...
+        };
+
+        template < typename Iterator, std::size_t NumberOfAttributes, std::uint16_t LastHandle >
+        struct direct_handle_mapping : binary_search_handle_mapping< Iterator, NumberOfAttributes >
+        {
+            using table = handle_to_index_table< Iterator, make_index_sequence< LastHandle + 1 > >;
+
+            static std::size_t first_index_by_handle( std::uint16_t handle )
+            {
+                return handle <= LastHandle
+                    ? table::indices[ handle ]
+                    : invalid_attribute_index;
             }
         };
 
@@ -332,22 +411,43 @@ namespace bluetoe {
          * An attribute index is a 0-based into an array of all attributes contained in a server. Accessing the
          * attribute by table is very fast. If neither attribute_handle<> or attribute_handles<> is used, the mapping
          * is trivial and an index I is mapped to a handle I + 1.
+         *
+         * If attribute_handle<> or attribute_handles<> create gaps in the handle range, a table of all handles is
+         * generated at compile time. If the handles are dense, an index is looked up by an additional table, indexed
+         * by handle. Otherwise, an index is looked up by binary search.
          */
         template < typename Server >
         struct handle_index_mapping;
 
         template < typename ... Options >
         struct handle_index_mapping< ::bluetoe::server< Options... > >
-            : private interate_service_index_mappings< 1u, 0u, typename ::bluetoe::server< Options... >::services >
         {
             static constexpr std::size_t   invalid_attribute_index  = ::bluetoe::details::invalid_attribute_index;
             static constexpr std::uint16_t invalid_attribute_handle = ::bluetoe::details::invalid_attribute_handle;
 
-            using iterator = interate_service_index_mappings< 1u, 0u, typename ::bluetoe::server< Options... >::services >;
+            using services = typename ::bluetoe::server< Options... >::services;
+            using iterator = interate_service_index_mappings< 1u, 0u, services >;
+
+            static constexpr std::size_t   number_of_attributes = sum_by< services, sum_by_attributes >::value;
+            static constexpr std::uint16_t first_handle         = iterator::service_handle_by_index( 0 );
+            static constexpr std::uint16_t last_handle          = iterator::service_handle_by_index( number_of_attributes - 1 );
+
+            static constexpr bool contiguous = std::size_t( last_handle - first_handle ) + 1 == number_of_attributes;
+            static constexpr bool dense      = std::size_t( last_handle ) < 2 * number_of_attributes;
+
+            using mapping = typename select_type<
+                contiguous,
+                contiguous_handle_mapping< iterator, number_of_attributes, first_handle >,
+                typename select_type<
+                    dense,
+                    direct_handle_mapping< iterator, number_of_attributes, last_handle >,
+                    binary_search_handle_mapping< iterator, number_of_attributes >
+                >::type
+            >::type;
 
             static std::uint16_t handle_by_index( std::size_t index )
             {
-                return iterator::service_handle_by_index( index );
+                return mapping::handle_by_index( index );
             }
 
             /**
@@ -358,7 +458,7 @@ namespace bluetoe {
              */
             static std::size_t first_index_by_handle( std::uint16_t handle )
             {
-                return iterator::service_first_index_by_handle( handle );
+                return mapping::first_index_by_handle( handle );
             }
 
             static std::size_t index_by_handle( std::uint16_t handle )
@@ -46,6 +46,9 @@ namespace bluetoe
     namespace nrf52_details
     {
         static constexpr std::uint8_t       maximum_advertising_pdu_size = 0x3f;
+        // ADV_EXT_IND, AUX_ADV_IND and AUX_SYNC_IND carry up to 255 octets of payload
+        static constexpr std::uint8_t       maximum_extended_advertising_pdu_size = 0xff;
+        static constexpr std::uint8_t       extended_advertising_pdu_type = 0x07;
         // position of the connecting address (AdvA)
         static constexpr unsigned           connect_addr_offset          = 2 + 6;
 
@@ -304,12 +307,21 @@ namespace bluetoe
             static bool             identity_resolving_enabled_;
         };
 
+        /*
+         * Options for the radio: the binding specific options and the options that configure the PDU buffers
+         */
         template < typename ... Options >
         struct radio_options
         {
-            using result = typename bluetoe::details::find_all_by_meta_type<
-                bluetoe::nrf::nrf_details::radio_option_meta_type,
-                Options...
+            using result = typename bluetoe::details::add_type<
+                typename bluetoe::details::find_all_by_meta_type<
+                    bluetoe::nrf::nrf_details::radio_option_meta_type,
+                    Options...
+                >::type,
+                typename bluetoe::details::find_all_by_meta_type<
+                    bluetoe::link_layer::details::pdu_buffer_meta_type,
+                    Options...
+                >::type
             >::type;
         };
 
@@ -354,8 +366,12 @@ namespace bluetoe
                 assert( state_ == state::idle );
                 assert( receive.buffer && receive.size >= 2u );
 
+                const std::size_t maximum_size = ( advertising_data.buffer[ 0 ] & 0x0f ) == extended_advertising_pdu_type
+                    ? maximum_extended_advertising_pdu_size
+                    : maximum_advertising_pdu_size;
+
                 bluetoe::link_layer::write_buffer advertising = advertising_data;
-                advertising.size = std::min< std::uint8_t >( advertising.size, maximum_advertising_pdu_size );
+                advertising.size = std::min< std::size_t >( advertising.size, maximum_size );
 
                 response_data_       = response_data;
                 receive_buffer_      = receive;
@@ -778,7 +794,7 @@ namespace bluetoe
             typename ... RadioOptions
         >
         class nrf52_radio< TransmitSize, ReceiveSize, false, CallBacks, Hardware, RadioOptions... > :
-            public nrf52_radio_base< CallBacks, Hardware, bluetoe::link_layer::ll_data_pdu_buffer< TransmitSize, ReceiveSize, nrf52_radio< TransmitSize, ReceiveSize, false, CallBacks, Hardware, RadioOptions... > >,
+            public nrf52_radio_base< CallBacks, Hardware, bluetoe::link_layer::ll_data_pdu_buffer< TransmitSize, ReceiveSize, nrf52_radio< TransmitSize, ReceiveSize, false, CallBacks, Hardware, RadioOptions... >, RadioOptions... >,
                                     RadioOptions... >
         {
         public:
@@ -800,7 +816,7 @@ namespace bluetoe
                 CallBacks,
                 Hardware,
                 bluetoe::link_layer::ll_data_pdu_buffer< TransmitSize, ReceiveSize,
-                    nrf52_radio< TransmitSize, ReceiveSize, true, CallBacks, Hardware, RadioOptions... > >,
+                    nrf52_radio< TransmitSize, ReceiveSize, true, CallBacks, Hardware, RadioOptions... >, RadioOptions... >,
                     RadioOptions... >,
             public security_tool_box
         {
@@ -813,7 +829,7 @@ namespace bluetoe
                 CallBacks,
                 Hardware,
                 bluetoe::link_layer::ll_data_pdu_buffer< TransmitSize, ReceiveSize,
-                    nrf52_radio< TransmitSize, ReceiveSize, true, CallBacks, Hardware, RadioOptions... > >,
+                    nrf52_radio< TransmitSize, ReceiveSize, true, CallBacks, Hardware, RadioOptions... >, RadioOptions... >,
                     RadioOptions...  >;
 
             nrf52_radio() : radio_base_t( encrypted_message_.data )
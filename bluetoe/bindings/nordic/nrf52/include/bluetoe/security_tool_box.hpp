@@ -60,6 +60,25 @@ namespace bluetoe
              */
             bluetoe::details::ecdh_shared_secret_t p256( const std::uint8_t* private_key, const std::uint8_t* public_key );
 
+            /**
+             * @brief starts an incremental p256() calculation
+             *
+             * Used by bluetoe::incremental_dh_key_calculation
+             */
+            void p256_start( const std::uint8_t* private_key, const std::uint8_t* public_key );
+
+            /**
+             * @brief continues the incremental p256() calculation by p256_bits_per_step bits
+             *
+             * @return true, if the result is available
+             */
+            bool p256_step();
+
+            /**
+             * @brief result of the last incremental p256() calculation
+             */
+            bluetoe::details::ecdh_shared_secret_t p256_result() const;
+
             /**
              * @brief f4() security toolbox function, as specified in the core spec
              */
@@ -100,6 +119,12 @@ namespace bluetoe
              * Functions required by IO capabilties
              */
             bluetoe::details::uint128_t create_passkey();
+
+        private:
+            // 257 bits in total; roughly 3% of a p256() calculation per call to p256_step()
+            static constexpr unsigned p256_bits_per_step = 8;
+
+            bluetoe::details::ecdh_shared_secret_t p256_result_;
         };
 
     }
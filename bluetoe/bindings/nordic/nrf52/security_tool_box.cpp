@@ -211,6 +211,40 @@ namespace nrf52_details
         return result;
     }
 
+    void security_tool_box::p256_start( const std::uint8_t* private_key, const std::uint8_t* public_key )
+    {
+        bluetoe::details::ecdh_private_key_t priv_key;
+        bluetoe::details::ecdh_public_key_t  pub_key;
+        std::reverse_copy( public_key, public_key + 32, pub_key.begin() );
+        std::reverse_copy( public_key + 32, public_key + 64, pub_key.begin() + 32 );
+        std::reverse_copy( private_key, private_key + 32, priv_key.begin() );
+
+        const int rc = uECC_shared_secret_start( pub_key.data(), priv_key.data() );
+        static_cast< void >( rc );
+        assert( rc == 1 );
+    }
+
+    bool security_tool_box::p256_step()
+    {
+        if ( !uECC_shared_secret_step( p256_bits_per_step ) )
+            return false;
+
+        bluetoe::details::ecdh_private_key_t shared_secret;
+
+        const int rc = uECC_shared_secret_finish( shared_secret.data() );
+        static_cast< void >( rc );
+        assert( rc == 1 );
+
+        std::reverse_copy( shared_secret.begin(), shared_secret.end(), p256_result_.begin() );
+
+        return true;
+    }
+
+    bluetoe::details::ecdh_shared_secret_t security_tool_box::p256_result() const
+    {
+        return p256_result_;
+    }
+
     static bluetoe::details::uint128_t left_shift(const bluetoe::details::uint128_t& input)
     {
         bluetoe::details::uint128_t output;
@@ -2070,6 +2070,104 @@ int uECC_shared_secret(const uint8_t public_key[uECC_BYTES*2],
     return !EccPoint_isZero(&product);
 }
 
+/* State of the incremental shared secret calculation. Only one calculation can be in progress at a time. */
+static struct {
+    EccPoint point;
+    uECC_word_t Rx[2][uECC_WORDS];
+    uECC_word_t Ry[2][uECC_WORDS];
+    uECC_word_t scalar[uECC_WORDS];
+    bitcount_t bit;
+} g_shared_secret;
+
+int uECC_shared_secret_start(const uint8_t public_key[uECC_BYTES*2],
+                             const uint8_t private_key[uECC_BYTES]) {
+    uECC_word_t private[uECC_WORDS];
+    uECC_word_t random[uECC_WORDS];
+    uECC_word_t *initial_Z = 0;
+    uECC_word_t tries;
+    bitcount_t numBits;
+#if (uECC_CURVE != uECC_secp160r1)
+    uECC_word_t tmp[uECC_WORDS];
+    uECC_word_t *p2[2] = {private, tmp};
+    uECC_word_t carry;
+#endif
+
+    for (tries = 0; tries < MAX_TRIES; ++tries) {
+        if (g_rng_function((uint8_t *)random, sizeof(random)) && !vli_isZero(random)) {
+            initial_Z = random;
+            break;
+        }
+    }
+
+    vli_bytesToNative(private, private_key);
+    vli_bytesToNative(g_shared_secret.point.x, public_key);
+    vli_bytesToNative(g_shared_secret.point.y, public_key + uECC_BYTES);
+
+#if (uECC_CURVE == uECC_secp160r1)
+    vli_set(g_shared_secret.scalar, private);
+    numBits = vli_numBits(private, uECC_WORDS);
+#else
+    carry = vli_add(private, private, curve_n);
+    vli_add(tmp, private, curve_n);
+    vli_set(g_shared_secret.scalar, p2[!carry]);
+    numBits = (uECC_BYTES * 8) + 1;
+#endif
+
+    vli_set(g_shared_secret.Rx[1], g_shared_secret.point.x);
+    vli_set(g_shared_secret.Ry[1], g_shared_secret.point.y);
+
+    XYcZ_initial_double(g_shared_secret.Rx[1], g_shared_secret.Ry[1],
+                        g_shared_secret.Rx[0], g_shared_secret.Ry[0], initial_Z);
+
+    g_shared_secret.bit = numBits - 2;
+
+    return 1;
+}
+
+int uECC_shared_secret_step(unsigned max_bits) {
+    uECC_word_t nb;
+
+    for (; g_shared_secret.bit > 0 && max_bits != 0; --g_shared_secret.bit, --max_bits) {
+        nb = !vli_testBit(g_shared_secret.scalar, g_shared_secret.bit);
+        XYcZ_addC(g_shared_secret.Rx[1 - nb], g_shared_secret.Ry[1 - nb],
+                  g_shared_secret.Rx[nb], g_shared_secret.Ry[nb]);
+        XYcZ_add(g_shared_secret.Rx[nb], g_shared_secret.Ry[nb],
+                 g_shared_secret.Rx[1 - nb], g_shared_secret.Ry[1 - nb]);
+    }
+
+    return g_shared_secret.bit <= 0;
+}
+
+int uECC_shared_secret_finish(uint8_t secret[uECC_BYTES]) {
+    EccPoint product;
+    uECC_word_t z[uECC_WORDS];
+    uECC_word_t nb;
+    uECC_word_t (*Rx)[uECC_WORDS] = g_shared_secret.Rx;
+    uECC_word_t (*Ry)[uECC_WORDS] = g_shared_secret.Ry;
+
+    nb = !vli_testBit(g_shared_secret.scalar, 0);
+    XYcZ_addC(Rx[1 - nb], Ry[1 - nb], Rx[nb], Ry[nb]);
+
+    /* Find final 1/Z value. */
+    vli_modSub_fast(z, Rx[1], Rx[0]);   /* X1 - X0 */
+    vli_modMult_fast(z, z, Ry[1 - nb]); /* Yb * (X1 - X0) */
+    vli_modMult_fast(z, z, g_shared_secret.point.x); /* xP * Yb * (X1 - X0) */
+    vli_modInv(z, z, curve_p);          /* 1 / (xP * Yb * (X1 - X0)) */
+    vli_modMult_fast(z, z, g_shared_secret.point.y); /* yP / (xP * Yb * (X1 - X0)) */
+    vli_modMult_fast(z, z, Rx[1 - nb]); /* Xb * yP / (xP * Yb * (X1 - X0)) */
+    /* End 1/Z calculation */
+
+    XYcZ_add(Rx[nb], Ry[nb], Rx[1 - nb], Ry[1 - nb]);
+    apply_z(Rx[0], Ry[0], z);
+
+    vli_set(product.x, Rx[0]);
+    vli_set(product.y, Ry[0]);
+    vli_clear(g_shared_secret.scalar);
+
+    vli_nativeToBytes(secret, product.x);
+    return !EccPoint_isZero(&product);
+}
+
 void uECC_compress(const uint8_t public_key[uECC_BYTES*2], uint8_t compressed[uECC_BYTES+1]) {
     wordcount_t i;
     for (i = 0; i < uECC_BYTES; ++i) {
@@ -184,6 +184,12 @@ namespace bluetoe {
         template < typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename Service, typename Server >
         static details::attribute attribute_at( std::size_t index );
 
+        /**
+         * @brief a std::tuple of all types that generate the attributes of this characteristic, in attribute order
+         */
+        template < typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename Service, typename Server >
+        struct attribute_generators;
+
         typedef typename details::find_by_meta_type< details::characteristic_value_meta_type, Options... >::type    base_value_type;
 
         static_assert( !std::is_same< base_value_type, details::no_such_type >::value,
@@ -243,10 +249,19 @@ namespace bluetoe {
     {
         assert( index < number_of_attributes );
 
-        using characteristic_descriptor_declarations = typename details::generate_characteristic_attributes< CCCDIndices, Options... >;
-        return characteristic_descriptor_declarations::template attribute_at< ClientCharacteristicIndex, Service, Server >( index );
+        using attributes = details::attribute_table< typename attribute_generators< CCCDIndices, ClientCharacteristicIndex, Service, Server >::type >;
+
+        return attributes::attributes[ index ];
     }
 
+    template < typename ... Options >
+    template < typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename Service, typename Server >
+    struct characteristic< Options... >::attribute_generators
+    {
+        using characteristic_descriptor_declarations = typename details::generate_characteristic_attributes< CCCDIndices, Options... >;
+        using type = typename characteristic_descriptor_declarations::template attribute_generators< ClientCharacteristicIndex, Service, Server >;
+    };
+
     namespace details {
         template < typename ServiceUUID, typename ... Options >
         struct characteristic_or_service_uuid
@@ -341,7 +356,7 @@ namespace bluetoe {
         };
 
         template < typename ... AttrOptions, typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename ... ServiceOptions, typename Server, typename ... Options >
-        const attribute generate_attribute< std::tuple< characteristic_declaration_parameter, AttrOptions... >, CCCDIndices, ClientCharacteristicIndex, service< ServiceOptions... > , Server, Options... >::attr {
+        constexpr attribute generate_attribute< std::tuple< characteristic_declaration_parameter, AttrOptions... >, CCCDIndices, ClientCharacteristicIndex, service< ServiceOptions... > , Server, Options... >::attr {
             bits( details::gatt_uuids::characteristic ),
             &generate_attribute< std::tuple< characteristic_declaration_parameter, AttrOptions... >, CCCDIndices, ClientCharacteristicIndex, service< ServiceOptions... >, Server, Options... >::char_declaration_access
         };
@@ -361,7 +376,7 @@ namespace bluetoe {
         };
 
         template < typename ... AttrOptions, typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename Service, typename Server, typename ... Options >
-        const attribute generate_attribute< std::tuple< characteristic_value_declaration_parameter, AttrOptions... >, CCCDIndices, ClientCharacteristicIndex, Service, Server, Options... >::attr {
+        constexpr attribute generate_attribute< std::tuple< characteristic_value_declaration_parameter, AttrOptions... >, CCCDIndices, ClientCharacteristicIndex, Service, Server, Options... >::attr {
             uuid::is_128bit
                 ? bits( details::gatt_uuids::internal_128bit_uuid )
                 : uuid::as_16bit(),
@@ -402,7 +417,7 @@ namespace bluetoe {
         };
 
         template < const char* const Name, typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename Service, typename Server, typename ... Options >
-        const attribute generate_attribute< std::tuple< characteristic_user_description_parameter, characteristic_name< Name > >, CCCDIndices, ClientCharacteristicIndex, Service, Server, Options... >::attr {
+        constexpr attribute generate_attribute< std::tuple< characteristic_user_description_parameter, characteristic_name< Name > >, CCCDIndices, ClientCharacteristicIndex, Service, Server, Options... >::attr {
             bits( gatt_uuids::characteristic_user_description ),
             &generate_attribute< std::tuple< characteristic_user_description_parameter, characteristic_name< Name > >, CCCDIndices, ClientCharacteristicIndex, Service, Server, Options... >::access
         };
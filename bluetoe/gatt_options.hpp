@@ -11,6 +11,7 @@ namespace bluetoe {
     namespace details {
         struct mtu_size_meta_type {};
         struct cccd_callback_meta_type {};
+        struct multiple_handle_value_notifications_meta_type {};
     }
 
     /**
@@ -60,7 +61,43 @@ namespace bluetoe {
         /** @endcond */
     };
 
+    /**
+     * @brief send pending notifications combined in ATT Multiple Handle Value Notifications
+     *
+     * When more than one characteristic is queued for notification, the server packs as many of the
+     * pending values as fit into the negotiated MTU into a single ATT Multiple Handle Value Notification
+     * (opcode 0x23), instead of sending one ATT Handle Value Notification per value. The values are taken
+     * from the notification queue in the order given by higher_outgoing_priority / lower_outgoing_priority.
+     *
+     * A client has to indicate, that it supports the reception of Multiple Handle Value Notifications, by
+     * setting bit 2 of the Client Supported Features characteristic (see gatt::service_with_caching). Until then,
+     * the server sends single notifications on that connection.
+     *
+     * @sa server
+     * @sa higher_outgoing_priority
+     * @sa gatt::service_with_caching
+     */
+    struct multiple_handle_value_notifications
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::multiple_handle_value_notifications_meta_type,
+            details::valid_server_option_meta_type {};
+
+        static constexpr bool enabled = true;
+        /** @endcond */
+    };
+
     /** @cond HIDDEN_SYMBOLS */
+    struct no_multiple_handle_value_notifications
+    {
+        struct meta_type :
+            details::multiple_handle_value_notifications_meta_type,
+            details::valid_server_option_meta_type {};
+
+        static constexpr bool enabled = false;
+    };
+
     struct no_client_characteristic_configuration_update_callback
     {
         struct meta_type :
@@ -0,0 +1,308 @@
+#ifndef BLUETOE_HCI_H4_TRANSPORT_HPP
+#define BLUETOE_HCI_H4_TRANSPORT_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace bluetoe {
+namespace hci {
+
+    namespace details {
+        /*
+         * H4 packet indicators, as defined by the UART transport layer of the Core Specification (Vol 4, Part A)
+         */
+        enum class h4_packet_type : std::uint8_t {
+            command     = 0x01,
+            acl_data    = 0x02,
+            sync_data   = 0x03,
+            event       = 0x04,
+            iso_data    = 0x05
+        };
+
+        inline bool h4_valid_packet_type( std::uint8_t indicator )
+        {
+            return indicator >= static_cast< std::uint8_t >( h4_packet_type::command )
+                && indicator <= static_cast< std::uint8_t >( h4_packet_type::iso_data );
+        }
+
+        /*
+         * returns the size of the H4 packet (including the packet indicator) at the start of the
+         * given data or 0, if the packet header is not complete.
+         *
+         * @pre h4_valid_packet_type( data[ 0 ] )
+         */
+        inline std::size_t h4_packet_size( const std::uint8_t* data, std::size_t size )
+        {
+            switch ( static_cast< h4_packet_type >( data[ 0 ] ) )
+            {
+            case h4_packet_type::command:
+            case h4_packet_type::sync_data:
+                return size < 4 ? 0 : 4u + data[ 3 ];
+            case h4_packet_type::acl_data:
+                return size < 5 ? 0 : 5u + ( data[ 3 ] | ( data[ 4 ] << 8 ) );
+            case h4_packet_type::event:
+                return size < 3 ? 0 : 3u + data[ 2 ];
+            case h4_packet_type::iso_data:
+                return size < 5 ? 0 : 5u + ( data[ 3 ] | ( ( data[ 4 ] & 0x3f ) << 8 ) );
+            }
+
+            return 0;
+        }
+    }
+
+    /**
+     * @brief HCI transport for the UART transport layer (H4) over a file descriptor
+     *
+     * The file descriptor can be a tty connected to an external controller (see open()) or any
+     * other stream, like one end of a socketpair (see attach()).
+     *
+     * All packets of a batch are written with a single call to write(). If the stream takes only a part
+     * of the batch, a partially written packet is completed, so that the stream stays in sync.
+     *
+     * @sa link_layer
+     */
+    template < typename LinkLayer >
+    class h4_transport
+    {
+    public:
+        h4_transport();
+        ~h4_transport();
+
+        h4_transport( const h4_transport& ) = delete;
+        h4_transport& operator=( const h4_transport& ) = delete;
+
+        /**
+         * @brief opens the given tty and configures it for raw data with hardware flow control
+         *
+         * Returns false, if the device could not be opened or configured.
+         */
+        bool open( const char* device, speed_t baudrate = B115200 );
+
+        /**
+         * @brief uses the given stream file descriptor as transport
+         *
+         * The transport takes the ownership of the file descriptor.
+         */
+        void attach( int fd );
+
+        /**
+         * @brief maximum time in ms, receive_packet() waits for a packet. Defaults to 100ms.
+         */
+        void receive_timeout( int timeout_ms );
+
+        /** @cond HIDDEN_SYMBOLS */
+        // count H4 packets, stored back to back in buffer; returns the number of packets written
+        std::size_t transmit_packets( const std::uint8_t* buffer, const std::size_t* sizes, std::size_t count );
+
+        // returns the size of a single, complete H4 packet or 0 if there is no packet within the receive timeout
+        std::size_t receive_packet( std::uint8_t* buffer, std::size_t buffer_size );
+        /** @endcond */
+
+    private:
+        static constexpr std::size_t stream_buffer_size = 2048;
+
+        void close_fd();
+        void consume( std::size_t size );
+        bool wait_writable() const;
+
+        int             fd_;
+        int             timeout_ms_;
+        std::uint8_t    stream_[ stream_buffer_size ];
+        std::size_t     stream_size_;
+        std::size_t     discard_;
+    };
+
+    // implementation
+    /** @cond HIDDEN_SYMBOLS */
+    template < typename LinkLayer >
+    h4_transport< LinkLayer >::h4_transport()
+        : fd_( -1 )
+        , timeout_ms_( 100 )
+        , stream_size_( 0 )
+        , discard_( 0 )
+    {
+    }
+
+    template < typename LinkLayer >
+    h4_transport< LinkLayer >::~h4_transport()
+    {
+        close_fd();
+    }
+
+    template < typename LinkLayer >
+    bool h4_transport< LinkLayer >::open( const char* device, speed_t baudrate )
+    {
+        const int fd = ::open( device, O_RDWR | O_NOCTTY | O_CLOEXEC );
+
+        if ( fd < 0 )
+            return false;
+
+        termios tio;
+
+        if ( tcgetattr( fd, &tio ) != 0 )
+        {
+            ::close( fd );
+            return false;
+        }
+
+        cfmakeraw( &tio );
+        tio.c_cflag |= CLOCAL | CREAD | CRTSCTS;
+        tio.c_cc[ VMIN ]  = 0;
+        tio.c_cc[ VTIME ] = 0;
+
+        if ( cfsetispeed( &tio, baudrate ) != 0 || cfsetospeed( &tio, baudrate ) != 0 || tcsetattr( fd, TCSANOW, &tio ) != 0 )
+        {
+            ::close( fd );
+            return false;
+        }
+
+        tcflush( fd, TCIOFLUSH );
+        attach( fd );
+
+        return true;
+    }
+
+    template < typename LinkLayer >
+    void h4_transport< LinkLayer >::attach( int fd )
+    {
+        close_fd();
+
+        fd_          = fd;
+        stream_size_ = 0;
+        discard_     = 0;
+    }
+
+    template < typename LinkLayer >
+    void h4_transport< LinkLayer >::receive_timeout( int timeout_ms )
+    {
+        timeout_ms_ = timeout_ms;
+    }
+
+    template < typename LinkLayer >
+    std::size_t h4_transport< LinkLayer >::transmit_packets( const std::uint8_t* buffer, const std::size_t* sizes, std::size_t count )
+    {
+        std::size_t size = 0;
+
+        for ( std::size_t packet = 0; packet != count; ++packet )
+            size += sizes[ packet ];
+
+        std::size_t packets    = 0;
+        std::size_t written    = 0;
+        std::size_t packet_end = count == 0 ? 0 : sizes[ 0 ];
+
+        while ( written != size )
+        {
+            const ssize_t result = ::write( fd_, buffer + written, size - written );
+
+            if ( result <= 0 )
+            {
+                // a packet, that was written in parts, has to be completed
+                if ( written == packet_end - sizes[ packets ] || !wait_writable() )
+                    break;
+
+                continue;
+            }
+
+            written += static_cast< std::size_t >( result );
+
+            for ( ; packets != count && written >= packet_end; ++packets )
+                packet_end += packets + 1 == count ? 0 : sizes[ packets + 1 ];
+        }
+
+        return packets;
+    }
+
+    template < typename LinkLayer >
+    std::size_t h4_transport< LinkLayer >::receive_packet( std::uint8_t* buffer, std::size_t buffer_size )
+    {
+        for ( ;; )
+        {
+            for ( bool parse = true; parse; )
+            {
+                parse = false;
+
+                // drop the remainder of a packet, that is too large to be received
+                const std::size_t dropped = std::min( discard_, stream_size_ );
+                consume( dropped );
+                discard_ -= dropped;
+
+                if ( discard_ != 0 || stream_size_ == 0 )
+                    break;
+
+                // resynchronize by dropping a single byte
+                if ( !details::h4_valid_packet_type( stream_[ 0 ] ) )
+                {
+                    consume( 1 );
+                    parse = true;
+
+                    continue;
+                }
+
+                const std::size_t packet_size = details::h4_packet_size( stream_, stream_size_ );
+
+                if ( packet_size > buffer_size || packet_size > stream_buffer_size )
+                {
+                    discard_ = packet_size;
+                    parse    = true;
+                }
+                else if ( packet_size != 0 && packet_size <= stream_size_ )
+                {
+                    std::memcpy( buffer, stream_, packet_size );
+                    consume( packet_size );
+
+                    return packet_size;
+                }
+            }
+
+            if ( fd_ < 0 )
+                return 0;
+
+            pollfd fds = { fd_, POLLIN, 0 };
+
+            if ( ::poll( &fds, 1, timeout_ms_ ) <= 0 )
+                return 0;
+
+            const ssize_t received = ::read( fd_, &stream_[ stream_size_ ], stream_buffer_size - stream_size_ );
+
+            if ( received <= 0 )
+                return 0;
+
+            stream_size_ += static_cast< std::size_t >( received );
+        }
+    }
+
+    template < typename LinkLayer >
+    void h4_transport< LinkLayer >::close_fd()
+    {
+        if ( fd_ >= 0 )
+            ::close( fd_ );
+
+        fd_ = -1;
+    }
+
+    template < typename LinkLayer >
+    bool h4_transport< LinkLayer >::wait_writable() const
+    {
+        pollfd fds = { fd_, POLLOUT, 0 };
+
+        return ::poll( &fds, 1, timeout_ms_ ) > 0;
+    }
+
+    template < typename LinkLayer >
+    void h4_transport< LinkLayer >::consume( std::size_t size )
+    {
+        std::memmove( stream_, &stream_[ size ], stream_size_ - size );
+        stream_size_ -= size;
+    }
+    /** @endcond */
+}
+}
+
+#endif // include guard
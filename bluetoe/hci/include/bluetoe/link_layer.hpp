@@ -2,12 +2,135 @@
 #define BLUETOE_HCI_LINK_LAYER_HPP
 
 #include <bluetoe/address.hpp>
+#include <bluetoe/bits.hpp>
+#include <bluetoe/codes.hpp>
+#include <bluetoe/l2cap.hpp>
+#include <bluetoe/l2cap_channels.hpp>
+#include <bluetoe/link_state.hpp>
+#include <bluetoe/h4_transport.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <algorithm>
 
 namespace bluetoe {
 namespace hci {
 
+    template <
+        class Server,
+        template < typename >
+        class Transport,
+        typename ... Options
+    >
+    class link_layer;
+
+    namespace details {
+        // the HCI link layer does not support pairing
+        struct no_pairing_channel
+        {
+            template < class PreviousData >
+            using channel_data_t = PreviousData;
+
+            template < class Connection >
+            void l2cap_input( const std::uint8_t*, std::size_t, std::uint8_t* output, std::size_t& out_size, Connection& )
+            {
+                static constexpr std::uint8_t pairing_failed        = 0x05;
+                static constexpr std::uint8_t pairing_not_supported = 0x05;
+
+                if ( out_size < 2 )
+                {
+                    out_size = 0;
+                    return;
+                }
+
+                output[ 0 ] = pairing_failed;
+                output[ 1 ] = pairing_not_supported;
+                out_size    = 2;
+            }
+
+            template < class Connection >
+            void l2cap_output( std::uint8_t*, std::size_t& out_size, Connection& )
+            {
+                out_size = 0;
+            }
+
+            static constexpr std::uint16_t channel_id               = bluetoe::l2cap_channel_ids::sm;
+            static constexpr std::size_t   minimum_channel_mtu_size = 0;
+            static constexpr std::size_t   maximum_channel_mtu_size = 0;
+        };
+
+        template < class Server, template < typename > class Transport, typename ... Options >
+        using l2cap_layer = bluetoe::details::l2cap<
+            link_layer< Server, Transport, Options... >,
+            bluetoe::details::link_state,
+            Server,
+            no_pairing_channel
+        >;
+
+        // HCI command opcodes
+        namespace opcodes {
+            enum : std::uint16_t {
+                disconnect                          = 0x0406,
+                set_event_mask                      = 0x0C01,
+                reset                               = 0x0C03,
+                set_controller_to_host_flow_control = 0x0C31,
+                host_buffer_size                    = 0x0C33,
+                host_number_of_completed_packets    = 0x0C35,
+                read_buffer_size                    = 0x1005,
+                read_bd_addr                        = 0x1009,
+                le_read_buffer_size                 = 0x2002,
+                le_set_advertising_parameters       = 0x2006,
+                le_set_advertising_data             = 0x2008,
+                le_set_scan_response_data           = 0x2009,
+                le_set_advertising_enable           = 0x200A
+            };
+        }
+
+        // HCI event codes
+        namespace events {
+            enum : std::uint8_t {
+                disconnection_complete          = 0x05,
+                command_complete                = 0x0E,
+                command_status                  = 0x0F,
+                number_of_completed_packets     = 0x13,
+                le_meta                         = 0x3E
+            };
+        }
+
+        namespace le_subevents {
+            enum : std::uint8_t {
+                connection_complete             = 0x01,
+                enhanced_connection_complete    = 0x0A
+            };
+        }
+    }
+
     /**
      * @brief link layer implementation based on HCI
+     *
+     * Runs a GATT server on top of an external controller, that is connected via a HCI
+     * transport. The Transport is a class template, that is instanciated with the link layer as
+     * argument and from which the link layer derives, so that the transport can be configured
+     * through the link layer object. Transports provided by bluetoe:
+     * - user_channel_transport: the Linux HCI user channel of a controller known to the kernel
+     * - h4_transport: the UART transport layer over a tty or any other stream file descriptor
+     *
+     * The link layer configures the controller for connectable, undirected advertising with
+     * the servers advertising data and accepts a single connection at a time. Outgoing L2CAP
+     * SDUs are fragmented into ACL data packets of the size reported by the controller and
+     * send in batches, as far as the controller has free buffers according to the
+     * Number Of Completed Packets events.
+     *
+     * Incoming ACL data is flow controlled by the host: the controller is told, that the host
+     * can hold only a few ACL data packets (Host Buffer Size) and every consumed packet is reported
+     * back with Host Number Of Completed Packets. So no data has to be dropped, while the server can
+     * not handle further requests.
+     *
+     * Pairing is not supported; a pairing request is answered with "Pairing Not Supported".
+     *
+     * @sa h4_transport
+     * @sa user_channel_transport
      */
     template <
         class Server,
@@ -15,21 +138,26 @@ namespace hci {
         class Transport,
         typename ... Options
     >
-    class link_layer : Transport< link_layer< Server, Transport, Options... > >
+    class link_layer :
+        public Transport< link_layer< Server, Transport, Options... > >,
+        public details::l2cap_layer< Server, Transport, Options... >
     {
     public:
+        link_layer();
+
         /**
          * @brief this function passes the CPU to the link layer implementation
          *
-         * This function should return on certain events to alow user code to do
-         * usefull things. Details depend on the ScheduleRadio implemention.
+         * The function handles all HCI packets, that are received from the controller, until the
+         * transport does not deliver a packet within its receive timeout.
          */
-        void run( Server& );
+        void run();
 
         /**
          * @brief initiating the change of communication parameters of an established connection
          *
-         * If it was not possible to initiate the connection parameter update, the function returns false.
+         * The request is send to the central using the L2CAP signaling channel. If it was not possible
+         * to initiate the connection parameter update, the function returns false.
          * @todo Add parameter that identifies the connection.
          */
         bool connection_parameter_update_request( std::uint16_t interval_min, std::uint16_t interval_max, std::uint16_t latency, std::uint16_t timeout );
@@ -48,16 +176,690 @@ namespace hci {
 
         /**
          * @brief returns the own local device address
+         *
+         * This is the public address of the controller, that is read during the initialization of the controller.
          */
         const bluetoe::link_layer::device_address& local_address() const;
+
+        /**
+         * @brief returns true, if the link layer is connected to a central
+         */
+        bool connected() const;
+
+        /** @cond HIDDEN_SYMBOLS */
+        using l2cap_t           = details::l2cap_layer< Server, Transport, Options... >;
+        using connection_data_t = typename l2cap_t::connection_data_t;
+
+        std::pair< std::size_t, std::uint8_t* > allocate_l2cap_output_buffer( std::size_t size );
+        void commit_l2cap_output_buffer( std::pair< std::size_t, std::uint8_t* > buffer );
+
+        static bool queue_lcap_notification( const ::bluetoe::details::notification_data& item, void* usr_arg, ::bluetoe::details::notification_type type );
+        /** @endcond */
+
     private:
+        static constexpr std::size_t    sdu_size                    = l2cap_t::maximum_mtu_size + bluetoe::details::l2cap_layer_header_size;
+        static constexpr std::size_t    tx_queue_size               = 4;
+        static constexpr std::size_t    max_acl_payload_size        = 251;
+        static constexpr std::size_t    acl_header_size             = 5;
+        static constexpr std::size_t    max_batch_size              = 8;
+        static constexpr std::size_t    max_packet_size             = acl_header_size + 1021;
+        static constexpr std::size_t    rx_packet_slots             = 3;
+        static constexpr std::size_t    rx_held_slots               = rx_packet_slots - 1;
+        static constexpr std::size_t    advertising_data_size       = 31;
+        static constexpr std::uint16_t  advertising_interval        = 160; // 100ms in 0.625ms units
+        static constexpr std::uint8_t   remote_user_terminated      = 0x13;
+        static constexpr std::uint8_t   connection_parameter_update = 0x12;
+        static constexpr std::uint16_t  handle_mask                 = 0x0fff;
+        static constexpr std::uint16_t  packet_boundary_mask        = 0x3000;
+        static constexpr std::uint16_t  continuing_fragment         = 0x1000;
+        static constexpr std::uint16_t  no_setup_command            = 0x0000;
+
+        enum class state {
+            initial,
+            setup,
+            advertising,
+            connected
+        };
+
+        enum pending_command : unsigned {
+            pending_disconnect          = 0x01,
+            pending_advertising_enable  = 0x02
+        };
+
+        bool send_command( std::uint16_t opcode, const std::uint8_t* parameters, std::uint8_t size );
+        bool transmit_command( std::uint16_t opcode, const std::uint8_t* parameters, std::uint8_t size );
+        bool send_setup_command();
+        bool send_setup_command( std::uint16_t opcode, const std::uint8_t* parameters, std::uint8_t size );
+        void send_pending_commands();
+        void send_completed_packets();
+        void transmit_acl_fragments();
+        bool handle_packet( const std::uint8_t* packet, std::size_t size );
+        void handle_event( const std::uint8_t* event, std::size_t size );
+        void handle_command_complete( std::uint16_t opcode, const std::uint8_t* parameters, std::size_t size );
+        void handle_le_meta_event( const std::uint8_t* event, std::size_t size );
+        bool handle_acl_data( const std::uint8_t* packet, std::size_t size );
+        void handle_received_sdu();
+        void connection_closed();
+
+        state                           state_;
+        std::size_t                     setup_step_;
+        std::uint16_t                   setup_opcode_;
+        unsigned                        command_credits_;
+        unsigned                        pending_commands_;
+
+        bluetoe::link_layer::device_address address_;
+        std::uint16_t                   connection_handle_;
+        connection_data_t               connection_data_;
+        std::uint8_t                    signaling_identifier_;
+
+        // controller buffers
+        std::size_t                     acl_size_;
+        unsigned                        acl_credits_;
+        unsigned                        acl_in_flight_;
+
+        // received L2CAP SDU
+        std::uint8_t                    rx_sdu_[ sdu_size ];
+        std::size_t                     rx_sdu_size_;
+        bool                            rx_sdu_pending_;
+
+        // consumed ACL data packets, that are not reported to the controller yet
+        unsigned                        rx_completed_packets_;
+
+        // queue of outgoing L2CAP SDUs
+        std::uint8_t                    tx_queue_[ tx_queue_size ][ sdu_size ];
+        std::size_t                     tx_sizes_[ tx_queue_size ];
+        std::size_t                     tx_first_;
+        std::size_t                     tx_count_;
+        std::size_t                     tx_sent_;
+
+        // Packets are received into the next free slot. ACL data, that can not be handled, because the previous
+        // SDU is still pending, is held in its slot. One slot is always kept free, so that events keep flowing
+        // while ACL data is held; otherwise, Number Of Completed Packets events, that are required to get
+        // the pending SDU handled, would never be received. The number of ACL data packets, that can be held,
+        // is announced to the controller with Host Buffer Size, so the controller never sends more.
+        std::uint8_t                    rx_packets_[ rx_packet_slots ][ max_packet_size ];
+        std::size_t                     rx_packet_sizes_[ rx_packet_slots ];
+        std::size_t                     rx_held_first_;
+        std::size_t                     rx_held_count_;
+        std::uint8_t                    batch_[ max_batch_size * ( acl_header_size + max_acl_payload_size ) ];
     };
 
     // implementation
+    /** @cond HIDDEN_SYMBOLS */
+    template < class Server, template < typename > class Transport, typename ... Options >
+    link_layer< Server, Transport, Options... >::link_layer()
+        : state_( state::initial )
+        , setup_step_( 0 )
+        , setup_opcode_( no_setup_command )
+        , command_credits_( 1 )
+        , pending_commands_( 0 )
+        , connection_handle_( 0 )
+        , signaling_identifier_( 0 )
+        , acl_size_( 0 )
+        , acl_credits_( 0 )
+        , acl_in_flight_( 0 )
+        , rx_sdu_size_( 0 )
+        , rx_sdu_pending_( false )
+        , rx_completed_packets_( 0 )
+        , tx_first_( 0 )
+        , tx_count_( 0 )
+        , tx_sent_( 0 )
+        , rx_held_first_( 0 )
+        , rx_held_count_( 0 )
+    {
+        this->notification_callback( queue_lcap_notification, this );
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    void link_layer< Server, Transport, Options... >::run()
+    {
+        if ( state_ == state::initial )
+            state_ = state::setup;
+
+        for ( bool received = true; received; )
+        {
+            // the next setup command is sent as soon as the controller accepts commands
+            if ( state_ == state::setup && setup_opcode_ == no_setup_command )
+                send_setup_command();
+
+            if ( rx_sdu_pending_ )
+                handle_received_sdu();
+
+            for ( ; rx_held_count_ && handle_acl_data( rx_packets_[ rx_held_first_ ] + 1, rx_packet_sizes_[ rx_held_first_ ] - 1 ); --rx_held_count_ )
+                rx_held_first_ = ( rx_held_first_ + 1 ) % rx_packet_slots;
+
+            if ( state_ == state::connected )
+                this->transmit_pending_l2cap_output( connection_data_ );
+
+            send_completed_packets();
+            send_pending_commands();
+            transmit_acl_fragments();
+
+            const std::size_t   slot   = ( rx_held_first_ + rx_held_count_ ) % rx_packet_slots;
+            std::uint8_t* const packet = rx_packets_[ slot ];
+            const std::size_t   size   = this->receive_packet( packet, max_packet_size );
+            received = size != 0;
+
+            if ( received && !handle_packet( packet, size ) )
+            {
+                // the host flow control limits the ACL data, that is not consumed, to the held slots
+                assert( rx_held_count_ != rx_held_slots );
+
+                rx_packet_sizes_[ slot ] = size;
+                ++rx_held_count_;
+            }
+        }
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    bool link_layer< Server, Transport, Options... >::connection_parameter_update_request( std::uint16_t interval_min, std::uint16_t interval_max, std::uint16_t latency, std::uint16_t timeout )
+    {
+        static constexpr std::size_t command_size = 12;
+
+        if ( state_ != state::connected )
+            return false;
+
+        auto buffer = allocate_l2cap_output_buffer( bluetoe::details::l2cap_layer_header_size + command_size );
+
+        if ( buffer.first == 0 )
+            return false;
+
+        std::uint8_t* out = buffer.second;
+        out = bluetoe::details::write_16bit( out, command_size );
+        out = bluetoe::details::write_16bit( out, bluetoe::l2cap_channel_ids::signaling );
+        *out++ = connection_parameter_update;
+        *out++ = ++signaling_identifier_ == 0 ? ++signaling_identifier_ : signaling_identifier_;
+        out = bluetoe::details::write_16bit( out, command_size - 4 );
+        out = bluetoe::details::write_16bit( out, interval_min );
+        out = bluetoe::details::write_16bit( out, interval_max );
+        out = bluetoe::details::write_16bit( out, latency );
+        bluetoe::details::write_16bit( out, timeout );
+
+        commit_l2cap_output_buffer( { bluetoe::details::l2cap_layer_header_size + command_size, buffer.second } );
+
+        return true;
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    void link_layer< Server, Transport, Options... >::disconnect()
+    {
+        if ( state_ == state::connected )
+            pending_commands_ |= pending_disconnect;
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    std::size_t link_layer< Server, Transport, Options... >::fill_l2cap_advertising_data( std::uint8_t* buffer, std::size_t buffer_size ) const
+    {
+        return this->advertising_data( buffer, buffer_size );
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    const bluetoe::link_layer::device_address& link_layer< Server, Transport, Options... >::local_address() const
+    {
+        return address_;
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    bool link_layer< Server, Transport, Options... >::connected() const
+    {
+        return state_ == state::connected;
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    std::pair< std::size_t, std::uint8_t* > link_layer< Server, Transport, Options... >::allocate_l2cap_output_buffer( std::size_t size )
+    {
+        if ( tx_count_ == tx_queue_size || size > sdu_size )
+            return { 0, nullptr };
+
+        return { sdu_size, tx_queue_[ ( tx_first_ + tx_count_ ) % tx_queue_size ] };
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    void link_layer< Server, Transport, Options... >::commit_l2cap_output_buffer( std::pair< std::size_t, std::uint8_t* > buffer )
+    {
+        const std::size_t index = ( tx_first_ + tx_count_ ) % tx_queue_size;
+        assert( buffer.second == tx_queue_[ index ] );
+
+        tx_sizes_[ index ] = buffer.first;
+        ++tx_count_;
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    bool link_layer< Server, Transport, Options... >::queue_lcap_notification( const ::bluetoe::details::notification_data& item, void* that, ::bluetoe::details::notification_type type )
+    {
+        auto& connection = static_cast< link_layer< Server, Transport, Options... >* >( that )->connection_data_;
+
+        switch ( type )
+        {
+            case bluetoe::details::notification_type::notification:
+                return connection.queue_notification( item.client_characteristic_configuration_index() );
+            case bluetoe::details::notification_type::indication:
+                return connection.queue_indication( item.client_characteristic_configuration_index() );
+            case bluetoe::details::notification_type::confirmation:
+                connection.indication_confirmed();
+                return true;
+        }
+
+        return true;
+    }
+
     template < class Server, template < typename > class Transport, typename ... Options >
-    void link_layer< Server, Transport, Options... >::run( Server& )
+    bool link_layer< Server, Transport, Options... >::send_command( std::uint16_t opcode, const std::uint8_t* parameters, std::uint8_t size )
     {
+        if ( command_credits_ == 0 || !transmit_command( opcode, parameters, size ) )
+            return false;
+
+        --command_credits_;
+
+        return true;
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    bool link_layer< Server, Transport, Options... >::transmit_command( std::uint16_t opcode, const std::uint8_t* parameters, std::uint8_t size )
+    {
+        std::uint8_t* const command = &batch_[ 0 ];
+        command[ 0 ] = static_cast< std::uint8_t >( details::h4_packet_type::command );
+        bluetoe::details::write_16bit( &command[ 1 ], opcode );
+        command[ 3 ] = size;
+        if ( size )
+            std::copy( parameters, parameters + size, &command[ 4 ] );
+
+        const std::size_t packet_size = 4u + size;
+
+        return this->transmit_packets( command, &packet_size, 1 ) == 1;
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    bool link_layer< Server, Transport, Options... >::send_setup_command()
+    {
+        std::uint8_t parameters[ 1 + advertising_data_size ] = { 0 };
+
+        switch ( setup_step_ )
+        {
+        case 0:
+            return send_setup_command( details::opcodes::reset, parameters, 0 );
+        case 1:
+            {
+                // Disconnection Complete, Hardware Error and LE Meta events
+                static const std::uint8_t event_mask[] = { 0x10, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20 };
+
+                return send_setup_command( details::opcodes::set_event_mask, event_mask, sizeof( event_mask ) );
+            }
+        case 2:
+            return send_setup_command( details::opcodes::le_read_buffer_size, parameters, 0 );
+        case 3:
+            return send_setup_command( details::opcodes::read_bd_addr, parameters, 0 );
+        case 4:
+            {
+                // ACL data packets of the maximum size, that can be held, no synchronous data
+                std::uint8_t* out = parameters;
+                out = bluetoe::details::write_16bit( out, max_packet_size - acl_header_size );
+                *out++ = 0;
+                out = bluetoe::details::write_16bit( out, rx_held_slots );
+                bluetoe::details::write_16bit( out, 0 );
+
+                return send_setup_command( details::opcodes::host_buffer_size, parameters, 7 );
+            }
+        case 5:
+            // flow control for ACL data
+            parameters[ 0 ] = 0x01;
+
+            return send_setup_command( details::opcodes::set_controller_to_host_flow_control, parameters, 1 );
+        case 6:
+            {
+                // connectable undirected advertising with the public address on all channels
+                std::uint8_t* out = parameters;
+                out = bluetoe::details::write_16bit( out, advertising_interval );
+                out = bluetoe::details::write_16bit( out, advertising_interval );
+                std::fill( out, &parameters[ 15 ], 0 );
+                parameters[ 13 ] = 0x07;
+
+                return send_setup_command( details::opcodes::le_set_advertising_parameters, parameters, 15 );
+            }
+        case 7:
+            parameters[ 0 ] = static_cast< std::uint8_t >( this->advertising_data( &parameters[ 1 ], advertising_data_size ) );
+
+            return send_setup_command( details::opcodes::le_set_advertising_data, parameters, sizeof( parameters ) );
+        case 8:
+            parameters[ 0 ] = static_cast< std::uint8_t >( this->scan_response_data( &parameters[ 1 ], advertising_data_size ) );
+
+            return send_setup_command( details::opcodes::le_set_scan_response_data, parameters, sizeof( parameters ) );
+        case 9:
+            parameters[ 0 ] = 1;
+
+            return send_setup_command( details::opcodes::le_set_advertising_enable, parameters, 1 );
+        }
+
+        return false;
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    bool link_layer< Server, Transport, Options... >::send_setup_command( std::uint16_t opcode, const std::uint8_t* parameters, std::uint8_t size )
+    {
+        if ( !send_command( opcode, parameters, size ) )
+            return false;
+
+        setup_opcode_ = opcode;
+
+        return true;
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    void link_layer< Server, Transport, Options... >::send_pending_commands()
+    {
+        if ( ( pending_commands_ & pending_disconnect ) && state_ == state::connected )
+        {
+            std::uint8_t parameters[ 3 ];
+            bluetoe::details::write_16bit( parameters, connection_handle_ );
+            parameters[ 2 ] = remote_user_terminated;
+
+            if ( send_command( details::opcodes::disconnect, parameters, sizeof( parameters ) ) )
+                pending_commands_ &= ~pending_disconnect;
+        }
+
+        if ( pending_commands_ & pending_advertising_enable )
+        {
+            const std::uint8_t enable = 1;
+
+            if ( send_command( details::opcodes::le_set_advertising_enable, &enable, 1 ) )
+                pending_commands_ &= ~pending_advertising_enable;
+        }
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    void link_layer< Server, Transport, Options... >::send_completed_packets()
+    {
+        if ( state_ != state::connected || rx_completed_packets_ == 0 )
+            return;
+
+        // Host Number Of Completed Packets can be sent regardless of the command credits
+        std::uint8_t parameters[ 5 ] = { 1 };
+        bluetoe::details::write_16bit( &parameters[ 1 ], connection_handle_ );
+        bluetoe::details::write_16bit( &parameters[ 3 ], static_cast< std::uint16_t >( rx_completed_packets_ ) );
+
+        if ( transmit_command( details::opcodes::host_number_of_completed_packets, parameters, sizeof( parameters ) ) )
+            rx_completed_packets_ = 0;
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    void link_layer< Server, Transport, Options... >::transmit_acl_fragments()
+    {
+        if ( state_ != state::connected )
+            return;
+
+        std::size_t   sizes[ max_batch_size ];
+        std::size_t   count = 0;
+        std::uint8_t* out   = &batch_[ 0 ];
+
+        std::size_t   first  = tx_first_;
+        std::size_t   queued = tx_count_;
+        std::size_t   sent   = tx_sent_;
+
+        for ( ; queued != 0 && count != acl_credits_ && count != max_batch_size; ++count )
+        {
+            const std::uint8_t* const sdu  = tx_queue_[ first ];
+            const std::size_t         size = std::min( acl_size_, tx_sizes_[ first ] - sent );
+
+            *out++ = static_cast< std::uint8_t >( details::h4_packet_type::acl_data );
+            out = bluetoe::details::write_16bit( out, connection_handle_ | ( sent == 0 ? 0 : continuing_fragment ) );
+            out = bluetoe::details::write_16bit( out, static_cast< std::uint16_t >( size ) );
+            out = std::copy( sdu + sent, sdu + sent + size, out );
+
+            sizes[ count ] = acl_header_size + size;
+            sent += size;
+
+            if ( sent == tx_sizes_[ first ] )
+            {
+                first = ( first + 1 ) % tx_queue_size;
+                --queued;
+                sent = 0;
+            }
+        }
+
+        if ( count == 0 )
+            return;
+
+        // the queue and the controller buffers are only consumed by the fragments, that the transport took
+        const std::size_t transmitted = this->transmit_packets( &batch_[ 0 ], sizes, count );
+
+        for ( std::size_t fragment = 0; fragment != transmitted; ++fragment )
+        {
+            tx_sent_ += sizes[ fragment ] - acl_header_size;
+
+            if ( tx_sent_ == tx_sizes_[ tx_first_ ] )
+            {
+                tx_first_ = ( tx_first_ + 1 ) % tx_queue_size;
+                --tx_count_;
+                tx_sent_ = 0;
+            }
+        }
+
+        acl_credits_   -= static_cast< unsigned >( transmitted );
+        acl_in_flight_ += static_cast< unsigned >( transmitted );
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    bool link_layer< Server, Transport, Options... >::handle_packet( const std::uint8_t* packet, std::size_t size )
+    {
+        switch ( static_cast< details::h4_packet_type >( packet[ 0 ] ) )
+        {
+        case details::h4_packet_type::event:
+            handle_event( packet + 1, size - 1 );
+            break;
+        case details::h4_packet_type::acl_data:
+            // ACL data must not overtake held ACL data
+            return rx_held_count_ == 0 && handle_acl_data( packet + 1, size - 1 );
+        default:
+            break;
+        }
+
+        return true;
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    void link_layer< Server, Transport, Options... >::handle_event( const std::uint8_t* event, std::size_t size )
+    {
+        if ( size < 2 || size != 2u + event[ 1 ] )
+            return;
+
+        const std::uint8_t* const parameters = event + 2;
+        const std::size_t         length     = event[ 1 ];
+
+        switch ( event[ 0 ] )
+        {
+        case details::events::command_complete:
+            if ( length >= 3 )
+            {
+                command_credits_ = parameters[ 0 ];
+                handle_command_complete( bluetoe::details::read_16bit( parameters + 1 ), parameters + 3, length - 3 );
+            }
+            break;
+        case details::events::command_status:
+            if ( length >= 4 )
+                command_credits_ = parameters[ 1 ];
+            break;
+        case details::events::disconnection_complete:
+            if ( length >= 3 && parameters[ 0 ] == 0 && state_ == state::connected
+              && ( bluetoe::details::read_16bit( parameters + 1 ) & handle_mask ) == connection_handle_ )
+            {
+                connection_closed();
+            }
+            break;
+        case details::events::number_of_completed_packets:
+            if ( length >= 1 && length >= 1u + parameters[ 0 ] * 4u )
+            {
+                const std::uint8_t* const end = parameters + 1 + parameters[ 0 ] * 4u;
+
+                // every connection handle is directly followed by its number of completed packets
+                for ( const std::uint8_t* entry = parameters + 1; entry != end; entry += 4 )
+                {
+                    const std::uint16_t handle    = bluetoe::details::read_16bit( entry ) & handle_mask;
+                    const unsigned      completed = std::min< unsigned >( bluetoe::details::read_16bit( entry + 2 ), acl_in_flight_ );
+
+                    if ( state_ == state::connected && handle == connection_handle_ )
+                    {
+                        acl_credits_   += completed;
+                        acl_in_flight_ -= completed;
+                    }
+                }
+            }
+            break;
+        case details::events::le_meta:
+            handle_le_meta_event( parameters, length );
+            break;
+        }
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    void link_layer< Server, Transport, Options... >::handle_command_complete( std::uint16_t opcode, const std::uint8_t* parameters, std::size_t size )
+    {
+        // Command Complete events of other commands (for example a NOP Command Complete after power up) do not advance the setup
+        if ( state_ != state::setup || setup_opcode_ == no_setup_command || opcode != setup_opcode_ )
+            return;
+
+        setup_opcode_ = no_setup_command;
+
+        const bool success = size >= 1 && parameters[ 0 ] == 0;
+
+        switch ( opcode )
+        {
+        case details::opcodes::le_read_buffer_size:
+            if ( success && size >= 4 )
+            {
+                acl_size_    = std::min< std::size_t >( bluetoe::details::read_16bit( parameters + 1 ), max_acl_payload_size );
+                acl_credits_ = parameters[ 3 ];
+            }
+
+            // the controller shares the buffers between BR/EDR and LE
+            if ( acl_size_ == 0 || acl_credits_ == 0 )
+            {
+                send_setup_command( details::opcodes::read_buffer_size, nullptr, 0 );
+                return;
+            }
+            break;
+        case details::opcodes::read_buffer_size:
+            if ( success && size >= 8 )
+            {
+                acl_size_    = std::min< std::size_t >( bluetoe::details::read_16bit( parameters + 1 ), max_acl_payload_size );
+                acl_credits_ = bluetoe::details::read_16bit( parameters + 4 );
+            }
+            break;
+        case details::opcodes::read_bd_addr:
+            if ( success && size >= 7 )
+                address_ = bluetoe::link_layer::public_device_address( parameters + 1 );
+            break;
+        }
+
+        if ( opcode == details::opcodes::le_set_advertising_enable )
+        {
+            state_ = state::advertising;
+        }
+        else
+        {
+            ++setup_step_;
+            send_setup_command();
+        }
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    void link_layer< Server, Transport, Options... >::handle_le_meta_event( const std::uint8_t* event, std::size_t size )
+    {
+        if ( size < 4 )
+            return;
+
+        const std::uint8_t subevent = event[ 0 ];
+        const std::uint8_t status   = event[ 1 ];
+
+        if ( ( subevent != details::le_subevents::connection_complete && subevent != details::le_subevents::enhanced_connection_complete )
+          || status != 0 || state_ != state::advertising )
+            return;
+
+        connection_handle_    = bluetoe::details::read_16bit( event + 2 ) & handle_mask;
+        connection_data_      = connection_data_t();
+        rx_sdu_size_          = 0;
+        rx_sdu_pending_       = false;
+        rx_completed_packets_ = 0;
+        state_                = state::connected;
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    bool link_layer< Server, Transport, Options... >::handle_acl_data( const std::uint8_t* packet, std::size_t size )
+    {
+        if ( state_ != state::connected || size < 4 )
+            return true;
+
+        const std::uint16_t handle_and_flags = bluetoe::details::read_16bit( packet );
+
+        if ( ( handle_and_flags & handle_mask ) != connection_handle_ )
+            return true;
+
+        // data, received while the previous SDU could not be handled, has to wait
+        if ( rx_sdu_pending_ )
+            return false;
+
+        ++rx_completed_packets_;
+
+        if ( size != 4u + bluetoe::details::read_16bit( packet + 2 ) )
+            return true;
+
+        const std::uint8_t* const data      = packet + 4;
+        const std::size_t         data_size = size - 4;
+
+        if ( ( handle_and_flags & packet_boundary_mask ) != continuing_fragment )
+            rx_sdu_size_ = 0;
+
+        if ( rx_sdu_size_ + data_size > sdu_size )
+        {
+            rx_sdu_size_ = 0;
+            return true;
+        }
+
+        std::copy( data, data + data_size, &rx_sdu_[ rx_sdu_size_ ] );
+        rx_sdu_size_ += data_size;
+
+        if ( rx_sdu_size_ >= bluetoe::details::l2cap_layer_header_size
+          && rx_sdu_size_ == bluetoe::details::l2cap_layer_header_size + bluetoe::details::read_16bit( rx_sdu_ ) )
+        {
+            rx_sdu_pending_ = true;
+            handle_received_sdu();
+        }
+
+        return true;
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    void link_layer< Server, Transport, Options... >::handle_received_sdu()
+    {
+        if ( this->handle_l2cap_input( rx_sdu_, rx_sdu_size_, connection_data_ ) )
+        {
+            rx_sdu_pending_ = false;
+            rx_sdu_size_    = 0;
+        }
+    }
+
+    template < class Server, template < typename > class Transport, typename ... Options >
+    void link_layer< Server, Transport, Options... >::connection_closed()
+    {
+        this->client_disconnected( connection_data_ );
+
+        // the controller flushes all packets of the connection
+        acl_credits_   += acl_in_flight_;
+        acl_in_flight_  = 0;
+
+        tx_first_       = 0;
+        tx_count_       = 0;
+        tx_sent_        = 0;
+        rx_sdu_size_    = 0;
+        rx_sdu_pending_ = false;
+        rx_held_count_  = 0;
+
+        // the controller considers all packets of the connection to be completed
+        rx_completed_packets_ = 0;
+
+        pending_commands_ = ( pending_commands_ & ~pending_disconnect ) | pending_advertising_enable;
+        state_            = state::advertising;
     }
+    /** @endcond */
 }
 }
 
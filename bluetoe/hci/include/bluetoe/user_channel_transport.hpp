@@ -0,0 +1,171 @@
+#ifndef BLUETOE_HCI_USER_CHANNEL_TRANSPORT_HPP
+#define BLUETOE_HCI_USER_CHANNEL_TRANSPORT_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace bluetoe {
+namespace hci {
+
+    namespace details {
+        // from the Linux kernel headers include/net/bluetooth/{bluetooth.h, hci_sock.h}, to not depend on BlueZ headers
+        static constexpr int            af_bluetooth        = 31;
+        static constexpr int            btproto_hci         = 1;
+        static constexpr std::uint16_t  hci_channel_user    = 1;
+
+        struct sockaddr_hci
+        {
+            sa_family_t     hci_family;
+            unsigned short  hci_dev;
+            unsigned short  hci_channel;
+        };
+    }
+
+    /**
+     * @brief HCI transport over the Linux HCI user channel
+     *
+     * The user channel gives exclusive access to a controller, that is known to the Linux kernel,
+     * bypassing the kernels Bluetooth host stack. The controller has to be down
+     * (`hciconfig hci0 down` or `btmgmt --index 0 power off`) and the process
+     * requires the CAP_NET_ADMIN capability.
+     *
+     * As every read and write on the user channel transfers exactly one HCI packet, a batch
+     * of packets is written with one write() per packet. The batch ends with the first packet,
+     * that could not be written.
+     *
+     * @sa link_layer
+     */
+    template < typename LinkLayer >
+    class user_channel_transport
+    {
+    public:
+        user_channel_transport();
+        ~user_channel_transport();
+
+        user_channel_transport( const user_channel_transport& ) = delete;
+        user_channel_transport& operator=( const user_channel_transport& ) = delete;
+
+        /**
+         * @brief opens the user channel of the controller with the given index (0 for hci0)
+         *
+         * Returns false, if the channel could not be opened.
+         */
+        bool open( std::uint16_t device );
+
+        /**
+         * @brief maximum time in ms, receive_packet() waits for a packet. Defaults to 100ms.
+         */
+        void receive_timeout( int timeout_ms );
+
+        /** @cond HIDDEN_SYMBOLS */
+        // returns the number of packets written
+        std::size_t transmit_packets( const std::uint8_t* buffer, const std::size_t* sizes, std::size_t count );
+        std::size_t receive_packet( std::uint8_t* buffer, std::size_t buffer_size );
+        /** @endcond */
+
+    private:
+        void close_fd();
+
+        int fd_;
+        int timeout_ms_;
+    };
+
+    // implementation
+    /** @cond HIDDEN_SYMBOLS */
+    template < typename LinkLayer >
+    user_channel_transport< LinkLayer >::user_channel_transport()
+        : fd_( -1 )
+        , timeout_ms_( 100 )
+    {
+    }
+
+    template < typename LinkLayer >
+    user_channel_transport< LinkLayer >::~user_channel_transport()
+    {
+        close_fd();
+    }
+
+    template < typename LinkLayer >
+    bool user_channel_transport< LinkLayer >::open( std::uint16_t device )
+    {
+        close_fd();
+
+        const int fd = ::socket( details::af_bluetooth, SOCK_RAW | SOCK_CLOEXEC, details::btproto_hci );
+
+        if ( fd < 0 )
+            return false;
+
+        details::sockaddr_hci address = {};
+        address.hci_family  = details::af_bluetooth;
+        address.hci_dev     = device;
+        address.hci_channel = details::hci_channel_user;
+
+        if ( ::bind( fd, reinterpret_cast< const sockaddr* >( &address ), sizeof( address ) ) != 0 )
+        {
+            ::close( fd );
+            return false;
+        }
+
+        fd_ = fd;
+
+        return true;
+    }
+
+    template < typename LinkLayer >
+    void user_channel_transport< LinkLayer >::receive_timeout( int timeout_ms )
+    {
+        timeout_ms_ = timeout_ms;
+    }
+
+    template < typename LinkLayer >
+    std::size_t user_channel_transport< LinkLayer >::transmit_packets( const std::uint8_t* buffer, const std::size_t* sizes, std::size_t count )
+    {
+        std::size_t packets = 0;
+
+        for ( ; packets != count; ++packets )
+        {
+            if ( ::write( fd_, buffer, sizes[ packets ] ) != static_cast< ssize_t >( sizes[ packets ] ) )
+                break;
+
+            buffer += sizes[ packets ];
+        }
+
+        return packets;
+    }
+
+    template < typename LinkLayer >
+    std::size_t user_channel_transport< LinkLayer >::receive_packet( std::uint8_t* buffer, std::size_t buffer_size )
+    {
+        if ( fd_ < 0 )
+            return 0;
+
+        pollfd fds = { fd_, POLLIN, 0 };
+
+        if ( ::poll( &fds, 1, timeout_ms_ ) <= 0 )
+            return 0;
+
+        // packets, that are larger than the buffer are truncated by the kernel and thus dropped here
+        const ssize_t received = ::recv( fd_, buffer, buffer_size, MSG_TRUNC );
+
+        return received > 0 && static_cast< std::size_t >( received ) <= buffer_size
+            ? static_cast< std::size_t >( received )
+            : 0;
+    }
+
+    template < typename LinkLayer >
+    void user_channel_transport< LinkLayer >::close_fd()
+    {
+        if ( fd_ >= 0 )
+            ::close( fd_ );
+
+        fd_ = -1;
+    }
+    /** @endcond */
+}
+}
+
+#endif // include guard
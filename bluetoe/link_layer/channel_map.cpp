@@ -1,11 +1,15 @@
 #include <bluetoe/channel_map.hpp>
 #include <cassert>
+#include <algorithm>
 
 namespace bluetoe {
 namespace link_layer {
 
     channel_map::channel_map()
         : hop_( 0 )
+        , used_channels_count_( 0 )
+        , channel_identifier_( 0 )
+        , algorithm_2_( false )
     {
     }
 
@@ -37,7 +41,8 @@ namespace link_layer {
         if ( hop < 5 || hop > 16 )
             return false;
 
-        hop_ = hop;
+        hop_         = hop;
+        algorithm_2_ = false;
 
         std::uint8_t   used_channels[ max_number_of_data_channels ];
         const unsigned used_channels_count = build_used_channel_map( map, used_channels );
@@ -64,15 +69,82 @@ namespace link_layer {
 
     bool channel_map::reset( const std::uint8_t* map )
     {
+        if ( algorithm_2_ )
+        {
+            std::uint8_t   used_channels[ max_number_of_data_channels ];
+            const unsigned used_channels_count = build_used_channel_map( map, used_channels );
+
+            if ( used_channels_count < 2 )
+                return false;
+
+            std::copy( &used_channels[ 0 ], &used_channels[ used_channels_count ], map_ );
+            std::copy( map, map + channel_map_size, used_map_ );
+            used_channels_count_ = used_channels_count;
+
+            return true;
+        }
+
         return reset( map, hop_ );
     }
 
+    bool channel_map::reset_algorithm_2( const std::uint8_t* map, std::uint32_t access_address )
+    {
+        assert( map );
+
+        channel_identifier_ = static_cast< std::uint16_t >( ( access_address >> 16 ) ^ ( access_address & 0xffff ) );
+        algorithm_2_        = true;
+
+        return reset( map );
+    }
+
     unsigned channel_map::data_channel( unsigned index ) const
     {
         assert( index < max_number_of_data_channels );
+        assert( !algorithm_2_ );
         return map_[ index ];
     }
 
+    unsigned channel_map::data_channel( unsigned index, std::uint16_t connection_event_counter ) const
+    {
+        assert( index < max_number_of_data_channels );
+
+        return algorithm_2_
+            ? algorithm_2_channel( connection_event_counter )
+            : map_[ index ];
+    }
+
+    // reverses the bit order in both octets of the input
+    static std::uint16_t permutate( std::uint16_t v )
+    {
+        v = static_cast< std::uint16_t >( ( ( v & 0xaaaa ) >> 1 ) | ( ( v & 0x5555 ) << 1 ) );
+        v = static_cast< std::uint16_t >( ( ( v & 0xcccc ) >> 2 ) | ( ( v & 0x3333 ) << 2 ) );
+        v = static_cast< std::uint16_t >( ( ( v & 0xf0f0 ) >> 4 ) | ( ( v & 0x0f0f ) << 4 ) );
+
+        return v;
+    }
+
+    // multiply, add and modulo 2^16
+    static std::uint16_t mam( std::uint16_t a, std::uint16_t b )
+    {
+        return static_cast< std::uint16_t >( 17u * a + b );
+    }
+
+    unsigned channel_map::algorithm_2_channel( std::uint16_t connection_event_counter ) const
+    {
+        std::uint16_t prn = connection_event_counter ^ channel_identifier_;
+
+        for ( int round = 0; round != 3; ++round )
+            prn = mam( permutate( prn ), channel_identifier_ );
+
+        const std::uint16_t prn_e     = prn ^ channel_identifier_;
+        const unsigned      unmapped  = prn_e % max_number_of_data_channels;
+
+        if ( in_map( used_map_, unmapped ) )
+            return unmapped;
+
+        return map_[ ( used_channels_count_ * prn_e ) >> 16 ];
+    }
+
 
 }
 }
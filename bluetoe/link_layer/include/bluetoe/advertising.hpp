@@ -7,6 +7,11 @@
 #include <bluetoe/buffer.hpp>
 #include <bluetoe/delta_time.hpp>
 #include <bluetoe/ll_meta_types.hpp>
+#include <bluetoe/channel_map.hpp>
+#include <bluetoe/resolving_list.hpp>
+
+#include <algorithm>
+#include <atomic>
 
 /**
  * @file bluetoe/link_layer/include/bluetoe/advertising.hpp
@@ -25,6 +30,8 @@ namespace link_layer {
         struct advertising_type_meta_type {};
         struct advertising_startup_meta_type {};
         struct advertising_interval_meta_type {};
+        struct runtime_advertising_data_meta_type {};
+        struct periodic_advertising_meta_type {};
 
         template < unsigned long long AdvertisingIntervalMilliSeconds >
         struct check_advertising_interval_parameter {
@@ -34,15 +41,95 @@ namespace link_layer {
             typedef void type;
         };
 
+        /*
+         * checks an access address for a periodic advertising train or a connection against the
+         * rules of the Core Specification (Vol 6, Part B, 2.1.2)
+         */
+        inline bool valid_access_address( std::uint32_t access_address )
+        {
+            static constexpr std::uint32_t advertising_access_address = 0x8E89BED6;
+
+            // must not be the advertising access address and must differ in more than one bit
+            const std::uint32_t difference = access_address ^ advertising_access_address;
+
+            if ( ( difference & ( difference - 1 ) ) == 0 )
+                return false;
+
+            // the four octets must not all be equal
+            if ( ( access_address & 0xff ) * 0x01010101u == access_address )
+                return false;
+
+            // no more than six consecutive zeros or ones and no more than 24 transitions
+            unsigned equal_bits  = 1;
+            unsigned transitions = 0;
+
+            for ( unsigned bit = 1; bit != 32; ++bit )
+            {
+                if ( ( ( access_address >> bit ) & 1 ) == ( ( access_address >> ( bit - 1 ) ) & 1 ) )
+                {
+                    if ( ++equal_bits > 6 )
+                        return false;
+                }
+                else
+                {
+                    equal_bits = 1;
+                    ++transitions;
+                }
+            }
+
+            if ( transitions > 24 )
+                return false;
+
+            // at least two transitions in the most significant six bits
+            unsigned msb_transitions = 0;
+
+            for ( unsigned bit = 27; bit != 32; ++bit )
+                msb_transitions += ( ( access_address >> bit ) ^ ( access_address >> ( bit - 1 ) ) ) & 1;
+
+            return msb_transitions >= 2;
+        }
+
+        /*
+         * derives a valid access address and a CRC init value for the periodic advertising train of
+         * an advertising set from the advertising address, so that nearby devices use different trains
+         */
+        inline void periodic_access_address_and_crc_init( const device_address& address, std::uint8_t set_id, std::uint32_t& access_address, std::uint32_t& crc_init )
+        {
+            // FNV-1a over address and advertising set ID
+            std::uint32_t hash = 2166136261u;
+
+            for ( const std::uint8_t octet : address )
+                hash = ( hash ^ octet ) * 16777619u;
+
+            hash = ( hash ^ set_id ) * 16777619u;
+
+            const auto next = [&hash]() -> std::uint32_t
+            {
+                hash = hash * 1664525u + 1013904223u;
+
+                return hash;
+            };
+
+            do
+            {
+                access_address = next();
+            }
+            while ( !valid_access_address( access_address ) );
+
+            crc_init = next() >> 8;
+        }
+
         struct advertising_type_base {
             static constexpr std::uint8_t   header_txaddr_field         = 0x40;
             static constexpr std::uint8_t   header_rxaddr_field         = 0x80;
+            static constexpr std::uint8_t   header_chsel_field          = 0x20;
             static constexpr std::size_t    advertising_pdu_header_size = 2;
             static constexpr std::uint8_t   adv_ind_pdu_type_code       = 0;
             static constexpr std::uint8_t   adv_direct_ind_pdu_type_code= 1;
             static constexpr std::uint8_t   adv_nonconn_ind_pdu_type_code= 2;
             static constexpr std::uint8_t   adv_scan_ind_pdu_type_code  = 6;
             static constexpr std::uint8_t   scan_response_pdu_type_code = 4;
+            static constexpr std::uint8_t   adv_ext_ind_pdu_type_code   = 7;
             static constexpr std::size_t    address_length              = 6;
             static constexpr std::size_t    maximum_adv_request_size    = 34;
 
@@ -177,6 +264,9 @@ namespace link_layer {
                 if ( addr.is_random() )
                     header |= header_txaddr_field;
 
+                if ( LinkLayer::channel_selection_algorithm_2_supported )
+                    header |= header_chsel_field;
+
                 const std::size_t size =
                     address_length
                   + link_layer().fill_l2cap_advertising_data( &body[ address_length ], max_advertising_data_size );
@@ -323,7 +413,9 @@ namespace link_layer {
          * @brief sets the address to be used in the advertising
          *        PDU.
          *
-         * Starts advertising if an address was not set before.
+         * Starts advertising if an address was not set before. If the link layer has a resolving_list
+         * and addr is the identity address of a device in that list, connection requests from a resolvable
+         * private address of that device are accepted too.
          */
         void directed_advertising_address( const device_address& addr );
 
@@ -384,6 +476,9 @@ namespace link_layer {
                 if ( addr_.is_random() )
                     header |= header_rxaddr_field;
 
+                if ( LinkLayer::channel_selection_algorithm_2_supported )
+                    header |= header_chsel_field;
+
                 header |= ( 2 * address_length ) << 8;
 
                 layout_t::header( adv_data, header );
@@ -414,14 +509,21 @@ namespace link_layer {
             {
                 using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
 
-                bool result = details::advertising_type_base::is_valid_connect_request< layout_t >( receive, link_layer().local_address() );
+                const bool result = details::advertising_type_base::is_valid_connect_request< layout_t >( receive, link_layer().local_address() );
                 const auto body   = layout_t::body( receive ).first;
                 const auto header = layout_t::header( receive );
 
-                result = result && std::equal( &body[ 0 ], &body[ address_length ], addr_.begin() ) && addr_valid_;
-                result = result && addr_.is_random() == ( ( header & header_txaddr_field ) != 0 );
+                const device_address initiator( &body[ 0 ], ( header & header_txaddr_field ) != 0 );
 
-                return result;
+                if ( !result || !addr_valid_ )
+                    return false;
+
+                if ( initiator == addr_ )
+                    return true;
+
+                const auto identity = details::resolve_address( link_layer(), initiator );
+
+                return identity.first && identity.second == addr_;
             }
 
             static constexpr std::size_t maximum_required_advertising_buffer()
@@ -706,6 +808,286 @@ namespace link_layer {
         /** @endcond */
     };
 
+    /**
+     * @brief enables non-connectable and non-scannable extended advertising
+     *
+     * Every advertising event consists of an ADV_EXT_IND PDU on each of the three primary
+     * advertising channels, followed by an AUX_ADV_IND PDU on a secondary advertising channel.
+     * The primary PDUs only point to the auxiliary PDU, which contains the advertising address
+     * and the advertising data. This allows up to 245 bytes of advertising data (the
+     * 255 bytes of PDU payload minus the extended header).
+     *
+     * The PDUs of an advertising event are scheduled 2.4ms apart. With this fixed distance,
+     * the AuxPtr fields of the primary PDUs contain the exact offset to the auxiliary PDU.
+     * The secondary channel changes from one advertising event to the next.
+     *
+     * This advertising type can not be combined with other advertising types. Only scanners
+     * that support extended advertising (Bluetooth 5) will receive the advertising data.
+     *
+     * @sa non_connectable_undirected_advertising
+     */
+    class non_connectable_extended_advertising
+    {
+    public:
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::advertising_type_meta_type,
+            details::valid_link_layer_option_meta_type {};
+
+        template < typename LinkLayer, typename >
+        class impl : protected details::advertising_type_base
+        {
+        public:
+            impl()
+                : aux_size_( 0 )
+                , aux_channel_( 0 )
+                , data_id_( 0 )
+                , sync_info_size_( 0 )
+            {
+            }
+
+        protected:
+            static constexpr unsigned       pdus_per_advertising_event  = 4;
+            static constexpr std::uint32_t  pdu_spacing_us              = 2400;
+
+            /*
+             * builds the auxiliary PDU from the current advertising data and the primary PDUs pointing to it
+             */
+            void fill_advertising_data()
+            {
+                using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+                const device_address& addr = link_layer().local_address();
+
+                // the advertising data ID has to change, whenever the advertising data changes
+                data_id_ = ( data_id_ + 1 ) & 0x0fff;
+
+                const std::size_t extended_header_size = aux_extended_header_size + sync_info_size_;
+
+                // prevent assert() in layout_t::body
+                aux_size_ = extended_header_size;
+
+                std::uint16_t header = adv_ext_ind_pdu_type_code;
+                std::uint8_t* body   = layout_t::body( aux_buffer() ).first;
+
+                if ( addr.is_random() )
+                    header |= header_txaddr_field;
+
+                body[ 0 ] = static_cast< std::uint8_t >( extended_header_size - 1 );
+                body[ 1 ] = extended_header_adva_flag | extended_header_adi_flag
+                    | ( sync_info_size_ ? extended_header_syncinfo_flag : 0 );
+                std::copy( addr.begin(), addr.end(), &body[ 2 ] );
+                write_adi( &body[ 2 + address_length ] );
+
+                const std::size_t size =
+                    extended_header_size
+                  + link_layer().fill_l2cap_advertising_data( &body[ extended_header_size ], maximum_pdu_payload_size - extended_header_size );
+
+                header   |= size << 8;
+                aux_size_ = size;
+
+                layout_t::header( aux_buffer(), header );
+
+                fill_primary_pdus();
+            }
+
+            /*
+             * selects the secondary channel for the next advertising event
+             */
+            void next_advertising_event()
+            {
+                aux_channel_ = ( aux_channel_ + secondary_channel_hop ) % number_of_secondary_channels;
+
+                fill_primary_pdus();
+            }
+
+            read_buffer advertising_pdu( unsigned index )
+            {
+                return index < number_of_primary_pdus
+                    ? primary_buffer( index )
+                    : aux_buffer();
+            }
+
+            /*
+             * adds a SyncInfo field to the auxiliary PDU; the content is written by the periodic advertiser
+             */
+            void enable_sync_info()
+            {
+                sync_info_size_ = sync_info_size;
+            }
+
+            std::uint8_t* sync_info()
+            {
+                using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                return layout_t::body( aux_buffer() ).first + aux_extended_header_size;
+            }
+
+            static constexpr std::size_t    sync_info_size              = 18;
+
+            unsigned advertising_pdu_channel( unsigned index ) const
+            {
+                return index < number_of_primary_pdus
+                    ? first_primary_channel + index
+                    : aux_channel_;
+            }
+
+            static constexpr std::size_t maximum_required_advertising_buffer()
+            {
+                using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                return layout_t::data_channel_pdu_memory_size( maximum_pdu_payload_size )
+                     + number_of_primary_pdus * layout_t::data_channel_pdu_memory_size( primary_pdu_size )
+                     + layout_t::data_channel_pdu_memory_size( maximum_adv_request_size );
+            }
+
+            /*
+             * nothing is expected to be received, but scheduled_radio::schedule_advertisment() requires a receive buffer
+             */
+            read_buffer advertising_receive_buffer()
+            {
+                using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                return read_buffer{
+                    primary_buffer( number_of_primary_pdus ).buffer,
+                    layout_t::data_channel_pdu_memory_size( maximum_adv_request_size ) };
+            }
+
+        private:
+            static constexpr std::size_t    maximum_pdu_payload_size    = 255;
+            // extended header length and AdvMode, extended header flags, AdvA and ADI
+            static constexpr std::size_t    aux_extended_header_size    = 1 + 1 + address_length + 2;
+            // extended header length and AdvMode, extended header flags, ADI and AuxPtr
+            static constexpr std::size_t    primary_pdu_size            = 1 + 1 + 2 + 3;
+            static constexpr unsigned       number_of_primary_pdus      = 3;
+            static constexpr unsigned       first_primary_channel       = 37;
+            static constexpr unsigned       number_of_secondary_channels= 37;
+            static constexpr unsigned       secondary_channel_hop       = 13;
+            static constexpr std::uint8_t   extended_header_adva_flag   = 0x01;
+            static constexpr std::uint8_t   extended_header_adi_flag    = 0x08;
+            static constexpr std::uint8_t   extended_header_auxptr_flag = 0x10;
+            static constexpr std::uint8_t   extended_header_syncinfo_flag = 0x20;
+            static constexpr std::uint32_t  aux_offset_unit_us          = 30;
+
+            void fill_primary_pdus()
+            {
+                using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                for ( unsigned index = 0; index != number_of_primary_pdus; ++index )
+                {
+                    const read_buffer pdu  = primary_buffer( index );
+                    std::uint8_t*     body = layout_t::body( pdu ).first;
+
+                    // the primary PDUs contain no AdvA, thus TxAdd is 0
+                    layout_t::header( pdu, adv_ext_ind_pdu_type_code | ( primary_pdu_size << 8 ) );
+
+                    body[ 0 ] = primary_pdu_size - 1;
+                    body[ 1 ] = extended_header_adi_flag | extended_header_auxptr_flag;
+                    write_adi( &body[ 2 ] );
+
+                    // offset units of 30µs, clock accuracy of 51 ppm to 500 ppm, LE 1M PHY
+                    const std::uint16_t aux_offset = static_cast< std::uint16_t >(
+                        ( number_of_primary_pdus - index ) * pdu_spacing_us / aux_offset_unit_us );
+
+                    body[ 4 ] = static_cast< std::uint8_t >( aux_channel_ );
+                    body[ 5 ] = static_cast< std::uint8_t >( aux_offset & 0xff );
+                    body[ 6 ] = static_cast< std::uint8_t >( ( aux_offset >> 8 ) & 0x1f );
+                }
+            }
+
+            void write_adi( std::uint8_t* out ) const
+            {
+                // advertising set ID 0
+                out[ 0 ] = static_cast< std::uint8_t >( data_id_ & 0xff );
+                out[ 1 ] = static_cast< std::uint8_t >( data_id_ >> 8 );
+            }
+
+            read_buffer aux_buffer()
+            {
+                using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                return read_buffer{ link_layer().raw_pdu_buffer(), layout_t::data_channel_pdu_memory_size( aux_size_ ) };
+            }
+
+            read_buffer primary_buffer( unsigned index )
+            {
+                using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                return read_buffer{
+                    link_layer().raw_pdu_buffer()
+                        + layout_t::data_channel_pdu_memory_size( maximum_pdu_payload_size )
+                        + index * layout_t::data_channel_pdu_memory_size( primary_pdu_size ),
+                    layout_t::data_channel_pdu_memory_size( primary_pdu_size ) };
+            }
+
+            LinkLayer& link_layer()
+            {
+                return static_cast< LinkLayer& >( *this );
+            }
+
+            std::size_t                     aux_size_;
+            unsigned                        aux_channel_;
+            std::uint16_t                   data_id_;
+            std::size_t                     sync_info_size_;
+        };
+        /** @endcond */
+    };
+
+    /**
+     * @brief adds periodic advertising to non_connectable_extended_advertising
+     *
+     * With this option, the link layer sends an AUX_SYNC_IND PDU every IntervalMs (rounded
+     * down to a multiple of 1.25ms). The auxiliary PDUs of the extended advertising contain
+     * a SyncInfo field, that allows scanners to synchronize to this train of PDUs. The
+     * AUX_SYNC_IND PDUs use channel selection algorithm #2 over all data channels.
+     *
+     * Extended advertising events are moved, when they would overlap with a periodic advertising
+     * event; the periodic advertising events are never moved.
+     *
+     * This option will add the following functions to the link_layer:
+     * std::uint8_t* periodic_advertising_buffer()
+     * void commit_periodic_advertising_data( std::size_t size )
+     *
+     * periodic_advertising_buffer() returns the buffer for the periodic advertising data of one
+     * of the next periodic advertising events. The buffer can be filled with up to MaxSize bytes
+     * of AD structures and then be handed to the link layer by calling commit_periodic_advertising_data().
+     * If the link layer has not yet picked up the previously committed data, the function returns nullptr.
+     * The committed data is sent with the next periodic advertising event and repeated until new
+     * data is committed. Both functions must not be called from a context that interrupts the link
+     * layers radio callbacks.
+     *
+     * @tparam IntervalMs periodic advertising interval in ms in the range 20ms to 2.4s
+     * @tparam MaxSize maximum size of the periodic advertising data
+     *
+     * @sa non_connectable_extended_advertising
+     */
+    template < std::uint16_t IntervalMs, std::size_t MaxSize = 254 >
+    class periodic_advertising
+    {
+    public:
+        static_assert( IntervalMs >= 20,   "the periodic advertising interval must be greater than or equal to 20ms." );
+        static_assert( IntervalMs <= 2400, "the periodic advertising interval must be smaller than or equal to 2.4s." );
+        static_assert( MaxSize <= 254,     "the periodic advertising data can not be larger than 254 bytes." );
+
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::periodic_advertising_meta_type,
+            details::valid_link_layer_option_meta_type {};
+
+        static constexpr std::uint16_t  interval_units  = IntervalMs * 4 / 5;
+        static constexpr std::uint32_t  interval_us     = interval_units * 1250u;
+        static constexpr std::size_t    max_size        = MaxSize;
+        /** @endcond */
+    };
+
+    namespace details {
+        struct no_periodic_advertising
+        {
+            struct meta_type :
+                periodic_advertising_meta_type,
+                valid_link_layer_option_meta_type {};
+        };
+    }
+
     /**
      * @brief if this options is given to the link layer, the link layer will start to
      *        advertise automatically, when started or when disconnected.
@@ -941,7 +1323,108 @@ namespace link_layer {
         /** @endcond */
     };
 
+    /**
+     * @brief adds a double buffered advertising payload, that can be changed while advertising
+     *
+     * Using this type as an option to the link_layer, adds the documented
+     * functions to the link_layer. A payload that is passed to set_advertising_data()
+     * is picked up by the link layer at the start of the next advertising event, without
+     * stopping and restarting advertising. As long as no payload was set, the advertising
+     * data of the GATT server is used.
+     *
+     * The link layer copies the payload from within the radio callbacks. set_advertising_data()
+     * must thus not be called from a context that interrupts these callbacks.
+     *
+     * @tparam MaxSize maximum size of the payload in bytes
+     */
+    template < std::size_t MaxSize = 31 >
+    class runtime_advertising_data
+    {
+    public:
+        runtime_advertising_data()
+            : version_( 0 )
+            , consumed_version_( 0 )
+            , sizes_{ 0, 0 }
+        {
+        }
+
+        /**
+         * @brief sets the advertising data (AD structures) to be used from the next advertising event on
+         *
+         * Returns false, if size is larger than MaxSize. The current advertising data is not changed in
+         * this case.
+         */
+        bool set_advertising_data( const std::uint8_t* data, std::size_t size )
+        {
+            if ( size > MaxSize )
+                return false;
+
+            std::uint32_t next = version_.load( std::memory_order_relaxed ) + 1;
+
+            // 0 denotes "no payload set"; skip it without changing the buffer order
+            if ( next == 0 )
+                next = 2;
+
+            std::copy( data, data + size, &buffers_[ next % 2 ][ 0 ] );
+            sizes_[ next % 2 ] = size;
+
+            version_.store( next, std::memory_order_release );
+
+            return true;
+        }
+
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::runtime_advertising_data_meta_type,
+            details::valid_link_layer_option_meta_type {};
+
+    protected:
+        bool advertising_data_changed() const
+        {
+            return version_.load( std::memory_order_acquire ) != consumed_version_;
+        }
+
+        bool copy_runtime_advertising_data( std::uint8_t* buffer, std::size_t buffer_size, std::size_t& size )
+        {
+            const std::uint32_t version = version_.load( std::memory_order_acquire );
+            consumed_version_ = version;
+
+            if ( version == 0 )
+                return false;
+
+            size = std::min( sizes_[ version % 2 ], buffer_size );
+            std::copy( &buffers_[ version % 2 ][ 0 ], &buffers_[ version % 2 ][ size ], buffer );
+
+            return true;
+        }
+
+    private:
+        std::atomic< std::uint32_t >    version_;
+        std::uint32_t                   consumed_version_;
+        std::size_t                     sizes_[ 2 ];
+        std::uint8_t                    buffers_[ 2 ][ MaxSize ];
+        /** @endcond */
+    };
+
     namespace details {
+        struct no_runtime_advertising_data
+        {
+            struct meta_type :
+                runtime_advertising_data_meta_type,
+                valid_link_layer_option_meta_type {};
+
+        protected:
+            static constexpr bool advertising_data_changed()
+            {
+                return false;
+            }
+
+            static constexpr bool copy_runtime_advertising_data( std::uint8_t*, std::size_t, std::size_t& )
+            {
+                return false;
+            }
+        };
+
         /*
          * Type to implement the single and multiple adverting type advertisings
          */
@@ -962,7 +1445,10 @@ namespace link_layer {
             public advertiser_base_base,
             public bluetoe::details::find_by_meta_type<
                     details::advertising_interval_meta_type,
-                    Options..., advertising_interval< 100 > >::type
+                    Options..., advertising_interval< 100 > >::type,
+            public bluetoe::details::find_by_meta_type<
+                    details::runtime_advertising_data_meta_type,
+                    Options..., no_runtime_advertising_data >::type
         {
         protected:
             advertiser_base()
@@ -976,6 +1462,12 @@ namespace link_layer {
                 if ( current_channel_index_ != this->first_advertising_channel )
                     return delta_time::now();
 
+                return next_adv_event_start();
+            }
+
+            // advertising interval plus a pseudo random advertising delay
+            delta_time next_adv_event_start()
+            {
                 adv_perturbation_ = ( adv_perturbation_ + 7 ) % ( max_adv_perturbation_ + 1 );
 
                 return this->current_advertising_interval() + delta_time::msec( adv_perturbation_ );
@@ -986,6 +1478,12 @@ namespace link_layer {
                 return current_channel_index_;
             }
 
+            // a changed runtime payload is taken over at the start of an advertising event
+            bool refill_advertising_data() const
+            {
+                return current_channel_index_ == last_advertising_channel && this->advertising_data_changed();
+            }
+
             void next_channel()
             {
                 current_channel_index_ = current_channel_index_ == last_advertising_channel
@@ -1082,7 +1580,9 @@ namespace link_layer {
 
             void handle_adv_timeout()
             {
-                const read_buffer advertising_data = this->get_advertising_data();
+                const read_buffer advertising_data = this->refill_advertising_data()
+                    ? this->fill_advertising_data()
+                    : this->get_advertising_data();
                 const read_buffer response_data    = this->get_advertising_response_data();
 
                 if ( !advertising_data.empty() && this->continued_advertising_events() )
@@ -1099,6 +1599,375 @@ namespace link_layer {
             }
         };
 
+        /*
+         * Extended advertising: 3 primary PDUs, followed by an auxiliary PDU. All PDUs of an advertising
+         * event are scheduled relative to the previous one, so that the offsets in the primary PDUs are exact.
+         */
+        template < typename LinkLayer, typename Periodic, typename ... Options >
+        class extended_advertiser :
+            public non_connectable_extended_advertising::template impl< LinkLayer, extended_advertiser< LinkLayer, Periodic, Options... > >,
+            public advertiser_base< Options... >,
+            public start_stop_implementation< LinkLayer, std::tuple< non_connectable_extended_advertising >, Options... >
+        {
+        public:
+            extended_advertiser()
+                : pdu_index_( 0 )
+            {
+            }
+
+            void handle_start_advertising()
+            {
+                pdu_index_ = 0;
+                this->fill_advertising_data();
+
+                if ( this->begin_of_advertising_events() )
+                {
+                    LinkLayer& link_layer  = static_cast< LinkLayer& >( *this );
+
+                    link_layer.set_access_address_and_crc_init(
+                        this->advertising_radio_access_address,
+                        this->advertising_crc_init );
+
+                    schedule_pdu( delta_time::now() );
+                }
+            }
+
+            void handle_stop_advertising()
+            {
+                this->end_of_advertising_events();
+            }
+
+            bool handle_adv_receive( read_buffer, device_address& )
+            {
+                handle_adv_timeout();
+
+                return false;
+            }
+
+            void handle_adv_timeout()
+            {
+                if ( !this->continued_advertising_events() )
+                    return;
+
+                pdu_index_ = ( pdu_index_ + 1 ) % this->pdus_per_advertising_event;
+
+                if ( pdu_index_ != 0 )
+                {
+                    schedule_pdu( delta_time::usec( this->pdu_spacing_us ) );
+                    return;
+                }
+
+                if ( this->advertising_data_changed() )
+                    this->fill_advertising_data();
+
+                this->next_advertising_event();
+
+                // the last anchor was the auxiliary PDU of the previous advertising event
+                schedule_pdu( this->next_adv_event_start()
+                    - delta_time::usec( ( this->pdus_per_advertising_event - 1 ) * this->pdu_spacing_us ) );
+            }
+
+        private:
+            void schedule_pdu( delta_time when )
+            {
+                static_cast< LinkLayer& >( *this ).schedule_advertisment(
+                    this->advertising_pdu_channel( pdu_index_ ),
+                    write_buffer( this->advertising_pdu( pdu_index_ ) ),
+                    write_buffer{ nullptr, 0 },
+                    when,
+                    this->advertising_receive_buffer() );
+            }
+
+            unsigned pdu_index_;
+        };
+
+        /*
+         * Extended advertising with periodic advertising: The timing of both, the advertising events and the
+         * periodic advertising events is kept relative to the anchor of the last scheduled PDU.
+         */
+        template < typename LinkLayer, std::uint16_t IntervalMs, std::size_t MaxSize, typename ... Options >
+        class extended_advertiser< LinkLayer, periodic_advertising< IntervalMs, MaxSize >, Options... > :
+            public non_connectable_extended_advertising::template impl< LinkLayer, extended_advertiser< LinkLayer, periodic_advertising< IntervalMs, MaxSize >, Options... > >,
+            public advertiser_base< Options... >,
+            public start_stop_implementation< LinkLayer, std::tuple< non_connectable_extended_advertising >, Options... >
+        {
+        public:
+            extended_advertiser()
+                : pdu_index_( 0 )
+                , next_advertising_event_( 0 )
+                , next_periodic_event_( 0 )
+                , event_counter_( 0 )
+                , periodic_access_address_( 0 )
+                , periodic_crc_init_( 0 )
+                , sync_buffer_( 0 )
+                , version_( 0 )
+                , consumed_version_( 0 )
+            {
+                this->enable_sync_info();
+            }
+
+            std::uint8_t* periodic_advertising_buffer()
+            {
+                if ( version_.load( std::memory_order_acquire ) != consumed_version_.load( std::memory_order_acquire ) )
+                    return nullptr;
+
+                return sync_pdu_body( 1 - sync_buffer_.load( std::memory_order_acquire ) ) + 1;
+            }
+
+            void commit_periodic_advertising_data( std::size_t size )
+            {
+                assert( size <= MaxSize );
+
+                fill_sync_pdu( 1 - sync_buffer_.load( std::memory_order_acquire ), size );
+                version_.store( version_.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+            }
+
+            void handle_start_advertising()
+            {
+                pdu_index_ = 0;
+                this->fill_advertising_data();
+
+                if ( consumed_version_.load( std::memory_order_relaxed ) == 0 )
+                    fill_sync_pdu( sync_buffer_.load( std::memory_order_relaxed ), 0 );
+
+                static const std::uint8_t all_channels[] = { 0xff, 0xff, 0xff, 0xff, 0x1f };
+
+                // advertising set ID 0
+                details::periodic_access_address_and_crc_init(
+                    static_cast< LinkLayer& >( *this ).local_address(), 0, periodic_access_address_, periodic_crc_init_ );
+                sync_channels_.reset_algorithm_2( all_channels, periodic_access_address_ );
+
+                if ( this->begin_of_advertising_events() )
+                {
+                    next_advertising_event_ = this->next_adv_event_start().usec();
+                    next_periodic_event_    = advertising_event_duration + this->pdu_spacing_us;
+
+                    schedule_advertising_pdu( delta_time::now() );
+                }
+            }
+
+            void handle_stop_advertising()
+            {
+                this->end_of_advertising_events();
+            }
+
+            bool handle_adv_receive( read_buffer, device_address& )
+            {
+                handle_adv_timeout();
+
+                return false;
+            }
+
+            void handle_adv_timeout()
+            {
+                if ( !this->continued_advertising_events() )
+                    return;
+
+                if ( pdu_index_ < this->pdus_per_advertising_event - 1 )
+                {
+                    ++pdu_index_;
+                    schedule_advertising_pdu( delta_time::usec( this->pdu_spacing_us ) );
+
+                    return;
+                }
+
+                // the advertising event or the periodic advertising event is over
+                if ( next_advertising_event_ + advertising_event_duration + this->pdu_spacing_us <= next_periodic_event_ )
+                {
+                    pdu_index_ = 0;
+
+                    if ( this->advertising_data_changed() )
+                        this->fill_advertising_data();
+
+                    this->next_advertising_event();
+
+                    // schedule_advertising_pdu() moves the anchor to the start of the new advertising event
+                    const std::uint32_t when = next_advertising_event_;
+                    next_advertising_event_ += this->next_adv_event_start().usec();
+
+                    schedule_advertising_pdu( delta_time( when ) );
+                }
+                else
+                {
+                    if ( next_advertising_event_ < next_periodic_event_ + this->pdu_spacing_us )
+                        next_advertising_event_ = next_periodic_event_ + this->pdu_spacing_us;
+
+                    schedule_periodic_pdu();
+                }
+            }
+
+            static constexpr std::size_t maximum_required_advertising_buffer()
+            {
+                using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                return non_connectable_extended_advertising::template impl< LinkLayer, extended_advertiser >::maximum_required_advertising_buffer()
+                    + 2 * layout_t::data_channel_pdu_memory_size( MaxSize + 1 );
+            }
+
+        private:
+            using periodic_t = periodic_advertising< IntervalMs, MaxSize >;
+
+            static constexpr std::uint32_t  advertising_event_duration  = ( non_connectable_extended_advertising::template impl< LinkLayer, extended_advertiser >::pdus_per_advertising_event - 1 )
+                                                                        * non_connectable_extended_advertising::template impl< LinkLayer, extended_advertiser >::pdu_spacing_us;
+            static constexpr std::uint32_t  sync_offset_unit_us         = 30;
+            static constexpr std::uint32_t  sync_offset_large_unit_us   = 300;
+            static constexpr std::uint32_t  sync_offset_large_units     = 245700;
+            static constexpr std::uint8_t   sync_offset_units_flag      = 0x20;
+
+            // all times are relative to the anchor of the last scheduled PDU
+            void move_anchor( std::uint32_t when )
+            {
+                next_advertising_event_ -= when;
+                next_periodic_event_    -= when;
+            }
+
+            void schedule_advertising_pdu( delta_time when )
+            {
+                LinkLayer& link_layer = static_cast< LinkLayer& >( *this );
+
+                move_anchor( when.usec() );
+
+                if ( pdu_index_ == 0 )
+                {
+                    link_layer.set_access_address_and_crc_init(
+                        this->advertising_radio_access_address,
+                        this->advertising_crc_init );
+                }
+                else if ( pdu_index_ == this->pdus_per_advertising_event - 1 )
+                {
+                    write_sync_info();
+                }
+
+                link_layer.schedule_advertisment(
+                    this->advertising_pdu_channel( pdu_index_ ),
+                    write_buffer( this->advertising_pdu( pdu_index_ ) ),
+                    write_buffer{ nullptr, 0 },
+                    when,
+                    this->advertising_receive_buffer() );
+            }
+
+            void schedule_periodic_pdu()
+            {
+                LinkLayer& link_layer = static_cast< LinkLayer& >( *this );
+
+                // pick up newly committed data
+                const std::uint32_t version = version_.load( std::memory_order_acquire );
+
+                if ( version != consumed_version_.load( std::memory_order_relaxed ) )
+                {
+                    sync_buffer_.store( 1 - sync_buffer_.load( std::memory_order_relaxed ), std::memory_order_release );
+                    consumed_version_.store( version, std::memory_order_release );
+                }
+
+                const std::uint32_t when    = next_periodic_event_;
+                const unsigned      channel = sync_channels_.data_channel( 0, event_counter_ );
+
+                move_anchor( when );
+                next_periodic_event_ = periodic_t::interval_us;
+                ++event_counter_;
+
+                link_layer.set_access_address_and_crc_init( periodic_access_address_, periodic_crc_init_ );
+                link_layer.schedule_advertisment(
+                    channel,
+                    write_buffer( sync_pdu( sync_buffer_.load( std::memory_order_relaxed ) ) ),
+                    write_buffer{ nullptr, 0 },
+                    delta_time( when ),
+                    this->advertising_receive_buffer() );
+            }
+
+            void write_sync_info()
+            {
+                std::uint8_t* const out = this->sync_info();
+
+                std::uint16_t offset = next_periodic_event_ < sync_offset_large_units
+                    ? static_cast< std::uint16_t >( next_periodic_event_ / sync_offset_unit_us )
+                    : static_cast< std::uint16_t >( ( next_periodic_event_ / sync_offset_large_unit_us ) | ( sync_offset_units_flag << 8 ) );
+
+                out[ 0 ]  = static_cast< std::uint8_t >( offset & 0xff );
+                out[ 1 ]  = static_cast< std::uint8_t >( offset >> 8 );
+                out[ 2 ]  = static_cast< std::uint8_t >( periodic_t::interval_units & 0xff );
+                out[ 3 ]  = static_cast< std::uint8_t >( periodic_t::interval_units >> 8 );
+
+                // all data channels used, sleep clock accuracy of 251 ppm to 500 ppm
+                out[ 4 ]  = 0xff;
+                out[ 5 ]  = 0xff;
+                out[ 6 ]  = 0xff;
+                out[ 7 ]  = 0xff;
+                out[ 8 ]  = 0x1f;
+
+                for ( unsigned byte = 0; byte != 4; ++byte )
+                    out[ 9 + byte ] = static_cast< std::uint8_t >( periodic_access_address_ >> ( 8 * byte ) );
+
+                for ( unsigned byte = 0; byte != 3; ++byte )
+                    out[ 13 + byte ] = static_cast< std::uint8_t >( periodic_crc_init_ >> ( 8 * byte ) );
+
+                out[ 16 ] = static_cast< std::uint8_t >( event_counter_ & 0xff );
+                out[ 17 ] = static_cast< std::uint8_t >( event_counter_ >> 8 );
+            }
+
+            read_buffer sync_pdu( unsigned index, std::size_t size )
+            {
+                using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+                using impl_t   = typename non_connectable_extended_advertising::template impl< LinkLayer, extended_advertiser >;
+
+                return read_buffer{
+                    static_cast< LinkLayer& >( *this ).raw_pdu_buffer()
+                        + impl_t::maximum_required_advertising_buffer()
+                        + index * layout_t::data_channel_pdu_memory_size( MaxSize + 1 ),
+                    layout_t::data_channel_pdu_memory_size( size ) };
+            }
+
+            read_buffer sync_pdu( unsigned index )
+            {
+                using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                const read_buffer pdu = sync_pdu( index, MaxSize + 1 );
+
+                return sync_pdu( index, ( layout_t::header( pdu ) >> 8 ) & 0xff );
+            }
+
+            std::uint8_t* sync_pdu_body( unsigned index )
+            {
+                using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                return layout_t::body( sync_pdu( index, MaxSize + 1 ) ).first;
+            }
+
+            // AUX_SYNC_IND without extended header
+            void fill_sync_pdu( unsigned index, std::size_t size )
+            {
+                using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                sync_pdu_body( index )[ 0 ] = 0;
+                layout_t::header( sync_pdu( index, MaxSize + 1 ),
+                    static_cast< std::uint16_t >( this->adv_ext_ind_pdu_type_code | ( ( size + 1 ) << 8 ) ) );
+            }
+
+            unsigned                        pdu_index_;
+            std::uint32_t                   next_advertising_event_;
+            std::uint32_t                   next_periodic_event_;
+            std::uint16_t                   event_counter_;
+            std::uint32_t                   periodic_access_address_;
+            std::uint32_t                   periodic_crc_init_;
+            channel_map                     sync_channels_;
+
+            std::atomic< unsigned >         sync_buffer_;
+            std::atomic< std::uint32_t >    version_;
+            std::atomic< std::uint32_t >    consumed_version_;
+        };
+
+        template < typename LinkLayer, typename ... Options >
+        class advertiser< LinkLayer, std::tuple< Options... >, std::tuple< non_connectable_extended_advertising > > :
+            public extended_advertiser<
+                LinkLayer,
+                typename bluetoe::details::find_by_meta_type<
+                    periodic_advertising_meta_type,
+                    Options...,
+                    no_periodic_advertising >::type,
+                Options... >
+        {
+        };
+
         /*
          * Default
          */
@@ -1237,6 +2106,10 @@ namespace link_layer {
             public start_stop_implementation< LinkLayer, std::tuple< FirstAdv, SecondAdv, Advertisings... >, Options... >
         {
         public:
+            static_assert(
+                bluetoe::details::index_of< non_connectable_extended_advertising, FirstAdv, SecondAdv, Advertisings... >::value == sizeof...(Advertisings) + 2,
+                "non_connectable_extended_advertising can not be combined with other advertising types" );
+
             advertiser()
                 : selected_( 0 )
                 , proposal_( 0 )
@@ -1295,7 +2168,7 @@ namespace link_layer {
 
             void handle_adv_timeout()
             {
-                const bool fill_data = selected_ != proposal_;
+                const bool fill_data = selected_ != proposal_ || this->refill_advertising_data();
 
                 selected_ = proposal_;
                 const read_buffer advertising_data = fill_data
@@ -2,6 +2,7 @@
 #define BLUETOE_LINK_LAYER_CHANNEL_MAP_HPP
 
 #include <cstdint>
+#include <cstddef>
 
 namespace bluetoe {
 namespace link_layer {
@@ -30,22 +31,50 @@ namespace link_layer {
          */
         bool reset( const std::uint8_t* map );
 
+        /**
+         * @brief sets a new list of used channels and selects channel selection algorithm #2
+         *
+         * The channel identifier used by the algorithm is derived from the access address of the connection.
+         * The function returns true, if the given parameters are valid. A valid map contains at least 2 channel.
+         *
+         * Subsequent calls to reset( const std::uint8_t* map ) keep channel selection algorithm #2.
+         */
+        bool reset_algorithm_2( const std::uint8_t* map, std::uint32_t access_address );
+
         /**
          * the BLE channel hop sequence is 37 entries long, after 37 hops, the sequence starts again.
          * This function returns the entries in this sequence. The channel for the first entry is given
          * by calling the function with index = 0, the last entry with index = max_number_of_data_channels -1
+         *
+         * @pre channel selection algorithm #1 is in use
          */
         unsigned data_channel( unsigned index ) const;
 
+        /**
+         * @brief returns the data channel for a connection event
+         *
+         * With channel selection algorithm #1, the channel is looked up by index (see data_channel( unsigned )),
+         * with channel selection algorithm #2, the channel is calculated from the connection event counter.
+         */
+        unsigned data_channel( unsigned index, std::uint16_t connection_event_counter ) const;
+
         /**
          * the number of channels, used as data channel.
          */
         static constexpr unsigned max_number_of_data_channels = 37;
     private:
+        static constexpr std::size_t channel_map_size = 5;
+
         unsigned build_used_channel_map( const std::uint8_t* map, std::uint8_t* used ) const;
+        unsigned algorithm_2_channel( std::uint16_t connection_event_counter ) const;
 
-        std::uint8_t map_[ max_number_of_data_channels ];
-        std::uint8_t hop_;
+        // algorithm #1: the hop sequence; algorithm #2: the list of used channels
+        std::uint8_t  map_[ max_number_of_data_channels ];
+        std::uint8_t  used_map_[ channel_map_size ];
+        std::uint8_t  hop_;
+        std::uint8_t  used_channels_count_;
+        std::uint16_t channel_identifier_;
+        bool          algorithm_2_;
     };
 }
 }
@@ -0,0 +1,638 @@
+#ifndef BLUETOE_LINK_LAYER_CONCURRENT_CONNECTIONS_HPP
+#define BLUETOE_LINK_LAYER_CONCURRENT_CONNECTIONS_HPP
+
+#include <bluetoe/connection_scheduler.hpp>
+#include <bluetoe/ll_options.hpp>
+#include <bluetoe/buffer.hpp>
+#include <bluetoe/delta_time.hpp>
+#include <bluetoe/phy_encodings.hpp>
+#include <bluetoe/meta_tools.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <utility>
+#include <type_traits>
+
+namespace bluetoe {
+namespace link_layer {
+
+    /** @cond HIDDEN_SYMBOLS */
+    namespace details {
+
+        /*
+         * States of the link layer, that are kept per connection
+         */
+        enum class link_layer_state
+        {
+            initial,
+            advertising,
+            connecting,
+            connected,
+            disconnecting,
+            connection_changed
+        };
+
+        inline bool is_connection_state( link_layer_state state )
+        {
+            return state == link_layer_state::connecting
+                || state == link_layer_state::connected
+                || state == link_layer_state::disconnecting
+                || state == link_layer_state::connection_changed;
+        }
+
+        /*
+         * Everything a link layer has to park for a connection, while an other connection or
+         * the advertising is using the link layer.
+         */
+        template < class State, class Latency, class DataLength, class Security, class Signaling, class Buffers, class Encryption >
+        struct connection_context
+        {
+            using state_t = State;
+
+            State       state;
+            Latency     latency;
+            DataLength  data_length;
+            Security    security;
+            Signaling   signaling;
+            Buffers     buffers;
+            Encryption  encryption;
+        };
+
+        /*
+         * Used for radios without encryption support
+         */
+        struct no_encryption_context {};
+
+        template < class Radio >
+        struct radio_encryption_context
+        {
+            template < class R >
+            static typename R::encryption_context check( int );
+
+            template < class R >
+            static no_encryption_context check( long );
+
+            using type = decltype( check< Radio >( 0 ) );
+        };
+
+        template < class Radio >
+        void store_encryption_context( const Radio&, no_encryption_context& )
+        {
+        }
+
+        template < class Radio, class Context >
+        void store_encryption_context( const Radio& radio, Context& context )
+        {
+            radio.store_encryption_context( context );
+        }
+
+        template < class Radio >
+        void restore_encryption_context( Radio&, const no_encryption_context& )
+        {
+        }
+
+        template < class Radio, class Context >
+        void restore_encryption_context( Radio& radio, const Context& context )
+        {
+            radio.restore_encryption_context( context );
+        }
+
+        template < typename ... Options >
+        using concurrent_connections_option = typename ::bluetoe::details::find_by_meta_type<
+            concurrent_connections_meta_type,
+            Options...,
+            max_concurrent_connections< 1 > >::type;
+
+        /*
+         * Shares the radio of a link layer between Connections connections and the advertising.
+         *
+         * The link layer owns the state of a single connection: the active slot. All calls from the link layer
+         * and the advertiser to the radio are routed through this class. Requests for radio events are recorded
+         * by a connection_scheduler and the next event is passed to the radio by dispatch_radio_event(),
+         * which the link layer calls at the end of every radio callback and in run(). Before an event of a
+         * connection is passed to the radio, the state of that connection is restored by the link layer.
+         *
+         * The default is a single connection, for which all calls are directly forwarded to the radio.
+         */
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        class concurrent_connections_impl
+        {
+        public:
+            concurrent_connections_impl();
+
+            static constexpr std::size_t number_of_connections = Connections;
+
+            ConnectionData& current_connection_data();
+            const ConnectionData& current_connection_data() const;
+
+            ConnectionData& slot_connection_data( std::size_t slot );
+            bool slot_connection_established( std::size_t slot ) const;
+            const typename Context::state_t& slot_connection_state( std::size_t slot ) const;
+
+        protected:
+            void advertising_event_done();
+            void connection_event_timed_out();
+            void connection_event_ended();
+            void dispatch_radio_event();
+            bool start_advertising_in_current_slot();
+
+            void concurrent_schedule_advertisment(
+                unsigned                                    channel,
+                const write_buffer&                         advertising_data,
+                const write_buffer&                         response_data,
+                delta_time                                  when,
+                const read_buffer&                          receive );
+
+            delta_time concurrent_schedule_connection_event(
+                unsigned                                    channel,
+                delta_time                                  start_receive,
+                delta_time                                  end_receive,
+                delta_time                                  connection_interval,
+                delta_time                                  supervision_timeout );
+
+            std::pair< bool, delta_time > concurrent_disarm_connection_event();
+
+            void concurrent_set_access_address_and_crc_init( std::uint32_t access_address, std::uint32_t crc_init );
+            void concurrent_set_connection_access_address_and_crc_init( std::uint32_t access_address, std::uint32_t crc_init );
+            void concurrent_radio_set_phy( phy_ll_encoding::phy_ll_encoding_t receiving, phy_ll_encoding::phy_ll_encoding_t transmitting );
+            std::uint8_t* concurrent_raw_pdu_buffer();
+
+        private:
+            using scheduler_t = connection_scheduler< Connections >;
+            using event_t     = typename scheduler_t::event;
+
+            static constexpr unsigned invalid_slot = scheduler_t::invalid_slot;
+
+            struct link_parameters
+            {
+                std::uint32_t                       access_address;
+                std::uint32_t                       crc_init;
+                phy_ll_encoding::phy_ll_encoding_t  receiving_phy;
+                phy_ll_encoding::phy_ll_encoding_t  transmitting_phy;
+                unsigned                            channel;
+                delta_time                          interval;
+            };
+
+            struct advertising_parameters
+            {
+                std::uint32_t   access_address;
+                std::uint32_t   crc_init;
+                unsigned        channel;
+                write_buffer    advertising_data;
+                write_buffer    response_data;
+                read_buffer     receive;
+            };
+
+            LinkLayer& link_layer();
+            const LinkLayer& link_layer() const;
+
+            details::link_layer_state slot_state( unsigned slot ) const;
+            void activate( unsigned slot );
+            void activate_last_connection();
+            void start_advertising_in_free_slot();
+
+            template < class Radio >
+            void set_phy( Radio& radio, phy_ll_encoding::phy_ll_encoding_t receiving, phy_ll_encoding::phy_ll_encoding_t transmitting, std::true_type );
+
+            template < class Radio >
+            void set_phy( Radio&, phy_ll_encoding::phy_ll_encoding_t, phy_ll_encoding::phy_ll_encoding_t, std::false_type );
+
+            scheduler_t             scheduler_;
+            Context                 contexts_[ Connections ];
+            ConnectionData          connection_data_[ Connections ];
+            link_parameters         links_[ Connections ];
+            advertising_parameters  advertising_;
+            unsigned                active_;
+            unsigned                advertising_slot_;
+            unsigned                last_connection_;
+            bool                    armed_;
+
+            // the LL PDU buffer is used by the active connection, even during advertising events
+            std::uint8_t            advertising_buffer_[ AdvertisingBufferSize ];
+        };
+
+        template < class LinkLayer, class Context, class ConnectionData, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        class concurrent_connections_impl< LinkLayer, Context, ConnectionData, 1, EventLengthUs, AdvertisingBufferSize >
+        {
+        public:
+            static constexpr std::size_t number_of_connections = 1;
+
+            ConnectionData& current_connection_data()
+            {
+                return connection_data_;
+            }
+
+            const ConnectionData& current_connection_data() const
+            {
+                return connection_data_;
+            }
+
+            ConnectionData& slot_connection_data( std::size_t )
+            {
+                return connection_data_;
+            }
+
+            bool slot_connection_established( std::size_t ) const
+            {
+                return true;
+            }
+
+            template < class LL = LinkLayer >
+            const typename Context::state_t& slot_connection_state( std::size_t ) const
+            {
+                return static_cast< const LL& >( *this );
+            }
+
+        protected:
+            void advertising_event_done() {}
+            void connection_event_timed_out() {}
+            void connection_event_ended() {}
+            void dispatch_radio_event() {}
+
+            bool start_advertising_in_current_slot()
+            {
+                return true;
+            }
+
+            void concurrent_schedule_advertisment(
+                unsigned                                    channel,
+                const write_buffer&                         advertising_data,
+                const write_buffer&                         response_data,
+                delta_time                                  when,
+                const read_buffer&                          receive )
+            {
+                radio().schedule_advertisment( channel, advertising_data, response_data, when, receive );
+            }
+
+            delta_time concurrent_schedule_connection_event(
+                unsigned                                    channel,
+                delta_time                                  start_receive,
+                delta_time                                  end_receive,
+                delta_time                                  connection_interval,
+                delta_time                                  /* supervision_timeout */ )
+            {
+                return radio().schedule_connection_event( channel, start_receive, end_receive, connection_interval );
+            }
+
+            std::pair< bool, delta_time > concurrent_disarm_connection_event()
+            {
+                return radio().disarm_connection_event();
+            }
+
+            void concurrent_set_access_address_and_crc_init( std::uint32_t access_address, std::uint32_t crc_init )
+            {
+                radio().set_access_address_and_crc_init( access_address, crc_init );
+            }
+
+            void concurrent_set_connection_access_address_and_crc_init( std::uint32_t access_address, std::uint32_t crc_init )
+            {
+                radio().set_access_address_and_crc_init( access_address, crc_init );
+            }
+
+            void concurrent_radio_set_phy( phy_ll_encoding::phy_ll_encoding_t receiving, phy_ll_encoding::phy_ll_encoding_t transmitting )
+            {
+                radio().radio_set_phy( receiving, transmitting );
+            }
+
+            std::uint8_t* concurrent_raw_pdu_buffer()
+            {
+                return radio().raw_pdu_buffer();
+            }
+
+        private:
+            // LinkLayer is incomplete, when this class gets instantiated
+            template < class LL = LinkLayer >
+            typename LL::radio_t& radio()
+            {
+                return static_cast< typename LL::radio_t& >( static_cast< LL& >( *this ) );
+            }
+
+            ConnectionData connection_data_;
+        };
+
+        // implementation
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::concurrent_connections_impl()
+            : scheduler_( delta_time::usec( EventLengthUs ) )
+            , advertising_{ 0, 0, 0, write_buffer{ nullptr, 0 }, write_buffer{ nullptr, 0 }, read_buffer{ nullptr, 0 } }
+            , active_( 0 )
+            , advertising_slot_( invalid_slot )
+            , last_connection_( invalid_slot )
+            , armed_( false )
+        {
+            for ( auto& link: links_ )
+                link = link_parameters{ 0, 0, phy_ll_encoding::le_1m_phy, phy_ll_encoding::le_1m_phy, 0, delta_time() };
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        ConnectionData& concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::current_connection_data()
+        {
+            return connection_data_[ active_ ];
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        const ConnectionData& concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::current_connection_data() const
+        {
+            return connection_data_[ active_ ];
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        ConnectionData& concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::slot_connection_data( std::size_t slot )
+        {
+            assert( slot < Connections );
+
+            return connection_data_[ slot ];
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        const typename Context::state_t& concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::slot_connection_state( std::size_t slot ) const
+        {
+            assert( slot < Connections );
+
+            if ( slot == active_ )
+                return link_layer();
+
+            return contexts_[ slot ].state;
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        bool concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::slot_connection_established( std::size_t slot ) const
+        {
+            const link_layer_state state = slot_state( slot );
+
+            return is_connection_state( state ) && state != link_layer_state::disconnecting;
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        void concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::advertising_event_done()
+        {
+            const unsigned slot = scheduler_.dispatched();
+
+            scheduler_.advertising_event_done();
+            armed_ = false;
+
+            activate( slot );
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        void concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::connection_event_timed_out()
+        {
+            assert( scheduler_.dispatched() == active_ );
+
+            scheduler_.connection_event_timed_out();
+            armed_ = false;
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        void concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::connection_event_ended()
+        {
+            assert( scheduler_.dispatched() == active_ );
+
+            scheduler_.connection_event_ended();
+            armed_ = false;
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        void concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::dispatch_radio_event()
+        {
+            if ( scheduler_.dispatched() != invalid_slot )
+                return;
+
+            if ( advertising_slot_ != invalid_slot && slot_state( advertising_slot_ ) != link_layer_state::advertising )
+                advertising_slot_ = invalid_slot;
+
+            if ( advertising_slot_ == invalid_slot )
+                start_advertising_in_free_slot();
+
+            for ( ;; )
+            {
+                const event_t event = scheduler_.next_event();
+                auto&         radio = static_cast< typename LinkLayer::radio_t& >( link_layer() );
+
+                switch ( event.kind )
+                {
+                case event_t::none:
+                    activate_last_connection();
+                    return;
+
+                case event_t::skipped_connection_event:
+                    activate( event.slot );
+                    link_layer().handle_connection_event_timeout();
+                    break;
+
+                case event_t::skipped_advertising_event:
+                    link_layer().handle_adv_timeout();
+                    break;
+
+                case event_t::connection_event:
+                    {
+                        activate( event.slot );
+                        last_connection_ = event.slot;
+
+                        // output of the connection, that was queued while an other connection was active
+                        link_layer().transmit_pending_output();
+
+                        const link_parameters& link = links_[ event.slot ];
+
+                        radio.set_access_address_and_crc_init( link.access_address, link.crc_init );
+                        set_phy( radio, link.receiving_phy, link.transmitting_phy,
+                            std::integral_constant< bool, LinkLayer::radio_t::hardware_supports_2mbit >() );
+
+                        armed_ = true;
+                        radio.schedule_connection_event( link.channel, event.start, event.end, link.interval );
+                    }
+                    return;
+
+                case event_t::advertising_event:
+                    radio.set_access_address_and_crc_init( advertising_.access_address, advertising_.crc_init );
+                    set_phy( radio, phy_ll_encoding::le_1m_phy, phy_ll_encoding::le_1m_phy,
+                        std::integral_constant< bool, LinkLayer::radio_t::hardware_supports_2mbit >() );
+
+                    armed_ = true;
+                    radio.schedule_advertisment( advertising_.channel, advertising_.advertising_data, advertising_.response_data, event.start, advertising_.receive );
+
+                    // user requests address the last connection, while the advertising is on air
+                    activate_last_connection();
+                    return;
+                }
+            }
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        bool concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::start_advertising_in_current_slot()
+        {
+            if ( advertising_slot_ != invalid_slot && advertising_slot_ != active_ )
+                return false;
+
+            advertising_slot_ = active_;
+
+            return true;
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        void concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::concurrent_schedule_advertisment(
+            unsigned                                    channel,
+            const write_buffer&                         advertising_data,
+            const write_buffer&                         response_data,
+            delta_time                                  when,
+            const read_buffer&                          receive )
+        {
+            // all slots are used by connections
+            if ( advertising_slot_ == invalid_slot )
+                return;
+
+            advertising_.channel            = channel;
+            advertising_.advertising_data   = advertising_data;
+            advertising_.response_data      = response_data;
+            advertising_.receive            = receive;
+
+            scheduler_.request_advertising_event( advertising_slot_, when );
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        delta_time concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::concurrent_schedule_connection_event(
+            unsigned                                    channel,
+            delta_time                                  start_receive,
+            delta_time                                  end_receive,
+            delta_time                                  connection_interval,
+            delta_time                                  supervision_timeout )
+        {
+            links_[ active_ ].channel  = channel;
+            links_[ active_ ].interval = connection_interval;
+
+            scheduler_.request_connection_event( active_, start_receive, end_receive, supervision_timeout );
+
+            // the distance to the last radio event is the best available estimate
+            return scheduler_.slot_to_radio_time( active_, start_receive );
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        std::pair< bool, delta_time > concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::concurrent_disarm_connection_event()
+        {
+            if ( !armed_ || scheduler_.dispatched() != active_ )
+                return { false, delta_time() };
+
+            const std::pair< bool, delta_time > result =
+                static_cast< typename LinkLayer::radio_t& >( link_layer() ).disarm_connection_event();
+
+            if ( !result.first )
+                return result;
+
+            scheduler_.withdraw();
+            armed_ = false;
+
+            return { true, scheduler_.radio_to_slot_time( active_, result.second ) };
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        void concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::concurrent_set_access_address_and_crc_init( std::uint32_t access_address, std::uint32_t crc_init )
+        {
+            advertising_.access_address = access_address;
+            advertising_.crc_init       = crc_init;
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        void concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::concurrent_set_connection_access_address_and_crc_init( std::uint32_t access_address, std::uint32_t crc_init )
+        {
+            links_[ active_ ].access_address    = access_address;
+            links_[ active_ ].crc_init          = crc_init;
+            links_[ active_ ].receiving_phy     = phy_ll_encoding::le_1m_phy;
+            links_[ active_ ].transmitting_phy  = phy_ll_encoding::le_1m_phy;
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        void concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::concurrent_radio_set_phy( phy_ll_encoding::phy_ll_encoding_t receiving, phy_ll_encoding::phy_ll_encoding_t transmitting )
+        {
+            if ( receiving != phy_ll_encoding::le_unchanged_coding )
+                links_[ active_ ].receiving_phy = receiving;
+
+            if ( transmitting != phy_ll_encoding::le_unchanged_coding )
+                links_[ active_ ].transmitting_phy = transmitting;
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        std::uint8_t* concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::concurrent_raw_pdu_buffer()
+        {
+            return &advertising_buffer_[ 0 ];
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        LinkLayer& concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::link_layer()
+        {
+            return static_cast< LinkLayer& >( *this );
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        const LinkLayer& concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::link_layer() const
+        {
+            return static_cast< const LinkLayer& >( *this );
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        link_layer_state concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::slot_state( unsigned slot ) const
+        {
+            assert( slot < Connections );
+
+            return slot == active_
+                ? link_layer().state_
+                : contexts_[ slot ].state.state_;
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        void concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::activate( unsigned slot )
+        {
+            assert( slot < Connections );
+
+            if ( slot == active_ )
+                return;
+
+            link_layer().store_connection( contexts_[ active_ ] );
+            active_ = slot;
+            link_layer().restore_connection( contexts_[ active_ ] );
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        void concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::activate_last_connection()
+        {
+            if ( last_connection_ != invalid_slot && is_connection_state( slot_state( last_connection_ ) ) )
+                activate( last_connection_ );
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        void concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::start_advertising_in_free_slot()
+        {
+            for ( unsigned slot = 0; slot != Connections; ++slot )
+            {
+                const link_layer_state state = slot_state( slot );
+
+                if ( state == link_layer_state::initial || state == link_layer_state::advertising )
+                {
+                    activate( slot );
+                    link_layer().start_advertising_impl();
+
+                    return;
+                }
+            }
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        template < class Radio >
+        void concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::set_phy(
+            Radio& radio, phy_ll_encoding::phy_ll_encoding_t receiving, phy_ll_encoding::phy_ll_encoding_t transmitting, std::true_type )
+        {
+            radio.radio_set_phy( receiving, transmitting );
+        }
+
+        template < class LinkLayer, class Context, class ConnectionData, std::size_t Connections, unsigned EventLengthUs, std::size_t AdvertisingBufferSize >
+        template < class Radio >
+        void concurrent_connections_impl< LinkLayer, Context, ConnectionData, Connections, EventLengthUs, AdvertisingBufferSize >::set_phy(
+            Radio&, phy_ll_encoding::phy_ll_encoding_t, phy_ll_encoding::phy_ll_encoding_t, std::false_type )
+        {
+        }
+    }
+    /** @endcond */
+}
+}
+
+#endif
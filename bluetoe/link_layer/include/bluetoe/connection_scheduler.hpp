@@ -0,0 +1,439 @@
+#ifndef BLUETOE_LINK_LAYER_CONNECTION_SCHEDULER_HPP
+#define BLUETOE_LINK_LAYER_CONNECTION_SCHEDULER_HPP
+
+#include <bluetoe/delta_time.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace bluetoe {
+namespace link_layer {
+
+    /**
+     * @brief shares a single scheduled radio between up to Slots connections and an advertiser
+     *
+     * Every slot (a connection or the advertising, that might lead to a new connection) requests its next
+     * radio event, exactly as it would request it from a scheduled_radio that serves just a single
+     * connection: relative to the anchor of the last event of the slot. The scheduler translates the requests
+     * into the time base of the radio (relative to the anchor of the last radio event) and decides, which
+     * request is passed to the radio next.
+     *
+     * After a connection event, the anchor of the next radio event is only known within the receive window
+     * of that connection event. That uncertainty is added to the receive windows of all other connections,
+     * until they have an event on their own.
+     *
+     * If two requested events would overlap, one of them is skipped: an advertising event always yields to a
+     * connection event. Of two connection events, the event of the connection that is closer to its
+     * supervision timeout takes place. The ratio of the time since the last event to the supervision timeout
+     * is used to compare connections with different timeouts. If both connections have the same ratio, the
+     * earlier event takes place.
+     */
+    template < std::size_t Slots >
+    class connection_scheduler
+    {
+    public:
+        static_assert( Slots > 0, "at least one slot is required" );
+
+        /**
+         * @brief slot identifier that does not denote a slot
+         */
+        static constexpr unsigned invalid_slot = Slots;
+
+        /**
+         * @brief the next thing to do, returned by next_event()
+         */
+        struct event
+        {
+            enum kind_t {
+                /** nothing requested or the radio is busy */
+                none,
+                /** pass the connection event to the radio */
+                connection_event,
+                /** pass the advertising event to the radio */
+                advertising_event,
+                /** handle the connection event, as if the central would not have answered */
+                skipped_connection_event,
+                /** handle the advertising event, as if it timed out */
+                skipped_advertising_event
+            };
+
+            kind_t      kind;
+
+            /**
+             * @brief the requesting slot
+             */
+            unsigned    slot;
+
+            /**
+             * @brief start of the receive window or the start of the advertising event, relative to the anchor of the last radio event
+             */
+            delta_time  start;
+
+            /**
+             * @brief end of the receive window, relative to the anchor of the last radio event
+             */
+            delta_time  end;
+        };
+
+        /**
+         * @param event_length the time reserved for every connection event, after the end of its receive window
+         */
+        explicit connection_scheduler( delta_time event_length );
+
+        /**
+         * @brief request a connection event with the given receive window for a slot
+         *
+         * start and end are relative to the anchor of the last connection event of the slot. For the first
+         * connection event, they are relative to the advertising event, that lead to the connection.
+         *
+         * @pre slot != dispatched()
+         */
+        void request_connection_event( unsigned slot, delta_time start, delta_time end, delta_time supervision_timeout );
+
+        /**
+         * @brief request an advertising event for a slot
+         *
+         * when is relative to the last advertising event of the slot, or relative to the anchor of the last
+         * radio event, if the slot was not advertising before.
+         *
+         * @pre slot != dispatched()
+         */
+        void request_advertising_event( unsigned slot, delta_time when );
+
+        /**
+         * @brief removes a pending request of the slot
+         *
+         * @pre slot != dispatched()
+         */
+        void cancel( unsigned slot );
+
+        /**
+         * @brief returns the next event to be passed to the radio or the next request to be skipped
+         *
+         * If an event is passed to the radio, no further event is returned, until the radio reported
+         * the end of the event by a call to advertising_event_done(), connection_event_timed_out(),
+         * connection_event_ended() or withdraw().
+         *
+         * A request that is skipped is removed. It's up to the requester to request the next event.
+         */
+        event next_event();
+
+        /**
+         * @brief the slot of the event that was passed to the radio, or invalid_slot
+         */
+        unsigned dispatched() const;
+
+        /**
+         * @brief the dispatched advertising event is over (timeout or a received PDU)
+         */
+        void advertising_event_done();
+
+        /**
+         * @brief the dispatched connection event timed out
+         */
+        void connection_event_timed_out();
+
+        /**
+         * @brief the dispatched connection event took place
+         */
+        void connection_event_ended();
+
+        /**
+         * @brief the dispatched connection event was disarmed from the radio
+         */
+        void withdraw();
+
+        /**
+         * @brief translates a time relative to the anchor of the last radio event into a time
+         *        relative to the anchor of the slot.
+         */
+        delta_time radio_to_slot_time( unsigned slot, delta_time radio_time ) const;
+
+        /**
+         * @brief translates a time relative to the anchor of the slot into a time relative
+         *        to the anchor of the last radio event.
+         */
+        delta_time slot_to_radio_time( unsigned slot, delta_time slot_time ) const;
+
+    private:
+        enum class request_t : std::uint8_t {
+            none,
+            connection_event,
+            advertising_event
+        };
+
+        struct slot_t
+        {
+            request_t       request;
+            // requested times, relative to the anchor of the slot
+            std::int32_t    start;
+            std::int32_t    end;
+            std::int32_t    supervision_timeout;
+            // anchor of the slot and its uncertainty, relative to the anchor of the last radio event
+            std::int32_t    anchor;
+            std::int32_t    uncertainty;
+            // the last request of the slot was an advertising event
+            bool            advertising;
+        };
+
+        std::int32_t radio_start( const slot_t& ) const;
+        std::int32_t radio_end( const slot_t& ) const;
+        unsigned more_urgent( unsigned first, unsigned second ) const;
+        void move_anchors( std::int32_t distance );
+        event skip( unsigned slot );
+
+        static delta_time to_delta_time( std::int32_t );
+
+        const std::int32_t  event_length_;
+        slot_t              slots_[ Slots ];
+        unsigned            dispatched_;
+        std::int32_t        dispatched_start_;
+        std::int32_t        dispatched_end_;
+    };
+
+    // implementation
+    template < std::size_t Slots >
+    connection_scheduler< Slots >::connection_scheduler( delta_time event_length )
+        : event_length_( static_cast< std::int32_t >( event_length.usec() ) )
+        , dispatched_( invalid_slot )
+        , dispatched_start_( 0 )
+        , dispatched_end_( 0 )
+    {
+        for ( auto& slot: slots_ )
+            slot = slot_t{ request_t::none, 0, 0, 0, 0, 0, false };
+    }
+
+    template < std::size_t Slots >
+    void connection_scheduler< Slots >::request_connection_event( unsigned slot, delta_time start, delta_time end, delta_time supervision_timeout )
+    {
+        assert( slot < Slots );
+        assert( slot != dispatched_ );
+
+        slot_t& s = slots_[ slot ];
+        s.request               = request_t::connection_event;
+        s.advertising           = false;
+        s.start                 = static_cast< std::int32_t >( start.usec() );
+        s.end                   = static_cast< std::int32_t >( end.usec() );
+        s.supervision_timeout   = static_cast< std::int32_t >( supervision_timeout.usec() );
+    }
+
+    template < std::size_t Slots >
+    void connection_scheduler< Slots >::request_advertising_event( unsigned slot, delta_time when )
+    {
+        assert( slot < Slots );
+        assert( slot != dispatched_ );
+
+        slot_t& s = slots_[ slot ];
+
+        // a slot that starts advertising, starts at the anchor of the last radio event
+        if ( !s.advertising )
+        {
+            s.anchor      = 0;
+            s.uncertainty = 0;
+            s.advertising = true;
+        }
+
+        s.request   = request_t::advertising_event;
+        s.start     = static_cast< std::int32_t >( when.usec() );
+        s.end       = s.start;
+    }
+
+    template < std::size_t Slots >
+    void connection_scheduler< Slots >::cancel( unsigned slot )
+    {
+        assert( slot < Slots );
+        assert( slot != dispatched_ );
+
+        slots_[ slot ].request = request_t::none;
+    }
+
+    template < std::size_t Slots >
+    typename connection_scheduler< Slots >::event connection_scheduler< Slots >::next_event()
+    {
+        if ( dispatched_ != invalid_slot )
+            return event{ event::none, invalid_slot, delta_time(), delta_time() };
+
+        unsigned earliest = invalid_slot;
+
+        for ( unsigned slot = 0; slot != Slots; ++slot )
+        {
+            if ( slots_[ slot ].request != request_t::none
+              && ( earliest == invalid_slot || radio_start( slots_[ slot ] ) < radio_start( slots_[ earliest ] ) ) )
+            {
+                earliest = slot;
+            }
+        }
+
+        if ( earliest == invalid_slot )
+            return event{ event::none, invalid_slot, delta_time(), delta_time() };
+
+        const slot_t& first = slots_[ earliest ];
+
+        // a connection event, that is already over
+        if ( first.request == request_t::connection_event && radio_end( first ) < 0 )
+            return skip( earliest );
+
+        for ( unsigned slot = 0; slot != Slots; ++slot )
+        {
+            if ( slot != earliest && slots_[ slot ].request != request_t::none
+              && radio_start( slots_[ slot ] ) < radio_end( first ) + event_length_ )
+            {
+                return skip( more_urgent( earliest, slot ) == earliest ? slot : earliest );
+            }
+        }
+
+        dispatched_         = earliest;
+        dispatched_start_   = radio_start( first ) < 0 ? 0 : radio_start( first );
+        dispatched_end_     = radio_end( first ) < dispatched_start_ ? dispatched_start_ : radio_end( first );
+
+        return event{
+            first.request == request_t::connection_event ? event::connection_event : event::advertising_event,
+            earliest,
+            to_delta_time( dispatched_start_ ),
+            to_delta_time( dispatched_end_ ) };
+    }
+
+    template < std::size_t Slots >
+    unsigned connection_scheduler< Slots >::dispatched() const
+    {
+        return dispatched_;
+    }
+
+    template < std::size_t Slots >
+    void connection_scheduler< Slots >::advertising_event_done()
+    {
+        assert( dispatched_ != invalid_slot );
+        assert( slots_[ dispatched_ ].request == request_t::advertising_event );
+
+        // the radio moved its anchor to the start of the advertising event
+        move_anchors( dispatched_start_ );
+
+        slots_[ dispatched_ ].request     = request_t::none;
+        slots_[ dispatched_ ].anchor      = 0;
+        slots_[ dispatched_ ].uncertainty = 0;
+        dispatched_ = invalid_slot;
+    }
+
+    template < std::size_t Slots >
+    void connection_scheduler< Slots >::connection_event_timed_out()
+    {
+        assert( dispatched_ != invalid_slot );
+        assert( slots_[ dispatched_ ].request == request_t::connection_event );
+
+        // the anchor of the radio stays unchanged
+        slots_[ dispatched_ ].request = request_t::none;
+        dispatched_ = invalid_slot;
+    }
+
+    template < std::size_t Slots >
+    void connection_scheduler< Slots >::connection_event_ended()
+    {
+        assert( dispatched_ != invalid_slot );
+        assert( slots_[ dispatched_ ].request == request_t::connection_event );
+
+        // the radio moved its anchor to the actual anchor of the connection event, which is somewhere in the receive window
+        const std::int32_t half_window = ( dispatched_end_ - dispatched_start_ ) / 2;
+
+        move_anchors( dispatched_start_ + half_window );
+
+        for ( auto& slot: slots_ )
+            slot.uncertainty += half_window;
+
+        slots_[ dispatched_ ].request     = request_t::none;
+        slots_[ dispatched_ ].anchor      = 0;
+        slots_[ dispatched_ ].uncertainty = 0;
+        dispatched_ = invalid_slot;
+    }
+
+    template < std::size_t Slots >
+    void connection_scheduler< Slots >::withdraw()
+    {
+        assert( dispatched_ != invalid_slot );
+
+        slots_[ dispatched_ ].request = request_t::none;
+        dispatched_ = invalid_slot;
+    }
+
+    template < std::size_t Slots >
+    delta_time connection_scheduler< Slots >::radio_to_slot_time( unsigned slot, delta_time radio_time ) const
+    {
+        assert( slot < Slots );
+
+        return to_delta_time( static_cast< std::int32_t >( radio_time.usec() ) - slots_[ slot ].anchor );
+    }
+
+    template < std::size_t Slots >
+    delta_time connection_scheduler< Slots >::slot_to_radio_time( unsigned slot, delta_time slot_time ) const
+    {
+        assert( slot < Slots );
+
+        return to_delta_time( static_cast< std::int32_t >( slot_time.usec() ) + slots_[ slot ].anchor );
+    }
+
+    template < std::size_t Slots >
+    std::int32_t connection_scheduler< Slots >::radio_start( const slot_t& slot ) const
+    {
+        return slot.anchor + slot.start - slot.uncertainty;
+    }
+
+    template < std::size_t Slots >
+    std::int32_t connection_scheduler< Slots >::radio_end( const slot_t& slot ) const
+    {
+        return slot.anchor + slot.end + slot.uncertainty;
+    }
+
+    template < std::size_t Slots >
+    unsigned connection_scheduler< Slots >::more_urgent( unsigned first, unsigned second ) const
+    {
+        const slot_t& a = slots_[ first ];
+        const slot_t& b = slots_[ second ];
+
+        if ( a.request == request_t::advertising_event )
+            return b.request == request_t::advertising_event ? first : second;
+
+        if ( b.request == request_t::advertising_event )
+            return first;
+
+        // compare the time since the last event relative to the supervision timeout: since_a / timeout_a < since_b / timeout_b
+        const std::int64_t since_a = ( a.start + a.end ) / 2;
+        const std::int64_t since_b = ( b.start + b.end ) / 2;
+
+        return since_a * b.supervision_timeout < since_b * a.supervision_timeout
+            ? second
+            : first;
+    }
+
+    template < std::size_t Slots >
+    void connection_scheduler< Slots >::move_anchors( std::int32_t distance )
+    {
+        for ( auto& slot: slots_ )
+            slot.anchor -= distance;
+    }
+
+    template < std::size_t Slots >
+    typename connection_scheduler< Slots >::event connection_scheduler< Slots >::skip( unsigned slot )
+    {
+        slot_t& s = slots_[ slot ];
+        const bool advertising = s.request == request_t::advertising_event;
+
+        // the next advertising event is requested relative to the skipped one
+        if ( advertising )
+            s.anchor += s.start;
+
+        s.request = request_t::none;
+
+        return event{
+            advertising ? event::skipped_advertising_event : event::skipped_connection_event,
+            slot, delta_time(), delta_time() };
+    }
+
+    template < std::size_t Slots >
+    delta_time connection_scheduler< Slots >::to_delta_time( std::int32_t time )
+    {
+        return delta_time( time < 0 ? 0 : static_cast< std::uint32_t >( time ) );
+    }
+}
+}
+
+#endif
@@ -13,6 +13,7 @@
 #include <bluetoe/connection_event_callback.hpp>
 #include <bluetoe/l2cap_signaling_channel.hpp>
 #include <bluetoe/white_list.hpp>
+#include <bluetoe/resolving_list.hpp>
 #include <bluetoe/advertising.hpp>
 #include <bluetoe/attribute.hpp>
 #include <bluetoe/meta_types.hpp>
@@ -23,6 +24,7 @@
 #include <bluetoe/l2cap.hpp>
 #include <bluetoe/connection_events.hpp>
 #include <bluetoe/peripheral_latency.hpp>
+#include <bluetoe/concurrent_connections.hpp>
 
 #include <algorithm>
 #include <cassert>
@@ -106,6 +108,17 @@ namespace link_layer {
             typedef typename list::template impl< Radio, LinkLayer > type;
         };
 
+        template < typename Radio, typename LinkLayer, typename ... Options >
+        struct resolving_list
+        {
+            typedef typename bluetoe::details::find_by_meta_type<
+                resolving_list_meta_type,
+                Options...,
+                no_resolving_list >::type list;
+
+            typedef typename list::template impl< Radio, LinkLayer > type;
+        };
+
         /*
          * The Part of link layer, that handles security related stuff is
          * factored out, to not have unnessary code, in case that no
@@ -150,7 +163,7 @@ namespace link_layer {
                               std::uint32_t ivs  = 0;
 
                         bluetoe::details::uint128_t key;
-                        std::tie( has_key_, key ) = that().connection_data_.find_key( ediv, rand );
+                        std::tie( has_key_, key ) = that().current_connection_data().find_key( ediv, rand );
 
                         // setup encryption
                         std::tie( skds, ivs ) = that().setup_encryption( key, skdm, ivm );
@@ -163,22 +176,22 @@ namespace link_layer {
                     {
                         fill< layout_t >( write, { LinkLayer::ll_control_pdu_code, 1, LinkLayer::LL_START_ENC_RSP } );
                         that().start_transmit_encrypted();
-                        encryption_changed = that().connection_data_.is_encrypted( true );
+                        encryption_changed = that().current_connection_data().is_encrypted( true );
 
                         if ( encryption_changed )
-                            that().connection_data_.restore_bonded_cccds( that().connection_data_ );
+                            that().current_connection_data().restore_bonded_cccds( that().current_connection_data() );
 
                     }
                     else if ( opcode == LinkLayer::LL_PAUSE_ENC_REQ && size == 1 )
                     {
                         fill< layout_t >( write, { LinkLayer::ll_control_pdu_code, 1, LinkLayer::LL_PAUSE_ENC_RSP } );
                         that().stop_receive_encrypted();
-                        encryption_changed = that().connection_data_.is_encrypted( false );
+                        encryption_changed = that().current_connection_data().is_encrypted( false );
                     }
                     else if ( opcode == LinkLayer::LL_PAUSE_ENC_RSP && size == 1 )
                     {
                         that().stop_transmit_encrypted();
-                        encryption_changed = that().connection_data_.is_encrypted( false );
+                        encryption_changed = that().current_connection_data().is_encrypted( false );
 
                         commit = false;
                     }
@@ -189,8 +202,8 @@ namespace link_layer {
 
                     if ( encryption_changed )
                     {
-                        that().connection_data_.pairing_status(that().connection_data_.local_device_pairing_status());
-                        that().connection_changed( that().details(), that().connection_data_, static_cast< typename LinkLayer::radio_t& >( that() ) );
+                        that().current_connection_data().pairing_status(that().current_connection_data().local_device_pairing_status());
+                        that().connection_changed( that().details(), that().current_connection_data(), static_cast< typename LinkLayer::radio_t& >( that() ) );
                     }
 
                     return true;
@@ -226,7 +239,7 @@ namespace link_layer {
 
                 void reset_encryption()
                 {
-                    that().connection_data_.is_encrypted( false );
+                    that().current_connection_data().is_encrypted( false );
                     that().stop_receive_encrypted();
                     that().stop_transmit_encrypted();
                 }
@@ -324,6 +337,7 @@ namespace link_layer {
                     const auto p_to_c = static_cast< phy_ll_encoding::phy_ll_encoding_t >( pdu_body[ 2 ] );
                     link_layer.defered_ll_control_pdu_ = { nullptr, 0 };
                     link_layer.radio_set_phy( c_to_p, p_to_c );
+                    link_layer.phy_changed( c_to_p, p_to_c, link_layer );
 
                     return true;
                 }
@@ -365,6 +379,257 @@ namespace link_layer {
             {}
         };
 
+        /*
+         * The Part of link layer, that handles the LE Data Length Update procedure
+         */
+        template < class Option >
+        class data_length_update_impl
+        {
+        public:
+            data_length_update_impl()
+                : length_request_pending_( false )
+            {
+                reset_effective_lengths();
+            }
+
+            /**
+             * @brief maximum number of LL payload octets, the link layer currently transmits in a single PDU
+             */
+            std::uint16_t connection_max_tx_octets() const
+            {
+                return max_tx_octets_;
+            }
+
+            /**
+             * @brief maximum time in µs, the link layer currently uses to transmit a single PDU
+             */
+            std::uint16_t connection_max_tx_time() const
+            {
+                return max_tx_time_;
+            }
+
+            /**
+             * @brief maximum number of LL payload octets, the link layer currently expects in a single received PDU
+             */
+            std::uint16_t connection_max_rx_octets() const
+            {
+                return max_rx_octets_;
+            }
+
+            /**
+             * @brief maximum time in µs, the link layer currently expects the central to use for a single PDU
+             */
+            std::uint16_t connection_max_rx_time() const
+            {
+                return max_rx_time_;
+            }
+
+            /** @cond HIDDEN_SYMBOLS */
+            template < class LL >
+            bool handle_length_request( std::uint8_t opcode, std::uint8_t size, const write_buffer& pdu, read_buffer& write, LL& link_layer, bool& commit )
+            {
+                using layout_t = typename pdu_layout_by_radio< typename LL::radio_t >::pdu_layout;
+
+                if ( ( opcode != LL::LL_LENGTH_REQ && opcode != LL::LL_LENGTH_RSP ) || size != 9 )
+                    return false;
+
+                store_remote_lengths( layout_t::body( pdu ).first );
+                update_effective_lengths( link_layer );
+
+                if ( opcode == LL::LL_LENGTH_REQ )
+                {
+                    fill_length_pdu( write, LL::LL_LENGTH_RSP, link_layer );
+                }
+                else
+                {
+                    commit = false;
+                }
+
+                return true;
+            }
+
+            template < class LL >
+            void transmit_pending_length_request( LL& link_layer )
+            {
+                if ( !length_request_pending_ )
+                    return;
+
+                if ( ( link_layer.used_features_ & LL::link_layer_feature::le_data_packet_length_extension ) == 0 )
+                {
+                    length_request_pending_ = false;
+                    return;
+                }
+
+                auto out_buffer = link_layer.allocate_ll_transmit_buffer( LL::maximum_ll_payload_size );
+                if ( out_buffer.empty() )
+                    return;
+
+                fill_length_pdu( out_buffer, LL::LL_LENGTH_REQ, link_layer );
+                link_layer.commit_ll_transmit_buffer( out_buffer );
+
+                length_request_pending_ = false;
+            }
+
+            template < class LL >
+            void phy_changed( phy_ll_encoding::phy_ll_encoding_t c_to_p, phy_ll_encoding::phy_ll_encoding_t p_to_c, LL& link_layer )
+            {
+                if ( c_to_p != phy_ll_encoding::le_unchanged_coding )
+                    rx_phy_ = c_to_p;
+
+                if ( p_to_c != phy_ll_encoding::le_unchanged_coding )
+                    tx_phy_ = p_to_c;
+
+                // the time limits stay, but translate into a different number of octets
+                update_effective_lengths( link_layer );
+            }
+
+            template < class LL >
+            void reset_data_length( LL& link_layer )
+            {
+                reset_effective_lengths();
+
+                // only worth the effort, if the buffers can hold larger PDUs at all
+                length_request_pending_ =
+                    supported_max_tx_octets( link_layer ) > minimum_octets
+                 || supported_max_rx_octets( link_layer ) > minimum_octets;
+            }
+            /** @endcond */
+
+        private:
+            static constexpr std::uint16_t minimum_octets   = 27;
+            static constexpr std::uint16_t minimum_time     = 328;
+
+            // PDU with preamble, access address, header, payload, MIC and CRC: the preamble is
+            // 1 octet long on the LE 1M PHY and 2 octets long on the LE 2M PHY, that transmits
+            // an octet in 4µs instead of 8µs
+            static constexpr std::uint16_t octets_to_time( std::uint16_t octets, phy_ll_encoding::phy_ll_encoding_t phy )
+            {
+                return phy == phy_ll_encoding::le_2m_phy
+                    ? static_cast< std::uint16_t >( ( octets + 15 ) * 4 )
+                    : static_cast< std::uint16_t >( ( octets + 14 ) * 8 );
+            }
+
+            static constexpr std::uint16_t time_to_octets( std::uint16_t time, phy_ll_encoding::phy_ll_encoding_t phy )
+            {
+                return phy == phy_ll_encoding::le_2m_phy
+                    ? static_cast< std::uint16_t >( time / 4 - 15 )
+                    : static_cast< std::uint16_t >( time / 8 - 14 );
+            }
+
+            static constexpr std::uint16_t at_least( std::uint16_t value, std::uint16_t minimum )
+            {
+                return value < minimum ? minimum : value;
+            }
+
+            template < class LL >
+            static std::uint16_t supported_max_tx_octets( const LL& link_layer )
+            {
+                return static_cast< std::uint16_t >( std::min< std::size_t >(
+                    Option::max_tx_octets, link_layer.max_max_tx_size() - LL::radio_t::header_size ) );
+            }
+
+            template < class LL >
+            static std::uint16_t supported_max_rx_octets( const LL& link_layer )
+            {
+                return static_cast< std::uint16_t >( std::min< std::size_t >(
+                    Option::max_rx_octets, link_layer.max_max_rx_size() - LL::radio_t::header_size ) );
+            }
+
+            template < class LL >
+            void fill_length_pdu( read_buffer& output, std::uint8_t opcode, const LL& link_layer ) const
+            {
+                using layout_t = typename pdu_layout_by_radio< typename LL::radio_t >::pdu_layout;
+
+                const std::uint16_t rx_octets = supported_max_rx_octets( link_layer );
+                const std::uint16_t tx_octets = supported_max_tx_octets( link_layer );
+                const std::uint16_t rx_time   = at_least( octets_to_time( rx_octets, rx_phy_ ), minimum_time );
+                const std::uint16_t tx_time   = at_least( octets_to_time( tx_octets, tx_phy_ ), minimum_time );
+
+                fill< layout_t >( output, {
+                    LL::ll_control_pdu_code, 9, opcode,
+                    static_cast< std::uint8_t >( rx_octets ), static_cast< std::uint8_t >( rx_octets >> 8 ),
+                    static_cast< std::uint8_t >( rx_time ),   static_cast< std::uint8_t >( rx_time >> 8 ),
+                    static_cast< std::uint8_t >( tx_octets ), static_cast< std::uint8_t >( tx_octets >> 8 ),
+                    static_cast< std::uint8_t >( tx_time ),   static_cast< std::uint8_t >( tx_time >> 8 ) } );
+            }
+
+            void store_remote_lengths( const std::uint8_t* body )
+            {
+                using bluetoe::details::read_16bit;
+
+                // values below the minimum are not valid and treated as the minimum
+                remote_rx_octets_ = at_least( read_16bit( &body[ 1 ] ), minimum_octets );
+                remote_rx_time_   = at_least( read_16bit( &body[ 3 ] ), minimum_time );
+                remote_tx_octets_ = at_least( read_16bit( &body[ 5 ] ), minimum_octets );
+                remote_tx_time_   = at_least( read_16bit( &body[ 7 ] ), minimum_time );
+            }
+
+            template < class LL >
+            void update_effective_lengths( LL& link_layer )
+            {
+                const std::uint16_t local_tx_octets  = supported_max_tx_octets( link_layer );
+                const std::uint16_t local_rx_octets  = supported_max_rx_octets( link_layer );
+
+                max_tx_time_   = std::min( at_least( octets_to_time( local_tx_octets, tx_phy_ ), minimum_time ), remote_rx_time_ );
+                max_rx_time_   = std::min( at_least( octets_to_time( local_rx_octets, rx_phy_ ), minimum_time ), remote_tx_time_ );
+                max_tx_octets_ = at_least( std::min( { local_tx_octets, remote_rx_octets_, time_to_octets( max_tx_time_, tx_phy_ ) } ), minimum_octets );
+                max_rx_octets_ = at_least( std::min( { local_rx_octets, remote_tx_octets_, time_to_octets( max_rx_time_, rx_phy_ ) } ), minimum_octets );
+
+                link_layer.max_tx_size( max_tx_octets_ + LL::radio_t::header_size );
+                link_layer.max_rx_size( max_rx_octets_ + LL::radio_t::header_size );
+            }
+
+            void reset_effective_lengths()
+            {
+                max_tx_octets_    = minimum_octets;
+                max_rx_octets_    = minimum_octets;
+                max_tx_time_      = minimum_time;
+                max_rx_time_      = minimum_time;
+                remote_tx_octets_ = minimum_octets;
+                remote_rx_octets_ = minimum_octets;
+                remote_tx_time_   = minimum_time;
+                remote_rx_time_   = minimum_time;
+                tx_phy_           = phy_ll_encoding::le_1m_phy;
+                rx_phy_           = phy_ll_encoding::le_1m_phy;
+            }
+
+            std::uint16_t   max_tx_octets_;
+            std::uint16_t   max_tx_time_;
+            std::uint16_t   max_rx_octets_;
+            std::uint16_t   max_rx_time_;
+            std::uint16_t   remote_tx_octets_;
+            std::uint16_t   remote_tx_time_;
+            std::uint16_t   remote_rx_octets_;
+            std::uint16_t   remote_rx_time_;
+            phy_ll_encoding::phy_ll_encoding_t tx_phy_;
+            phy_ll_encoding::phy_ll_encoding_t rx_phy_;
+            bool            length_request_pending_;
+        };
+
+        struct no_data_length_update_impl
+        {
+            template < class LL >
+            bool handle_length_request( std::uint8_t, std::uint8_t, const write_buffer&, read_buffer&, LL&, bool& )
+            {
+                return false;
+            }
+
+            template < class LL >
+            void transmit_pending_length_request( LL& )
+            {
+            }
+
+            template < class LL >
+            void phy_changed( phy_ll_encoding::phy_ll_encoding_t, phy_ll_encoding::phy_ll_encoding_t, LL& )
+            {
+            }
+
+            template < class LL >
+            void reset_data_length( LL& )
+            {
+            }
+        };
+
         template < class Server, class LinkLayer >
         using select_link_layer_security_impl =
             typename bluetoe::details::select_type<
@@ -389,6 +654,20 @@ namespace link_layer {
                 no_phy_update_request_impl
             >::type;
 
+        template < typename ... Options >
+        using data_length_extension_option = typename bluetoe::details::find_by_meta_type<
+            data_length_extension_meta_type,
+            Options...,
+            no_data_length_extension >::type;
+
+        template < typename ... Options >
+        using select_data_length_update_impl =
+            typename bluetoe::details::select_type<
+                data_length_extension_option< Options... >::enabled,
+                data_length_update_impl< data_length_extension_option< Options... > >,
+                no_data_length_update_impl
+            >::type;
+
         template <
             class Server,
             template <
@@ -428,6 +707,107 @@ namespace link_layer {
             Options...,
             no_synchronized_connection_event_callback
         >::type::template impl< Base >;
+
+        /*
+         * The link layer state of a single connection. Factored out, so that a link layer, that
+         * serves more than one connection, can park it, while an other connection is active.
+         */
+        struct link_layer_connection_state
+        {
+            link_layer_connection_state()
+                : defered_ll_control_pdu_{ nullptr, 0 }
+                , state_( link_layer_state::initial )
+                , connection_parameters_request_pending_( false )
+                , connection_parameters_request_running_( false )
+                , phy_update_request_pending_( false )
+            {
+            }
+
+            // a link layer control procedure waits for its instant or for the response of the central
+            bool control_procedure_pending() const
+            {
+                return defered_ll_control_pdu_.size != 0
+                    || connection_parameters_request_pending_
+                    || connection_parameters_request_running_
+                    || phy_update_request_pending_;
+            }
+
+            channel_map                     channels_;
+            unsigned                        cumulated_sleep_clock_accuracy_;
+            delta_time                      transmit_window_offset_;
+            delta_time                      transmit_window_size_;
+            delta_time                      connection_interval_;
+            std::uint16_t                   peripheral_latency_;
+            std::uint16_t                   timeout_value_;
+            delta_time                      connection_timeout_;
+            std::uint16_t                   defered_conn_event_counter_;
+            write_buffer                    defered_ll_control_pdu_;
+            bool                            termination_send_;
+            std::uint8_t                    used_features_;
+            bool                            pending_event_;
+            link_layer_state                state_;
+
+            std::uint16_t                   proposed_interval_min_;
+            std::uint16_t                   proposed_interval_max_;
+            std::uint16_t                   proposed_latency_;
+            std::uint16_t                   proposed_timeout_;
+            bool                            connection_parameters_request_pending_;
+            bool                            connection_parameters_request_running_;
+            bool                            phy_update_request_pending_;
+        };
+
+        template <
+            class Server,
+            template <
+                std::size_t TransmitSize,
+                std::size_t ReceiveSize,
+                class CallBack
+            >
+            class ScheduledRadio,
+            typename ... Options
+        >
+        struct concurrent_connections
+        {
+            using link_layer_t  = link_layer< Server, ScheduledRadio, Options... >;
+            using radio_t       = ScheduledRadio<
+                buffer_sizes< Options... >::tx_size,
+                buffer_sizes< Options... >::rx_size,
+                link_layer_t >;
+            using sdu_buffer_t  = ll_l2cap_sdu_buffer<
+                radio_t,
+                l2cap_layer< Server, ScheduledRadio, Options... >::required_minimum_l2cap_buffer_size,
+                Options... >;
+            using option        = concurrent_connections_option< Options... >;
+
+            using context = connection_context<
+                link_layer_connection_state,
+                connection_latency_state_t< Options... >,
+                select_data_length_update_impl< Options... >,
+                select_link_layer_security_impl< Server, link_layer_t >,
+                typename signaling_channel< Options... >::type,
+                typename sdu_buffer_t::sdu_buffer_state,
+                typename radio_encryption_context< radio_t >::type >;
+
+            using type = concurrent_connections_impl<
+                link_layer_t,
+                context,
+                typename l2cap_layer< Server, ScheduledRadio, Options... >::impl::connection_data_t,
+                option::connections,
+                option::event_length_us,
+                sdu_buffer_t::size >;
+        };
+
+        template <
+            class Server,
+            template <
+                std::size_t TransmitSize,
+                std::size_t ReceiveSize,
+                class CallBack
+            >
+            class ScheduledRadio,
+            typename ... Options
+        >
+        using select_concurrent_connections_impl = typename concurrent_connections< Server, ScheduledRadio, Options... >::type;
     }
 
     /**
@@ -439,6 +819,8 @@ namespace link_layer {
      * @sa connectable_directed_advertising
      * @sa scannable_undirected_advertising
      * @sa non_connectable_undirected_advertising
+     * @sa non_connectable_extended_advertising
+     * @sa periodic_advertising
      * @sa auto_start_advertising
      * @sa no_auto_start_advertising
      */
@@ -459,7 +841,8 @@ namespace link_layer {
                 details::buffer_sizes< Options... >::rx_size,
                 link_layer< Server, ScheduledRadio, Options... >
             >,
-            details::l2cap_layer< Server, ScheduledRadio, Options... >::required_minimum_l2cap_buffer_size
+            details::l2cap_layer< Server, ScheduledRadio, Options... >::required_minimum_l2cap_buffer_size,
+            Options...
         >,
         public details::white_list<
             bluetoe::link_layer::ll_l2cap_sdu_buffer<
@@ -468,7 +851,20 @@ namespace link_layer {
                     details::buffer_sizes< Options... >::rx_size,
                     link_layer< Server, ScheduledRadio, Options... >
                 >,
-                details::l2cap_layer< Server, ScheduledRadio, Options... >::required_minimum_l2cap_buffer_size
+                details::l2cap_layer< Server, ScheduledRadio, Options... >::required_minimum_l2cap_buffer_size,
+                Options...
+            >,
+            link_layer< Server, ScheduledRadio, Options... >,
+            Options... >::type,
+        public details::resolving_list<
+            bluetoe::link_layer::ll_l2cap_sdu_buffer<
+                ScheduledRadio<
+                    details::buffer_sizes< Options... >::tx_size,
+                    details::buffer_sizes< Options... >::rx_size,
+                    link_layer< Server, ScheduledRadio, Options... >
+                >,
+                details::l2cap_layer< Server, ScheduledRadio, Options... >::required_minimum_l2cap_buffer_size,
+                Options...
             >,
             link_layer< Server, ScheduledRadio, Options... >,
             Options... >::type,
@@ -485,7 +881,10 @@ namespace link_layer {
                 link_layer< Server, ScheduledRadio, Options... >
             > >,
         public details::select_user_timer_impl<
-            link_layer< Server, ScheduledRadio, Options... >, Options ... >
+            link_layer< Server, ScheduledRadio, Options... >, Options ... >,
+        public details::select_data_length_update_impl< Options... >,
+        private details::link_layer_connection_state,
+        private details::select_concurrent_connections_impl< Server, ScheduledRadio, Options... >
     {
     public:
         link_layer();
@@ -552,7 +951,7 @@ namespace link_layer {
         /**
          * @brief fills the given buffer with l2cap advertising payload
          */
-        std::size_t fill_l2cap_advertising_data( std::uint8_t* buffer, std::size_t buffer_size ) const;
+        std::size_t fill_l2cap_advertising_data( std::uint8_t* buffer, std::size_t buffer_size );
 
         /**
          * @brief fills the given buffer with l2cap scan response payload
@@ -587,6 +986,33 @@ namespace link_layer {
         // will cause the link layer to inform the user callbacks that a connection event happend
         void restart_user_timer();
 
+        // access to the radio by the link layer and the advertiser; routed through the connection scheduling,
+        // if more than one connection is supported
+        void schedule_advertisment(
+            unsigned                                    channel,
+            const write_buffer&                         advertising_data,
+            const write_buffer&                         response_data,
+            delta_time                                  when,
+            const read_buffer&                          receive );
+
+        delta_time schedule_connection_event(
+            unsigned                                    channel,
+            delta_time                                  start_receive,
+            delta_time                                  end_receive,
+            delta_time                                  connection_interval );
+
+        std::pair< bool, delta_time > disarm_connection_event();
+        void set_access_address_and_crc_init( std::uint32_t access_address, std::uint32_t crc_init );
+        void radio_set_phy( details::phy_ll_encoding::phy_ll_encoding_t receiving_encoding, details::phy_ll_encoding::phy_ll_encoding_t transmiting_encoding );
+        std::uint8_t* raw_pdu_buffer();
+
+        // indicated in connectable advertising PDUs
+        static constexpr bool channel_selection_algorithm_2_supported =
+            ::bluetoe::details::find_by_meta_type<
+                details::channel_selection_algorithm_meta_type,
+                Options...,
+                no_channel_selection_algorithm_2 >::type::supported;
+
         /** @endcond */
 
     private:
@@ -597,6 +1023,11 @@ namespace link_layer {
                 details::buffer_sizes< Options... >::rx_size,
                 link_layer< Server, ScheduledRadio, Options... >
             > >;
+        friend details::select_data_length_update_impl< Options... >;
+        friend details::select_concurrent_connections_impl< Server, ScheduledRadio, Options... >;
+
+        using concurrent_connections_t  = details::select_concurrent_connections_impl< Server, ScheduledRadio, Options... >;
+        using connection_context_t      = typename details::concurrent_connections< Server, ScheduledRadio, Options... >::context;
 
         static_assert(
             std::is_same<
@@ -611,6 +1042,20 @@ namespace link_layer {
         static_assert( !encryption_required || ( encryption_required && radio_t::hardware_supports_encryption ),
             "The GATT server requires encryption while the selecte hardware binding doesn't provide support for encryption!" );
 
+        // encryption of more than one connection requires the radio to park the encryption state of a connection
+        static_assert( concurrent_connections_t::number_of_connections == 1 || !encryption_required
+            || !std::is_same< typename details::radio_encryption_context< radio_t >::type, details::no_encryption_context >::value,
+            "max_concurrent_connections<> with encryption requires the radio to provide encryption_context, store_encryption_context() and restore_encryption_context()" );
+
+        // the synchronized connection event callback is bound to the timing of a single connection
+        static_assert( concurrent_connections_t::number_of_connections == 1 || std::is_same<
+                typename ::bluetoe::details::find_by_meta_type<
+                    details::synchronized_connection_event_callback_meta_type,
+                    Options...,
+                    no_synchronized_connection_event_callback >::type,
+                no_synchronized_connection_event_callback >::value,
+            "synchronized_connection_event_callback<> can not be combined with max_concurrent_connections<>" );
+
         using security_manager_t = typename details::security_manager<
                 link_layer< Server, ScheduledRadio, Options... >,
                 Server, Options...
@@ -618,6 +1063,16 @@ namespace link_layer {
 
         using signaling_channel_t = typename details::signaling_channel< Options... >::type;
 
+        static constexpr bool precompute_security_keys_enabled = !std::is_same<
+            typename bluetoe::details::find_by_meta_type<
+                bluetoe::details::ecdh_key_pool_meta_type,
+                Options...,
+                bluetoe::details::no_ecdh_key_pool >::type,
+            bluetoe::details::no_ecdh_key_pool >::value;
+
+        void precompute_security_keys( std::true_type );
+        void precompute_security_keys( std::false_type );
+
         using advertising_t = details::select_advertiser_implementation<
             link_layer< Server, ScheduledRadio, Options... >, Options... >;
 
@@ -628,7 +1083,12 @@ namespace link_layer {
         void force_disconnect();
         void start_advertising_impl();
         delta_time setup_next_connection_event();
+        void handle_connection_event_timeout();
+        void transmit_pending_output();
         void transmit_pending_control_pdus();
+        void set_connection_access_address_and_crc_init( std::uint32_t access_address, std::uint32_t crc_init );
+        void store_connection( connection_context_t& context ) const;
+        void restore_connection( const connection_context_t& context );
         void reject( std::uint8_t opcode, std::uint8_t error_code, read_buffer& output );
 
         enum class ll_result {
@@ -670,6 +1130,8 @@ namespace link_layer {
         static constexpr std::uint8_t   LL_REJECT_IND_EXT           = 0x11;
         static constexpr std::uint8_t   LL_PING_REQ                 = 0x12;
         static constexpr std::uint8_t   LL_PING_RSP                 = 0x13;
+        static constexpr std::uint8_t   LL_LENGTH_REQ               = 0x14;
+        static constexpr std::uint8_t   LL_LENGTH_RSP               = 0x15;
         static constexpr std::uint8_t   LL_PHY_REQ                  = 0x16;
         static constexpr std::uint8_t   LL_PHY_RSP                  = 0x17;
         static constexpr std::uint8_t   LL_PHY_UPDATE_IND           = 0x18;
@@ -696,6 +1158,9 @@ namespace link_layer {
             link_layer_feature::connection_parameters_request_procedure |
             link_layer_feature::extended_reject_indication |
             link_layer_feature::le_ping |
+            ( details::data_length_extension_option< Options... >::enabled
+                ? link_layer_feature::le_data_packet_length_extension
+                : 0 ) |
             ( bluetoe::details::requires_encryption_support_t< Server >::value
                 ? link_layer_feature::le_encryption
                 : 0 );
@@ -706,41 +1171,12 @@ namespace link_layer {
         // TODO: calculate the maximum required LL buffer size based on the supported features
         static constexpr std::size_t    maximum_ll_payload_size = 27u;
 
+        // the state of a connection is kept in details::link_layer_connection_state
+        using state = details::link_layer_state;
+
         const device_address            address_;
-        channel_map                     channels_;
-        unsigned                        cumulated_sleep_clock_accuracy_;
-        delta_time                      transmit_window_offset_;
-        delta_time                      transmit_window_size_;
-        delta_time                      connection_interval_;
-        std::uint16_t                   peripheral_latency_;
-        std::uint16_t                   timeout_value_;
-        delta_time                      connection_timeout_;
-        std::uint16_t                   defered_conn_event_counter_;
-        write_buffer                    defered_ll_control_pdu_;
-        connection_data_t               connection_data_;
-        bool                            termination_send_;
-        std::uint8_t                    used_features_;
-        bool                            pending_event_;
         volatile bool                   restart_user_timer_requested_;
 
-        enum class state
-        {
-            initial,
-            advertising,
-            connecting,
-            connected,
-            disconnecting,
-            connection_changed
-        }                               state_;
-
-        std::uint16_t                   proposed_interval_min_;
-        std::uint16_t                   proposed_interval_max_;
-        std::uint16_t                   proposed_latency_;
-        std::uint16_t                   proposed_timeout_;
-        bool                            connection_parameters_request_pending_;
-        bool                            connection_parameters_request_running_;
-        bool                            phy_update_request_pending_;
-
         // default configuration parameters
         typedef                         advertising_interval< 100 >         default_advertising_interval;
         typedef                         sleep_clock_accuracy_ppm< 500 >     default_sleep_clock_accuracy;
@@ -765,14 +1201,10 @@ namespace link_layer {
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
     link_layer< Server, ScheduledRadio, Options... >::link_layer()
         : address_( local_device_address::address( *this ) )
-        , defered_ll_control_pdu_{ nullptr, 0 }
-        , used_features_( supported_features )
         , restart_user_timer_requested_( false )
-        , state_( state::initial )
-        , connection_parameters_request_pending_( false )
-        , connection_parameters_request_running_( false )
-        , phy_update_request_pending_( false )
     {
+        used_features_ = supported_features;
+
         using user_timer_t = typename bluetoe::details::find_by_meta_type<
             details::synchronized_connection_event_callback_meta_type,
             Options...,
@@ -798,15 +1230,56 @@ namespace link_layer {
             start_advertising_impl();
         }
 
+        this->dispatch_radio_event();
+
         radio_t::run();
 
+        transmit_pending_output();
+
+        // use the remaining time until the next radio event to precompute expensive keys
+        precompute_security_keys( std::integral_constant< bool, precompute_security_keys_enabled >() );
+
+        this->template handle_connection_events< link_layer< Server, ScheduledRadio, Options... > >();
+
+        this->dispatch_radio_event();
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::transmit_pending_output()
+    {
         if ( state_ == state::connected )
         {
-            this->transmit_pending_l2cap_output( connection_data_ );
+            // SDUs, that did not fit into the transmit buffer, when they were committed
+            this->commit_pending_l2cap_transmit_buffers();
+            this->transmit_pending_l2cap_output( this->current_connection_data() );
             transmit_pending_control_pdus();
         }
+    }
 
-        this->template handle_connection_events< link_layer< Server, ScheduledRadio, Options... > >();
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::precompute_security_keys( std::true_type )
+    {
+        // A key pair is generated in one piece, which blocks the link layer for the whole P-256 key generation.
+        // To not delay responses, no key pair is generated while a connection is pairing or runs a link layer
+        // control procedure.
+        for ( std::size_t slot = 0; slot != concurrent_connections_t::number_of_connections; ++slot )
+        {
+            const details::link_layer_connection_state& connection = this->slot_connection_state( slot );
+
+            if ( details::is_connection_state( connection.state_ )
+              && ( connection.control_procedure_pending()
+                || this->security_manager_t::pairing_in_progress( this->slot_connection_data( slot ) ) ) )
+            {
+                return;
+            }
+        }
+
+        this->security_manager_t::precompute_security_keys();
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::precompute_security_keys( std::false_type )
+    {
     }
 
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
@@ -814,6 +1287,8 @@ namespace link_layer {
     {
         using namespace ::bluetoe::details;
 
+        this->advertising_event_done();
+
         assert( state_ == state::advertising );
 
         device_address remote_address;
@@ -821,9 +1296,16 @@ namespace link_layer {
 
         if ( connection_request_received )
         {
-            const std::uint8_t* const body = layout_t::body( receive ).first;
+            static constexpr std::uint16_t chsel_field = 0x20;
 
-            if ( channels_.reset( &body[ 28 ], body[ 33 ] & 0x1f )
+            const std::uint8_t* const body     = layout_t::body( receive ).first;
+            const bool                use_csa2 = channel_selection_algorithm_2_supported && ( layout_t::header( receive ) & chsel_field );
+
+            const bool valid_channel_map = use_csa2
+                ? channels_.reset_algorithm_2( &body[ 28 ], read_32bit( &body[ 12 ] ) )
+                : channels_.reset( &body[ 28 ], body[ 33 ] & 0x1f );
+
+            if ( valid_channel_map
               && parse_timing_parameters_from_connect_request( body ) )
             {
                 this->reset_connection_state();
@@ -836,30 +1318,47 @@ namespace link_layer {
                 phy_update_request_pending_             = false;
                 pending_event_                          = false;
 
-                this->set_access_address_and_crc_init( read_32bit( &body[ 12 ] ), read_24bit( &body[ 16 ] ) );
+                set_connection_access_address_and_crc_init( read_32bit( &body[ 12 ] ), read_24bit( &body[ 16 ] ) );
 
-                this->reset_pdu_buffer();
+                this->reset_l2cap_sdu_buffer();
+                this->reset_data_length( *this );
                 setup_next_connection_event();
 
                 this->connection_request( connection_addresses( address_, remote_address ) );
                 this->handle_stop_advertising();
 
-                connection_data_ = connection_data_t();
-                connection_data_.remote_connection_created( remote_address );
+                this->current_connection_data() = connection_data_t();
+                this->current_connection_data().remote_connection_created( remote_address );
+                details::resolve_remote_identity( *this, this->current_connection_data(), remote_address );
             }
         }
+
+        this->dispatch_radio_event();
     }
 
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
     void link_layer< Server, ScheduledRadio, Options... >::adv_timeout()
     {
+        this->advertising_event_done();
+
         assert( state_ == state::advertising );
 
         this->handle_adv_timeout();
+        this->dispatch_radio_event();
     }
 
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
     void link_layer< Server, ScheduledRadio, Options... >::timeout()
+    {
+        this->connection_event_timed_out();
+
+        handle_connection_event_timeout();
+
+        this->dispatch_radio_event();
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::handle_connection_event_timeout()
     {
         pending_event_ = false;
 
@@ -890,6 +1389,8 @@ namespace link_layer {
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
     void link_layer< Server, ScheduledRadio, Options... >::end_event( connection_event_events evts )
     {
+        this->connection_event_ended();
+
         pending_event_ = false;
 
         assert( state_ == state::connecting || state_ == state::connected || state_ == state::disconnecting || state_ == state::connection_changed );
@@ -902,7 +1403,7 @@ namespace link_layer {
 
         if ( state_ == state::connecting )
         {
-            this->connection_established( details(), connection_data_, static_cast< radio_t& >( *this ) );
+            this->connection_established( details(), this->current_connection_data(), static_cast< radio_t& >( *this ) );
         }
         else if ( state_ == state::connection_changed )
         {
@@ -928,6 +1429,7 @@ namespace link_layer {
         else
         {
             this->transmit_pending_security_pdus();
+            this->transmit_pending_length_request( *this );
 
             const std::pair< bool, std::uint16_t > pending_instant = { !defered_ll_control_pdu_.empty(), defered_conn_event_counter_ };
 
@@ -946,6 +1448,8 @@ namespace link_layer {
                 connection_event_callback::call_connection_event_callback( time_till_next_event );
             }
         }
+
+        this->dispatch_radio_event();
     }
 
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
@@ -1038,12 +1542,100 @@ namespace link_layer {
         }
 
         return this->schedule_connection_event(
-                channels_.data_channel( this->current_channel_index() ),
+                channels_.data_channel( this->current_channel_index(), this->connection_event_counter() ),
                 window_start,
                 window_end,
                 connection_interval_ );
     }
 
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::schedule_advertisment(
+        unsigned                                    channel,
+        const write_buffer&                         advertising_data,
+        const write_buffer&                         response_data,
+        delta_time                                  when,
+        const read_buffer&                          receive )
+    {
+        this->concurrent_schedule_advertisment( channel, advertising_data, response_data, when, receive );
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    delta_time link_layer< Server, ScheduledRadio, Options... >::schedule_connection_event(
+        unsigned                                    channel,
+        delta_time                                  start_receive,
+        delta_time                                  end_receive,
+        delta_time                                  connection_interval )
+    {
+        return this->concurrent_schedule_connection_event( channel, start_receive, end_receive, connection_interval, connection_timeout_ );
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    std::pair< bool, delta_time > link_layer< Server, ScheduledRadio, Options... >::disarm_connection_event()
+    {
+        return this->concurrent_disarm_connection_event();
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::set_access_address_and_crc_init( std::uint32_t access_address, std::uint32_t crc_init )
+    {
+        this->concurrent_set_access_address_and_crc_init( access_address, crc_init );
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::set_connection_access_address_and_crc_init( std::uint32_t access_address, std::uint32_t crc_init )
+    {
+        this->concurrent_set_connection_access_address_and_crc_init( access_address, crc_init );
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::radio_set_phy( details::phy_ll_encoding::phy_ll_encoding_t receiving_encoding, details::phy_ll_encoding::phy_ll_encoding_t transmiting_encoding )
+    {
+        this->concurrent_radio_set_phy( receiving_encoding, transmiting_encoding );
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    std::uint8_t* link_layer< Server, ScheduledRadio, Options... >::raw_pdu_buffer()
+    {
+        return this->concurrent_raw_pdu_buffer();
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::store_connection( connection_context_t& context ) const
+    {
+        context.state       = static_cast< const details::link_layer_connection_state& >( *this );
+        context.latency     = static_cast< const details::connection_latency_state_t< Options... >& >( *this );
+        context.data_length = static_cast< const details::select_data_length_update_impl< Options... >& >( *this );
+        context.security    = static_cast< const details::select_link_layer_security_impl< Server, link_layer< Server, ScheduledRadio, Options... > >& >( *this );
+        context.signaling   = static_cast< const signaling_channel_t& >( *this );
+
+        // buffer content and encryption are only of interest for established connections
+        if ( details::is_connection_state( state_ ) )
+        {
+            this->store_l2cap_sdu_buffer( context.buffers );
+            details::store_encryption_context( static_cast< const radio_t& >( *this ), context.encryption );
+        }
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::restore_connection( const connection_context_t& context )
+    {
+        static_cast< details::link_layer_connection_state& >( *this )                                                      = context.state;
+        static_cast< details::connection_latency_state_t< Options... >& >( *this )                                         = context.latency;
+        static_cast< details::select_data_length_update_impl< Options... >& >( *this )                                     = context.data_length;
+        static_cast< details::select_link_layer_security_impl< Server, link_layer< Server, ScheduledRadio, Options... > >& >( *this ) = context.security;
+        static_cast< signaling_channel_t& >( *this )                                                                       = context.signaling;
+
+        if ( details::is_connection_state( state_ ) )
+        {
+            this->restore_l2cap_sdu_buffer( context.buffers );
+            details::restore_encryption_context( static_cast< radio_t& >( *this ), context.encryption );
+        }
+        else
+        {
+            details::restore_encryption_context( static_cast< radio_t& >( *this ), decltype( context.encryption )() );
+        }
+    }
+
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
     void link_layer< Server, ScheduledRadio, Options... >::transmit_pending_control_pdus()
     {
@@ -1113,24 +1705,34 @@ namespace link_layer {
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
     bool link_layer< Server, ScheduledRadio, Options... >::queue_lcap_notification( const ::bluetoe::details::notification_data& item, void* that, ::bluetoe::details::notification_type type )
     {
-        auto& connection = static_cast< link_layer< Server, ScheduledRadio, Options... >* >( that )->connection_data_;
+        auto& self = *static_cast< link_layer< Server, ScheduledRadio, Options... >* >( that );
+
+        // a confirmation is received on the active connection
+        if ( type == bluetoe::details::notification_type::confirmation )
+        {
+            self.current_connection_data().indication_confirmed();
+            return true;
+        }
+
+        bool result = false;
 
         // TODO: Synchronization required!!!
-        switch ( type )
+        for ( std::size_t connection = 0; connection != concurrent_connections_t::number_of_connections; ++connection )
         {
-            case bluetoe::details::notification_type::notification:
-                return connection.queue_notification( item.client_characteristic_configuration_index() );
-                break;
-            case bluetoe::details::notification_type::indication:
-                return connection.queue_indication( item.client_characteristic_configuration_index() );
-                break;
-            case bluetoe::details::notification_type::confirmation:
-                connection.indication_confirmed();
-                return true;
-                break;
+            if ( !self.slot_connection_established( connection ) )
+                continue;
+
+            if ( type == bluetoe::details::notification_type::notification )
+            {
+                result = self.slot_connection_data( connection ).queue_notification( item.client_characteristic_configuration_index() ) || result;
+            }
+            else
+            {
+                result = self.slot_connection_data( connection ).queue_indication( item.client_characteristic_configuration_index() ) || result;
+            }
         }
 
-        return true;
+        return result;
     }
 
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
@@ -1195,7 +1797,7 @@ namespace link_layer {
     {
         this->synchronized_connection_event_callback_disconnect();
         this->reset_encryption();
-        this->connection_closed( connection_data_, static_cast< radio_t& >( *this ) );
+        this->connection_closed( this->current_connection_data(), static_cast< radio_t& >( *this ) );
         this->reset_phy( *this );
         start_advertising_impl();
     }
@@ -1203,10 +1805,17 @@ namespace link_layer {
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
     void link_layer< Server, ScheduledRadio, Options... >::start_advertising_impl()
     {
-        state_ = state::advertising;
-
         defered_ll_control_pdu_ = write_buffer{ nullptr, 0 };
 
+        // an other connection slot is already advertising
+        if ( !this->start_advertising_in_current_slot() )
+        {
+            state_ = state::initial;
+            return;
+        }
+
+        state_ = state::advertising;
+
         this->handle_start_advertising();
     }
 
@@ -1238,7 +1847,7 @@ namespace link_layer {
                 }
             }
             else if ( llid == lld_data_pdu_code && state_ != state::disconnecting
-                   && this->handle_l2cap_input( body.first, body.second - body.first, connection_data_ ) )
+                   && this->handle_l2cap_input( body.first, body.second - body.first, this->current_connection_data() ) )
             {
                 this->free_ll_l2cap_received();
                 pdu = this->next_ll_l2cap_received();
@@ -1393,6 +2002,10 @@ namespace link_layer {
             {
                 // all phy PDU handled in handle_phy_reqest
             }
+            else if ( this->handle_length_request( opcode, size, pdu, write, *this, commit ) )
+            {
+                // all data length PDU handled in handle_length_request
+            }
             else if ( opcode != LL_UNKNOWN_RSP )
             {
                 fill< layout_t >( write, { ll_control_pdu_code, 2, LL_UNKNOWN_RSP, opcode } );
@@ -1429,7 +2042,7 @@ namespace link_layer {
                 {
                     state_ = state::connection_changed;
                     this->synchronized_connection_event_callback_start_changing_connection();
-                    this->connection_changed( details(), connection_data_, static_cast< radio_t& >( *this ) );
+                    this->connection_changed( details(), this->current_connection_data(), static_cast< radio_t& >( *this ) );
                 }
                 else
                 {
@@ -1463,8 +2076,13 @@ namespace link_layer {
     }
 
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
-    std::size_t link_layer< Server, ScheduledRadio, Options... >::fill_l2cap_advertising_data( std::uint8_t* buffer, std::size_t buffer_size ) const
+    std::size_t link_layer< Server, ScheduledRadio, Options... >::fill_l2cap_advertising_data( std::uint8_t* buffer, std::size_t buffer_size )
     {
+        std::size_t size = 0;
+
+        if ( this->copy_runtime_advertising_data( buffer, buffer_size, size ) )
+            return size;
+
         return this->advertising_data( buffer, buffer_size );
     }
 
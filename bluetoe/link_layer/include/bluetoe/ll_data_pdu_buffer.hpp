@@ -6,13 +6,31 @@
 #include <cassert>
 #include <initializer_list>
 #include <algorithm>
+#include <iterator>
 
 #include <bluetoe/default_pdu_layout.hpp>
+#include <bluetoe/ll_options.hpp>
+#include <bluetoe/meta_tools.hpp>
 #include "ring_buffer.hpp"
 
 namespace bluetoe {
 namespace link_layer {
 
+    namespace details {
+        // locks the radio interrupt, unless the PDU rings are lock-free
+        template < bool LockFree, class Radio >
+        struct pdu_buffer_lock
+        {
+            typename Radio::lock_guard lock;
+        };
+
+        template < class Radio >
+        struct pdu_buffer_lock< true, Radio >
+        {
+            pdu_buffer_lock() {}
+        };
+    }
+
     /**
      * @brief ring buffers for ingoing and outgoing LL Data PDUs
      *
@@ -32,8 +50,15 @@ namespace link_layer {
      * TransmitSize and ReceiveSize are the total size of memory for the receiving and
      * transmitting buffer. Depending on the layout of the used Radio, there might be
      * an overhead per PDU.
+     *
+     * By default, the link layer side of the interfaces locks the radio interrupt by creating a Radio::lock_guard.
+     * If lock_free_pdu_buffers is given in Options, single-producer / single-consumer rings are used
+     * instead, and the radio interrupt is never locked. In both cases, sequence numbers of PDUs to be transmitted are
+     * assigned by the radio side, when a PDU is transmitted for the first time.
+     *
+     * @sa lock_free_pdu_buffers
      */
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
     class ll_data_pdu_buffer
     {
     public:
@@ -49,11 +74,24 @@ namespace link_layer {
          */
         using layout = typename pdu_layout_by_radio< Radio >::pdu_layout;
 
+        /**
+         * @brief true, if the buffers are accessed without locking the radio interrupt
+         */
+        static constexpr bool lock_free = bluetoe::details::find_by_meta_type<
+            details::pdu_buffer_meta_type,
+            Options...,
+            locked_pdu_buffers >::type::lock_free;
+
         /**
          * @brief the size of memory in bytes that are return by raw()
          */
         static constexpr std::size_t    size            = TransmitSize + ReceiveSize;
 
+        /**
+         * @brief the size of memory in bytes that is used to store outgoing PDUs
+         */
+        static constexpr std::size_t    transmit_size   = TransmitSize;
+
         /**
          * @brief the minimum size an element in the buffer can have (header size + payload size).
          */
@@ -62,7 +100,7 @@ namespace link_layer {
         /**
          * @brief the maximum size an element in the buffer can have (header size + payload size).
          */
-        static constexpr std::size_t    max_buffer_size = 251;
+        static constexpr std::size_t    max_buffer_size = 2 + 251;
 
         /**
          * @brief 16 bit header size of a link layer PDU
@@ -105,7 +143,7 @@ namespace link_layer {
         /**
          * @brief set the maximum receive size
          *
-         * The used size must be smaller or equal to ReceiveSize - layout_overhead / max_max_rx_size(), smaller than 251 and larger or equal to 29.
+         * The used size must be smaller or equal to ReceiveSize - layout_overhead / max_max_rx_size(), smaller than 253 and larger or equal to 29.
          * The memory is best used, when ReceiveSize divided by max_size + layout_overhead results in an integer. That integer is
          * then the number of PDUs that can be buffered on the receivin side.
          *
@@ -135,7 +173,7 @@ namespace link_layer {
         /**
          * @brief set the maximum transmit size
          *
-         * The used size must be smaller or equal to TransmitSize / max_max_tx_size(), smaller than 251 and larger or equal to 29.
+         * The used size must be smaller or equal to TransmitSize / max_max_tx_size(), smaller than 253 and larger or equal to 29.
          * The memory is best used, when TransmitSize divided by max_size results in an integer. That integer is
          * then the number of PDUs that can be buffered on the transmitting side.
          *
@@ -179,6 +217,29 @@ namespace link_layer {
          */
         void reset_pdu_buffer();
 
+        /**
+         * @brief content and state of the buffer in running mode
+         *
+         * Allows a link layer, that serves more than one connection, to park the buffered PDUs and
+         * sequence numbers of a connection, while an other connection uses the buffer.
+         */
+        struct pdu_buffer_state;
+
+        /**
+         * @brief copies the content and state of the buffer into state
+         *
+         * @pre buffer is in running mode
+         * @pre no buffer is allocated by the radio hardware
+         */
+        void store_pdu_buffer( pdu_buffer_state& state ) const;
+
+        /**
+         * @brief restores content and state of the buffer, previously stored by store_pdu_buffer()
+         *
+         * @post buffer is in running mode
+         */
+        void restore_pdu_buffer( const pdu_buffer_state& state );
+
         /**@}*/
 
         /**@{*/
@@ -193,9 +254,13 @@ namespace link_layer {
          * To indicate that the allocated memory is filled with data to be send, commit_transmit_buffer() must be called.
          * The size parameter is the sum of the payload + header.
          *
+         * The allocated memory can also be used to store several, consecutive PDUs, that are committed
+         * one after the other. In this case, size can be larger than max_tx_size(), but every single PDU
+         * must not.
+         *
          * @post r = allocate_transmit_buffer( n ); r.size == 0 || r.size == n
          * @pre  buffer is in running mode
-         * @pre size <= max_tx_size()
+         * @pre size <= max_tx_size() or the allocated memory is committed in several PDUs
          */
         read_buffer allocate_transmit_buffer( std::size_t size );
 
@@ -211,6 +276,9 @@ namespace link_layer {
          * need to assemble the PDU. Then commit_transmit_buffer() have to be called with the
          * size that the PDU is really filled with at the begining of the buffer.
          *
+         * If the allocated memory contains several PDUs, commit_transmit_buffer() has to be called for every
+         * PDU, where every further PDU starts directly behind the previous PDU.
+         *
          * @pre a buffer must have been allocated by a call to allocate_transmit_buffer()
          * @pre size
          * @pre buffer is in running mode
@@ -298,21 +366,49 @@ namespace link_layer {
         /**@}*/
 
     private:
+        template < std::size_t Size >
+        using ring_t = typename bluetoe::details::select_type<
+            lock_free,
+            spsc_pdu_ring_buffer< Size, read_buffer, layout >,
+            pdu_ring_buffer< Size, read_buffer, layout > >::type;
+
+        using lock_t = details::pdu_buffer_lock< lock_free, Radio >;
+
         // transmit buffer followed by receive buffer at buffer_[ TransmitSize ]
         std::uint8_t    buffer_[ size ];
 
-        pdu_ring_buffer< ReceiveSize, read_buffer, layout >  receive_buffer_;
+        ring_t< ReceiveSize >           receive_buffer_;
         volatile std::size_t            max_rx_size_;
 
-        pdu_ring_buffer< TransmitSize, read_buffer, layout > transmit_buffer_;
+        ring_t< TransmitSize >          transmit_buffer_;
         volatile std::size_t            max_tx_size_;
 
+        // state of the radio side: sequence number of the next new PDU and whether the oldest PDU in
+        // the transmit buffer was already given a sequence number
         bool                    sequence_number_;
+        bool                    transmit_sequence_number_assigned_;
         bool                    next_expected_sequence_number_;
         uint8_t                 empty_[ layout::data_channel_pdu_memory_size( 0 ) ];
         bool                    next_empty_;
         bool                    empty_sequence_number_;
 
+    public:
+        struct pdu_buffer_state
+        {
+            std::uint8_t                                    buffer[ size ];
+            typename ring_t< ReceiveSize >::positions       receive_positions;
+            std::size_t                                     max_rx_size;
+            typename ring_t< TransmitSize >::positions      transmit_positions;
+            std::size_t                                     max_tx_size;
+            bool                                            sequence_number;
+            bool                                            transmit_sequence_number_assigned;
+            bool                                            next_expected_sequence_number;
+            uint8_t                                         empty[ layout::data_channel_pdu_memory_size( 0 ) ];
+            bool                                            next_empty;
+            bool                                            empty_sequence_number;
+        };
+
+    private:
         static constexpr std::size_t  ll_header_size = 2;
         static constexpr std::uint8_t more_data_flag = 0x10;
         static constexpr std::uint8_t sn_flag        = 0x8;
@@ -343,11 +439,14 @@ namespace link_layer {
         write_buffer set_next_expected_sequence_number( read_buffer ) const;
 
         void acknowledge( bool sequence_number );
+
+        // the first transmission of a PDU assigns the next sequence number
+        void assign_sequence_number( const read_buffer& pdu );
     };
 
     // implementation
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::ll_data_pdu_buffer()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::ll_data_pdu_buffer()
         : receive_buffer_( receive_buffer() )
         , transmit_buffer_( transmit_buffer() )
     {
@@ -355,14 +454,14 @@ namespace link_layer {
         reset_pdu_buffer();
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    std::size_t ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::max_rx_size() const
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    std::size_t ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::max_rx_size() const
     {
         return max_rx_size_;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::max_rx_size( std::size_t max_size )
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::max_rx_size( std::size_t max_size )
     {
         assert( max_size >= min_buffer_size );
         assert( max_size <= max_buffer_size );
@@ -371,14 +470,14 @@ namespace link_layer {
         max_rx_size_ = max_size;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    std::size_t ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::max_tx_size() const
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    std::size_t ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::max_tx_size() const
     {
         return max_tx_size_;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::max_tx_size( std::size_t max_size )
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::max_tx_size( std::size_t max_size )
     {
         assert( max_size >= min_buffer_size );
         assert( max_size <= max_buffer_size );
@@ -387,8 +486,8 @@ namespace link_layer {
         max_tx_size_ = max_size;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::reset_pdu_buffer()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::reset_pdu_buffer()
     {
         max_rx_size_    = min_buffer_size;
         receive_buffer_.reset( receive_buffer() );
@@ -397,56 +496,82 @@ namespace link_layer {
         transmit_buffer_.reset( transmit_buffer() );
 
         sequence_number_ = false;
+        transmit_sequence_number_assigned_ = false;
         next_expected_sequence_number_ = false;
         next_empty_      = false;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    std::uint8_t* ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::raw_pdu_buffer()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::store_pdu_buffer( pdu_buffer_state& state ) const
+    {
+        std::copy( std::begin( buffer_ ), std::end( buffer_ ), std::begin( state.buffer ) );
+        std::copy( std::begin( empty_ ), std::end( empty_ ), std::begin( state.empty ) );
+
+        state.receive_positions                 = receive_buffer_.current_positions();
+        state.max_rx_size                       = max_rx_size_;
+        state.transmit_positions                = transmit_buffer_.current_positions();
+        state.max_tx_size                       = max_tx_size_;
+        state.sequence_number                   = sequence_number_;
+        state.transmit_sequence_number_assigned = transmit_sequence_number_assigned_;
+        state.next_expected_sequence_number     = next_expected_sequence_number_;
+        state.next_empty                        = next_empty_;
+        state.empty_sequence_number             = empty_sequence_number_;
+    }
+
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::restore_pdu_buffer( const pdu_buffer_state& state )
+    {
+        // the positions point into buffer_, so the content has to be restored at the very same address
+        std::copy( std::begin( state.buffer ), std::end( state.buffer ), std::begin( buffer_ ) );
+        std::copy( std::begin( state.empty ), std::end( state.empty ), std::begin( empty_ ) );
+
+        receive_buffer_.restore_positions( state.receive_positions );
+        max_rx_size_                        = state.max_rx_size;
+        transmit_buffer_.restore_positions( state.transmit_positions );
+        max_tx_size_                        = state.max_tx_size;
+        sequence_number_                    = state.sequence_number;
+        transmit_sequence_number_assigned_  = state.transmit_sequence_number_assigned;
+        next_expected_sequence_number_      = state.next_expected_sequence_number;
+        next_empty_                         = state.next_empty;
+        empty_sequence_number_              = state.empty_sequence_number;
+    }
+
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    std::uint8_t* ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::raw_pdu_buffer()
     {
         return &buffer_[ 0 ];
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    read_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::allocate_transmit_buffer( std::size_t size )
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    read_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::allocate_transmit_buffer( std::size_t size )
     {
-        typename Radio::lock_guard lock;
+        const lock_t lock;
 
         return transmit_buffer_.alloc_front( transmit_buffer(), size );
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::commit_transmit_buffer( read_buffer pdu )
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::commit_transmit_buffer( read_buffer pdu )
     {
         static constexpr std::uint8_t header_rfu_mask = 0xe0;
         static_cast< void >( header_rfu_mask );
 
         // make sure, no NFU bits are set
-        std::uint16_t header = layout::header( pdu );
-        assert( ( header & header_rfu_mask ) == 0 );
-
-        typename Radio::lock_guard lock;
+        assert( ( layout::header( pdu ) & header_rfu_mask ) == 0 );
 
-        // add sequence number
-        if ( sequence_number_ )
-        {
-            header |= sn_flag;
-            layout::header( pdu, header );
-        }
-
-        sequence_number_ = !sequence_number_;
+        const lock_t lock;
 
         transmit_buffer_.push_front( transmit_buffer(), pdu );
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    bool ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::pending_outgoing_data_available() const
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    bool ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::pending_outgoing_data_available() const
     {
         return transmit_buffer_.next_end().size != 0;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    write_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::set_next_expected_sequence_number( read_buffer buf ) const
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    write_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::set_next_expected_sequence_number( read_buffer buf ) const
     {
         // insert the next expected sequence for every attempt to send the PDU, because it could be that
         // the peripheral is able to receive data, while the central is not able to.
@@ -461,8 +586,8 @@ namespace link_layer {
         return write_buffer( buf );
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    write_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::next_transmit()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    write_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::next_transmit()
     {
         const read_buffer next = transmit_buffer_.next_end();
 
@@ -494,14 +619,16 @@ namespace link_layer {
             return set_next_expected_sequence_number( read_buffer{ &empty_[ 0 ], sizeof( empty_ ) } );
         }
 
+        assign_sequence_number( next );
+
         if ( transmit_buffer_.more_than_one() )
             layout::header( next, layout::header( next ) | more_data_flag );
 
         return set_next_expected_sequence_number( next );
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::acknowledge( bool nesn )
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::acknowledge( bool nesn )
     {
         if ( next_empty_ )
         {
@@ -516,45 +643,64 @@ namespace link_layer {
             if ( next.empty() )
                 return;
 
+            assign_sequence_number( next );
+
             const std::uint16_t header = layout::header( next );
             if ( static_cast< bool >( header & sn_flag ) != nesn )
             {
                 transmit_buffer_.pop_end( transmit_buffer() );
+                transmit_sequence_number_assigned_ = false;
                 static_cast< Radio* >( this )->increment_transmit_packet_counter();
             }
         }
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    read_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::allocate_transmit_buffer()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::assign_sequence_number( const read_buffer& pdu )
+    {
+        if ( transmit_sequence_number_assigned_ )
+            return;
+
+        const std::uint16_t header = layout::header( pdu );
+
+        layout::header( pdu, static_cast< std::uint16_t >( sequence_number_
+            ? ( header | sn_flag )
+            : ( header & ~sn_flag ) ) );
+
+        sequence_number_ = !sequence_number_;
+        transmit_sequence_number_assigned_ = true;
+    }
+
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    read_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::allocate_transmit_buffer()
     {
         return allocate_transmit_buffer( max_tx_size_ + layout_overhead );
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    write_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::next_received() const
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    write_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::next_received() const
     {
-        typename Radio::lock_guard lock;
+        const lock_t lock;
 
         return write_buffer( receive_buffer_.next_end() );
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::free_received()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::free_received()
     {
-        typename Radio::lock_guard lock;
+        const lock_t lock;
 
         receive_buffer_.pop_end( receive_buffer() );
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    read_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::allocate_receive_buffer() const
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    read_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::allocate_receive_buffer() const
     {
         return receive_buffer_.alloc_front( const_cast< std::uint8_t* >( receive_buffer() ), layout::data_channel_pdu_memory_size( max_rx_size_ - ll_header_size ) );
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    write_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::received( read_buffer pdu )
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    write_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::received( read_buffer pdu )
     {
         const std::uint16_t header = layout::header( pdu );
 
@@ -579,14 +725,14 @@ namespace link_layer {
         return next_transmit();
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    write_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::crc_error()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    write_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::crc_error()
     {
         return write_buffer{ 0, 0 };
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::timeout()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio, typename ... Options >
+    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio, Options... >::timeout()
     {
     }
 }
@@ -4,17 +4,100 @@
 #include <bluetoe/buffer.hpp>
 #include <bluetoe/codes.hpp>
 #include <bluetoe/bits.hpp>
+#include <bluetoe/ll_options.hpp>
+#include <bluetoe/meta_tools.hpp>
+
+#include <algorithm>
+#include <iterator>
 
 namespace bluetoe {
 namespace link_layer {
 
+    /** @cond HIDDEN_SYMBOLS */
+    namespace details {
+        // queue of staging buffers for outgoing SDUs, that are fragmented after they are completely written
+        template < std::size_t Size, std::size_t Depth, bool InPlace >
+        struct l2cap_transmit_state
+        {
+            l2cap_transmit_state()
+                : size()
+                , used( 0 )
+                , first( 0 )
+                , count( 0 )
+            {
+            }
+
+            // the buffer to be filled next
+            std::uint8_t* back()
+            {
+                return buffer[ ( first + count ) % Depth ];
+            }
+
+            std::uint16_t& back_size()
+            {
+                return size[ ( first + count ) % Depth ];
+            }
+
+            // the buffer that is currently fragmented
+            std::uint8_t* front()
+            {
+                return buffer[ first ];
+            }
+
+            std::uint16_t& front_size()
+            {
+                return size[ first ];
+            }
+
+            void pop_front()
+            {
+                first = ( first + 1 ) % Depth;
+                --count;
+                used  = 0;
+            }
+
+            std::uint8_t    buffer[ Depth ][ Size ];
+            std::uint16_t   size[ Depth ];
+
+            // number of bytes of the front buffer, that are already fragmented
+            std::size_t     used;
+            std::size_t     first;
+            std::size_t     count;
+        };
+
+        // outgoing SDUs are written directly into the transmit buffer of the link layer
+        template < std::size_t Size, std::size_t Depth >
+        struct l2cap_transmit_state< Size, Depth, true >
+        {
+            l2cap_transmit_state()
+                : region( nullptr )
+                , fragment_size( 0 )
+                , fragments( 0 )
+            {
+            }
+
+            // start of the allocated LL PDU(s), maximum payload per LL PDU and number of reserved LL headers
+            std::uint8_t*   region;
+            std::size_t     fragment_size;
+            std::size_t     fragments;
+        };
+    }
+    /** @endcond */
+
     /**
      * @brief buffer responsible for fragment or defragment L2CAP SDUs
      *
      * If the L2CAP MTU size is 23, this class shall no generate any overhead as SDUs are directly
      * mapped to LL PDUs.
+     *
+     * If in_place_l2cap_fragmentation is given in Options, outgoing SDUs are written directly into the
+     * LL transmit buffer and no staging buffer for outgoing SDUs is required. Otherwise, the number of
+     * SDUs that can be staged is configured by l2cap_transmit_queue.
+     *
+     * @sa in_place_l2cap_fragmentation
+     * @sa l2cap_transmit_queue
      */
-    template < class BufferedRadio, std::size_t MTUSize >
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
     class ll_l2cap_sdu_buffer : public BufferedRadio
     {
     public:
@@ -82,11 +165,51 @@ namespace link_layer {
          */
         void free_ll_l2cap_received();
 
+        /**
+         * @brief places the buffer and the underlying LL PDU buffer in running mode
+         *
+         * Partly received and pending outgoing SDUs are discarded.
+         */
+        void reset_l2cap_sdu_buffer();
+
+        /**
+         * @brief content and state of the buffer, including the underlying LL PDU buffer
+         */
+        struct sdu_buffer_state;
+
+        /**
+         * @brief copies the content and state of the buffer, including the underlying LL PDU buffer into state
+         *
+         * Used by a link layer, that serves more than one connection, to park the buffers of a connection.
+         */
+        void store_l2cap_sdu_buffer( sdu_buffer_state& state ) const;
+
+        /**
+         * @brief restores content and state, previously stored by store_l2cap_sdu_buffer()
+         */
+        void restore_l2cap_sdu_buffer( const sdu_buffer_state& state );
+
         /**
          * @brief radio layout assumed by the buffer
          */
         using layout = typename BufferedRadio::layout;
 
+        /**
+         * @brief true, if outgoing SDUs are fragmented in the LL transmit buffer
+         */
+        static constexpr bool in_place_fragmentation = bluetoe::details::find_by_meta_type<
+            details::l2cap_fragmentation_meta_type,
+            Options...,
+            buffered_l2cap_fragmentation >::type::in_place;
+
+        /**
+         * @brief number of L2CAP SDUs that can be staged for fragmentation
+         */
+        static constexpr std::size_t transmit_queue_depth = bluetoe::details::find_by_meta_type<
+            details::l2cap_transmit_queue_meta_type,
+            Options...,
+            l2cap_transmit_queue< 1 > >::type::depth;
+
     private:
         static constexpr std::uint16_t  pdu_type_mask           = 0x0003;
         static constexpr std::uint16_t  pdu_type_link_layer     = 0x0003;
@@ -99,28 +222,50 @@ namespace link_layer {
         static constexpr std::size_t    overall_overhead        = header_size + layout_overhead + l2cap_header_size;
         static constexpr std::size_t    ll_overhead             = header_size + layout_overhead;
 
+        // with in place fragmentation, the largest SDU, fragmented into LL PDUs of the minimum size, must fit into the transmit buffer
+        static constexpr std::size_t    min_fragment_size       = BufferedRadio::min_buffer_size - header_size;
+        static constexpr std::size_t    max_fragments           = ( MTUSize + l2cap_header_size + min_fragment_size - 1 ) / min_fragment_size;
+        static constexpr std::size_t    max_in_place_sdu_size   = MTUSize + l2cap_header_size + max_fragments * ll_overhead;
+
+        using in_place_t = std::integral_constant< bool, in_place_fragmentation >;
+
         void add_to_receive_buffer( const std::uint8_t*, const std::uint8_t* );
         void try_send_pdus();
+        void try_send_pdus( std::false_type );
+        void try_send_pdus( std::true_type );
+
+        read_buffer allocate_l2cap_transmit_buffer( std::size_t payload_size, std::false_type );
+        read_buffer allocate_l2cap_transmit_buffer( std::size_t payload_size, std::true_type );
+        void commit_l2cap_transmit_buffer( read_buffer buffer, std::false_type );
+        void commit_l2cap_transmit_buffer( read_buffer buffer, std::true_type );
 
         std::uint8_t    receive_buffer_[ MTUSize + overall_overhead ];
         std::uint16_t   receive_size_;
         std::size_t     receive_buffer_used_;
 
-        // when transmitting L2CAP PDUs, we need room for at least the first LL header. Otherwise,
-        // it would not be possible to transparently replace commit_l2cap_transmit_buffer()
-        // transparently with commit_transmit_buffer() for the case that fragmentation is not
-        // used.
-        std::uint8_t    transmit_buffer_[ MTUSize + overall_overhead ];
-        std::uint16_t   transmit_size_;
-        std::size_t     transmit_buffer_used_;
+        using transmit_state_t = details::l2cap_transmit_state< MTUSize + overall_overhead, transmit_queue_depth, in_place_fragmentation >;
+
+        // staging buffers for outgoing SDUs, including room for the first LL header, or the region in the
+        // LL transmit buffer, if outgoing SDUs are fragmented in place
+        transmit_state_t transmit_;
+
+    public:
+        struct sdu_buffer_state
+        {
+            typename BufferedRadio::pdu_buffer_state    pdu_buffer;
+            std::uint8_t                                receive_buffer[ MTUSize + overall_overhead ];
+            std::uint16_t                               receive_size;
+            std::size_t                                 receive_buffer_used;
+            transmit_state_t                            transmit;
+        };
     };
 
     /**
      * @brief specialisation for the minimum MTU size, which would not require any addition
      *        fragmentation / defragmentation
      */
-    template < class BufferedRadio >
-    class ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size > : public BufferedRadio
+    template < class BufferedRadio, typename ... Options >
+    class ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size, Options... > : public BufferedRadio
     {
     public:
         read_buffer allocate_l2cap_transmit_buffer( std::size_t size );
@@ -130,6 +275,12 @@ namespace link_layer {
         void commit_pending_l2cap_transmit_buffers();
         write_buffer next_ll_l2cap_received() const;
         void free_ll_l2cap_received();
+
+        void reset_l2cap_sdu_buffer();
+
+        using sdu_buffer_state = typename BufferedRadio::pdu_buffer_state;
+        void store_l2cap_sdu_buffer( sdu_buffer_state& state ) const;
+        void restore_l2cap_sdu_buffer( const sdu_buffer_state& state );
     private:
         static constexpr std::size_t    header_size             = BufferedRadio::header_size;
         static constexpr std::size_t    layout_overhead         = BufferedRadio::layout_overhead;
@@ -139,60 +290,129 @@ namespace link_layer {
     };
 
     // implementation
-    template < class BufferedRadio, std::size_t MTUSize >
-    ll_l2cap_sdu_buffer< BufferedRadio, MTUSize >::ll_l2cap_sdu_buffer()
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::ll_l2cap_sdu_buffer()
         : receive_size_( 0 )
         , receive_buffer_used_( 0 )
-        , transmit_size_( 0 )
-        , transmit_buffer_used_( 0 )
     {
     }
 
-    template < class BufferedRadio, std::size_t MTUSize >
-    read_buffer ll_l2cap_sdu_buffer< BufferedRadio, MTUSize >::allocate_l2cap_transmit_buffer( std::size_t payload_size )
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    read_buffer ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::allocate_l2cap_transmit_buffer( std::size_t payload_size )
     {
         assert( payload_size <= MTUSize );
 
-        if ( transmit_buffer_used_ != 0 ||  transmit_size_ != 0 )
+        return allocate_l2cap_transmit_buffer( payload_size, in_place_t() );
+    }
+
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    read_buffer ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::allocate_l2cap_transmit_buffer( std::size_t payload_size, std::false_type )
+    {
+        if ( transmit_.count == transmit_queue_depth )
             return { nullptr, 0 };
 
-        return { transmit_buffer_, payload_size + overall_overhead };
+        return { transmit_.back(), payload_size + overall_overhead };
     }
 
-    template < class BufferedRadio, std::size_t MTUSize >
-    read_buffer ll_l2cap_sdu_buffer< BufferedRadio, MTUSize >::allocate_ll_transmit_buffer( std::size_t payload_size )
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    read_buffer ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::allocate_l2cap_transmit_buffer( std::size_t payload_size, std::true_type )
+    {
+        static_assert( BufferedRadio::transmit_size >= max_in_place_sdu_size,
+            "with in_place_l2cap_fragmentation, TransmitSize has to be large enough to store an SDU of MTUSize, including the headers of all fragments." );
+
+        // every fragment is as large as the currently negotiated maximum LL PDU size and requires its own LL header
+        const std::size_t sdu_size      = payload_size + l2cap_header_size;
+        const std::size_t fragment_size = this->max_tx_size() - header_size;
+        const std::size_t fragments     = ( sdu_size + fragment_size - 1 ) / fragment_size;
+
+        const auto region = this->allocate_transmit_buffer( sdu_size + fragments * ll_overhead );
+
+        if ( region.size == 0 )
+            return { nullptr, 0 };
+
+        transmit_.region        = region.buffer;
+        transmit_.fragment_size = fragment_size;
+        transmit_.fragments     = fragments;
+
+        // the SDU is written behind the room for the LL headers of all fragments, but the first
+        return { region.buffer + ( fragments - 1 ) * ll_overhead, sdu_size + ll_overhead };
+    }
+
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    read_buffer ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::allocate_ll_transmit_buffer( std::size_t payload_size )
     {
         try_send_pdus();
 
         return this->allocate_transmit_buffer( payload_size + ll_overhead );
     }
 
-    template < class BufferedRadio, std::size_t MTUSize >
-    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize >::commit_l2cap_transmit_buffer( read_buffer buffer )
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::commit_l2cap_transmit_buffer( read_buffer buffer )
     {
+        commit_l2cap_transmit_buffer( buffer, in_place_t() );
+    }
+
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::commit_l2cap_transmit_buffer( read_buffer buffer, std::false_type )
+    {
+        assert( buffer.buffer == transmit_.back() );
+
         const auto          body    = layout::body( buffer );
         const std::size_t   size    = bluetoe::details::read_16bit( body.first ) + overall_overhead;
 
-        transmit_buffer_used_       = 0;
-        transmit_size_              = size;
+        transmit_.back_size()       = size;
+        ++transmit_.count;
 
         try_send_pdus();
     }
 
-    template < class BufferedRadio, std::size_t MTUSize >
-    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize >::commit_ll_transmit_buffer( read_buffer buffer )
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::commit_l2cap_transmit_buffer( read_buffer buffer, std::true_type )
+    {
+        assert( buffer.buffer == transmit_.region + ( transmit_.fragments - 1 ) * ll_overhead );
+
+        const std::uint8_t* sdu      = layout::body( buffer ).first;
+        std::size_t         sdu_size = bluetoe::details::read_16bit( sdu ) + l2cap_header_size;
+        std::uint8_t*       pdu      = transmit_.region;
+
+        // Move every fragment in front of its LL header. The fragments are moved towards the start of
+        // the region, so every fragment is moved before it could be overwritten. The first fragment of an SDU
+        // that fits into a single LL PDU is not moved at all.
+        for ( std::uint16_t type = pdu_type_start; sdu_size; type = pdu_type_continuation )
+        {
+            const std::size_t fragment_size = std::min( sdu_size, transmit_.fragment_size );
+            const read_buffer fragment{ pdu, fragment_size + ll_overhead };
+            std::uint8_t* const fragment_body = layout::body( fragment ).first;
+
+            if ( fragment_body != sdu )
+                std::copy( sdu, sdu + fragment_size, fragment_body );
+
+            std::fill( pdu + header_size, fragment_body, 0 );
+            layout::header( fragment, static_cast< std::uint16_t >( type | ( fragment_size << 8 ) ) );
+            this->commit_transmit_buffer( fragment );
+
+            sdu      += fragment_size;
+            sdu_size -= fragment_size;
+            pdu      += fragment.size;
+        }
+
+        transmit_.region = nullptr;
+    }
+
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::commit_ll_transmit_buffer( read_buffer buffer )
     {
         this->commit_transmit_buffer( buffer );
     }
 
-    template < class BufferedRadio, std::size_t MTUSize >
-    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize >::commit_pending_l2cap_transmit_buffers()
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::commit_pending_l2cap_transmit_buffers()
     {
         try_send_pdus();
     }
 
-    template < class BufferedRadio, std::size_t MTUSize >
-    write_buffer ll_l2cap_sdu_buffer< BufferedRadio, MTUSize >::next_ll_l2cap_received()
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    write_buffer ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::next_ll_l2cap_received()
     {
         // is there already a defragmented L2CAP SDU?
         if ( receive_buffer_used_ != 0 && receive_size_ == 0 )
@@ -221,14 +441,19 @@ namespace link_layer {
                     if ( l2cap_size + l2cap_header_size == body_size )
                         return pdu;
 
-                    if ( l2cap_size <= MTUSize )
+                    // a start fragment abandons a partially received SDU. With the data length extension, a
+                    // start fragment can be larger than the SDU it announces; such a PDU is dropped.
+                    receive_size_        = 0;
+                    receive_buffer_used_ = 0;
+
+                    if ( l2cap_size <= MTUSize && pdu.size <= l2cap_size + overall_overhead )
                     {
                         receive_size_ = l2cap_size + overall_overhead;
                         add_to_receive_buffer( pdu.buffer, pdu.buffer + pdu.size );
                     }
                 }
             }
-            else
+            else if ( receive_size_ != 0 )
             {
                 add_to_receive_buffer( body.first, body.second );
             }
@@ -244,27 +469,42 @@ namespace link_layer {
         return { nullptr, 0 };
     }
 
-    template < class BufferedRadio, std::size_t MTUSize >
-    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize >::add_to_receive_buffer( const std::uint8_t* begin, const std::uint8_t* end )
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::add_to_receive_buffer( const std::uint8_t* begin, const std::uint8_t* end )
     {
         const std::size_t copy_size = std::min< std::size_t >( receive_size_, end - begin );
 
-        std::copy( begin, end, &receive_buffer_[ receive_buffer_used_ ] );
+        std::copy( begin, begin + copy_size, &receive_buffer_[ receive_buffer_used_ ] );
         receive_buffer_used_ += copy_size;
         receive_size_ -= copy_size;
     }
 
-    template < class BufferedRadio, std::size_t MTUSize >
-    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize >::try_send_pdus()
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::try_send_pdus()
+    {
+        try_send_pdus( in_place_t() );
+    }
+
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::try_send_pdus( std::true_type )
     {
-        while ( transmit_size_ )
+        // all fragments are committed at once
+    }
+
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::try_send_pdus( std::false_type )
+    {
+        while ( transmit_.count )
         {
-            const bool first_fragment   = transmit_buffer_used_ == 0;
+            std::uint8_t* const   sdu   = transmit_.front();
+            std::uint16_t&        size  = transmit_.front_size();
+            const bool first_fragment   = transmit_.used == 0;
 
             // for the first PDU, the header overhead is already taken into account. For all additonal fragments,
             // an additional header has to be allocated.
             const std::size_t overhead  = first_fragment ? 0 : ll_overhead;
-            const auto buffer           = this->allocate_transmit_buffer( std::min( transmit_size_ + overhead, this->max_tx_size() ) );
+            // fragments are as large as the currently negotiated maximum LL PDU size
+            const auto buffer           = this->allocate_transmit_buffer( std::min( size + overhead, this->max_tx_size() + layout_overhead ) );
 
             if ( buffer.size == 0 )
                 return;
@@ -272,35 +512,37 @@ namespace link_layer {
             if ( first_fragment )
             {
                 // The first fragment contains the original LL header
-                const auto copy_size = std::min< std::size_t >( buffer.size, transmit_size_ );
+                const auto copy_size = std::min< std::size_t >( buffer.size, size );
 
-                std::copy( &transmit_buffer_[ 0 ], &transmit_buffer_[ copy_size ], buffer.buffer );
+                std::copy( &sdu[ 0 ], &sdu[ copy_size ], buffer.buffer );
                 layout::header( buffer, pdu_type_start | ( ( copy_size - ll_overhead ) << 8 ) );
 
-                transmit_size_        -= copy_size;
-                transmit_buffer_used_ += copy_size;
+                size           -= copy_size;
+                transmit_.used += copy_size;
             }
             else
             {
                 // for every additional fragment, an additional header has to be generated
                 const auto body        = layout::body( buffer );
-                const auto copy_size   = std::min< std::size_t >( std::distance( body.first, body.second ), transmit_size_ );
+                const auto copy_size   = std::min< std::size_t >( std::distance( body.first, body.second ), size );
 
-                std::copy( &transmit_buffer_[ transmit_buffer_used_ ], &transmit_buffer_[ transmit_buffer_used_+ copy_size ], body.first );
+                std::copy( &sdu[ transmit_.used ], &sdu[ transmit_.used + copy_size ], body.first );
                 layout::header( buffer, pdu_type_continuation | ( copy_size << 8 ) );
 
-                transmit_size_        -= copy_size;
-                transmit_buffer_used_ += copy_size;
+                size           -= copy_size;
+                transmit_.used += copy_size;
             }
 
             this->commit_transmit_buffer( buffer );
-        }
 
-        transmit_buffer_used_ = 0;
+            // SDU completely handed over to the link layer?
+            if ( size == 0 )
+                transmit_.pop_front();
+        }
     }
 
-    template < class BufferedRadio, std::size_t MTUSize >
-    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize >::free_ll_l2cap_received()
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::free_ll_l2cap_received()
     {
         if (receive_buffer_used_)
         {
@@ -313,48 +555,97 @@ namespace link_layer {
         }
     }
 
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::reset_l2cap_sdu_buffer()
+    {
+        this->reset_pdu_buffer();
+
+        receive_size_           = 0;
+        receive_buffer_used_    = 0;
+        transmit_               = transmit_state_t();
+    }
+
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::store_l2cap_sdu_buffer( sdu_buffer_state& state ) const
+    {
+        this->store_pdu_buffer( state.pdu_buffer );
+
+        std::copy( std::begin( receive_buffer_ ), std::end( receive_buffer_ ), std::begin( state.receive_buffer ) );
+        state.receive_size          = receive_size_;
+        state.receive_buffer_used   = receive_buffer_used_;
+        state.transmit              = transmit_;
+    }
+
+    template < class BufferedRadio, std::size_t MTUSize, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, MTUSize, Options... >::restore_l2cap_sdu_buffer( const sdu_buffer_state& state )
+    {
+        this->restore_pdu_buffer( state.pdu_buffer );
+
+        std::copy( std::begin( state.receive_buffer ), std::end( state.receive_buffer ), std::begin( receive_buffer_ ) );
+        receive_size_           = state.receive_size;
+        receive_buffer_used_    = state.receive_buffer_used;
+        transmit_               = state.transmit;
+    }
 
     // implementation
-    template < class BufferedRadio >
-    read_buffer ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size >::allocate_l2cap_transmit_buffer( std::size_t size )
+    template < class BufferedRadio, typename ... Options >
+    read_buffer ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size, Options... >::allocate_l2cap_transmit_buffer( std::size_t size )
     {
         return this->allocate_transmit_buffer( size + overall_overhead );
     }
 
-    template < class BufferedRadio >
-    read_buffer ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size >::allocate_ll_transmit_buffer( std::size_t size )
+    template < class BufferedRadio, typename ... Options >
+    read_buffer ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size, Options... >::allocate_ll_transmit_buffer( std::size_t size )
     {
         return this->allocate_transmit_buffer( size + ll_overhead );
     }
 
-    template < class BufferedRadio >
-    void ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size >::commit_l2cap_transmit_buffer( read_buffer buffer )
+    template < class BufferedRadio, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size, Options... >::commit_l2cap_transmit_buffer( read_buffer buffer )
     {
         return this->commit_transmit_buffer( buffer );
     }
 
-    template < class BufferedRadio >
-    void ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size >::commit_ll_transmit_buffer( read_buffer buffer )
+    template < class BufferedRadio, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size, Options... >::commit_ll_transmit_buffer( read_buffer buffer )
     {
         return this->commit_transmit_buffer( buffer );
     }
 
-    template < class BufferedRadio >
-    void ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size >::commit_pending_l2cap_transmit_buffers()
+    template < class BufferedRadio, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size, Options... >::commit_pending_l2cap_transmit_buffers()
     {
     }
 
-    template < class BufferedRadio >
-    write_buffer ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size >::next_ll_l2cap_received() const
+    template < class BufferedRadio, typename ... Options >
+    write_buffer ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size, Options... >::next_ll_l2cap_received() const
     {
         return this->next_received();
     }
 
-    template < class BufferedRadio >
-    void ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size >::free_ll_l2cap_received()
+    template < class BufferedRadio, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size, Options... >::free_ll_l2cap_received()
     {
         return this->free_received();
     }
+
+    template < class BufferedRadio, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size, Options... >::reset_l2cap_sdu_buffer()
+    {
+        this->reset_pdu_buffer();
+    }
+
+    template < class BufferedRadio, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size, Options... >::store_l2cap_sdu_buffer( sdu_buffer_state& state ) const
+    {
+        this->store_pdu_buffer( state );
+    }
+
+    template < class BufferedRadio, typename ... Options >
+    void ll_l2cap_sdu_buffer< BufferedRadio, bluetoe::details::default_att_mtu_size, Options... >::restore_l2cap_sdu_buffer( const sdu_buffer_state& state )
+    {
+        this->restore_pdu_buffer( state );
+    }
 }
 }
 
@@ -137,6 +137,277 @@ namespace link_layer
          */
         static constexpr std::size_t receive_buffer_size  = ReceiveSize;
     };
+
+    namespace details {
+        struct pdu_buffer_meta_type {};
+    }
+
+    /**
+     * @brief use lock-free rings to exchange LL Data PDUs between link layer and radio ISR
+     *
+     * By default, the link layer masks the radio interrupt, while it allocates and commits PDUs to
+     * the transmit buffer and while it takes PDUs out of the receive buffer. With this option, the
+     * transmit and receive buffers are implemented as single-producer / single-consumer rings with atomic
+     * indices, so that no interrupt masking is necessary.
+     *
+     * The option is evaluated by the ll_data_pdu_buffer of the scheduled radio; the nRF52 binding
+     * forwards it from the list of link layer options.
+     *
+     * @sa locked_pdu_buffers
+     * @sa spsc_pdu_ring_buffer
+     */
+    struct lock_free_pdu_buffers
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr bool lock_free = true;
+
+        struct meta_type :
+            details::pdu_buffer_meta_type,
+            details::valid_link_layer_option_meta_type {};
+        /** @endcond */
+    };
+
+    /**
+     * @brief the access to the LL Data PDU buffers is guarded by locking the radio interrupt
+     *
+     * This is the default.
+     *
+     * @sa lock_free_pdu_buffers
+     */
+    struct locked_pdu_buffers
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr bool lock_free = false;
+
+        struct meta_type :
+            details::pdu_buffer_meta_type,
+            details::valid_link_layer_option_meta_type {};
+        /** @endcond */
+    };
+
+    namespace details {
+        struct l2cap_fragmentation_meta_type {};
+    }
+
+    /**
+     * @brief fragment outgoing L2CAP SDUs in place, in the link layer transmit buffer
+     *
+     * By default, an outgoing L2CAP SDU, that is larger than the current maximum LL PDU size, is first
+     * written into a MTU sized staging buffer and then copied fragment by fragment into LL PDUs.
+     *
+     * With this option, the SDU is written directly into the transmit buffer of the link layer. The room
+     * for the LL headers of all fragments is reserved in front of the SDU and, when the SDU is committed, every
+     * fragment is moved in front of the next LL header. If the SDU fits into a single LL PDU (for example
+     * with an ATT MTU of 247 and a negotiated LL payload of 251 bytes), the SDU is not moved at all.
+     * This saves the MTU sized staging buffer and one copy of every outgoing SDU.
+     *
+     * The transmit buffer (see buffer_sizes) has to be large enough to store the largest L2CAP SDU
+     * including the LL headers and layout overhead of all fragments.
+     *
+     * The reassembly of incoming SDUs is not affected by this option.
+     *
+     * @sa buffered_l2cap_fragmentation
+     * @sa buffer_sizes
+     */
+    struct in_place_l2cap_fragmentation
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr bool in_place = true;
+
+        struct meta_type :
+            details::l2cap_fragmentation_meta_type,
+            details::valid_link_layer_option_meta_type {};
+        /** @endcond */
+    };
+
+    /**
+     * @brief outgoing L2CAP SDUs are written into a staging buffer and then fragmented into LL PDUs
+     *
+     * This is the default.
+     *
+     * @sa in_place_l2cap_fragmentation
+     */
+    struct buffered_l2cap_fragmentation
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr bool in_place = false;
+
+        struct meta_type :
+            details::l2cap_fragmentation_meta_type,
+            details::valid_link_layer_option_meta_type {};
+        /** @endcond */
+    };
+
+    namespace details {
+        struct l2cap_transmit_queue_meta_type {};
+    }
+
+    /**
+     * @brief number of outgoing L2CAP SDUs, that can be staged for fragmentation at the same time
+     *
+     * If the L2CAP MTU is larger than 23, outgoing SDUs are written into a staging buffer and fragmented
+     * from there into LL PDUs as soon as there is room in the link layer transmit buffer. By default,
+     * there is only one staging buffer, so no new SDU (for example a notification) can be generated,
+     * before the last SDU was completely handed over to the link layer.
+     *
+     * With Depth > 1, up to Depth SDUs can be staged and are handed over to the link layer in the order they
+     * where generated. Every staging buffer is as large as the largest L2CAP SDU.
+     *
+     * The option has no effect with in_place_l2cap_fragmentation or an MTU of 23.
+     *
+     * @sa buffered_l2cap_fragmentation
+     */
+    template < std::size_t Depth >
+    struct l2cap_transmit_queue
+    {
+        static_assert( Depth > 0, "at least one staging buffer is required" );
+
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr std::size_t depth = Depth;
+
+        struct meta_type :
+            details::l2cap_transmit_queue_meta_type,
+            details::valid_link_layer_option_meta_type {};
+        /** @endcond */
+    };
+
+    namespace details {
+        struct data_length_extension_meta_type {};
+    }
+
+    /**
+     * @brief enables the LE Data Length Extension procedure (LL_LENGTH_REQ / LL_LENGTH_RSP)
+     *
+     * With this option, the link layer announces the LE Data Packet Length Extension feature,
+     * answers LL_LENGTH_REQ from the central and requests larger PDUs after a connection was
+     * established. The negotiated sizes are then used by the link layer to receive and transmit
+     * PDUs and to fragment L2CAP SDUs.
+     *
+     * MaxTxOctets and MaxRxOctets are the largest LL payloads, the link layer is willing to send and
+     * to receive. Both have to be in the range 27 to 251. The link layer further limits the supported
+     * sizes to what fits into the configured buffer_sizes.
+     *
+     * @sa no_data_length_extension
+     * @sa buffer_sizes
+     */
+    template < std::uint16_t MaxTxOctets = 251, std::uint16_t MaxRxOctets = 251 >
+    struct data_length_extension
+    {
+        static_assert( MaxTxOctets >= 27 && MaxTxOctets <= 251, "MaxTxOctets has to be in the range of 27 to 251" );
+        static_assert( MaxRxOctets >= 27 && MaxRxOctets <= 251, "MaxRxOctets has to be in the range of 27 to 251" );
+
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr bool           enabled         = true;
+        static constexpr std::uint16_t  max_tx_octets   = MaxTxOctets;
+        static constexpr std::uint16_t  max_rx_octets   = MaxRxOctets;
+
+        struct meta_type :
+            details::data_length_extension_meta_type,
+            details::valid_link_layer_option_meta_type {};
+        /** @endcond */
+    };
+
+    /**
+     * @brief disables the LE Data Length Extension procedure
+     *
+     * All LL payloads are limited to 27 bytes and a LL_LENGTH_REQ is answered with LL_UNKNOWN_RSP.
+     * This is the default.
+     *
+     * @sa data_length_extension
+     */
+    struct no_data_length_extension
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr bool           enabled         = false;
+        static constexpr std::uint16_t  max_tx_octets   = 27;
+        static constexpr std::uint16_t  max_rx_octets   = 27;
+
+        struct meta_type :
+            details::data_length_extension_meta_type,
+            details::valid_link_layer_option_meta_type {};
+        /** @endcond */
+    };
+    namespace details {
+        struct channel_selection_algorithm_meta_type {};
+    }
+
+    /**
+     * @brief enables support for the LE Channel Selection Algorithm #2
+     *
+     * The link layer indicates the support in connectable advertising PDUs. If the central
+     * sets the ChSel bit in the CONNECT_IND, channel selection algorithm #2 is used for the
+     * connection. Otherwise, channel selection algorithm #1 is used.
+     *
+     * @sa no_channel_selection_algorithm_2
+     */
+    struct channel_selection_algorithm_2
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr bool supported = true;
+
+        struct meta_type :
+            details::channel_selection_algorithm_meta_type,
+            details::valid_link_layer_option_meta_type {};
+        /** @endcond */
+    };
+
+    /**
+     * @brief only channel selection algorithm #1 will be used
+     *
+     * This is the default.
+     *
+     * @sa channel_selection_algorithm_2
+     */
+    struct no_channel_selection_algorithm_2
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr bool supported = false;
+
+        struct meta_type :
+            details::channel_selection_algorithm_meta_type,
+            details::valid_link_layer_option_meta_type {};
+        /** @endcond */
+    };
+
+    namespace details {
+        struct concurrent_connections_meta_type {};
+    }
+
+    /**
+     * @brief number of connections, the link layer serves at the same time in the peripheral role
+     *
+     * As long as there are fewer than Connections connections established, the link layer keeps advertising.
+     * All connections share a single radio. Every connection has its own LL PDU buffers, L2CAP
+     * buffers, encryption state and connection data (like CCCDs). Notifications and indications are
+     * queued for every established connection.
+     *
+     * Events of different connections, that would overlap, collide. EventLengthUs is the time in µs that is
+     * reserved for every connection event. Of two colliding events, the event of the connection that is
+     * closer to its supervision timeout takes place and the other event is handled, as if the central
+     * would not have answered. Advertising events always yield to connection events.
+     *
+     * Functions like link_layer::disconnect() or link_layer::connection_parameter_update_request(), which
+     * take no connection as parameter, are applied to the connection that had the last connection event.
+     *
+     * With more than one connection, encryption requires a scheduled radio that provides an encryption_context
+     * and the synchronized_connection_event_callback is not supported.
+     *
+     * The default is a single connection.
+     */
+    template < std::size_t Connections, unsigned EventLengthUs = 2500 >
+    struct max_concurrent_connections
+    {
+        static_assert( Connections > 0, "at least one connection has to be supported" );
+
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr std::size_t    connections     = Connections;
+        static constexpr unsigned       event_length_us = EventLengthUs;
+
+        struct meta_type :
+            details::concurrent_connections_meta_type,
+            details::valid_link_layer_option_meta_type {};
+        /** @endcond */
+    };
 }
 }
 
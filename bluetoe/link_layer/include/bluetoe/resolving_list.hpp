@@ -0,0 +1,489 @@
+#ifndef BLUETOE_LINK_LAYER_RESOLVING_LIST_HPP
+#define BLUETOE_LINK_LAYER_RESOLVING_LIST_HPP
+
+#include <bluetoe/address.hpp>
+#include <bluetoe/aes.hpp>
+#include <bluetoe/ll_meta_types.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+#include <utility>
+
+namespace bluetoe {
+
+namespace details {
+    using identity_resolving_key_t  = std::array< std::uint8_t, 16 >;
+}
+
+namespace link_layer {
+
+    namespace details {
+        struct resolving_list_meta_type {};
+
+        template < std::size_t Size, std::size_t CacheSize, bool SoftwareRequired, typename Radio, typename LinkLayer >
+        class resolving_list_implementation;
+    }
+
+    /**
+     * @brief adds a resolving list to the link layer
+     *
+     * The resolving list maps resolvable private addresses (RPA) of peer devices to their identity addresses,
+     * by the identity resolving keys (IRK) of the peers. The white list and connectable directed advertising
+     * then accept a device, that uses a resolvable private address, if the identity address of that device is
+     * in the white list or is the directed advertising address.
+     *
+     * Resolving an address requires one AES evaluation per IRK in the list. The last CacheSize results (resolved
+     * or not resolvable) are cached, so that the next PDU with the same address costs a single cache lookup.
+     *
+     * If the radio supports at least Size entries in hardware (Radio::radio_maximum_resolving_list_entries),
+     * the list is implemented by the radio, otherwise by software.
+     *
+     * @tparam Size the maximum number of devices, the resolving list will contain.
+     * @tparam CacheSize the number of cached resolutions, has to be a power of 2.
+     *
+     * @sa white_list
+     * @sa connectable_directed_advertising
+     */
+    template < std::size_t Size = 8, std::size_t CacheSize = 8 >
+    class resolving_list
+    {
+    public:
+        /** @cond HIDDEN_SYMBOLS */
+        // this functions are purly for documentation purpose, the used implementations is in details::resolving_list_implementation
+        /** @endcond */
+
+        /**
+         * @brief The maximum number of devices, the resolving list can contain.
+         */
+        static constexpr std::size_t maximum_resolving_list_entries = Size;
+
+        /**
+         * @brief add a device with the given identity address and IRK to the resolving list
+         *
+         * The IRK is expected in the byte order of the security manager's Identity Information PDU
+         * (least significant octet first). If the identity address is already in the list, the IRK is
+         * replaced. If there was not enough room to add the device, the function returns false.
+         */
+        bool add_to_resolving_list( const device_address& identity, const bluetoe::details::identity_resolving_key_t& irk );
+
+        /**
+         * @brief remove the device with the given identity address from the resolving list
+         *
+         * The function returns true, if the device was in the list.
+         */
+        bool remove_from_resolving_list( const device_address& identity );
+
+        /**
+         * @brief returns true, if a device with the given identity address is in the resolving list
+         */
+        bool is_in_resolving_list( const device_address& identity ) const;
+
+        /**
+         * @brief returns the number of devices that could be added to the
+         *        resolving list before add_to_resolving_list() would return false.
+         */
+        std::size_t resolving_list_free_size() const;
+
+        /**
+         * @brief remove all entries from the resolving list
+         */
+        void clear_resolving_list();
+
+        /**
+         * @brief resolves the given address to the identity address of a device in the resolving list
+         *
+         * If the address is a resolvable private address, that was generated with the IRK of a device in
+         * the resolving list, the function returns true and the identity address of that device. Otherwise,
+         * the function returns false and the unchanged address.
+         */
+        std::pair< bool, device_address > resolve_address( const device_address& addr ) const;
+
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::resolving_list_meta_type,
+            details::valid_link_layer_option_meta_type {};
+
+        template < class Radio, class LinkLayer >
+        struct impl;
+        /** @endcond */
+    };
+
+    /**
+     * @brief no resolving list in the link layer
+     *
+     * This is the default
+     */
+    struct no_resolving_list {
+        /** @cond HIDDEN_SYMBOLS */
+        template < class Radio, class LinkLayer >
+        struct impl {
+            std::pair< bool, device_address > resolve_address( const device_address& addr ) const
+            {
+                return { false, addr };
+            }
+        };
+
+        struct meta_type :
+            details::resolving_list_meta_type,
+            details::valid_link_layer_option_meta_type {};
+        /** @endcond */
+    };
+
+    namespace details {
+
+        /*
+         * number of resolving list entries supported by the radio
+         */
+        template < class Radio >
+        struct radio_resolving_list_entries
+        {
+            template < class T >
+            static constexpr std::size_t entries( decltype( T::radio_maximum_resolving_list_entries )* )
+            {
+                return T::radio_maximum_resolving_list_entries;
+            }
+
+            template < class T >
+            static constexpr std::size_t entries( ... )
+            {
+                return 0;
+            }
+
+            static constexpr std::size_t value = entries< Radio >( nullptr );
+        };
+
+        /*
+         * resolves the given address with the resolving list of the link layer, if the link layer has a resolving list
+         */
+        template < class LinkLayer >
+        auto resolve_address( const LinkLayer& link_layer, const device_address& addr, int )
+            -> decltype( link_layer.resolve_address( addr ) )
+        {
+            return link_layer.resolve_address( addr );
+        }
+
+        template < class LinkLayer >
+        std::pair< bool, device_address > resolve_address( const LinkLayer&, const device_address& addr, long )
+        {
+            return { false, addr };
+        }
+
+        template < class LinkLayer >
+        std::pair< bool, device_address > resolve_address( const LinkLayer& link_layer, const device_address& addr )
+        {
+            if ( !addr.is_random_resolvable() )
+                return { false, addr };
+
+            return resolve_address( link_layer, addr, 0 );
+        }
+
+        /*
+         * passes the identity address of the remote device of a new connection to the connection data, if the remote
+         * address can be resolved and the connection data keeps track of the identity (security manager)
+         */
+        template < class ConnectionData >
+        auto remote_identity_resolved( ConnectionData& connection, const device_address& identity, int )
+            -> decltype( connection.remote_identity_resolved( identity ) )
+        {
+            return connection.remote_identity_resolved( identity );
+        }
+
+        template < class ConnectionData >
+        void remote_identity_resolved( ConnectionData&, const device_address&, long )
+        {
+        }
+
+        template < class LinkLayer, class ConnectionData >
+        void resolve_remote_identity( const LinkLayer& link_layer, ConnectionData& connection, const device_address& remote )
+        {
+            const auto identity = resolve_address( link_layer, remote );
+
+            if ( identity.first )
+                remote_identity_resolved( connection, identity.second, 0 );
+        }
+
+        /*
+         * ah() (Core Spec Vol 3, Part H, 2.2.2) with the key schedule of one IRK expanded in advance
+         */
+        class address_resolver
+        {
+        public:
+            static constexpr std::size_t block_size = bluetoe::details::aes128::block_size;
+
+            /*
+             * a resolver with an all zero IRK
+             */
+            address_resolver();
+
+            /*
+             * irk least significant octet first
+             */
+            explicit address_resolver( const std::uint8_t* irk );
+
+            /*
+             * the input block of ah() for the prand part of the given resolvable private address;
+             * this is the same for all IRKs and has to be calculated once per address
+             */
+            static void prand_block( const device_address& rpa, std::uint8_t* block );
+
+            /*
+             * returns true, if the hash part of rpa matches ah( irk, prand )
+             */
+            bool resolves( const std::uint8_t* block, const device_address& rpa ) const;
+
+        private:
+            bluetoe::details::aes128 cipher_;
+        };
+
+        /*
+         * direct mapped cache of recently resolved addresses
+         */
+        template < std::size_t CacheSize >
+        class resolution_cache
+        {
+        public:
+            static_assert( CacheSize > 0 && ( CacheSize & ( CacheSize - 1 ) ) == 0, "CacheSize has to be a power of 2" );
+
+            static constexpr std::uint16_t no_entry = 0xffff;
+
+            resolution_cache()
+            {
+                clear();
+            }
+
+            void clear()
+            {
+                for ( auto& line : lines_ )
+                    line.entry = no_entry;
+            }
+
+            /*
+             * returns no_entry, if the address is not cached
+             */
+            std::uint16_t find( const device_address& rpa ) const
+            {
+                const line& l = lines_[ index( rpa ) ];
+
+                return l.entry != no_entry && l.rpa == rpa
+                    ? l.entry
+                    : no_entry;
+            }
+
+            void insert( const device_address& rpa, std::uint16_t entry )
+            {
+                line& l = lines_[ index( rpa ) ];
+                l.rpa   = rpa;
+                l.entry = entry;
+            }
+
+        private:
+            struct line
+            {
+                device_address  rpa;
+                std::uint16_t   entry;
+            };
+
+            // the hash part of the address is the output of the AES
+            static std::size_t index( const device_address& rpa )
+            {
+                const std::uint8_t* const octets = rpa.begin();
+
+                return ( octets[ 0 ] | ( octets[ 1 ] << 8 ) ) & ( CacheSize - 1 );
+            }
+
+            line lines_[ CacheSize ];
+        };
+
+        /**
+         * pure software implementation
+         */
+        template < std::size_t Size, std::size_t CacheSize, typename Radio, typename LinkLayer >
+        class resolving_list_implementation< Size, CacheSize, true, Radio, LinkLayer >
+        {
+        public:
+            static_assert( Size > 0 && Size < resolution_cache< CacheSize >::no_entry, "invalid resolving list size" );
+
+            static constexpr std::size_t maximum_resolving_list_entries = Size;
+
+            resolving_list_implementation()
+                : free_size_( Size )
+            {
+            }
+
+            std::size_t resolving_list_free_size() const
+            {
+                return free_size_;
+            }
+
+            void clear_resolving_list()
+            {
+                free_size_ = Size;
+                cache_.clear();
+            }
+
+            bool add_to_resolving_list( const device_address& identity, const bluetoe::details::identity_resolving_key_t& irk )
+            {
+                const std::size_t entry = find_identity( identity );
+
+                if ( entry == Size && free_size_ == 0 )
+                    return false;
+
+                if ( entry == Size )
+                {
+                    identities_[ Size - free_size_ ] = identity;
+                    resolvers_[ Size - free_size_ ]  = address_resolver( irk.data() );
+                    --free_size_;
+                }
+                else
+                {
+                    resolvers_[ entry ] = address_resolver( irk.data() );
+                }
+
+                // cached addresses, that could not be resolved, might be resolvable now
+                cache_.clear();
+
+                return true;
+            }
+
+            bool remove_from_resolving_list( const device_address& identity )
+            {
+                const std::size_t entry = find_identity( identity );
+
+                if ( entry == Size )
+                    return false;
+
+                const std::size_t last = Size - free_size_ - 1;
+                identities_[ entry ] = identities_[ last ];
+                resolvers_[ entry ]  = resolvers_[ last ];
+                ++free_size_;
+
+                cache_.clear();
+
+                return true;
+            }
+
+            bool is_in_resolving_list( const device_address& identity ) const
+            {
+                return find_identity( identity ) != Size;
+            }
+
+            std::pair< bool, device_address > resolve_address( const device_address& addr ) const
+            {
+                if ( !addr.is_random_resolvable() )
+                    return { false, addr };
+
+                std::uint16_t entry = cache_.find( addr );
+
+                if ( entry == resolution_cache< CacheSize >::no_entry )
+                {
+                    entry = static_cast< std::uint16_t >( resolve( addr ) );
+                    cache_.insert( addr, entry );
+                }
+
+                return entry == Size
+                    ? std::pair< bool, device_address >( false, addr )
+                    : std::pair< bool, device_address >( true, identities_[ entry ] );
+            }
+
+        private:
+            std::size_t find_identity( const device_address& identity ) const
+            {
+                const auto end = std::begin( identities_ ) + ( Size - free_size_ );
+                const auto pos = std::find( std::begin( identities_ ), end, identity );
+
+                return pos == end ? Size : pos - std::begin( identities_ );
+            }
+
+            // evaluates ah() for all IRKs with the same input block
+            std::size_t resolve( const device_address& rpa ) const
+            {
+                std::uint8_t block[ address_resolver::block_size ];
+                address_resolver::prand_block( rpa, block );
+
+                const std::size_t used = Size - free_size_;
+                std::size_t entry = 0;
+
+                for ( ; entry != used && !resolvers_[ entry ].resolves( block, rpa ); ++entry )
+                    ;
+
+                return entry == used ? Size : entry;
+            }
+
+            std::size_t                             free_size_;
+            device_address                          identities_[ Size ];
+            address_resolver                        resolvers_[ Size ];
+            mutable resolution_cache< CacheSize >   cache_;
+        };
+
+        /**
+         * Hardware only implemenation
+         */
+        template < std::size_t Size, std::size_t CacheSize, typename Radio, typename LinkLayer >
+        class resolving_list_implementation< Size, CacheSize, false, Radio, LinkLayer >
+        {
+        public:
+            static constexpr std::size_t maximum_resolving_list_entries = Size;
+
+            std::size_t resolving_list_free_size() const
+            {
+                return this_to_radio().radio_resolving_list_free_size();
+            }
+
+            void clear_resolving_list()
+            {
+                this_to_radio().radio_clear_resolving_list();
+            }
+
+            bool add_to_resolving_list( const device_address& identity, const bluetoe::details::identity_resolving_key_t& irk )
+            {
+                return this_to_radio().radio_add_to_resolving_list( identity, irk );
+            }
+
+            bool remove_from_resolving_list( const device_address& identity )
+            {
+                return this_to_radio().radio_remove_from_resolving_list( identity );
+            }
+
+            bool is_in_resolving_list( const device_address& identity ) const
+            {
+                return this_to_radio().radio_is_in_resolving_list( identity );
+            }
+
+            std::pair< bool, device_address > resolve_address( const device_address& addr ) const
+            {
+                return this_to_radio().radio_resolve_address( addr );
+            }
+
+        private:
+            Radio& this_to_radio()
+            {
+                return static_cast< Radio& >( static_cast< LinkLayer& >( *this ) );
+            }
+
+            const Radio& this_to_radio() const
+            {
+                return static_cast< const Radio& >( static_cast< const LinkLayer& >( *this ) );
+            }
+        };
+    }
+
+    /** @cond HIDDEN_SYMBOLS */
+    template < std::size_t Size, std::size_t CacheSize >
+    template < class Radio, class LinkLayer >
+    struct resolving_list< Size, CacheSize >::impl :
+        details::resolving_list_implementation<
+            Size,
+            CacheSize,
+            ( Size > details::radio_resolving_list_entries< Radio >::value ),
+            Radio,
+            LinkLayer
+        >
+    {
+    };
+    /** @endcond */
+}
+}
+#endif
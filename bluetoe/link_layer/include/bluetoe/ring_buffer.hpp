@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <cassert>
 #include <cstdlib>
+#include <atomic>
 
 #include <bluetoe/buffer.hpp>
 #include <bluetoe/default_pdu_layout.hpp>
@@ -91,6 +92,30 @@ namespace link_layer {
          */
         bool more_than_one() const;
 
+        /**
+         * @brief position of the oldest element and the position, where the next element will be stored
+         *
+         * The positions allow to park the content of a ring: the memory of the ring together with
+         * the positions can be copied out of the ring and restored later at the very same address.
+         */
+        struct positions
+        {
+            std::uint8_t* end;
+            std::uint8_t* front;
+        };
+
+        /**
+         * @brief the current positions of the ring
+         */
+        positions current_positions() const;
+
+        /**
+         * @brief restores positions, previously obtained by current_positions()
+         *
+         * @pre the memory of the ring contains the content, it contained, when the positions where obtained
+         */
+        void restore_positions( const positions& p );
+
     private:
         static constexpr std::size_t    ll_header_size = 2;
         static constexpr std::uint16_t  wrap_mark = 0;
@@ -201,6 +226,19 @@ namespace link_layer {
             end_ = buffer;
     }
 
+    template < std::size_t Size, typename Buffer, typename Layout >
+    typename pdu_ring_buffer< Size, Buffer, Layout >::positions pdu_ring_buffer< Size, Buffer, Layout >::current_positions() const
+    {
+        return positions{ end_, front_ };
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    void pdu_ring_buffer< Size, Buffer, Layout >::restore_positions( const positions& p )
+    {
+        end_   = p.end;
+        front_ = p.front;
+    }
+
     template < std::size_t Size, typename Buffer, typename Layout >
     template < class P >
     std::uint8_t pdu_ring_buffer< Size, Buffer, Layout >::pdu_length( const P& pdu )
@@ -221,6 +259,246 @@ namespace link_layer {
         return end_ != front_ && ( end_ + pdu_length( end_) ) != front_;
     }
 
+    /**
+     * @brief lock-free variant of pdu_ring_buffer for exactly one producer and one consumer
+     *
+     * The interface and the memory layout are the same as with pdu_ring_buffer, but the
+     * functions alloc_front() and push_front() (producer) can be called concurrently to next_end(),
+     * pop_end() and more_than_one() (consumer) without any further locking. This allows the link layer
+     * to fill the transmit ring, while the radio ISR takes PDUs out of the ring, without masking the
+     * radio interrupt.
+     *
+     * In contrast to pdu_ring_buffer, the producer never changes the end pointer. If the producer has to
+     * wrap around, the consumer detects the wrap mark that the producer left behind.
+     *
+     * @sa pdu_ring_buffer
+     */
+    template < std::size_t Size, typename Buffer = read_buffer, typename Layout = default_pdu_layout >
+    class spsc_pdu_ring_buffer
+    {
+    public:
+        /**
+         * @brief the size of the buffer in bytes
+         */
+        static constexpr std::size_t size = Size;
+
+        /**
+         * @brief sets up the ring to be empty
+         * @pre buffer must point to an array of at least Size bytes
+         */
+        explicit spsc_pdu_ring_buffer( std::uint8_t* buffer );
+
+        /**
+         * @brief resets the ring to be empty
+         *
+         * Must not be called concurrently with any other function.
+         * @pre buffer must point to an array of at least Size bytes
+         */
+        void reset( std::uint8_t* buffer );
+
+        /**
+         * @brief return a writeable PDU buffer of at least size bytes at the front of the ring
+         *
+         * Producer side.
+         * @sa pdu_ring_buffer::alloc_front
+         */
+        Buffer alloc_front( std::uint8_t* buffer, std::size_t size ) const;
+
+        /**
+         * @brief stores the allocated PDU in the ring and makes it visible to the consumer
+         *
+         * Producer side.
+         * @sa pdu_ring_buffer::push_front
+         */
+        void push_front( std::uint8_t* buffer, const Buffer& pdu );
+
+        /**
+         * @brief returns the next PDU from the ring.
+         *
+         * Consumer side. If no PDU is stored in the ring, the function will return an empty buffer.
+         */
+        Buffer next_end() const;
+
+        /**
+         * @brief frees the last PDU at the end of the ring
+         *
+         * Consumer side.
+         * @pre next_end().size != 0
+         */
+        void pop_end( std::uint8_t* buffer );
+
+        /**
+         * @brief returns true, if the buffer contains at least 2 elements
+         *
+         * Consumer side.
+         */
+        bool more_than_one() const;
+
+        /**
+         * @copydoc pdu_ring_buffer::positions
+         */
+        struct positions
+        {
+            std::uint8_t* end;
+            std::uint8_t* front;
+        };
+
+        /**
+         * @brief the current positions of the ring
+         *
+         * Must not be called concurrently with any other function.
+         */
+        positions current_positions() const;
+
+        /**
+         * @brief restores positions, previously obtained by current_positions()
+         *
+         * Must not be called concurrently with any other function.
+         * @pre the memory of the ring contains the content, it contained, when the positions where obtained
+         */
+        void restore_positions( const positions& p );
+
+    private:
+        static_assert( ATOMIC_POINTER_LOCK_FREE == 2, "spsc_pdu_ring_buffer requires lock-free atomic pointers" );
+
+        static constexpr std::uint16_t  wrap_mark = 0;
+
+        template < typename P >
+        static std::size_t pdu_length( P* );
+
+        // position of the oldest element, if end points to a wrap mark left by the producer
+        std::uint8_t* first_element( std::uint8_t* end, const std::uint8_t* front ) const;
+
+        std::uint8_t*                   buffer_;
+
+        // written by the consumer only
+        std::atomic< std::uint8_t* >    end_;
+
+        // written by the producer only
+        std::atomic< std::uint8_t* >    front_;
+    };
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    spsc_pdu_ring_buffer< Size, Buffer, Layout >::spsc_pdu_ring_buffer( std::uint8_t* buffer )
+    {
+        reset( buffer );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    void spsc_pdu_ring_buffer< Size, Buffer, Layout >::reset( std::uint8_t* buffer )
+    {
+        assert( buffer );
+        buffer_ = buffer;
+
+        Layout::header( buffer, wrap_mark );
+
+        end_.store( buffer, std::memory_order_relaxed );
+        front_.store( buffer, std::memory_order_release );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    Buffer spsc_pdu_ring_buffer< Size, Buffer, Layout >::alloc_front( std::uint8_t* buffer, std::size_t size ) const
+    {
+        assert( buffer == buffer_ );
+        assert( size >= Layout::data_channel_pdu_memory_size( 0 ) );
+
+        // a stale end only underestimates the available room
+        std::uint8_t* const front = front_.load( std::memory_order_relaxed );
+        std::uint8_t* const end   = end_.load( std::memory_order_acquire );
+
+        if ( end > front && static_cast< std::ptrdiff_t >( size ) < end - front )
+            return Buffer{ front, size };
+
+        if ( front >= end )
+        {
+            if ( static_cast< std::ptrdiff_t >( size ) <= buffer + Size - front )
+                return Buffer{ front, size };
+
+            if ( static_cast< std::ptrdiff_t >( size ) < end - buffer )
+                return Buffer{ buffer, size };
+        }
+
+        return Buffer{ 0, 0 };
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    void spsc_pdu_ring_buffer< Size, Buffer, Layout >::push_front( std::uint8_t* buffer, const Buffer& pdu )
+    {
+        assert( pdu.size >= pdu_length( pdu.buffer ) );
+
+        std::uint8_t* const front = front_.load( std::memory_order_relaxed );
+
+        // leave a wrap mark for the consumer, before the PDU becomes visible
+        if ( front != pdu.buffer && front + 1 < buffer + Size )
+            Layout::header( front, wrap_mark );
+
+        front_.store( pdu.buffer + pdu_length( pdu.buffer ), std::memory_order_release );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    Buffer spsc_pdu_ring_buffer< Size, Buffer, Layout >::next_end() const
+    {
+        const std::uint8_t* const front = front_.load( std::memory_order_acquire );
+        std::uint8_t* const       end   = first_element( end_.load( std::memory_order_relaxed ), front );
+
+        return front == end
+            ? Buffer{ 0, 0 }
+            : Buffer{ end, pdu_length( end ) };
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    void spsc_pdu_ring_buffer< Size, Buffer, Layout >::pop_end( std::uint8_t* buffer )
+    {
+        assert( buffer == buffer_ );
+        static_cast< void >( buffer );
+
+        const std::uint8_t* const front = front_.load( std::memory_order_acquire );
+        std::uint8_t*             end   = first_element( end_.load( std::memory_order_relaxed ), front );
+
+        assert( end != front );
+        end += pdu_length( end );
+
+        // releases the memory of the PDU to the producer
+        end_.store( first_element( end, front ), std::memory_order_release );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    bool spsc_pdu_ring_buffer< Size, Buffer, Layout >::more_than_one() const
+    {
+        const std::uint8_t* const front = front_.load( std::memory_order_acquire );
+        std::uint8_t* const       end   = first_element( end_.load( std::memory_order_relaxed ), front );
+
+        return end != front && ( end + pdu_length( end ) ) != front;
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    typename spsc_pdu_ring_buffer< Size, Buffer, Layout >::positions spsc_pdu_ring_buffer< Size, Buffer, Layout >::current_positions() const
+    {
+        return positions{ end_.load( std::memory_order_relaxed ), front_.load( std::memory_order_relaxed ) };
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    void spsc_pdu_ring_buffer< Size, Buffer, Layout >::restore_positions( const positions& p )
+    {
+        end_.store( p.end, std::memory_order_relaxed );
+        front_.store( p.front, std::memory_order_release );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    std::uint8_t* spsc_pdu_ring_buffer< Size, Buffer, Layout >::first_element( std::uint8_t* end, const std::uint8_t* front ) const
+    {
+        return end != front && ( end + 1 >= buffer_ + Size || end[ 1 ] == wrap_mark )
+            ? buffer_
+            : end;
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    template < typename P >
+    std::size_t spsc_pdu_ring_buffer< Size, Buffer, Layout >::pdu_length( P* p )
+    {
+        return Layout::data_channel_pdu_memory_size( Layout::header( p ) >> 8 );
+    }
+
 }
 }
 
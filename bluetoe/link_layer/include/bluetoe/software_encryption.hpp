@@ -0,0 +1,419 @@
+#ifndef BLUETOE_LINK_LAYER_SOFTWARE_ENCRYPTION_HPP
+#define BLUETOE_LINK_LAYER_SOFTWARE_ENCRYPTION_HPP
+
+#include <bluetoe/aes.hpp>
+#include <bluetoe/buffer.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <utility>
+#include <algorithm>
+
+namespace bluetoe {
+namespace link_layer {
+
+    namespace details {
+        /*
+         * AES-CCM as used by the link layer (Core Spec Vol 6, Part E): 13 octet nonce build from the packet counter,
+         * the direction bit and the IV, the first header octet as additional authenticated data and a 4 octet MIC.
+         */
+        class ll_ccm
+        {
+        public:
+            static constexpr std::size_t block_size       = bluetoe::details::aes128::block_size;
+            static constexpr std::size_t mic_size         = 4;
+            static constexpr std::size_t max_payload_size = 251;
+
+            // S0, followed by S1 to Sn, that are required to encrypt a payload of max_payload_size
+            static constexpr std::size_t max_key_stream_blocks = 1 + ( max_payload_size + block_size - 1 ) / block_size;
+
+            /*
+             * number of key stream blocks, that are required to encrypt / decrypt a payload of the given size
+             */
+            static constexpr std::size_t key_stream_blocks( std::size_t payload_size )
+            {
+                return 1 + ( payload_size + block_size - 1 ) / block_size;
+            }
+
+            /*
+             * a session with a key of all zeros
+             */
+            ll_ccm();
+
+            /*
+             * 16 octet session_key in little endian, as it is calculated by session_key(), iv = IVs || IVm
+             */
+            ll_ccm( const std::uint8_t* session_key, std::uint64_t iv );
+
+            /*
+             * SK = e( LTK, SKDs || SKDm ), 16 octet long term key and session key in little endian
+             */
+            static void session_key( const std::uint8_t* long_term_key, std::uint64_t skdm, std::uint64_t skds, std::uint8_t* session_key );
+
+            /*
+             * calculates the key stream blocks [ first, last ) for the given packet counter and direction
+             */
+            void key_stream( std::uint64_t packet_counter, bool central_to_peripheral,
+                std::size_t first, std::size_t last, std::uint8_t* stream ) const;
+
+            /*
+             * encrypts the payload in place and writes the MIC behind the payload
+             *
+             * key_stream must contain at least key_stream_blocks( size ) blocks for the same
+             * packet counter and direction.
+             */
+            void encrypt( std::uint8_t header, std::uint8_t* payload, std::size_t size,
+                std::uint64_t packet_counter, bool central_to_peripheral, const std::uint8_t* key_stream ) const;
+
+            /*
+             * decrypts the payload in place and returns true, if the MIC, that follows the size octets
+             * of payload, matches.
+             */
+            bool decrypt( std::uint8_t header, std::uint8_t* payload, std::size_t size,
+                std::uint64_t packet_counter, bool central_to_peripheral, const std::uint8_t* key_stream ) const;
+
+        private:
+            void nonce( std::uint64_t packet_counter, bool central_to_peripheral, std::uint8_t* block ) const;
+
+            // CBC-MAC over B0, the additional authenticated data and the unencrypted payload
+            void authenticate( std::uint8_t header, const std::uint8_t* payload, std::size_t size,
+                std::uint64_t packet_counter, bool central_to_peripheral, std::uint8_t* tag ) const;
+
+            bluetoe::details::aes128    cipher_;
+            std::uint8_t                iv_[ 8 ];
+        };
+    }
+
+    /**
+     * @brief software implementation of the link layer encryption for radios without crypto hardware
+     *
+     * A scheduled radio, that can not rely on a hardware CCM unit, can derive from this class to implement
+     * the link layer encryption interface (start_receive_encrypted(), stop_transmit_encrypted(),
+     * increment_receive_packet_counter() etc.) in software. The radio implements setup_encryption() by
+     * calling setup_session() with random values for SKDs and IVs. Before a PDU is transmitted, the radio
+     * passes it to encrypt() and every received PDU is passed to decrypt() before it is handed to the
+     * ll_data_pdu_buffer. A failed MIC check has to be handled like a CRC error. Layout is the PDU layout
+     * of the radio.
+     *
+     * The key stream of a PDU depends only on the session key and on the packet counter. A radio can call
+     * prepare() when it is idle (for example after a connection event or while the next transmit PDU
+     * is being prepared) to calculate the key streams for the next PDU in both directions in advance. Then,
+     * encrypting and decrypting a PDU just requires the calculation of the MIC. Without calling prepare(),
+     * the key stream is calculated on demand.
+     *
+     * @sa scheduled_radio_with_encryption
+     */
+    template < class Layout >
+    class software_encryption
+    {
+    public:
+        /**
+         * @brief size of the message integrity check, that is appended to every encrypted PDU
+         */
+        static constexpr std::size_t mic_size = details::ll_ccm::mic_size;
+
+        software_encryption();
+
+        /**
+         * @brief derives the session key and the IV from the long term key and from the values exchanged
+         *        with LL_ENC_REQ and LL_ENC_RSP
+         *
+         * key is the 16 octet long term key in little endian. skds and ivs are the random values of the
+         * peripheral, that are returned to be sent to the central. Both packet counters are reset.
+         */
+        std::pair< std::uint64_t, std::uint32_t > setup_session( const std::uint8_t* key,
+            std::uint64_t skdm, std::uint32_t ivm, std::uint64_t skds, std::uint32_t ivs );
+
+        /**@{*/
+        /**
+         * @name part of the interface of a radio with encryption support
+         *
+         * Starting the encryption of a direction resets the packet counter of that direction, as the PDUs
+         * that are exchanged unencrypted after setup_session() (LL_ENC_RSP, LL_START_ENC_REQ) are counted too.
+         */
+        void start_receive_encrypted();
+        void start_transmit_encrypted();
+        void stop_receive_encrypted();
+        void stop_transmit_encrypted();
+
+        void increment_receive_packet_counter();
+        void increment_transmit_packet_counter();
+        /**@}*/
+
+        /**
+         * @brief returns the PDU to be transmitted
+         *
+         * If transmit encryption is started and the PDU is not empty, the PDU is encrypted into encrypted and
+         * the returned buffer refers to encrypted. Otherwise, pdu is returned. As a PDU might be retransmitted, pdu
+         * itself is never changed. encrypted must be large enough to store the PDU plus mic_size octets; with
+         * a maximum payload of 251 octets, the encrypted payload can be up to 255 octets long.
+         */
+        write_buffer encrypt( const write_buffer& pdu, const read_buffer& encrypted );
+
+        /**
+         * @brief decrypts a received PDU in place
+         *
+         * If receive encryption is started and the PDU is not empty, the PDU is decrypted and the MIC is
+         * removed from the PDU. Returns false, if the MIC does not match.
+         */
+        bool decrypt( const read_buffer& pdu );
+
+        /**
+         * @brief calculates the key streams for the next PDU to be transmitted and the next PDU to be received
+         *
+         * transmit_size and receive_size are the maximum payload sizes of the PDUs.
+         */
+        void prepare( std::size_t transmit_size, std::size_t receive_size );
+
+        /**
+         * @brief true, if received PDUs are decrypted
+         */
+        bool receive_encrypted() const;
+
+        /**
+         * @brief true, if transmitted PDUs are encrypted
+         */
+        bool transmit_encrypted() const;
+
+        /**
+         * @brief session key, IV, encryption state and packet counters of a connection
+         *
+         * A default constructed context denotes an unencrypted connection.
+         */
+        struct encryption_context
+        {
+            encryption_context();
+
+            details::ll_ccm     ccm;
+            bool                receive_encrypted;
+            bool                transmit_encrypted;
+            std::uint64_t       receive_counter;
+            std::uint64_t       transmit_counter;
+        };
+
+        /**
+         * @brief copies the encryption state of the current connection into context
+         */
+        void store_encryption_context( encryption_context& context ) const;
+
+        /**
+         * @brief restores the encryption state of a connection, previously stored by store_encryption_context()
+         */
+        void restore_encryption_context( const encryption_context& context );
+
+    private:
+        struct key_stream_cache
+        {
+            std::uint64_t   packet_counter;
+            std::size_t     blocks;
+            std::uint8_t    stream[ details::ll_ccm::max_key_stream_blocks * details::ll_ccm::block_size ];
+        };
+
+        const std::uint8_t* key_stream( key_stream_cache& cache, std::uint64_t packet_counter, bool central_to_peripheral, std::size_t size );
+
+        static constexpr std::uint64_t packet_counter_mask = ( std::uint64_t( 1 ) << 39 ) - 1;
+
+        details::ll_ccm     ccm_;
+        bool                receive_encrypted_;
+        bool                transmit_encrypted_;
+        std::uint64_t       receive_counter_;
+        std::uint64_t       transmit_counter_;
+        key_stream_cache    receive_stream_;
+        key_stream_cache    transmit_stream_;
+    };
+
+    // implementation
+    template < class Layout >
+    software_encryption< Layout >::software_encryption()
+        : receive_encrypted_( false )
+        , transmit_encrypted_( false )
+        , receive_counter_( 0 )
+        , transmit_counter_( 0 )
+    {
+        receive_stream_.blocks  = 0;
+        transmit_stream_.blocks = 0;
+    }
+
+    template < class Layout >
+    software_encryption< Layout >::encryption_context::encryption_context()
+        : receive_encrypted( false )
+        , transmit_encrypted( false )
+        , receive_counter( 0 )
+        , transmit_counter( 0 )
+    {
+    }
+
+    template < class Layout >
+    void software_encryption< Layout >::store_encryption_context( encryption_context& context ) const
+    {
+        context.ccm                 = ccm_;
+        context.receive_encrypted   = receive_encrypted_;
+        context.transmit_encrypted  = transmit_encrypted_;
+        context.receive_counter     = receive_counter_;
+        context.transmit_counter    = transmit_counter_;
+    }
+
+    template < class Layout >
+    void software_encryption< Layout >::restore_encryption_context( const encryption_context& context )
+    {
+        ccm_                    = context.ccm;
+        receive_encrypted_      = context.receive_encrypted;
+        transmit_encrypted_     = context.transmit_encrypted;
+        receive_counter_        = context.receive_counter;
+        transmit_counter_       = context.transmit_counter;
+        receive_stream_.blocks  = 0;
+        transmit_stream_.blocks = 0;
+    }
+
+    template < class Layout >
+    std::pair< std::uint64_t, std::uint32_t > software_encryption< Layout >::setup_session( const std::uint8_t* key,
+        std::uint64_t skdm, std::uint32_t ivm, std::uint64_t skds, std::uint32_t ivs )
+    {
+        std::uint8_t session_key[ details::ll_ccm::block_size ];
+        details::ll_ccm::session_key( key, skdm, skds, session_key );
+
+        ccm_ = details::ll_ccm(
+            session_key,
+            static_cast< std::uint64_t >( ivm ) | ( static_cast< std::uint64_t >( ivs ) << 32 ) );
+
+        receive_counter_        = 0;
+        transmit_counter_       = 0;
+        receive_stream_.blocks  = 0;
+        transmit_stream_.blocks = 0;
+
+        return { skds, ivs };
+    }
+
+    template < class Layout >
+    void software_encryption< Layout >::start_receive_encrypted()
+    {
+        receive_encrypted_ = true;
+        receive_counter_   = 0;
+    }
+
+    template < class Layout >
+    void software_encryption< Layout >::start_transmit_encrypted()
+    {
+        transmit_encrypted_ = true;
+        transmit_counter_   = 0;
+    }
+
+    template < class Layout >
+    void software_encryption< Layout >::stop_receive_encrypted()
+    {
+        receive_encrypted_ = false;
+    }
+
+    template < class Layout >
+    void software_encryption< Layout >::stop_transmit_encrypted()
+    {
+        transmit_encrypted_ = false;
+    }
+
+    template < class Layout >
+    void software_encryption< Layout >::increment_receive_packet_counter()
+    {
+        receive_counter_ = ( receive_counter_ + 1 ) & packet_counter_mask;
+    }
+
+    template < class Layout >
+    void software_encryption< Layout >::increment_transmit_packet_counter()
+    {
+        transmit_counter_ = ( transmit_counter_ + 1 ) & packet_counter_mask;
+    }
+
+    template < class Layout >
+    write_buffer software_encryption< Layout >::encrypt( const write_buffer& pdu, const read_buffer& encrypted )
+    {
+        const std::uint16_t header = Layout::header( pdu );
+        const std::size_t   size   = header >> 8;
+
+        if ( !transmit_encrypted_ || size == 0 )
+            return pdu;
+
+        assert( size <= details::ll_ccm::max_payload_size );
+        assert( encrypted.size >= Layout::data_channel_pdu_memory_size( size + mic_size ) );
+
+        const read_buffer result{ encrypted.buffer, Layout::data_channel_pdu_memory_size( size + mic_size ) };
+        Layout::header( result, static_cast< std::uint16_t >( ( header & 0x00ff ) | ( ( size + mic_size ) << 8 ) ) );
+
+        std::uint8_t* const payload = Layout::body( result ).first;
+        std::copy( Layout::body( pdu ).first, Layout::body( pdu ).first + size, payload );
+
+        ccm_.encrypt( static_cast< std::uint8_t >( header ), payload, size, transmit_counter_, false,
+            key_stream( transmit_stream_, transmit_counter_, false, size ) );
+
+        return write_buffer( result );
+    }
+
+    template < class Layout >
+    bool software_encryption< Layout >::decrypt( const read_buffer& pdu )
+    {
+        const std::uint16_t header = Layout::header( pdu );
+        const std::size_t   size   = header >> 8;
+
+        if ( !receive_encrypted_ || size == 0 )
+            return true;
+
+        if ( size < mic_size )
+            return false;
+
+        const std::size_t payload_size = size - mic_size;
+
+        if ( !ccm_.decrypt( static_cast< std::uint8_t >( header ), Layout::body( pdu ).first, payload_size, receive_counter_, true,
+            key_stream( receive_stream_, receive_counter_, true, payload_size ) ) )
+        {
+            return false;
+        }
+
+        Layout::header( pdu, static_cast< std::uint16_t >( ( header & 0x00ff ) | ( payload_size << 8 ) ) );
+
+        return true;
+    }
+
+    template < class Layout >
+    void software_encryption< Layout >::prepare( std::size_t transmit_size, std::size_t receive_size )
+    {
+        if ( transmit_encrypted_ )
+            key_stream( transmit_stream_, transmit_counter_, false, std::min( transmit_size, details::ll_ccm::max_payload_size ) );
+
+        if ( receive_encrypted_ )
+            key_stream( receive_stream_, receive_counter_, true, std::min( receive_size, details::ll_ccm::max_payload_size ) );
+    }
+
+    template < class Layout >
+    bool software_encryption< Layout >::receive_encrypted() const
+    {
+        return receive_encrypted_;
+    }
+
+    template < class Layout >
+    bool software_encryption< Layout >::transmit_encrypted() const
+    {
+        return transmit_encrypted_;
+    }
+
+    template < class Layout >
+    const std::uint8_t* software_encryption< Layout >::key_stream(
+        key_stream_cache& cache, std::uint64_t packet_counter, bool central_to_peripheral, std::size_t size )
+    {
+        if ( cache.blocks != 0 && cache.packet_counter != packet_counter )
+            cache.blocks = 0;
+
+        const std::size_t required = details::ll_ccm::key_stream_blocks( size );
+
+        if ( cache.blocks < required )
+        {
+            ccm_.key_stream( packet_counter, central_to_peripheral, cache.blocks, required, cache.stream );
+
+            cache.packet_counter = packet_counter;
+            cache.blocks         = required;
+        }
+
+        return cache.stream;
+    }
+}
+}
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <bluetoe/address.hpp>
 #include <bluetoe/ll_meta_types.hpp>
+#include <bluetoe/resolving_list.hpp>
 
 #include <iterator>
 #include <algorithm>
@@ -25,6 +26,9 @@ namespace link_layer {
      * @note the functions is_connection_request_in_filter() and is_scan_request_in_filter() might
      *       return always true, for a hardware implementation and the hardware would then not
      *       call the receive callback for devices that are not within the white list.
+     *
+     * If the link layer has a resolving_list, a device using a resolvable private address passes the
+     * filters, if its identity address is within the white list.
      */
     template < std::size_t Size = 8 >
     class white_list
@@ -249,15 +253,22 @@ namespace link_layer {
 
             bool is_connection_request_in_filter( const device_address& addr ) const
             {
-                return !connection_filter_ || is_in_white_list( addr );
+                return !connection_filter_ || is_in_white_list( addr ) || is_identity_in_white_list( addr );
             }
 
             bool is_scan_request_in_filter( const device_address& addr ) const
             {
-                return !scan_filter_ || is_in_white_list( addr );
+                return !scan_filter_ || is_in_white_list( addr ) || is_identity_in_white_list( addr );
             }
 
         private:
+            bool is_identity_in_white_list( const device_address& addr ) const
+            {
+                const auto identity = resolve_address( static_cast< const LinkLayer& >( *this ), addr );
+
+                return identity.first && is_in_white_list( identity.second );
+            }
+
             bool            active_;
             std::size_t     free_size_;
             device_address  addresses_[ Size ];
@@ -321,12 +332,22 @@ namespace link_layer {
 
             bool is_connection_request_in_filter( const device_address& addr ) const
             {
-                return this_to_radio().radio_is_connection_request_in_filter( addr );
+                if ( this_to_radio().radio_is_connection_request_in_filter( addr ) )
+                    return true;
+
+                const auto identity = resolve_address( static_cast< const LinkLayer& >( *this ), addr );
+
+                return identity.first && this_to_radio().radio_is_connection_request_in_filter( identity.second );
             }
 
             bool is_scan_request_in_filter( const device_address& addr ) const
             {
-                return this_to_radio().radio_is_scan_request_in_filter( addr );
+                if ( this_to_radio().radio_is_scan_request_in_filter( addr ) )
+                    return true;
+
+                const auto identity = resolve_address( static_cast< const LinkLayer& >( *this ), addr );
+
+                return identity.first && this_to_radio().radio_is_scan_request_in_filter( identity.second );
             }
         private:
             Radio& this_to_radio()
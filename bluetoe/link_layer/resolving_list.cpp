@@ -0,0 +1,54 @@
+#include <bluetoe/resolving_list.hpp>
+
+namespace bluetoe {
+namespace link_layer {
+namespace details {
+
+    namespace {
+        constexpr std::size_t hash_size  = 3;
+        constexpr std::size_t prand_size = 3;
+
+        const std::uint8_t zero_irk[ address_resolver::block_size ] = { 0 };
+
+        // the AES takes the key with the most significant octet first
+        struct reversed_key
+        {
+            explicit reversed_key( const std::uint8_t* key )
+            {
+                std::reverse_copy( key, key + address_resolver::block_size, octets );
+            }
+
+            std::uint8_t octets[ address_resolver::block_size ];
+        };
+    }
+
+    address_resolver::address_resolver()
+        : address_resolver( zero_irk )
+    {
+    }
+
+    address_resolver::address_resolver( const std::uint8_t* irk )
+        : cipher_( reversed_key( irk ).octets )
+    {
+    }
+
+    // r' = padding || prand, with the most significant octet first; prand are the upper 3 octets of the address
+    void address_resolver::prand_block( const device_address& rpa, std::uint8_t* block )
+    {
+        std::fill( block, block + block_size - prand_size, 0 );
+        std::reverse_copy( rpa.begin() + hash_size, rpa.end(), block + block_size - prand_size );
+    }
+
+    // the hash are the lower 3 octets of the address and the least significant octets of e( irk, r' )
+    bool address_resolver::resolves( const std::uint8_t* block, const device_address& rpa ) const
+    {
+        std::uint8_t result[ block_size ];
+        cipher_.encrypt( block, result );
+
+        return std::equal( rpa.begin(), rpa.begin() + hash_size,
+            std::reverse_iterator< const std::uint8_t* >( &result[ block_size ] ) );
+    }
+
+}
+}
+}
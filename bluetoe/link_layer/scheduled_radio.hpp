@@ -272,7 +272,8 @@ namespace link_layer {
      * @brief extension of a scheduled_radio with functions to support encryption
      *
      * To allow the utilization of hardware support for certain cryptographical functions,
-     * this interface abstracts at a quite high level.
+     * this interface abstracts at a quite high level. Radios without a hardware CCM unit can
+     * implement the link layer encryption by deriving from software_encryption.
      */
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
     class scheduled_radio_with_encryption : public scheduled_radio< TransmitSize, ReceiveSize, CallBack >
@@ -428,6 +429,27 @@ namespace link_layer {
          * @brief stop transmitting encrypted with the next connection event.
          */
         void stop_transmit_encrypted();
+
+        /**
+         * @brief optional: keys, encryption state and packet counters of a single connection
+         *
+         * A default constructed context denotes an unencrypted connection. A radio, that provides
+         * this type and the two functions below, can be used by a link layer, that serves more than
+         * one connection at the same time (see max_concurrent_connections).
+         */
+        struct encryption_context {};
+
+        /**
+         * @brief optional: copies the encryption state of the current connection into context
+         */
+        void store_encryption_context( encryption_context& context ) const;
+
+        /**
+         * @brief optional: restores the encryption state of a connection
+         *
+         * Will not be called during a connection event.
+         */
+        void restore_encryption_context( const encryption_context& context );
     };
 
     /**
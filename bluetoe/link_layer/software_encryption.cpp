@@ -0,0 +1,150 @@
+#include <bluetoe/software_encryption.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace bluetoe {
+namespace link_layer {
+namespace details {
+
+    namespace {
+        constexpr std::uint8_t b0_flags            = 0x49;
+        constexpr std::uint8_t a_flags             = 0x01;
+        constexpr std::uint8_t header_mask         = 0xe3;
+        constexpr std::size_t  nonce_offset        = 1;
+        constexpr std::size_t  nonce_size          = 13;
+
+        void xor_block( std::uint8_t* block, const std::uint8_t* data, std::size_t size )
+        {
+            for ( std::size_t i = 0; i != size; ++i )
+                block[ i ] ^= data[ i ];
+        }
+
+        const std::uint8_t zero_key[ ll_ccm::block_size ] = { 0 };
+
+        // the AES takes the key with the most significant octet first
+        struct reversed_key
+        {
+            explicit reversed_key( const std::uint8_t* key )
+            {
+                std::reverse_copy( key, key + ll_ccm::block_size, octets );
+            }
+
+            std::uint8_t octets[ ll_ccm::block_size ];
+        };
+    }
+
+    ll_ccm::ll_ccm()
+        : ll_ccm( zero_key, 0 )
+    {
+    }
+
+    ll_ccm::ll_ccm( const std::uint8_t* session_key, std::uint64_t iv )
+        : cipher_( reversed_key( session_key ).octets )
+    {
+        for ( std::size_t i = 0; i != sizeof( iv_ ); ++i, iv >>= 8 )
+            iv_[ i ] = static_cast< std::uint8_t >( iv );
+    }
+
+    void ll_ccm::session_key( const std::uint8_t* long_term_key, std::uint64_t skdm, std::uint64_t skds, std::uint8_t* session_key )
+    {
+        // e() takes and returns the most significant octet first
+        std::uint8_t diversifier[ block_size ];
+
+        for ( std::size_t i = 0; i != 8; ++i )
+        {
+            diversifier[ 15 - i ] = static_cast< std::uint8_t >( skdm >> ( 8 * i ) );
+            diversifier[ 7 - i ]  = static_cast< std::uint8_t >( skds >> ( 8 * i ) );
+        }
+
+        bluetoe::details::aes128_encrypt( reversed_key( long_term_key ).octets, diversifier, diversifier );
+        std::reverse_copy( std::begin( diversifier ), std::end( diversifier ), session_key );
+    }
+
+    void ll_ccm::nonce( std::uint64_t packet_counter, bool central_to_peripheral, std::uint8_t* block ) const
+    {
+        for ( std::size_t i = 0; i != 5; ++i, packet_counter >>= 8 )
+            block[ i ] = static_cast< std::uint8_t >( packet_counter );
+
+        block[ 4 ] = static_cast< std::uint8_t >( ( block[ 4 ] & 0x7f ) | ( central_to_peripheral ? 0x80 : 0x00 ) );
+
+        std::copy( std::begin( iv_ ), std::end( iv_ ), &block[ 5 ] );
+    }
+
+    void ll_ccm::key_stream( std::uint64_t packet_counter, bool central_to_peripheral,
+        std::size_t first, std::size_t last, std::uint8_t* stream ) const
+    {
+        std::uint8_t counter_block[ block_size ];
+        counter_block[ 0 ] = a_flags;
+        nonce( packet_counter, central_to_peripheral, &counter_block[ nonce_offset ] );
+
+        for ( std::size_t i = first; i != last; ++i )
+        {
+            counter_block[ 14 ] = static_cast< std::uint8_t >( i >> 8 );
+            counter_block[ 15 ] = static_cast< std::uint8_t >( i );
+
+            cipher_.encrypt( counter_block, &stream[ i * block_size ] );
+        }
+    }
+
+    void ll_ccm::authenticate( std::uint8_t header, const std::uint8_t* payload, std::size_t size,
+        std::uint64_t packet_counter, bool central_to_peripheral, std::uint8_t* tag ) const
+    {
+        // B0
+        tag[ 0 ] = b0_flags;
+        nonce( packet_counter, central_to_peripheral, &tag[ nonce_offset ] );
+        tag[ nonce_offset + nonce_size ] = static_cast< std::uint8_t >( size >> 8 );
+        tag[ nonce_offset + nonce_size + 1 ] = static_cast< std::uint8_t >( size );
+
+        cipher_.encrypt( tag, tag );
+
+        // B1: length of the additional authenticated data, followed by the masked first header octet
+        tag[ 1 ] ^= 0x01;
+        tag[ 2 ] ^= header & header_mask;
+
+        cipher_.encrypt( tag, tag );
+
+        for ( ; size != 0; )
+        {
+            const std::size_t block = std::min( size, block_size );
+
+            xor_block( tag, payload, block );
+            cipher_.encrypt( tag, tag );
+
+            payload += block;
+            size    -= block;
+        }
+    }
+
+    void ll_ccm::encrypt( std::uint8_t header, std::uint8_t* payload, std::size_t size,
+        std::uint64_t packet_counter, bool central_to_peripheral, const std::uint8_t* key_stream ) const
+    {
+        std::uint8_t tag[ block_size ];
+        authenticate( header, payload, size, packet_counter, central_to_peripheral, tag );
+
+        xor_block( payload, &key_stream[ block_size ], size );
+
+        for ( std::size_t i = 0; i != mic_size; ++i )
+            payload[ size + i ] = tag[ i ] ^ key_stream[ i ];
+    }
+
+    bool ll_ccm::decrypt( std::uint8_t header, std::uint8_t* payload, std::size_t size,
+        std::uint64_t packet_counter, bool central_to_peripheral, const std::uint8_t* key_stream ) const
+    {
+        xor_block( payload, &key_stream[ block_size ], size );
+
+        std::uint8_t tag[ block_size ];
+        authenticate( header, payload, size, packet_counter, central_to_peripheral, tag );
+
+        // compare without an early exit
+        std::uint8_t difference = 0;
+
+        for ( std::size_t i = 0; i != mic_size; ++i )
+            difference |= static_cast< std::uint8_t >( payload[ size + i ] ^ tag[ i ] ^ key_stream[ i ] );
+
+        return difference == 0;
+    }
+
+}
+}
+}
@@ -8,6 +8,8 @@
 #include <algorithm>
 #include <iterator>
 
+#include <bluetoe/bits.hpp>
+
 namespace bluetoe {
 
     namespace details {
@@ -39,8 +41,8 @@ namespace bluetoe {
      * @param Mixin a class to be mixed in, to allow empty base class optimizations
      *
      * For all function, index is an index into a list of all the characterstics with notifications / indications
-     * enable. The queue is implemented by an array that contains a few bits (2) per characteristic to store the
-     * requested (or queued) notifications / indications.
+     * enable. The queue is implemented by two bitmaps of 32 bit words, one for the requested (or queued) notifications
+     * and one for the requested indications. The next entry to be send is found by scanning for the next set bit.
      */
     template < typename Sizes, class Mixin >
     class notification_queue : public Mixin, details::notification_queue_impl_base< Sizes, 0 >
@@ -109,6 +111,14 @@ namespace bluetoe {
          */
         std::pair< details::notification_queue_entry_type, std::size_t > dequeue_indication_or_confirmation();
 
+        /**
+         * @brief return a next notification to be send.
+         *
+         * Like dequeue_indication_or_confirmation(), but queued indications are not taken into account and
+         * stay in the queue. The function is intended to fill up a PDU with further notifications.
+         */
+        std::pair< details::notification_queue_entry_type, std::size_t > dequeue_notification();
+
         /**
          * @brief removes all entries from the queue
          */
@@ -154,6 +164,12 @@ namespace bluetoe {
         return result;
     }
 
+    template < typename Sizes, class Mixin >
+    std::pair< details::notification_queue_entry_type, std::size_t > notification_queue< Sizes, Mixin >::dequeue_notification()
+    {
+        return impl::dequeue_notification( 0 );
+    }
+
     template < typename Sizes, class Mixin >
     void notification_queue< Sizes, Mixin >::clear_indications_and_confirmations()
     {
@@ -176,93 +192,117 @@ namespace bluetoe {
             bool queue_notification( std::size_t index )
             {
                 assert( index < Size );
-                return add( index, notification_bit );
+                return add( notifications_, index );
             }
 
             bool queue_indication( std::size_t index )
             {
                 assert( index < Size );
 
-                return add( index, indication_bit );
+                return add( indications_, index );
             }
 
             std::pair< notification_queue_entry_type, std::size_t > dequeue_indication_or_confirmation( std::size_t offset, std::size_t& outstanding_confirmation )
             {
-                bool ignore_first = true;
+                const bool        indications_allowed = outstanding_confirmation == no_outstanding_indicaton;
+                const std::size_t i                   = next_pending( indications_allowed );
 
-                // loop over all entries in a circle
-                for ( std::size_t i = next_; ignore_first || i != next_; i = ( i + 1 ) % Size )
-                {
-                    ignore_first = false;
-                    auto entry = at( i );
-
-                    if ( entry & indication_bit && outstanding_confirmation == no_outstanding_indicaton )
-                    {
-                        outstanding_confirmation = i + offset;
-                        next_ = ( i + 1 ) % Size;
-                        remove( i, indication_bit );
-                        return { notification_queue_entry_type::indication, i + offset };
-                    }
-                    else if ( entry & notification_bit )
-                    {
-                        next_ = ( i + 1 ) % Size;
-                        remove( i, notification_bit );
-                        return { notification_queue_entry_type::notification, i + offset };
-                    }
+                if ( i == Size )
+                    return { notification_queue_entry_type::empty, 0 };
 
+                next_ = ( i + 1 ) % Size;
+
+                if ( indications_allowed && remove( indications_, i ) )
+                {
+                    outstanding_confirmation = i + offset;
+                    return { notification_queue_entry_type::indication, i + offset };
                 }
 
-                return { notification_queue_entry_type::empty, 0 };
+                remove( notifications_, i );
+                return { notification_queue_entry_type::notification, i + offset };
+            }
+
+            std::pair< notification_queue_entry_type, std::size_t > dequeue_notification( std::size_t offset )
+            {
+                const std::size_t i = next_pending( false );
+
+                if ( i == Size )
+                    return { notification_queue_entry_type::empty, 0 };
+
+                next_ = ( i + 1 ) % Size;
+                remove( notifications_, i );
+
+                return { notification_queue_entry_type::notification, i + offset };
             }
 
             void clear_indications_and_confirmations()
             {
                 next_ = 0;
-                std::fill( std::begin( queue_ ), std::end( queue_ ), 0 );
+                std::fill( std::begin( notifications_ ), std::end( notifications_ ), 0 );
+                std::fill( std::begin( indications_ ), std::end( indications_ ), 0 );
             }
 
         private:
-            int at( std::size_t index )
-            {
-                const auto bit_offset  = ( index * bits_per_characteristc ) % 8;
-                const auto byte_offset = index * bits_per_characteristc / 8;
-                assert( byte_offset < sizeof( queue_ ) / sizeof( queue_[ 0 ] ) );
+            using word_t = std::uint32_t;
 
-                return ( queue_[ byte_offset ] >> bit_offset ) & 0x03;
-            }
+            static constexpr std::size_t bits_per_word   = 32;
+            static constexpr std::size_t number_of_words = ( Size + bits_per_word - 1 ) / bits_per_word;
 
-            bool add( std::size_t index, int bits )
+            static word_t mask( std::size_t index )
             {
-                assert( bits & ( ( 1 << bits_per_characteristc ) -1 ) );
-                const auto bit_offset  = ( index * bits_per_characteristc ) % 8;
-                const auto byte_offset = index * bits_per_characteristc / 8;
-                assert( byte_offset < sizeof( queue_ ) / sizeof( queue_[ 0 ] ) );
+                return word_t( 1 ) << ( index % bits_per_word );
+            }
 
-                const bool result = ( queue_[ byte_offset ] & ( bits << bit_offset ) ) == 0;
-                queue_[ byte_offset ] |= bits << bit_offset;
+            static bool add( word_t* bitmap, std::size_t index )
+            {
+                const bool result = ( bitmap[ index / bits_per_word ] & mask( index ) ) == 0;
+                bitmap[ index / bits_per_word ] |= mask( index );
 
                 return result;
             }
 
-            void remove( std::size_t index, int bits )
+            static bool remove( word_t* bitmap, std::size_t index )
             {
-                assert( bits & ( ( 1 << bits_per_characteristc ) -1 ) );
-                const auto bit_offset  = ( index * bits_per_characteristc ) % 8;
-                const auto byte_offset = index * bits_per_characteristc / 8;
-                assert( byte_offset < sizeof( queue_ ) / sizeof( queue_[ 0 ] ) );
+                const bool result = ( bitmap[ index / bits_per_word ] & mask( index ) ) != 0;
+                bitmap[ index / bits_per_word ] &= ~mask( index );
 
-                queue_[ byte_offset ] &= ~( bits << bit_offset );
+                return result;
             }
 
-            static constexpr std::size_t bits_per_characteristc = 2;
+            word_t pending( std::size_t word, bool indications_allowed ) const
+            {
+                return notifications_[ word ] | ( indications_allowed ? indications_[ word ] : 0 );
+            }
+
+            // first pending entry at or after next_ in circular order; Size, if there is none
+            std::size_t next_pending( bool indications_allowed ) const
+            {
+                const std::size_t first_word = next_ / bits_per_word;
+                const word_t      above_next = ~word_t( 0 ) << ( next_ % bits_per_word );
+
+                word_t word = pending( first_word, indications_allowed ) & above_next;
+
+                for ( std::size_t w = first_word, visited = 0; visited != number_of_words; )
+                {
+                    if ( word )
+                        return w * bits_per_word + count_trailing_zeros( word );
 
-            enum char_bits {
-                notification_bit = 0x01,
-                indication_bit   = 0x02
-            };
+                    ++visited;
+                    w    = ( w + 1 ) % number_of_words;
+                    word = pending( w, indications_allowed );
+                }
+
+                // wrapped around to the entries in front of next_
+                word = pending( first_word, indications_allowed ) & ~above_next;
+
+                return word
+                    ? first_word * bits_per_word + count_trailing_zeros( word )
+                    : Size;
+            }
 
             std::size_t     next_;
-            std::uint8_t    queue_[ ( Size * bits_per_characteristc + 7 ) / 8 ];
+            word_t          notifications_[ number_of_words ];
+            word_t          indications_[ number_of_words ];
         };
 
         /**
@@ -317,6 +357,16 @@ namespace bluetoe {
                 return result;
             }
 
+            std::pair< notification_queue_entry_type, std::size_t > dequeue_notification( std::size_t offset )
+            {
+                if ( state_ != notification_queue_entry_type::notification )
+                    return { notification_queue_entry_type::empty, 0 };
+
+                state_ = notification_queue_entry_type::empty;
+
+                return { notification_queue_entry_type::notification, offset };
+            }
+
             void clear_indications_and_confirmations()
             {
                 state_ = notification_queue_entry_type::empty;
@@ -337,6 +387,11 @@ namespace bluetoe {
                 return { notification_queue_entry_type::empty, 0 };
             }
 
+            std::pair< notification_queue_entry_type, std::size_t > dequeue_notification( std::size_t )
+            {
+                return { notification_queue_entry_type::empty, 0 };
+            }
+
             void clear_indications_and_confirmations() {}
         };
 
@@ -377,6 +432,15 @@ namespace bluetoe {
                 return result;
             }
 
+            std::pair< notification_queue_entry_type, std::size_t > dequeue_notification( std::size_t offset )
+            {
+                const auto result = impl::dequeue_notification( offset );
+
+                return result.first != notification_queue_entry_type::empty
+                    ? result
+                    : base::dequeue_notification( offset + Size );
+            }
+
             void clear_indications_and_confirmations()
             {
                 impl::clear_indications_and_confirmations();
@@ -1,6 +1,8 @@
 #ifndef BLUETOE_PERIPHERAL_CONNECTION_INTERVAL_RANGE_HPP
 #define BLUETOE_PERIPHERAL_CONNECTION_INTERVAL_RANGE_HPP
 
+#include <bluetoe/meta_tools.hpp>
+
 namespace bluetoe {
     static constexpr std::uint16_t no_specific_peripheral_connection_minimum_interval = 0xFFFF;
     static constexpr std::uint16_t no_specific_peripheral_connection_maximum_interval = 0xFFFF;
@@ -33,6 +35,9 @@ namespace bluetoe {
             {
                 return begin;
             }
+
+            template < std::size_t >
+            using static_advertising_data = byte_sequence<>;
         };
     }
 
@@ -72,6 +77,13 @@ namespace bluetoe {
             return begin;
         }
 
+        template < std::size_t Space >
+        using static_advertising_data = typename details::select_type< ( Space >= 6u ),
+            details::byte_sequence<
+                0x05, 0x12,
+                static_cast< std::uint8_t >( MinInterval & 0xff ), static_cast< std::uint8_t >( MinInterval >> 8 ),
+                static_cast< std::uint8_t >( MaxInterval & 0xff ), static_cast< std::uint8_t >( MaxInterval >> 8 ) >,
+            details::byte_sequence<> >::type;
         /** @endcond */
     };
 }
@@ -21,9 +21,12 @@
 #include <bluetoe/attribute_handle.hpp>
 #include <bluetoe/l2cap_channels.hpp>
 #include <bluetoe/notification_queue.hpp>
+#include <bluetoe/aes.hpp>
+#include <bluetoe/services/gatt.hpp>
 
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
 #include <algorithm>
 #include <iterator>
 #include <cassert>
@@ -55,6 +58,7 @@ namespace bluetoe {
      * @sa appearance
      * @sa requires_encryption
      * @sa max_mtu_size
+     * @sa multiple_handle_value_notifications
      */
     template < typename ... Options >
     class server
@@ -81,9 +85,16 @@ namespace bluetoe {
 
         using cccd_indices = typename details::find_notification_data_in_list< notification_priority, services >::cccd_indices;
 
+        using multiple_notifications_option = typename details::find_by_meta_type< details::multiple_handle_value_notifications_meta_type,
+            Options..., no_multiple_handle_value_notifications >::type;
+
         using server_t       = server< Options... >;
         using handle_mapping = details::handle_index_mapping< server_t >;
 
+        // all attributes of the server, flattened into one table at compile time
+        using attribute_table = details::attribute_table<
+            typename details::attribute_generators_from_service_list< services, server_t, cccd_indices >::type >;
+
         /** @endcond */
 
         /**
@@ -99,6 +110,8 @@ namespace bluetoe {
         public:
             connection_data()
                 : client_mtu_( details::default_att_mtu_size )
+                , caching_state_( caching_state::change_aware )
+                , service_changed_indicated_( false )
             {
             }
 
@@ -142,9 +155,71 @@ namespace bluetoe {
                 return maximum_channel_mtu_size;
             }
 
+            /**
+             * @brief returns true, if the server can send ATT Multiple Handle Value Notifications on this connection
+             *
+             * That is the case, if the server was configured with multiple_handle_value_notifications and the client
+             * announced support for it in the Client Supported Features characteristic.
+             */
+            bool client_supports_multiple_handle_value_notifications() const
+            {
+                return multiple_notifications_option::enabled
+                    && ( this->client_supported_features() & details::client_supported_features_multiple_handle_value_notifications );
+            }
+
+            /**
+             * @brief marks the connected client as change-unaware
+             *
+             * If the GATT database changed since the last connection to a bonded client, call this function after
+             * restoring the client supported features from the bonding data. If that client enabled robust caching,
+             * the server will respond to the next request with a "Database Out Of Sync" error and will ignore commands,
+             * until the client becomes change-aware again, by reading the Database Hash or by sending a further request.
+             *
+             * @sa gatt::service_with_caching
+             */
+            void client_change_unaware()
+            {
+                caching_state_ = caching_state::change_unaware;
+            }
+
+            /**
+             * @brief returns false, if the client has to be treated as change-unaware
+             */
+            bool client_change_aware() const
+            {
+                return caching_state_ == caching_state::change_aware
+                    || ( this->client_supported_features() & details::client_supported_features_robust_caching ) == 0;
+            }
+
+            /** @cond HIDDEN_SYMBOLS */
+            // returns false, if the request must not be processed
+            bool robust_caching_filter( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size );
+
+            void indication_sent( bool service_changed )
+            {
+                service_changed_indicated_ = service_changed;
+            }
+
+            // only the confirmation of a Service Changed indication makes the client change-aware
+            void client_confirmed_indication()
+            {
+                if ( service_changed_indicated_ )
+                    caching_state_ = caching_state::change_aware;
+
+                service_changed_indicated_ = false;
+            }
+            /** @endcond */
 
         private:
+            enum class caching_state : std::uint8_t {
+                change_aware,
+                change_unaware,
+                change_unaware_informed
+            };
+
             std::uint16_t               client_mtu_;
+            caching_state               caching_state_;
+            bool                        service_changed_indicated_;
         };
 
         /**
@@ -283,6 +358,17 @@ namespace bluetoe {
          */
         std::size_t advertising_data( std::uint8_t* buffer, std::size_t buffer_size ) const;
 
+        /** @cond HIDDEN_SYMBOLS */
+        struct default_advertising;
+
+        // default advertising data for a buffer of Space octets, generated at compile time; requires a server_name,
+        // that is a constant expression
+        template < std::size_t Space >
+        using static_advertising_data = typename default_advertising::template static_data< Space >;
+
+        // default advertising data, generated at runtime
+        std::size_t runtime_advertising_data( std::uint8_t* buffer, std::size_t buffer_size ) const;
+        /** @endcond */
 
         /**
          * @brief returns the scan response data to the L2CAP implementation
@@ -310,6 +396,13 @@ namespace bluetoe {
 
         static details::attribute attribute_at( std::size_t index );
 
+        /**
+         * @brief the 128 bit Database Hash of this server in little endian byte order
+         *
+         * The hash is calculated once, with the first call to this function.
+         */
+        static const std::uint8_t* database_hash();
+
         static constexpr std::uint16_t channel_id               = l2cap_channel_ids::att;
         static constexpr std::size_t   minimum_channel_mtu_size = bluetoe::details::default_att_mtu_size;
         static constexpr std::size_t   maximum_channel_mtu_size = bluetoe::details::find_by_meta_type<
@@ -366,6 +459,8 @@ namespace bluetoe {
         template < typename ConnectionData >
         void handle_read_multiple_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
         template < typename ConnectionData >
+        void handle_read_multiple_variable_length_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
+        template < typename ConnectionData >
         void handle_write_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
         template < typename ConnectionData >
         void handle_write_command( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
@@ -380,6 +475,10 @@ namespace bluetoe {
         void handle_execute_write_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, Connection&, const WriteQueue& );
         void handle_value_confirmation( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data& );
 
+        template < typename ConnectionData >
+        std::size_t append_pending_notifications( std::uint8_t* output, std::size_t size, std::size_t max_size, ConnectionData& );
+
+        // calls iter( index, attribute ) for every attribute in the given range, that passes filter, until iter returns false
         template < class Iterator, class Filter = details::all_uuid_filter >
         void all_attributes( std::uint16_t starting_handle, std::uint16_t ending_handle, Iterator&, const Filter& filter = details::all_uuid_filter() );
 
@@ -394,6 +493,8 @@ namespace bluetoe {
         std::size_t last_handle_index( std::uint16_t ending_handle );
 
         std::size_t advertising_data_impl( std::uint8_t* buffer, std::size_t buffer_size, const details::no_such_type& ) const;
+        std::size_t default_advertising_data( std::uint8_t* buffer, std::size_t buffer_size, const std::true_type& ) const;
+        std::size_t default_advertising_data( std::uint8_t* buffer, std::size_t buffer_size, const std::false_type& ) const;
 
         template < class T >
         std::size_t advertising_data_impl( std::uint8_t* buffer, std::size_t buffer_size, const T& ) const;
@@ -476,6 +577,9 @@ namespace bluetoe {
         assert( in_size != 0 );
         assert( out_size >= details::default_att_mtu_size );
 
+        if ( !connection.client_change_aware() && !connection.robust_caching_filter( input, in_size, output, out_size ) )
+            return;
+
         const details::att_opcodes opcode = static_cast< details::att_opcodes >( input[ 0 ] );
 
         switch ( opcode )
@@ -509,6 +613,9 @@ namespace bluetoe {
         case details::att_opcodes::read_multiple_request:
             handle_read_multiple_request( input, in_size, output, out_size, connection );
             break;
+        case details::att_opcodes::read_multiple_variable_length_request:
+            handle_read_multiple_variable_length_request( input, in_size, output, out_size, connection );
+            break;
         case details::att_opcodes::write_request:
             handle_write_request( input, in_size, output, out_size, connection );
             break;
@@ -558,7 +665,19 @@ namespace bluetoe {
                         : bits( details::att_opcodes::indication );
                     details::write_handle( output +1, handle_mapping::handle_by_index( data.attribute_table_index() ) );
 
+                    // the value attribute of the Service Changed characteristic
+                    if ( pending.first != details::notification_queue_entry_type::notification )
+                        connection.indication_sent( attr.uuid == gatt::service_changed_uuid::as_16bit() );
+
+                    const std::size_t max_size = out_size;
                     out_size = 3 + read.buffer_size;
+
+                    if ( pending.first == details::notification_queue_entry_type::notification
+                      && connection.client_supports_multiple_handle_value_notifications() )
+                    {
+                        out_size = append_pending_notifications( output, out_size, max_size, connection );
+                    }
+
                     return;
                 }
             }
@@ -567,6 +686,63 @@ namespace bluetoe {
         out_size = 0;
     }
 
+    template < typename ... Options >
+    template < typename ConnectionData >
+    std::size_t server< Options... >::append_pending_notifications( std::uint8_t* output, std::size_t size, std::size_t max_size, ConnectionData& connection )
+    {
+        // every handle value tuple in a multiple handle value notification starts with handle and length
+        static constexpr std::size_t tuple_header_size = 4;
+
+        std::uint8_t* const end = output + max_size;
+
+        // the already read, first value will be moved by 2 octets to make room for its length
+        std::uint8_t* out = output + size + 2;
+        bool          packed = false;
+
+        // at least one octet of value per tuple
+        while ( out + tuple_header_size < end )
+        {
+            const auto pending = connection.dequeue_notification();
+
+            if ( pending.first == details::notification_queue_entry_type::empty )
+                break;
+
+            const auto data = find_notification_data_by_index( pending.second );
+
+            if ( ( connection.client_configurations().flags( data.client_characteristic_configuration_index() )
+                & details::client_characteristic_configuration_notification_enabled ) == 0 )
+                continue;
+
+            auto read = details::attribute_access_arguments::read( out + tuple_header_size, end, 0, connection.client_configurations(), connection.security_attributes(), this );
+            auto attr = attribute_at( data.attribute_table_index() );
+
+            if ( attr.access( read, data.attribute_table_index() ) != details::attribute_access_result::success )
+                continue;
+
+            // a value that fills the remaining space might be truncated; it will be send with the next PDU
+            if ( out + tuple_header_size + read.buffer_size == end )
+            {
+                connection.queue_notification( pending.second );
+                break;
+            }
+
+            details::write_handle( out, handle_mapping::handle_by_index( data.attribute_table_index() ) );
+            details::write_16bit( out + 2, read.buffer_size );
+
+            out   += tuple_header_size + read.buffer_size;
+            packed = true;
+        }
+
+        if ( !packed )
+            return size;
+
+        std::copy_backward( output + 3, output + size, output + size + 2 );
+        output[ 0 ] = bits( details::att_opcodes::multiple_handle_value_notification );
+        details::write_16bit( output + 3, size - 3 );
+
+        return out - output;
+    }
+
     namespace details {
         // all this hassel to stop gcc from complaining about constant argument to if
         template < bool >
@@ -604,6 +780,126 @@ namespace bluetoe {
             }
         };
 
+        /*
+         * Compile time generation of the default advertising data:
+         *
+         * Every AD generator provides an alias template static_advertising_data< Space >, that yields the
+         * byte_sequence, the runtime advertising_data() function would write into a buffer of Space bytes.
+         */
+        static constexpr std::size_t legacy_advertising_data_size = 31;
+
+        // no advertising PDU carries more AD octets; every larger buffer would get the very same data
+        static constexpr std::size_t maximum_advertising_data_size = 255;
+
+        constexpr std::size_t constexpr_strlen( const char* s )
+        {
+            return *s ? 1 + constexpr_strlen( s + 1 ) : 0;
+        }
+
+        template < const char* const Name, std::size_t Space,
+            std::size_t Length = constexpr_strlen( Name ),
+            std::size_t Size   = ( Space <= 2 ? 0 : ( Length < Space - 2 ? Length : Space - 2 ) ),
+            typename = make_index_sequence< Size > >
+        struct name_advertising_data;
+
+        template < const char* const Name, std::size_t Space, std::size_t Length, std::size_t Size, std::size_t ... Is >
+        struct name_advertising_data< Name, Space, Length, Size, index_sequence< Is... > >
+        {
+            using type = byte_sequence<
+                static_cast< std::uint8_t >( Size + 1 ),
+                Size == Length
+                    ? bits( gap_types::complete_local_name )
+                    : bits( gap_types::shortened_local_name ),
+                static_cast< std::uint8_t >( Name[ Is ] )... >;
+        };
+
+        template < const char* const Name, std::size_t Space, std::size_t Length >
+        struct name_advertising_data< Name, Space, Length, 0, index_sequence<> >
+        {
+            using type = byte_sequence<>;
+        };
+
+        // a name, that is not a constant expression, can only be used at runtime
+        template < const char* const Name, std::size_t = constexpr_strlen( Name ) >
+        std::true_type is_constant_name( int );
+
+        template < const char* const Name >
+        std::false_type is_constant_name( long );
+
+        template < const char* const Name >
+        struct has_name : std::true_type {};
+
+        template <>
+        struct has_name< nullptr > : std::false_type {};
+
+        template < typename Name >
+        struct is_constant_server_name : decltype( is_constant_name< Name::name >( 0 ) ) {};
+
+        template < typename Name, bool = has_name< Name::name >::value, bool = is_constant_server_name< Name >::value >
+        struct name_advertising_generator
+        {
+            static constexpr bool is_constant = true;
+
+            template < std::size_t Space >
+            using static_advertising_data = typename name_advertising_data< Name::name, Space >::type;
+        };
+
+        template < typename Name, bool IsConstant >
+        struct name_advertising_generator< Name, false, IsConstant >
+        {
+            static constexpr bool is_constant = true;
+
+            template < std::size_t >
+            using static_advertising_data = byte_sequence<>;
+        };
+
+        // no static_advertising_data; the name will be written by copy_name at runtime
+        template < typename Name >
+        struct name_advertising_generator< Name, true, false >
+        {
+            static constexpr bool is_constant = false;
+        };
+
+        struct flags_advertising_generator
+        {
+            // LE General Discoverable Mode | BR/EDR Not Supported
+            template < std::size_t Space >
+            using static_advertising_data = typename select_type< ( Space >= 3 ),
+                byte_sequence< 2, bits( gap_types::flags ), 6 >,
+                byte_sequence<> >::type;
+        };
+
+        template < typename Config, typename Appearance >
+        struct appearance_advertising_generator
+        {
+            template < std::size_t Space >
+            using static_advertising_data = typename Config::template static_advertising_data< Appearance, Space >;
+        };
+
+        // aditional empty AD to be visible to Nordic sniffer
+        struct empty_advertising_generator
+        {
+            template < std::size_t Space >
+            using static_advertising_data = typename select_type< ( Space >= 2 ),
+                byte_sequence< 0, 0 >,
+                byte_sequence<> >::type;
+        };
+
+        template < std::size_t Space, typename ... Generators >
+        struct build_static_advertising_data
+        {
+            using type = byte_sequence<>;
+        };
+
+        template < std::size_t Space, typename Generator, typename ... Generators >
+        struct build_static_advertising_data< Space, Generator, Generators... >
+        {
+            using head = typename Generator::template static_advertising_data< Space >;
+
+            using type = typename concat_byte_sequences<
+                head,
+                typename build_static_advertising_data< Space - head::size, Generators... >::type >::type;
+        };
     }
 
     template < typename ... Options >
@@ -624,60 +920,120 @@ namespace bluetoe {
     }
 
     template < typename ... Options >
-    std::size_t server< Options... >::advertising_data_impl( std::uint8_t* begin, std::size_t buffer_size, const details::no_such_type& ) const
+    struct server< Options... >::default_advertising
     {
-        std::uint8_t* const end = begin + buffer_size;
-
-        if ( buffer_size >= 3 )
-        {
-            begin[ 0 ] = 2;
-            begin[ 1 ] = bits( details::gap_types::flags );
-            // LE General Discoverable Mode | BR/EDR Not Supported
-            begin[ 2 ] = 6;
-
-            begin += 3;
-        }
-
         using device_appearance = typename details::find_by_meta_type<
                 details::device_appearance_meta_type,
                 Options...,
                 appearance::unknown
             >::type;
 
-        using appearance_advertising_config = typename details::find_by_meta_type<
+        using appearance_config = typename details::find_by_meta_type<
             details::advertise_appearance_meta_type,
             Options...,
             no_advertise_appearance >::type;
 
-        begin = appearance_advertising_config::template advertising_data< device_appearance >( begin, end );
-
         typedef typename details::find_by_meta_type< details::server_name_meta_type, Options..., server_name< nullptr > >::type name;
 
-        begin = details::copy_name< name::name != nullptr >::impl( begin, end, name::name );
-
         typedef typename details::find_by_meta_type<
             details::list_of_16_bit_service_uuids_tag,
             Options...,
             details::default_list_of_16_bit_service_uuids< services >
         >::type service_list_uuid16;
 
-        begin = service_list_uuid16::advertising_data( begin, end );
-
         typedef typename details::find_by_meta_type<
             details::list_of_128_bit_service_uuids_tag,
             Options...,
             details::default_list_of_128_bit_service_uuids< services >
         >::type service_list_uuid128;
 
-        begin = service_list_uuid128::advertising_data( begin, end );
-
         typedef typename details::find_by_meta_type<
             details::peripheral_connection_interval_range_meta_type,
             Options...,
             details::no_peripheral_connection_interval_range
         >::type peripheral_connection_interval_range_ad;
 
-        begin = peripheral_connection_interval_range_ad::advertising_data( begin, end );
+        using name_generator = details::name_advertising_generator< name >;
+
+        template < std::size_t Space >
+        using static_data = typename details::build_static_advertising_data<
+            Space,
+            details::flags_advertising_generator,
+            details::appearance_advertising_generator< appearance_config, device_appearance >,
+            name_generator,
+            service_list_uuid16,
+            service_list_uuid128,
+            peripheral_connection_interval_range_ad,
+            details::empty_advertising_generator >::type;
+
+        template < typename Spaces >
+        struct static_data_table;
+
+        // the static advertising data for every buffer size from 0 up to the size of the complete data
+        template < std::size_t ... Spaces >
+        struct static_data_table< details::index_sequence< Spaces... > >
+        {
+            static std::size_t copy( std::uint8_t* begin, std::size_t buffer_size )
+            {
+                static constexpr const std::uint8_t* values[ sizeof...( Spaces ) ] = { &static_data< Spaces >::values[ 0 ]... };
+                static constexpr std::uint8_t        sizes[ sizeof...( Spaces ) ]  = { static_cast< std::uint8_t >( static_data< Spaces >::size )... };
+
+                // every larger buffer gets the complete data
+                const std::size_t space = std::min( buffer_size, sizeof...( Spaces ) - 1 );
+                std::memcpy( begin, values[ space ], sizes[ space ] );
+
+                return sizes[ space ];
+            }
+        };
+    };
+
+    template < typename ... Options >
+    std::size_t server< Options... >::advertising_data_impl( std::uint8_t* begin, std::size_t buffer_size, const details::no_such_type& ) const
+    {
+        return default_advertising_data( begin, buffer_size,
+            std::integral_constant< bool, default_advertising::name_generator::is_constant >() );
+    }
+
+    template < typename ... Options >
+    std::size_t server< Options... >::default_advertising_data( std::uint8_t* begin, std::size_t buffer_size, const std::true_type& ) const
+    {
+        // with a constant name, the advertising data for every buffer size is known at compile time
+        static constexpr std::size_t complete_size = static_advertising_data< details::maximum_advertising_data_size >::size;
+
+        return default_advertising::template static_data_table<
+            details::make_index_sequence< complete_size + 1 > >::copy( begin, buffer_size );
+    }
+
+    template < typename ... Options >
+    std::size_t server< Options... >::default_advertising_data( std::uint8_t* begin, std::size_t buffer_size, const std::false_type& ) const
+    {
+        return runtime_advertising_data( begin, buffer_size );
+    }
+
+    template < typename ... Options >
+    std::size_t server< Options... >::runtime_advertising_data( std::uint8_t* begin, std::size_t buffer_size ) const
+    {
+        using appearance_advertising_config = typename default_advertising::appearance_config;
+        using device_appearance             = typename default_advertising::device_appearance;
+        using name                          = typename default_advertising::name;
+
+        std::uint8_t* const end = begin + buffer_size;
+
+        if ( buffer_size >= 3 )
+        {
+            begin[ 0 ] = 2;
+            begin[ 1 ] = bits( details::gap_types::flags );
+            // LE General Discoverable Mode | BR/EDR Not Supported
+            begin[ 2 ] = 6;
+
+            begin += 3;
+        }
+
+        begin = appearance_advertising_config::template advertising_data< device_appearance >( begin, end );
+        begin = details::copy_name< name::name != nullptr >::impl( begin, end, name::name );
+        begin = default_advertising::service_list_uuid16::advertising_data( begin, end );
+        begin = default_advertising::service_list_uuid128::advertising_data( begin, end );
+        begin = default_advertising::peripheral_connection_interval_range_ad::advertising_data( begin, end );
 
         // add aditional empty AD to be visible to Nordic sniffer
         if ( static_cast< unsigned >( end - begin ) >= 2u )
@@ -836,7 +1192,121 @@ namespace bluetoe {
     template < typename ... Options >
     details::attribute server< Options... >::attribute_at( std::size_t index )
     {
-        return details::attribute_from_service_list< services, server< Options... >, cccd_indices >::attribute_at( index );
+        static_assert( attribute_table::size == number_of_attributes, "attribute table does not match the number of attributes" );
+        assert( index < number_of_attributes );
+
+        return attribute_table::attributes[ index ];
+    }
+
+    template < typename ... Options >
+    const std::uint8_t* server< Options... >::database_hash()
+    {
+        // the database does not change at runtime; trivial types to not require thread safe static initialization
+        static std::uint8_t hash[ 16 ];
+        static bool         calculated;
+
+        if ( calculated )
+            return hash;
+
+        static constexpr std::uint8_t zero_key[ 16 ] = { 0 };
+        details::aes_cmac cmac( zero_key );
+
+        for ( std::size_t index = 0; index != number_of_attributes; ++index )
+        {
+            const details::attribute attr = attribute_at( index );
+            bool include_value = false;
+
+            switch ( attr.uuid )
+            {
+            case bits( details::gatt_uuids::primary_service ):
+            case bits( details::gatt_uuids::secondary_service ):
+            case bits( details::gatt_uuids::include ):
+            case bits( details::gatt_uuids::characteristic ):
+            case bits( details::gatt_uuids::characteristic_extended_properties ):
+                include_value = true;
+                break;
+            case bits( details::gatt_uuids::characteristic_user_description ):
+            case bits( details::gatt_uuids::client_characteristic_configuration ):
+            case bits( details::gatt_uuids::server_characteristic_configuration ):
+            case bits( details::gatt_uuids::characteristic_presentation_format ):
+            case bits( details::gatt_uuids::characteristic_aggregate_format ):
+                break;
+            default:
+                continue;
+            }
+
+            std::uint8_t buffer[ 19 ];
+            details::write_16bit_uuid( details::write_handle( buffer, handle_mapping::handle_by_index( index ) ), attr.uuid );
+            cmac.update( buffer, 4 );
+
+            if ( include_value )
+            {
+                auto read = details::attribute_access_arguments::read( buffer, 0 );
+
+                if ( attr.access( read, index ) == details::attribute_access_result::success )
+                    cmac.update( buffer, read.buffer_size );
+            }
+        }
+
+        cmac.finalize( hash );
+        std::reverse( std::begin( hash ), std::end( hash ) );
+        calculated = true;
+
+        return hash;
+    }
+
+    template < typename ... Options >
+    bool server< Options... >::connection_data::robust_caching_filter( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size )
+    {
+        static constexpr std::uint8_t command_flag = 0x40;
+        const auto opcode = static_cast< details::att_opcodes >( input[ 0 ] );
+
+        // commands from a change-unaware client are ignored
+        if ( input[ 0 ] & command_flag )
+        {
+            out_size = 0;
+            return false;
+        }
+
+        if ( opcode == details::att_opcodes::exchange_mtu_request
+          || opcode == details::att_opcodes::error_response
+          || opcode == details::att_opcodes::confirmation )
+            return true;
+
+        // reading the database hash makes the client change-aware
+        if ( opcode == details::att_opcodes::read_by_type_request && in_size == 7
+          && details::read_16bit_uuid( input + 5 ) == gatt::database_hash_uuid::as_16bit() )
+        {
+            caching_state_ = caching_state::change_aware;
+            return true;
+        }
+
+        if ( opcode == details::att_opcodes::read_request && in_size == 3 )
+        {
+            const std::size_t index = handle_mapping::index_by_handle( details::read_handle( input + 1 ) );
+
+            if ( index != details::invalid_attribute_index && attribute_at( index ).uuid == gatt::database_hash_uuid::as_16bit() )
+            {
+                caching_state_ = caching_state::change_aware;
+                return true;
+            }
+        }
+
+        if ( caching_state_ == caching_state::change_unaware_informed )
+        {
+            caching_state_ = caching_state::change_aware;
+            return true;
+        }
+
+        output[ 0 ] = bits( details::att_opcodes::error_response );
+        output[ 1 ] = input[ 0 ];
+        details::write_handle( &output[ 2 ], 0 );
+        output[ 4 ] = bits( details::att_error_codes::database_out_of_sync );
+        out_size = 5;
+
+        caching_state_ = caching_state::change_unaware_informed;
+
+        return false;
     }
 
     template < typename ... Options >
@@ -1134,7 +1604,8 @@ namespace bluetoe {
         template < typename Server >
         struct collect_attributes
         {
-            void operator()( std::size_t index, const details::attribute& attr )
+            // returns false, if no further attribute will fit into the response
+            bool operator()( std::size_t index, const details::attribute& attr )
             {
                 static constexpr std::size_t maximum_pdu_size = 253u;
                 static constexpr std::size_t header_size      = 2u;
@@ -1163,6 +1634,9 @@ namespace bluetoe {
                         }
                     }
                 }
+
+                // once the size of the elements is known, there is no point in reading attributes that will not fit
+                return end_ - current_ >= static_cast< std::ptrdiff_t >( first_ ? header_size : size_ );
             }
 
             collect_attributes( std::uint8_t* begin, std::uint8_t* end,
@@ -1365,6 +1839,63 @@ namespace bluetoe {
         out_size = out_ptr - output;
     }
 
+    template < typename ... Options >
+    template < typename ConnectionData >
+    void server< Options... >::handle_read_multiple_variable_length_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* const output, std::size_t& out_size, ConnectionData& cc )
+    {
+        static constexpr std::size_t length_size = 2;
+
+        if ( in_size < 5 || in_size % 2 == 0 )
+            return error_response( *input, details::att_error_codes::invalid_pdu, output, out_size );
+
+        const std::uint8_t opcode = *input;
+        ++input;
+        --in_size;
+
+        std::uint8_t* const end_output = output + out_size;
+        std::uint8_t*       out_ptr    = output;
+
+        *out_ptr = bits( details::att_opcodes::read_multiple_variable_length_response );
+        ++out_ptr;
+
+        for ( const std::uint8_t* const end_input = input + in_size; input != end_input; input += 2 )
+        {
+            const std::uint16_t handle = details::read_handle( input );
+
+            if ( handle == 0 )
+                return error_response( opcode, details::att_error_codes::invalid_handle, handle, output, out_size );
+
+            const std::size_t index = handle_mapping::index_by_handle( handle );
+            if ( index == details::invalid_attribute_index )
+                return error_response( opcode, details::att_error_codes::invalid_handle, handle, output, out_size );
+
+            // once there is no more room for a length field, the remaining attributes are still accessed to
+            // find errors, but the response is truncated to the MTU
+            const bool    room_for_length = end_output - out_ptr >= static_cast< std::ptrdiff_t >( length_size );
+            std::uint8_t* value           = room_for_length ? out_ptr + length_size : end_output;
+
+            auto read = details::attribute_access_arguments::read( value, end_output, 0, cc.client_configurations(), cc.security_attributes(), this );
+            auto rc   = attribute_at( index ).access( read, index );
+
+            if ( rc == details::attribute_access_result::success )
+            {
+                if ( room_for_length )
+                {
+                    // the length of a value, that was clipped to the MTU, is the length of the clipped value
+                    details::write_16bit( out_ptr, read.buffer_size );
+                    out_ptr = value + read.buffer_size;
+                    assert( out_ptr <= end_output );
+                }
+            }
+            else
+            {
+                return error_response( opcode, access_result_to_att_code( rc, details::att_error_codes::read_not_permitted ), handle, output, out_size );
+            }
+        }
+
+        out_size = out_ptr - output;
+    }
+
     template < typename ... Options >
     template < typename ConnectionData >
     void server< Options... >::handle_write_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& connection )
@@ -1494,13 +2025,15 @@ namespace bluetoe {
     }
 
     template < typename ... Options >
-    void server< Options... >::handle_value_confirmation( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data& )
+    void server< Options... >::handle_value_confirmation( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data& connection )
     {
         if ( in_size != 1 )
             return error_response( *input, static_cast< details::att_error_codes >( 0x04 ), output, out_size );
 
         out_size = 0;
 
+        connection.client_confirmed_indication();
+
         if ( l2cap_cb_ )
             l2cap_cb_( details::notification_data(), l2cap_arg_, details::notification_type::confirmation );
     }
@@ -1516,8 +2049,8 @@ namespace bluetoe {
         {
             const details::attribute attr = attribute_at( index );
 
-            if ( filter( index, attr ) )
-                iter( index, attr );
+            if ( filter( index, attr ) && !iter( index, attr ) )
+                break;
         }
     }
 
@@ -15,6 +15,7 @@
 #include <cassert>
 #include <algorithm>
 #include <type_traits>
+#include <iterator>
 
 namespace bluetoe {
 
@@ -182,6 +183,12 @@ namespace bluetoe {
         template < typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename ServiceList, typename Server >
         static details::attribute attribute_at( std::size_t index );
 
+        /**
+         * a std::tuple of all types that generate the attributes of this service, including all characteristics, in attribute order
+         */
+        template < typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename ServiceList, typename Server >
+        struct attribute_generators;
+
         /**
          * @brief assembles one data packet for a "Read by Group Type Response"
          */
@@ -291,14 +298,23 @@ namespace bluetoe {
     {
         assert( index < number_of_attributes );
 
-        using attribute_generator = details::generate_attribute_list< details::attribute_generation_parameters< Options... >, CCCDIndices, ClientCharacteristicIndex, service< Options... >, Server, std::tuple< Options..., ServiceList > >;
-
-        if ( index < number_of_service_attributes )
-            return attribute_generator::attribute_at( index );
+        using attributes = details::attribute_table< typename attribute_generators< CCCDIndices, ClientCharacteristicIndex, ServiceList, Server >::type >;
 
-        return details::attribute_at_list< characteristics, CCCDIndices, ClientCharacteristicIndex, service< Options... >, Server >::attribute_at( index - number_of_service_attributes );
+        return attributes::attributes[ index ];
     }
 
+    template < typename ... Options >
+    template < typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename ServiceList, typename Server >
+    struct service< Options... >::attribute_generators
+    {
+        using attribute_generator = details::generate_attribute_list< details::attribute_generation_parameters< Options... >, CCCDIndices, ClientCharacteristicIndex, service< Options... >, Server, std::tuple< Options..., ServiceList > >;
+
+        using type = typename details::add_type<
+            typename attribute_generator::generators,
+            typename details::attribute_generators_from_list< characteristics, CCCDIndices, ClientCharacteristicIndex, service< Options... >, Server >::type
+        >::type;
+    };
+
     template < typename ... Options >
     template < typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename ServiceList, typename Server >
     std::uint8_t* service< Options... >::read_primary_service_response( std::uint8_t* output, std::uint8_t* end, std::size_t starting_index, bool is_128bit_filter, Server& server )
@@ -313,14 +329,15 @@ namespace bluetoe {
             output = details::write_handle( output, mapping::handle_by_index( starting_index ) );
             output = details::write_handle( output, mapping::handle_by_index( starting_index + number_of_attributes -1 ) );
 
-            const details::attribute primary_service = attribute_at< CCCDIndices, ClientCharacteristicIndex, ServiceList, Server >( 0 );
+            // the service declaration from the servers attribute table
+            const details::attribute primary_service = Server::attribute_at( starting_index );
 
             auto read = details::attribute_access_arguments::read( output, end, 0,
                             details::client_characteristic_configuration(),
                             connection_security_attributes(),
                             &server );
 
-            if ( primary_service.access( read, 1 ) == details::attribute_access_result::success )
+            if ( primary_service.access( read, starting_index ) == details::attribute_access_result::success )
             {
                 output += read.buffer_size;
             }
@@ -4,6 +4,9 @@
 #include <bluetoe/service.hpp>
 #include <bluetoe/characteristic.hpp>
 #include <bluetoe/attribute_handle.hpp>
+#include <bluetoe/codes.hpp>
+
+#include <algorithm>
 
 namespace bluetoe {
 
@@ -18,6 +21,153 @@ namespace bluetoe {
          */
         using service_changed_uuid = characteristic_uuid16< 0x2A05 >;
 
+        /**
+         * @brief The assigned 16 bit UUID for the Client Supported Features characteristic
+         */
+        using client_supported_features_uuid = characteristic_uuid16< 0x2B29 >;
+
+        /**
+         * @brief The assigned 16 bit UUID for the Database Hash characteristic
+         */
+        using database_hash_uuid = characteristic_uuid16< 0x2B2A >;
+
+        /**
+         * @brief characteristic value, that reports the Database Hash of the server
+         *
+         * The hash is calculated over the service, include, characteristic declarations and
+         * descriptors of the server with the first read access.
+         */
+        struct database_hash_value
+        {
+            /** @cond HIDDEN_SYMBOLS */
+            template < typename ... Options >
+            class value_impl : public details::value_impl_base< Options... >
+            {
+            public:
+                static constexpr bool has_read_access  = true;
+                static constexpr bool has_write_access = false;
+                static constexpr bool has_write_without_response = false;
+                static constexpr bool has_notification = false;
+                static constexpr bool has_indication   = false;
+
+                template < class Server, std::size_t ClientCharacteristicIndex, bool RequiresEncryption  >
+                static details::attribute_access_result characteristic_value_access( details::attribute_access_arguments& args, std::size_t )
+                {
+                    static constexpr std::size_t hash_size = 16;
+
+                    if ( args.type != details::attribute_access_type::read )
+                        return details::attribute_access_result::write_not_permitted;
+
+                    if ( args.buffer_offset > hash_size )
+                        return details::attribute_access_result::invalid_offset;
+
+                    args.buffer_size = std::min< std::size_t >( args.buffer_size, hash_size - args.buffer_offset );
+
+                    const std::uint8_t* const hash = Server::database_hash() + args.buffer_offset;
+                    std::copy( hash, hash + args.buffer_size, args.buffer );
+
+                    return details::attribute_access_result::success;
+                }
+
+                static constexpr bool is_this( const void* )
+                {
+                    return false;
+                }
+            };
+
+            struct meta_type :
+                details::characteristic_value_meta_type,
+                details::characteristic_value_declaration_parameter,
+                details::valid_characteristic_option_meta_type {};
+            /** @endcond */
+        };
+
+        /**
+         * @brief characteristic value, that stores the Client Supported Features per connection
+         *
+         * A client can only set features; an attempt to clear a feature bit is answered with
+         * "Value Not Allowed". Unknown feature bits are ignored.
+         */
+        struct client_supported_features_value
+        {
+            /** @cond HIDDEN_SYMBOLS */
+            template < typename ... Options >
+            class value_impl : public details::value_impl_base< Options... >
+            {
+            public:
+                static constexpr bool has_read_access  = true;
+                static constexpr bool has_write_access = true;
+                static constexpr bool has_write_without_response = false;
+                static constexpr bool has_notification = false;
+                static constexpr bool has_indication   = false;
+
+                template < class Server, std::size_t ClientCharacteristicIndex, bool RequiresEncryption  >
+                static details::attribute_access_result characteristic_value_access( details::attribute_access_arguments& args, std::size_t )
+                {
+                    if ( args.buffer_offset > 1 )
+                        return details::attribute_access_result::invalid_offset;
+
+                    const std::uint8_t features = args.client_config.client_supported_features();
+
+                    if ( args.type == details::attribute_access_type::read )
+                    {
+                        args.buffer_size = std::min< std::size_t >( args.buffer_size, 1 - args.buffer_offset );
+
+                        if ( args.buffer_size )
+                            args.buffer[ 0 ] = features;
+
+                        return details::attribute_access_result::success;
+                    }
+
+                    if ( args.type != details::attribute_access_type::write )
+                        return details::attribute_access_result::write_not_permitted;
+
+                    // a check_write() access has no buffer
+                    if ( args.buffer == nullptr )
+                        return details::attribute_access_result::success;
+
+                    if ( args.buffer_offset != 0 || args.buffer_size == 0 )
+                        return details::attribute_access_result::invalid_attribute_value_length;
+
+                    const std::uint8_t new_features = args.buffer[ 0 ] & details::client_supported_features_all;
+
+                    if ( ( features & ~new_features ) != 0 )
+                        return details::attribute_access_result::value_not_allowed;
+
+                    args.client_config.client_supported_features( new_features );
+
+                    return details::attribute_access_result::success;
+                }
+
+                static constexpr bool is_this( const void* )
+                {
+                    return false;
+                }
+            };
+
+            struct meta_type :
+                details::characteristic_value_meta_type,
+                details::characteristic_value_declaration_parameter,
+                details::valid_characteristic_option_meta_type {};
+            /** @endcond */
+        };
+
+        /**
+         * @brief Client Supported Features characteristic
+         */
+        using client_supported_features_characteristic = characteristic<
+            client_supported_features_uuid,
+            client_supported_features_value
+        >;
+
+        /**
+         * @brief Database Hash characteristic
+         */
+        using database_hash_characteristic = characteristic<
+            database_hash_uuid,
+            database_hash_value
+        >;
+
         /**
          * @brief Service Changed characteristic
          */
@@ -40,6 +190,22 @@ namespace bluetoe {
             service_changed_characteristic
         >;
 
+        /**
+         * @brief Generic Attribute Profile service with Service Changed, Client Supported Features and Database Hash characteristic
+         *
+         * With this service, a client can detect changes of the database by comparing the Database Hash with
+         * the cached value and can enable robust caching and the reception of ATT Multiple Handle Value Notifications
+         * by writing to the Client Supported Features characteristic.
+         *
+         * @sa multiple_handle_value_notifications
+         */
+        using service_with_caching = ::bluetoe::service<
+            service_uuid,
+            service_changed_characteristic,
+            client_supported_features_characteristic,
+            database_hash_characteristic
+        >;
+
         /**
          * @brief Generic Attribute Profile service with a single Service Changed characteristic
          *
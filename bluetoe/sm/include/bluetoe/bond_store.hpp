@@ -0,0 +1,868 @@
+#ifndef BLUETOE_SM_BOND_STORE_HPP
+#define BLUETOE_SM_BOND_STORE_HPP
+
+#include <bluetoe/security_manager.hpp>
+#include <bluetoe/address.hpp>
+#include <bluetoe/bits.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+namespace bluetoe {
+
+    /**
+     * @brief persistent bond data base with constant time key lookup
+     *
+     * bond_store implements the requirements of bonding_data_base. It stores up to MaxBonds bonds (long term key,
+     * EDIV, Rand, address of the bonded device and the state of NumberOfCccds client characteristic configurations)
+     * in the pages of Storage. If all MaxBonds are used, a new bond replaces the least recently created bond.
+     *
+     * The pages are used as a log: every change appends a record to the current page and pages are filled round
+     * robin. When only one erased page is left, the current state is written to that page and all other pages
+     * are erased. Thus, all pages wear equally and an interrupted write or erase (power loss) never destroys
+     * the last consistent state.
+     *
+     * For every bond, only the location of the record is kept in RAM. Two hashed indices (by EDIV / Rand and
+     * by the device address) map to that location, so that find_key() takes constant time, independent of the
+     * number of bonds. A key with EDIV and Rand being 0 (LE Secure Connections) is looked up by the address of the
+     * connected device.
+     *
+     * Bonds are stored with the identity address of the connected device. To recognize a device, that uses resolvable
+     * private addresses, the link layer needs a resolving_list, that contains the IRK of that device.
+     *
+     * Storage has to implement the following functions:
+     *
+     *   static constexpr std::size_t page_size;
+     *   static constexpr std::size_t number_of_pages;
+     *
+     *   void read( std::size_t page, std::size_t offset, std::uint8_t* data, std::size_t size ) const;
+     *   void write( std::size_t page, std::size_t offset, const std::uint8_t* data, std::size_t size );
+     *   void erase( std::size_t page );
+     *
+     * erase() sets all octets of the page to 0xff. write() is called only for erased octets, with offset and size
+     * being multiples of 4. A page must be large enough to store all MaxBonds bonds plus one.
+     *
+     * open() has to be called once, before the bond store is used, to restore the state from the storage. Updates
+     * of the client characteristic configurations are stored by calling store_cccds(), for example when a
+     * connection is closed.
+     *
+     * Example:
+     * @code
+     * using storage_t = bluetoe::file_page_storage< 1024, 4 >;
+     * storage_t storage( "bonds.bin" );
+     *
+     * using bonds_t = bluetoe::bond_store< storage_t, 8, gatt_server::number_of_client_configs >;
+     * bonds_t bonds( storage );
+     *
+     * using link_layer = bluetoe::link_layer::link_layer< gatt_server, bluetoe::nrf52,
+     *     bluetoe::security_manager,
+     *     bluetoe::bonding_data_base< bonds_t, bonds > >;
+     * @endcode
+     *
+     * @sa bonding_data_base
+     * @sa file_page_storage
+     */
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds = 0 >
+    class bond_store
+    {
+    public:
+        /**
+         * @brief a bond store, that uses the given storage
+         */
+        explicit bond_store( Storage& storage );
+
+        /**
+         * @brief restores the bonds from the storage
+         *
+         * Pages with incomplete or inconsistent content are erased.
+         */
+        void open();
+
+        /**
+         * @brief number of bonds stored
+         */
+        std::size_t number_of_bonds() const;
+
+        /**
+         * @brief removes the bond with the given device
+         *
+         * Returns false, if there is no bond with that device.
+         */
+        bool remove_bond( const link_layer::device_address& address );
+
+        /**
+         * @brief stores the client characteristic configurations of a bonded device
+         *
+         * The configuration is only written to the storage, if it changed.
+         */
+        template < class Connection >
+        void store_cccds( const Connection& connection );
+
+        /** @cond HIDDEN_SYMBOLS */
+        // interface required by bonding_data_base
+        template < class Radio >
+        details::longterm_key_t create_new_bond( Radio& radio, const link_layer::device_address& mac );
+
+        template < class Connection >
+        void store_bond( const details::longterm_key_t& key, const Connection& connection );
+
+        std::pair< bool, details::uint128_t > find_key( std::uint16_t ediv, std::uint64_t rand, const link_layer::device_address& remote_address ) const;
+
+        template < class Connection >
+        void restore_cccds( Connection& connection );
+        /** @endcond */
+
+    private:
+        static constexpr std::size_t page_size       = Storage::page_size;
+        static constexpr std::size_t number_of_pages = Storage::number_of_pages;
+        static constexpr std::size_t cccd_size       = ( NumberOfCccds * 2 + 7 ) / 8;
+
+        static constexpr std::size_t align( std::size_t size )
+        {
+            return ( size + 3 ) & ~std::size_t( 3 );
+        }
+
+        // page header: magic, flags, sequence number, checksum
+        static constexpr std::uint8_t  page_magic          = 0xB5;
+        static constexpr std::uint8_t  compacted_page_flag = 0x01;
+        static constexpr std::size_t   page_header_size    = 8;
+
+        // records: type, slot, content, checksum
+        enum record_type : std::uint8_t {
+            bond_record     = 0x01,
+            cccd_record     = 0x02,
+            remove_record   = 0x03,
+            compacted_record= 0x04,
+            end_of_log      = 0xff
+        };
+
+        static constexpr std::size_t bond_address_offset  = 2;
+        static constexpr std::size_t bond_key_offset      = bond_address_offset + 7;
+        static constexpr std::size_t bond_ediv_offset     = bond_key_offset + 16;
+        static constexpr std::size_t bond_rand_offset     = bond_ediv_offset + 2;
+        static constexpr std::size_t bond_counter_offset  = bond_rand_offset + 8;
+        static constexpr std::size_t bond_cccd_offset     = bond_counter_offset + 4;
+        static constexpr std::size_t cccd_offset          = 2;
+
+        static constexpr std::size_t bond_record_size     = align( bond_cccd_offset + cccd_size + 2 );
+        static constexpr std::size_t cccd_record_size     = align( cccd_offset + cccd_size + 2 );
+        static constexpr std::size_t short_record_size    = 4;
+
+        static constexpr std::size_t table_size( std::size_t size = 1 )
+        {
+            return size >= 2 * MaxBonds ? size : table_size( 2 * size );
+        }
+
+        static constexpr std::uint32_t invalid_location   = ~std::uint32_t( 0 );
+        static constexpr std::size_t   no_page            = number_of_pages;
+        static constexpr std::size_t   no_slot            = MaxBonds;
+
+        static_assert( MaxBonds > 0 && MaxBonds < 255, "MaxBonds has to be in the range 1 to 254" );
+        static_assert( number_of_pages >= 2, "at least two pages are required" );
+        static_assert( page_size % 4 == 0, "page size has to be a multiple of 4" );
+        static_assert( page_size >= page_header_size + ( MaxBonds + 1 ) * bond_record_size + short_record_size,
+            "a page has to be large enough to store all bonds plus one" );
+
+        struct slot_t
+        {
+            std::uint32_t bond;     // location of the bond record
+            std::uint32_t cccds;    // location of the current client characteristic configurations
+            std::uint32_t counter;  // creation order of the bonds
+        };
+
+        struct replay_result
+        {
+            std::size_t end;
+            bool        compacted;
+        };
+
+        static std::uint16_t checksum( const std::uint8_t* data, std::size_t size );
+        static std::size_t   record_size( std::uint8_t type );
+        static std::size_t   content_size( std::uint8_t type );
+        static std::uint32_t key_hash( std::uint16_t ediv, std::uint64_t rand );
+        static std::uint32_t address_hash( const link_layer::device_address& address );
+
+        void read( std::uint32_t location, std::uint8_t* data, std::size_t size ) const;
+
+        bool page_erased( std::size_t page ) const;
+        bool page_blank( std::size_t page ) const;
+        bool read_page_header( std::size_t page, std::uint32_t& sequence, bool& compacted ) const;
+        void start_page( std::size_t page, bool compacted );
+        replay_result replay_page( std::size_t page, bool apply );
+
+        std::uint32_t append( std::uint8_t* record, std::size_t size );
+        void          next_page();
+        void          compact( std::size_t target );
+        void          write_bond( std::size_t slot, const std::uint8_t* address, bool random, const details::longterm_key_t& key, const std::uint8_t* cccds );
+
+        void        rebuild_index();
+        std::size_t find_address( const link_layer::device_address& address ) const;
+        std::size_t find_key_slot( std::uint16_t ediv, std::uint64_t rand ) const;
+
+        template < class Connection >
+        void restore_cccds( Connection& connection, std::true_type );
+
+        template < class Connection >
+        void restore_cccds( Connection&, std::false_type );
+
+        template < class Connection >
+        void store_cccds( const Connection& connection, std::true_type );
+
+        template < class Connection >
+        void store_cccds( const Connection&, std::false_type );
+
+        Storage&        storage_;
+        bool            opened_;
+        slot_t          slots_[ MaxBonds ];
+        std::uint8_t    by_key_[ table_size() ];
+        std::uint8_t    by_address_[ table_size() ];
+        std::size_t     active_page_;
+        std::size_t     write_offset_;
+        std::uint32_t   next_sequence_;
+        std::uint32_t   next_counter_;
+    };
+
+    // implementation
+    /** @cond HIDDEN_SYMBOLS */
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    bond_store< Storage, MaxBonds, NumberOfCccds >::bond_store( Storage& storage )
+        : storage_( storage )
+        , opened_( false )
+        , active_page_( no_page )
+        , write_offset_( 0 )
+        , next_sequence_( 0 )
+        , next_counter_( 0 )
+    {
+        for ( auto& slot : slots_ )
+            slot = slot_t{ invalid_location, invalid_location, 0 };
+
+        std::fill( std::begin( by_key_ ), std::end( by_key_ ), 0 );
+        std::fill( std::begin( by_address_ ), std::end( by_address_ ), 0 );
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    void bond_store< Storage, MaxBonds, NumberOfCccds >::open()
+    {
+        for ( auto& slot : slots_ )
+            slot = slot_t{ invalid_location, invalid_location, 0 };
+
+        active_page_   = no_page;
+        write_offset_  = 0;
+        next_sequence_ = 0;
+        next_counter_  = 0;
+
+        // pages in use, sorted by sequence number
+        std::size_t   pages[ number_of_pages ];
+        std::uint32_t sequences[ number_of_pages ];
+        bool          compacted[ number_of_pages ];
+        std::size_t   used = 0;
+
+        for ( std::size_t page = 0; page != number_of_pages; ++page )
+        {
+            std::uint32_t sequence;
+            bool          compacted_page;
+
+            if ( read_page_header( page, sequence, compacted_page ) )
+            {
+                std::size_t pos = used;
+                for ( ; pos != 0 && sequences[ pos - 1 ] > sequence; --pos )
+                {
+                    pages[ pos ]     = pages[ pos - 1 ];
+                    sequences[ pos ] = sequences[ pos - 1 ];
+                    compacted[ pos ] = compacted[ pos - 1 ];
+                }
+
+                pages[ pos ]     = page;
+                sequences[ pos ] = sequence;
+                compacted[ pos ] = compacted_page;
+                ++used;
+            }
+            else if ( !page_blank( page ) )
+            {
+                storage_.erase( page );
+            }
+        }
+
+        // the state starts with the most recent, complete compaction; an incomplete compaction
+        // and pages that were not erased after the compaction are discarded
+        std::size_t first = 0;
+
+        for ( std::size_t index = used; index != 0; --index )
+        {
+            if ( !compacted[ index - 1 ] )
+                continue;
+
+            if ( replay_page( pages[ index - 1 ], false ).compacted )
+            {
+                first = index - 1;
+                break;
+            }
+
+            storage_.erase( pages[ index - 1 ] );
+            std::copy( &pages[ index ], &pages[ used ], &pages[ index - 1 ] );
+            std::copy( &sequences[ index ], &sequences[ used ], &sequences[ index - 1 ] );
+            std::copy( &compacted[ index ], &compacted[ used ], &compacted[ index - 1 ] );
+            --used;
+        }
+
+        for ( std::size_t index = 0; index != first; ++index )
+            storage_.erase( pages[ index ] );
+
+        for ( std::size_t index = first; index != used; ++index )
+        {
+            active_page_   = pages[ index ];
+            write_offset_  = replay_page( pages[ index ], true ).end;
+            next_sequence_ = sequences[ index ] + 1;
+        }
+
+        rebuild_index();
+        opened_ = true;
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    std::size_t bond_store< Storage, MaxBonds, NumberOfCccds >::number_of_bonds() const
+    {
+        return std::count_if( std::begin( slots_ ), std::end( slots_ ), []( const slot_t& slot ){
+            return slot.bond != invalid_location;
+        } );
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    bool bond_store< Storage, MaxBonds, NumberOfCccds >::remove_bond( const link_layer::device_address& address )
+    {
+        assert( opened_ );
+
+        const std::size_t slot = find_address( address );
+
+        if ( slot == no_slot )
+            return false;
+
+        std::uint8_t record[ short_record_size ] = { remove_record, static_cast< std::uint8_t >( slot ) };
+        append( record, sizeof( record ) );
+
+        slots_[ slot ] = slot_t{ invalid_location, invalid_location, 0 };
+        rebuild_index();
+
+        return true;
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    template < class Connection >
+    void bond_store< Storage, MaxBonds, NumberOfCccds >::store_cccds( const Connection& connection )
+    {
+        assert( opened_ );
+
+        store_cccds( connection, std::integral_constant< bool, cccd_size != 0 >() );
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    template < class Radio >
+    details::longterm_key_t bond_store< Storage, MaxBonds, NumberOfCccds >::create_new_bond( Radio& radio, const link_layer::device_address& )
+    {
+        return radio.create_long_term_key();
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    template < class Connection >
+    void bond_store< Storage, MaxBonds, NumberOfCccds >::store_bond( const details::longterm_key_t& key, const Connection& connection )
+    {
+        assert( opened_ );
+
+        const link_layer::device_address& address = connection.remote_identity_address();
+        std::uint8_t cccds[ cccd_size + 1 ] = { 0 };
+
+        std::size_t slot = find_address( address );
+
+        // a new pairing with a bonded device keeps the configuration
+        if ( slot != no_slot )
+        {
+            read( slots_[ slot ].cccds, cccds, cccd_size );
+        }
+        else
+        {
+            const auto free = std::find_if( std::begin( slots_ ), std::end( slots_ ), []( const slot_t& s ){
+                return s.bond == invalid_location;
+            } );
+
+            slot = free != std::end( slots_ )
+                ? static_cast< std::size_t >( free - std::begin( slots_ ) )
+                : static_cast< std::size_t >( std::min_element( std::begin( slots_ ), std::end( slots_ ), []( const slot_t& a, const slot_t& b ){
+                    return a.counter < b.counter;
+                } ) - std::begin( slots_ ) );
+        }
+
+        write_bond( slot, address.begin(), address.is_random(), key, cccds );
+        rebuild_index();
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    std::pair< bool, details::uint128_t > bond_store< Storage, MaxBonds, NumberOfCccds >::find_key(
+        std::uint16_t ediv, std::uint64_t rand, const link_layer::device_address& remote_address ) const
+    {
+        assert( opened_ );
+
+        const std::size_t slot = ediv == 0 && rand == 0
+            ? find_address( remote_address )
+            : find_key_slot( ediv, rand );
+
+        details::uint128_t key = {{ 0 }};
+
+        if ( slot == no_slot )
+            return { false, key };
+
+        read( slots_[ slot ].bond + bond_key_offset, key.data(), key.size() );
+
+        return { true, key };
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    template < class Connection >
+    void bond_store< Storage, MaxBonds, NumberOfCccds >::restore_cccds( Connection& connection )
+    {
+        assert( opened_ );
+
+        restore_cccds( connection, std::integral_constant< bool, cccd_size != 0 >() );
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    template < class Connection >
+    void bond_store< Storage, MaxBonds, NumberOfCccds >::restore_cccds( Connection& connection, std::true_type )
+    {
+        const std::size_t slot = find_address( connection.remote_identity_address() );
+
+        if ( slot == no_slot )
+            return;
+
+        const std::size_t size = std::min< std::size_t >( cccd_size,
+            connection.serialized_cccds_end() - connection.serialized_cccds_begin() );
+
+        read( slots_[ slot ].cccds, connection.serialized_cccds_begin(), size );
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    template < class Connection >
+    void bond_store< Storage, MaxBonds, NumberOfCccds >::restore_cccds( Connection&, std::false_type )
+    {
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    template < class Connection >
+    void bond_store< Storage, MaxBonds, NumberOfCccds >::store_cccds( const Connection& connection, std::true_type )
+    {
+        const std::size_t slot = find_address( connection.remote_identity_address() );
+
+        if ( slot == no_slot )
+            return;
+
+        std::uint8_t record[ cccd_record_size ];
+        std::fill( std::begin( record ), std::end( record ), 0xff );
+        record[ 0 ] = cccd_record;
+        record[ 1 ] = static_cast< std::uint8_t >( slot );
+
+        const std::size_t size = std::min< std::size_t >( cccd_size,
+            connection.serialized_cccds_end() - connection.serialized_cccds_begin() );
+
+        std::fill( &record[ cccd_offset ], &record[ cccd_offset + cccd_size ], 0 );
+        std::copy( connection.serialized_cccds_begin(), connection.serialized_cccds_begin() + size, &record[ cccd_offset ] );
+
+        std::uint8_t stored[ cccd_size ];
+        read( slots_[ slot ].cccds, stored, cccd_size );
+
+        if ( std::equal( std::begin( stored ), std::end( stored ), &record[ cccd_offset ] ) )
+            return;
+
+        slots_[ slot ].cccds = static_cast< std::uint32_t >( append( record, cccd_record_size ) + cccd_offset );
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    template < class Connection >
+    void bond_store< Storage, MaxBonds, NumberOfCccds >::store_cccds( const Connection&, std::false_type )
+    {
+    }
+
+    // Fletcher-16
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    std::uint16_t bond_store< Storage, MaxBonds, NumberOfCccds >::checksum( const std::uint8_t* data, std::size_t size )
+    {
+        std::uint16_t sum1 = 0;
+        std::uint16_t sum2 = 0;
+
+        for ( ; size != 0; --size, ++data )
+        {
+            sum1 = static_cast< std::uint16_t >( ( sum1 + *data ) % 255 );
+            sum2 = static_cast< std::uint16_t >( ( sum2 + sum1 ) % 255 );
+        }
+
+        return static_cast< std::uint16_t >( ( sum2 << 8 ) | sum1 );
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    std::size_t bond_store< Storage, MaxBonds, NumberOfCccds >::record_size( std::uint8_t type )
+    {
+        switch ( type )
+        {
+        case bond_record:
+            return bond_record_size;
+        case cccd_record:
+            return cccd_record_size;
+        case remove_record:
+        case compacted_record:
+            return short_record_size;
+        default:
+            return 0;
+        }
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    std::size_t bond_store< Storage, MaxBonds, NumberOfCccds >::content_size( std::uint8_t type )
+    {
+        switch ( type )
+        {
+        case bond_record:
+            return bond_cccd_offset + cccd_size;
+        case cccd_record:
+            return cccd_offset + cccd_size;
+        default:
+            return 2;
+        }
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    std::uint32_t bond_store< Storage, MaxBonds, NumberOfCccds >::key_hash( std::uint16_t ediv, std::uint64_t rand )
+    {
+        std::uint32_t hash = static_cast< std::uint32_t >( rand ) ^ static_cast< std::uint32_t >( rand >> 32 ) * 0x9E3779B1u ^ ediv * 0x85EBCA6Bu;
+        hash ^= hash >> 16;
+        hash *= 0x7FEB352Du;
+
+        return hash ^ ( hash >> 15 );
+    }
+
+    // FNV-1a
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    std::uint32_t bond_store< Storage, MaxBonds, NumberOfCccds >::address_hash( const link_layer::device_address& address )
+    {
+        std::uint32_t hash = 0x811C9DC5u ^ ( address.is_random() ? 1u : 0u );
+
+        for ( const std::uint8_t octet : address )
+            hash = ( hash ^ octet ) * 0x01000193u;
+
+        return hash;
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    void bond_store< Storage, MaxBonds, NumberOfCccds >::read( std::uint32_t location, std::uint8_t* data, std::size_t size ) const
+    {
+        storage_.read( location / page_size, location % page_size, data, size );
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    bool bond_store< Storage, MaxBonds, NumberOfCccds >::page_erased( std::size_t page ) const
+    {
+        std::uint8_t header[ page_header_size ];
+        storage_.read( page, 0, header, page_header_size );
+
+        return std::all_of( std::begin( header ), std::end( header ), []( std::uint8_t octet ){
+            return octet == 0xff;
+        } );
+    }
+
+    // after an interrupted erase, the header might be erased, while the rest of the page is not
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    bool bond_store< Storage, MaxBonds, NumberOfCccds >::page_blank( std::size_t page ) const
+    {
+        std::uint8_t chunk[ page_header_size ];
+
+        for ( std::size_t offset = 0; offset != page_size; offset += sizeof( chunk ) )
+        {
+            const std::size_t size = std::min( sizeof( chunk ), page_size - offset );
+            storage_.read( page, offset, chunk, size );
+
+            if ( !std::all_of( &chunk[ 0 ], &chunk[ size ], []( std::uint8_t octet ){ return octet == 0xff; } ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    bool bond_store< Storage, MaxBonds, NumberOfCccds >::read_page_header( std::size_t page, std::uint32_t& sequence, bool& compacted ) const
+    {
+        std::uint8_t header[ page_header_size ];
+        storage_.read( page, 0, header, page_header_size );
+
+        if ( header[ 0 ] != page_magic || details::read_16bit( &header[ 6 ] ) != checksum( header, 6 ) )
+            return false;
+
+        compacted = header[ 1 ] & compacted_page_flag;
+        sequence  = details::read_32bit( &header[ 2 ] );
+
+        return true;
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    void bond_store< Storage, MaxBonds, NumberOfCccds >::start_page( std::size_t page, bool compacted )
+    {
+        std::uint8_t header[ page_header_size ] = { page_magic, static_cast< std::uint8_t >( compacted ? compacted_page_flag : 0 ) };
+        details::write_32bit( &header[ 2 ], next_sequence_ );
+        details::write_16bit( &header[ 6 ], checksum( header, 6 ) );
+
+        storage_.write( page, 0, header, page_header_size );
+
+        ++next_sequence_;
+        active_page_  = page;
+        write_offset_ = page_header_size;
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    typename bond_store< Storage, MaxBonds, NumberOfCccds >::replay_result bond_store< Storage, MaxBonds, NumberOfCccds >::replay_page( std::size_t page, bool apply )
+    {
+        std::uint8_t record[ bond_record_size ];
+        bool         compacted = false;
+
+        for ( std::size_t offset = page_header_size; offset + short_record_size <= page_size; )
+        {
+            storage_.read( page, offset, record, 1 );
+
+            if ( record[ 0 ] == end_of_log )
+                return { offset, compacted };
+
+            const std::size_t size = record_size( record[ 0 ] );
+
+            // a record, that was not completely written, closes the page
+            if ( size == 0 || offset + size > page_size )
+                return { page_size, compacted };
+
+            storage_.read( page, offset, record, size );
+
+            const std::size_t content = content_size( record[ 0 ] );
+
+            if ( details::read_16bit( &record[ content ] ) != checksum( record, content ) )
+                return { page_size, compacted };
+
+            const std::size_t   slot     = record[ 1 ];
+            const std::uint32_t location = static_cast< std::uint32_t >( page * page_size + offset );
+
+            if ( record[ 0 ] == compacted_record )
+            {
+                compacted = true;
+            }
+            else if ( apply && slot < MaxBonds )
+            {
+                if ( record[ 0 ] == bond_record )
+                {
+                    const std::uint32_t counter = details::read_32bit( &record[ bond_counter_offset ] );
+
+                    slots_[ slot ] = slot_t{ location, static_cast< std::uint32_t >( location + bond_cccd_offset ), counter };
+                    next_counter_  = std::max( next_counter_, counter + 1 );
+                }
+                else if ( record[ 0 ] == cccd_record && slots_[ slot ].bond != invalid_location )
+                {
+                    slots_[ slot ].cccds = static_cast< std::uint32_t >( location + cccd_offset );
+                }
+                else if ( record[ 0 ] == remove_record )
+                {
+                    slots_[ slot ] = slot_t{ invalid_location, invalid_location, 0 };
+                }
+            }
+
+            offset += size;
+        }
+
+        return { page_size, compacted };
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    std::uint32_t bond_store< Storage, MaxBonds, NumberOfCccds >::append( std::uint8_t* record, std::size_t size )
+    {
+        const std::size_t content = content_size( record[ 0 ] );
+
+        details::write_16bit( &record[ content ], checksum( record, content ) );
+
+        if ( active_page_ == no_page || write_offset_ + size > page_size )
+            next_page();
+
+        const std::uint32_t location = static_cast< std::uint32_t >( active_page_ * page_size + write_offset_ );
+
+        storage_.write( active_page_, write_offset_, record, size );
+        write_offset_ += size;
+
+        return location;
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    void bond_store< Storage, MaxBonds, NumberOfCccds >::next_page()
+    {
+        const std::size_t start = active_page_ == no_page ? 0 : active_page_ + 1;
+
+        std::size_t erased = 0;
+        std::size_t next   = no_page;
+
+        for ( std::size_t i = 0; i != number_of_pages; ++i )
+        {
+            const std::size_t page = ( start + i ) % number_of_pages;
+
+            if ( page != active_page_ && page_erased( page ) )
+            {
+                ++erased;
+
+                if ( next == no_page )
+                    next = page;
+            }
+        }
+
+        assert( next != no_page );
+
+        // the last erased page is kept for the compaction
+        if ( erased > 1 )
+        {
+            start_page( next, false );
+        }
+        else
+        {
+            compact( next );
+        }
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    void bond_store< Storage, MaxBonds, NumberOfCccds >::compact( std::size_t target )
+    {
+        start_page( target, true );
+
+        std::uint8_t record[ bond_record_size ];
+
+        for ( auto& slot : slots_ )
+        {
+            if ( slot.bond == invalid_location )
+                continue;
+
+            read( slot.bond, record, bond_record_size );
+            read( slot.cccds, &record[ bond_cccd_offset ], cccd_size );
+            details::write_16bit( &record[ bond_cccd_offset + cccd_size ], checksum( record, bond_cccd_offset + cccd_size ) );
+
+            const std::uint32_t location = static_cast< std::uint32_t >( target * page_size + write_offset_ );
+            storage_.write( target, write_offset_, record, bond_record_size );
+            write_offset_ += bond_record_size;
+
+            slot.bond  = location;
+            slot.cccds = static_cast< std::uint32_t >( location + bond_cccd_offset );
+        }
+
+        std::uint8_t marker[ short_record_size ] = { compacted_record, 0 };
+        details::write_16bit( &marker[ 2 ], checksum( marker, 2 ) );
+        storage_.write( target, write_offset_, marker, short_record_size );
+        write_offset_ += short_record_size;
+
+        for ( std::size_t page = 0; page != number_of_pages; ++page )
+        {
+            if ( page != target && !page_erased( page ) )
+                storage_.erase( page );
+        }
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    void bond_store< Storage, MaxBonds, NumberOfCccds >::write_bond( std::size_t slot, const std::uint8_t* address, bool random,
+        const details::longterm_key_t& key, const std::uint8_t* cccds )
+    {
+        std::uint8_t record[ bond_record_size ];
+        std::fill( std::begin( record ), std::end( record ), 0xff );
+
+        record[ 0 ] = bond_record;
+        record[ 1 ] = static_cast< std::uint8_t >( slot );
+        record[ bond_address_offset ] = random ? 1 : 0;
+        std::copy( address, address + 6, &record[ bond_address_offset + 1 ] );
+        std::copy( key.longterm_key.begin(), key.longterm_key.end(), &record[ bond_key_offset ] );
+        details::write_16bit( &record[ bond_ediv_offset ], key.ediv );
+        details::write_64bit( &record[ bond_rand_offset ], key.rand );
+        details::write_32bit( &record[ bond_counter_offset ], next_counter_ );
+        std::copy( cccds, cccds + cccd_size, &record[ bond_cccd_offset ] );
+
+        const std::uint32_t location = append( record, bond_record_size );
+
+        slots_[ slot ] = slot_t{ location, static_cast< std::uint32_t >( location + bond_cccd_offset ), next_counter_ };
+        ++next_counter_;
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    void bond_store< Storage, MaxBonds, NumberOfCccds >::rebuild_index()
+    {
+        static constexpr std::size_t mask = table_size() - 1;
+
+        std::fill( std::begin( by_key_ ), std::end( by_key_ ), 0 );
+        std::fill( std::begin( by_address_ ), std::end( by_address_ ), 0 );
+
+        for ( std::size_t slot = 0; slot != MaxBonds; ++slot )
+        {
+            if ( slots_[ slot ].bond == invalid_location )
+                continue;
+
+            std::uint8_t record[ bond_counter_offset ];
+            read( slots_[ slot ].bond, record, sizeof( record ) );
+
+            const link_layer::device_address address( &record[ bond_address_offset + 1 ], record[ bond_address_offset ] != 0 );
+
+            std::size_t index = address_hash( address ) & mask;
+            for ( ; by_address_[ index ] != 0; index = ( index + 1 ) & mask )
+                ;
+
+            by_address_[ index ] = static_cast< std::uint8_t >( slot + 1 );
+
+            const std::uint16_t ediv = details::read_16bit( &record[ bond_ediv_offset ] );
+            const std::uint64_t rand = details::read_64bit( &record[ bond_rand_offset ] );
+
+            // keys from LE Secure Connections are found by address
+            if ( ediv == 0 && rand == 0 )
+                continue;
+
+            index = key_hash( ediv, rand ) & mask;
+            for ( ; by_key_[ index ] != 0; index = ( index + 1 ) & mask )
+                ;
+
+            by_key_[ index ] = static_cast< std::uint8_t >( slot + 1 );
+        }
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    std::size_t bond_store< Storage, MaxBonds, NumberOfCccds >::find_address( const link_layer::device_address& address ) const
+    {
+        static constexpr std::size_t mask = table_size() - 1;
+
+        for ( std::size_t index = address_hash( address ) & mask; by_address_[ index ] != 0; index = ( index + 1 ) & mask )
+        {
+            const std::size_t slot = by_address_[ index ] - 1;
+
+            std::uint8_t stored[ 7 ];
+            read( slots_[ slot ].bond + bond_address_offset, stored, sizeof( stored ) );
+
+            if ( ( stored[ 0 ] != 0 ) == address.is_random() && std::equal( address.begin(), address.end(), &stored[ 1 ] ) )
+                return slot;
+        }
+
+        return no_slot;
+    }
+
+    template < class Storage, std::size_t MaxBonds, std::size_t NumberOfCccds >
+    std::size_t bond_store< Storage, MaxBonds, NumberOfCccds >::find_key_slot( std::uint16_t ediv, std::uint64_t rand ) const
+    {
+        static constexpr std::size_t mask = table_size() - 1;
+
+        for ( std::size_t index = key_hash( ediv, rand ) & mask; by_key_[ index ] != 0; index = ( index + 1 ) & mask )
+        {
+            const std::size_t slot = by_key_[ index ] - 1;
+
+            std::uint8_t stored[ 10 ];
+            read( slots_[ slot ].bond + bond_ediv_offset, stored, sizeof( stored ) );
+
+            if ( details::read_16bit( &stored[ 0 ] ) == ediv && details::read_64bit( &stored[ 2 ] ) == rand )
+                return slot;
+        }
+
+        return no_slot;
+    }
+    /** @endcond */
+}
+
+#endif
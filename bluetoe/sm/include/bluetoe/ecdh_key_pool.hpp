@@ -0,0 +1,168 @@
+#ifndef BLUETOE_SM_INCLUDE_ECDH_KEY_POOL_HPP
+#define BLUETOE_SM_INCLUDE_ECDH_KEY_POOL_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <utility>
+
+#include <bluetoe/ll_meta_types.hpp>
+#include <bluetoe/security_connection_data.hpp>
+
+namespace bluetoe {
+
+    namespace details {
+        struct ecdh_key_pool_meta_type {};
+
+        // public and private key, as returned by the security functions generate_keys()
+        using ecdh_key_pair_t = std::pair< ecdh_public_key_t, ecdh_private_key_t >;
+    }
+
+    /**
+     * @brief pool of precomputed ECDH key pairs for LE Secure Connections pairing
+     *
+     * Without this option, the security manager generates the local P-256 key pair when
+     * the central sends its public key. Depending on the hardware binding, this can take
+     * several hundred milliseconds, during which the L2CAP layer is blocked.
+     *
+     * With this option, up to Size key pairs are generated in advance, one key pair
+     * per call to link_layer::run(), while the device is otherwise idle. When a pairing
+     * requires a key pair and the pool is empty, the key pair is generated on demand.
+     *
+     * A key pair is generated in one piece and blocks link_layer::run() for the whole
+     * P-256 key generation. So the link layer does not refill the pool, while a connection
+     * is pairing or waits for a link layer control procedure (like a connection update) to
+     * complete.
+     *
+     * By default, every pairing attempt consumes a fresh key pair, as recommended by the
+     * Core Specification. If ReuseKeyPairs is true, a key pair is used for more than one
+     * pairing until S + 3F > 8, where S is the number of successful and F is the number
+     * of failed pairings that used the key pair.
+     *
+     * This option is ment to be passed as a link layer option to the selected device binding.
+     *
+     * @sa lesc_security_manager
+     * @sa security_manager
+     */
+    template < std::size_t Size, bool ReuseKeyPairs = false >
+    class ecdh_key_pool
+    {
+        static_assert( Size > 0, "the pool has to contain at least one key pair" );
+
+        /** @cond HIDDEN_SYMBOLS */
+    public:
+        ecdh_key_pool()
+            : first_( 0 )
+            , count_( 0 )
+            , weight_( 0 )
+            , in_use_( false )
+        {
+        }
+
+        template < class SecurityFunctions >
+        bool precompute_ecdh_key_pair( SecurityFunctions& functions )
+        {
+            if ( count_ == Size )
+                return false;
+
+            keys_[ ( first_ + count_ ) % Size ] = functions.generate_keys();
+            ++count_;
+
+            return true;
+        }
+
+        template < class SecurityFunctions >
+        details::ecdh_key_pair_t acquire_ecdh_key_pair( SecurityFunctions& functions )
+        {
+            if ( count_ != 0 && weight_ > max_weight )
+                drop_first();
+
+            if ( count_ == 0 )
+                precompute_ecdh_key_pair( functions );
+
+            const details::ecdh_key_pair_t result = keys_[ first_ ];
+
+            // a pairing counts as failed, until it is completed, so that a pairing that is
+            // aborted by a disconnect can not keep a key pair in use forever
+            if ( ReuseKeyPairs )
+            {
+                weight_ += failed_pairing_weight;
+                in_use_  = true;
+            }
+            else
+            {
+                drop_first();
+            }
+
+            return result;
+        }
+
+        void ecdh_key_pair_pairing_completed()
+        {
+            if ( in_use_ )
+                weight_ -= failed_pairing_weight - successful_pairing_weight;
+
+            in_use_ = false;
+        }
+
+        void ecdh_key_pair_pairing_failed()
+        {
+            in_use_ = false;
+        }
+
+        struct meta_type :
+            details::ecdh_key_pool_meta_type,
+            link_layer::details::valid_link_layer_option_meta_type {};
+
+    private:
+        static constexpr unsigned successful_pairing_weight = 1;
+        static constexpr unsigned failed_pairing_weight     = 3;
+        static constexpr unsigned max_weight                = ReuseKeyPairs ? 8 : 0;
+
+        void drop_first()
+        {
+            first_  = ( first_ + 1 ) % Size;
+            --count_;
+            weight_ = 0;
+        }
+
+        std::array< details::ecdh_key_pair_t, Size > keys_;
+        std::size_t                                  first_;
+        std::size_t                                  count_;
+        unsigned                                     weight_;
+        bool                                         in_use_;
+        /** @endcond */
+    };
+
+    namespace details {
+        class no_ecdh_key_pool
+        {
+        public:
+            template < class SecurityFunctions >
+            bool precompute_ecdh_key_pair( SecurityFunctions& )
+            {
+                return false;
+            }
+
+            template < class SecurityFunctions >
+            ecdh_key_pair_t acquire_ecdh_key_pair( SecurityFunctions& functions )
+            {
+                return functions.generate_keys();
+            }
+
+            void ecdh_key_pair_pairing_completed()
+            {
+            }
+
+            void ecdh_key_pair_pairing_failed()
+            {
+            }
+
+            struct meta_type :
+                details::ecdh_key_pool_meta_type,
+                link_layer::details::valid_link_layer_option_meta_type {};
+        };
+    }
+}
+
+#endif // include guard
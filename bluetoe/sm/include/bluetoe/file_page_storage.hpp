@@ -0,0 +1,149 @@
+#ifndef BLUETOE_SM_FILE_PAGE_STORAGE_HPP
+#define BLUETOE_SM_FILE_PAGE_STORAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cassert>
+#include <algorithm>
+#include <stdexcept>
+
+namespace bluetoe {
+
+    /**
+     * @brief page storage for the bond_store, backed by a file
+     *
+     * Emulates NumberOfPages flash pages of PageSize octets each. If the file does not exist, it is created
+     * with all pages erased. Every write and erase is flushed to the file immediately. To detect wrong usage
+     * of the storage, writes to octets that are not erased are asserted.
+     *
+     * Intended for host applications and tests.
+     *
+     * @sa bond_store
+     */
+    template < std::size_t PageSize, std::size_t NumberOfPages >
+    class file_page_storage
+    {
+    public:
+        static constexpr std::size_t page_size       = PageSize;
+        static constexpr std::size_t number_of_pages = NumberOfPages;
+
+        /**
+         * @brief opens or creates the given file
+         *
+         * throws std::runtime_error, if the file can not be opened or created
+         */
+        explicit file_page_storage( const char* file_name );
+
+        ~file_page_storage();
+
+        file_page_storage( const file_page_storage& ) = delete;
+        file_page_storage& operator=( const file_page_storage& ) = delete;
+
+        void read( std::size_t page, std::size_t offset, std::uint8_t* data, std::size_t size ) const;
+        void write( std::size_t page, std::size_t offset, const std::uint8_t* data, std::size_t size );
+        void erase( std::size_t page );
+
+        /**
+         * @brief number of times, the given page was erased since the file was opened
+         */
+        std::size_t erase_count( std::size_t page ) const;
+
+    private:
+        void seek( std::size_t page, std::size_t offset ) const;
+
+        std::FILE*  file_;
+        std::size_t erase_counts_[ NumberOfPages ];
+    };
+
+    // implementation
+    /** @cond HIDDEN_SYMBOLS */
+    template < std::size_t PageSize, std::size_t NumberOfPages >
+    file_page_storage< PageSize, NumberOfPages >::file_page_storage( const char* file_name )
+        : file_( std::fopen( file_name, "r+b" ) )
+    {
+        std::fill( std::begin( erase_counts_ ), std::end( erase_counts_ ), 0 );
+
+        if ( !file_ )
+        {
+            file_ = std::fopen( file_name, "w+b" );
+
+            if ( !file_ )
+                throw std::runtime_error( "unable to create page storage file" );
+
+            for ( std::size_t page = 0; page != NumberOfPages; ++page )
+            {
+                erase( page );
+                erase_counts_[ page ] = 0;
+            }
+        }
+    }
+
+    template < std::size_t PageSize, std::size_t NumberOfPages >
+    file_page_storage< PageSize, NumberOfPages >::~file_page_storage()
+    {
+        std::fclose( file_ );
+    }
+
+    template < std::size_t PageSize, std::size_t NumberOfPages >
+    void file_page_storage< PageSize, NumberOfPages >::read( std::size_t page, std::size_t offset, std::uint8_t* data, std::size_t size ) const
+    {
+        assert( page < NumberOfPages );
+        assert( offset + size <= PageSize );
+
+        seek( page, offset );
+
+        if ( std::fread( data, 1, size, file_ ) != size )
+            std::fill( data, data + size, 0xff );
+    }
+
+    template < std::size_t PageSize, std::size_t NumberOfPages >
+    void file_page_storage< PageSize, NumberOfPages >::write( std::size_t page, std::size_t offset, const std::uint8_t* data, std::size_t size )
+    {
+        assert( page < NumberOfPages );
+        assert( offset + size <= PageSize );
+        assert( offset % 4 == 0 && size % 4 == 0 );
+
+#ifndef NDEBUG
+        std::uint8_t current[ PageSize ];
+        read( page, offset, current, size );
+        assert( std::all_of( &current[ 0 ], &current[ size ], []( std::uint8_t octet ){ return octet == 0xff; } ) );
+#endif
+
+        seek( page, offset );
+        std::fwrite( data, 1, size, file_ );
+        std::fflush( file_ );
+    }
+
+    template < std::size_t PageSize, std::size_t NumberOfPages >
+    void file_page_storage< PageSize, NumberOfPages >::erase( std::size_t page )
+    {
+        assert( page < NumberOfPages );
+
+        std::uint8_t erased[ PageSize ];
+        std::fill( std::begin( erased ), std::end( erased ), 0xff );
+
+        seek( page, 0 );
+        std::fwrite( erased, 1, PageSize, file_ );
+        std::fflush( file_ );
+
+        ++erase_counts_[ page ];
+    }
+
+    template < std::size_t PageSize, std::size_t NumberOfPages >
+    std::size_t file_page_storage< PageSize, NumberOfPages >::erase_count( std::size_t page ) const
+    {
+        assert( page < NumberOfPages );
+
+        return erase_counts_[ page ];
+    }
+
+    template < std::size_t PageSize, std::size_t NumberOfPages >
+    void file_page_storage< PageSize, NumberOfPages >::seek( std::size_t page, std::size_t offset ) const
+    {
+        std::fseek( file_, static_cast< long >( page * PageSize + offset ), SEEK_SET );
+    }
+    /** @endcond */
+}
+
+#endif
@@ -1,6 +1,16 @@
 #ifndef BLUETOE_SM_SECURITY_CONNECTION_DATA_HPP
 #define BLUETOE_SM_SECURITY_CONNECTION_DATA_HPP
 
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <array>
+#include <algorithm>
+
+#include <bluetoe/address.hpp>
+#include <bluetoe/pairing_status.hpp>
+#include <bluetoe/io_capabilities.hpp>
+
 namespace bluetoe {
 
     namespace details {
@@ -57,6 +67,7 @@ namespace bluetoe {
             lesc_public_keys_exchanged,
             lesc_pairing_confirm_send,
             lesc_pairing_random_exchanged,
+            lesc_dh_key_calculation,
         };
 
         enum class authentication_requirements_flags : std::uint8_t {
@@ -83,7 +94,14 @@ namespace bluetoe {
 
             void remote_connection_created( const bluetoe::link_layer::device_address& remote )
             {
-                remote_addr_ = remote;
+                remote_addr_     = remote;
+                remote_identity_ = remote;
+            }
+
+            // the remote address was resolved to the given identity address by the resolving list of the link layer
+            void remote_identity_resolved( const bluetoe::link_layer::device_address& identity )
+            {
+                remote_identity_ = identity;
             }
 
             const bluetoe::link_layer::device_address& remote_address() const
@@ -91,6 +109,12 @@ namespace bluetoe {
                 return remote_addr_;
             }
 
+            // the address, that identifies the remote device across connections
+            const bluetoe::link_layer::device_address& remote_identity_address() const
+            {
+                return remote_identity_;
+            }
+
             void error_reset()
             {
                 state( details::sm_pairing_state::idle );
@@ -104,6 +128,7 @@ namespace bluetoe {
 
         private:
             link_layer::device_address          remote_addr_;
+            link_layer::device_address          remote_identity_;
             details::sm_pairing_state           state_;
         };
 
@@ -297,11 +322,31 @@ namespace bluetoe {
                 std::copy( remote_nonce, remote_nonce + 16, remote_nonce_.begin() );
             }
 
-            void lesc_pairing_completed( const details::uint128_t& long_term_key )
+            void dh_key_calculation_started( const std::uint8_t* remote_dhkey_check )
             {
                 assert( this->state() == details::sm_pairing_state::lesc_pairing_random_exchanged
                      || this->state() == details::sm_pairing_state::user_response_success );
 
+                this->state( details::sm_pairing_state::lesc_dh_key_calculation );
+
+                check_remote_dhkey_ = remote_dhkey_check != nullptr;
+
+                if ( remote_dhkey_check )
+                    std::copy( remote_dhkey_check, remote_dhkey_check + 16, remote_dhkey_check_.begin() );
+            }
+
+            // the DHKey Check value of the central, that has to be verified, once the DH key is available
+            const std::uint8_t* remote_dhkey_check() const
+            {
+                return check_remote_dhkey_ ? remote_dhkey_check_.data() : nullptr;
+            }
+
+            void lesc_pairing_completed( const details::uint128_t& long_term_key )
+            {
+                assert( this->state() == details::sm_pairing_state::lesc_pairing_random_exchanged
+                     || this->state() == details::sm_pairing_state::user_response_success
+                     || this->state() == details::sm_pairing_state::lesc_dh_key_calculation );
+
                 this->state( details::sm_pairing_state::pairing_completed );
 
                 long_term_key_ = long_term_key;
@@ -361,6 +406,8 @@ namespace bluetoe {
             uint128_t                           remote_nonce_;
             io_capabilities_t                   remote_io_caps_;
             uint128_t                           long_term_key_;
+            uint128_t                           remote_dhkey_check_;
+            bool                                check_remote_dhkey_;
         };
 
         template < class OtherConnectionData >
@@ -436,11 +483,31 @@ namespace bluetoe {
                     : device_pairing_status::authenticated_key;
             }
 
-            void lesc_pairing_completed( const details::uint128_t& long_term_key )
+            void dh_key_calculation_started( const std::uint8_t* remote_dhkey_check )
             {
                 assert( this->state() == details::sm_pairing_state::lesc_pairing_random_exchanged
                      || this->state() == details::sm_pairing_state::user_response_success );
 
+                this->state( details::sm_pairing_state::lesc_dh_key_calculation );
+
+                state_data_.lesc_state.check_remote_dhkey_ = remote_dhkey_check != nullptr;
+
+                if ( remote_dhkey_check )
+                    std::copy( remote_dhkey_check, remote_dhkey_check + 16, state_data_.lesc_state.remote_dhkey_check_.begin() );
+            }
+
+            // the DHKey Check value of the central, that has to be verified, once the DH key is available
+            const std::uint8_t* remote_dhkey_check() const
+            {
+                return state_data_.lesc_state.check_remote_dhkey_ ? state_data_.lesc_state.remote_dhkey_check_.data() : nullptr;
+            }
+
+            void lesc_pairing_completed( const details::uint128_t& long_term_key )
+            {
+                assert( this->state() == details::sm_pairing_state::lesc_pairing_random_exchanged
+                     || this->state() == details::sm_pairing_state::user_response_success
+                     || this->state() == details::sm_pairing_state::lesc_dh_key_calculation );
+
                 this->state( details::sm_pairing_state::pairing_completed );
 
                 long_term_key_ = long_term_key;
@@ -599,6 +666,8 @@ namespace bluetoe {
                     uint128_t                   remote_nonce_;
                     io_capabilities_t           remote_io_caps_;
                     enum lesc_pairing_algorithm algorithm;
+                    uint128_t                   remote_dhkey_check_;
+                    bool                        check_remote_dhkey_;
                 }                                           lesc_state;
             } state_data_;
         };
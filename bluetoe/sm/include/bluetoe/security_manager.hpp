@@ -13,6 +13,7 @@
 #include <bluetoe/pairing_status.hpp>
 #include <bluetoe/ll_meta_types.hpp>
 #include <bluetoe/oob_authentication.hpp>
+#include <bluetoe/ecdh_key_pool.hpp>
 #include <bluetoe/meta_tools.hpp>
 #include <bluetoe/io_capabilities.hpp>
 #include <bluetoe/l2cap_channels.hpp>
@@ -80,7 +81,8 @@ namespace bluetoe {
      * store_bond() is used to store a key that was either created by store_bond(), or during the LESC paring process.
      *
      * find_key() will be called to lookup a stored long term key. If it does not exists, the function should return
-     * a pair with the first member set to false.
+     * a pair with the first member set to false. remote_address is the identity address of the remote device, if the
+     * link layer was able to resolve the address of the remote device with its resolving list.
      *
      * This will also set bonding flags in the pairing response to "Bonding".
      *
@@ -111,7 +113,7 @@ namespace bluetoe {
                 if ( local_key.first )
                     return local_key;
 
-                return obj.find_key( ediv, rand, this->remote_address() );
+                return obj.find_key( ediv, rand, this->remote_identity_address() );
             }
 
             template < class Radio, class Connection >
@@ -120,7 +122,7 @@ namespace bluetoe {
                 pending_encryption_information = true;
                 pending_central_identification = true;
 
-                pending_key = obj.create_new_bond( radio, connection.remote_address() );
+                pending_key = obj.create_new_bond( radio, connection.remote_identity_address() );
                 obj.store_bond( pending_key, connection );
             }
 
@@ -247,13 +249,46 @@ namespace bluetoe {
                 | accumulate_authentication_requirements_flags< std::tuple< Options... > >::flags;
         };
 
+        struct dh_key_calculation_meta_type {};
+
+        // default: the DH key is calculated, while the DHKey Check PDU is handled
+        class synchronous_dh_key_calculation
+        {
+        public:
+            template < class SecurityFunctions, class Connection >
+            bool start_dh_key_calculation( SecurityFunctions& functions, const std::uint8_t*, Connection& state, ecdh_shared_secret_t& dh_key )
+            {
+                dh_key = functions.p256( state.local_private_key(), state.remote_public_key() );
+
+                return true;
+            }
+
+            template < class SecurityFunctions, class Connection >
+            bool continue_dh_key_calculation( SecurityFunctions&, Connection&, ecdh_shared_secret_t&, const std::uint8_t*& )
+            {
+                return false;
+            }
+
+            struct meta_type :
+                details::dh_key_calculation_meta_type,
+                link_layer::details::valid_link_layer_option_meta_type {};
+        };
+
         // features required by legacy and by lesc pairing
         template < typename SecurityFunctions, template < class OtherConnectionData > class ConnectionData, typename ... Options >
         class security_manager_base :
             protected details::find_by_meta_type<
                 details::oob_authentication_callback_meta_type,
                 Options...,
-                details::no_oob_authentication >::type
+                details::no_oob_authentication >::type,
+            protected details::find_by_meta_type<
+                details::ecdh_key_pool_meta_type,
+                Options...,
+                details::no_ecdh_key_pool >::type,
+            protected details::find_by_meta_type<
+                details::dh_key_calculation_meta_type,
+                Options...,
+                details::synchronous_dh_key_calculation >::type
         {
         protected:
             static constexpr std::uint8_t authentication_requirements_flags =
@@ -275,6 +310,7 @@ namespace bluetoe {
             void error_response( details::sm_error_codes error_code, std::uint8_t* output, std::size_t& out_size, Connection& state )
             {
                 state.error_reset();
+                this->ecdh_key_pair_pairing_failed();
                 details::error_response( error_code, output, out_size );
             }
 
@@ -329,6 +365,9 @@ namespace bluetoe {
             template < class Connection >
             void lesc_handle_pairing_dhkey_check( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, Connection& );
 
+            template < class Connection >
+            void lesc_dhkey_check( const ecdh_shared_secret_t& dh_key, const std::uint8_t* remote_check, std::uint8_t* output, std::size_t& out_size, Connection& );
+
             template < class Connection >
             bool lesc_security_manager_output_available( Connection& ) const;
 
@@ -363,6 +402,12 @@ namespace bluetoe {
             template < class Connection >
             void l2cap_output( std::uint8_t* output, std::size_t& out_size, Connection& );
 
+            // legacy pairing does not use ECDH key pairs
+            bool precompute_security_keys()
+            {
+                return false;
+            }
+
             static constexpr std::uint16_t channel_id               = l2cap_channel_ids::sm;
             static constexpr std::size_t   minimum_channel_mtu_size = default_att_mtu_size;
             static constexpr std::size_t   maximum_channel_mtu_size = default_att_mtu_size;
@@ -385,6 +430,20 @@ namespace bluetoe {
             template < class Connection >
             void l2cap_output( std::uint8_t* output, std::size_t& out_size, Connection& );
 
+            // to be called, when the device is idle; generates at max one key pair per call
+            bool precompute_security_keys()
+            {
+                return this->precompute_ecdh_key_pair( this->security_functions() );
+            }
+
+            // true, while a pairing procedure is running on the given connection
+            template < class Connection >
+            bool pairing_in_progress( const Connection& state ) const
+            {
+                return state.state() != details::sm_pairing_state::idle
+                    && state.state() != details::sm_pairing_state::pairing_completed;
+            }
+
             static constexpr std::uint16_t channel_id               = l2cap_channel_ids::sm;
             static constexpr std::size_t   minimum_channel_mtu_size = default_lesc_mtu_size;
             static constexpr std::size_t   maximum_channel_mtu_size = default_lesc_mtu_size;
@@ -407,6 +466,20 @@ namespace bluetoe {
             template < class Connection >
             void l2cap_output( std::uint8_t* output, std::size_t& out_size, Connection& );
 
+            // to be called, when the device is idle; generates at max one key pair per call
+            bool precompute_security_keys()
+            {
+                return this->precompute_ecdh_key_pair( this->security_functions() );
+            }
+
+            // true, while a pairing procedure is running on the given connection
+            template < class Connection >
+            bool pairing_in_progress( const Connection& state ) const
+            {
+                return state.state() != details::sm_pairing_state::idle
+                    && state.state() != details::sm_pairing_state::pairing_completed;
+            }
+
             static constexpr std::uint16_t channel_id               = l2cap_channel_ids::sm;
             static constexpr std::size_t   minimum_channel_mtu_size = default_lesc_mtu_size;
             static constexpr std::size_t   maximum_channel_mtu_size = default_lesc_mtu_size;
@@ -614,6 +687,102 @@ namespace bluetoe {
         /** @endcond */
     };
 
+    /**
+     * @brief calculate the DH key of a LESC pairing in small steps, instead of blocking
+     *
+     * By default, the P-256 DH key is calculated, when the DHKey Check PDU from the central is
+     * received. Depending on the hardware binding, this can block the L2CAP layer for several
+     * hundred milliseconds.
+     *
+     * With this option, the calculation is just started, when the DHKey Check PDU is received.
+     * The calculation is continued by the link layer, every time it asks the security manager
+     * for pending output and the security manager responds with its DHKey Check PDU, once the
+     * calculation is finished.
+     *
+     * The security functions of the hardware binding have to provide the following functions:
+     *
+     * void p256_start( const std::uint8_t* private_key, const std::uint8_t* public_key );
+     *
+     * bool p256_step();
+     *
+     * ecdh_shared_secret_t p256_result();
+     *
+     * p256_step() performs a bounded amount of work and returns true, once the result of the calculation
+     * is available by calling p256_result().
+     *
+     * Only one DH key is calculated at a time. If the link layer serves more than one connection
+     * (max_concurrent_connections), a pairing that receives the DHKey Check PDU, while the DH key of
+     * an other connection is calculated, waits until that calculation is finished. The DHKey Check value
+     * of the central is kept in the connection data of every pairing.
+     *
+     * This option is ment to be passed as a link layer option to the selected device binding.
+     *
+     * @sa lesc_security_manager
+     * @sa security_manager
+     */
+    class incremental_dh_key_calculation
+    {
+    public:
+        /** @cond HIDDEN_SYMBOLS */
+        incremental_dh_key_calculation()
+            : calculating_for_( nullptr )
+        {
+        }
+
+        template < class SecurityFunctions, class Connection >
+        bool start_dh_key_calculation( SecurityFunctions& functions, const std::uint8_t* remote_check, Connection& state, details::ecdh_shared_secret_t& )
+        {
+            state.dh_key_calculation_started( remote_check );
+            claim_dh_key_calculation( functions, state );
+
+            return false;
+        }
+
+        template < class SecurityFunctions, class Connection >
+        bool continue_dh_key_calculation( SecurityFunctions& functions, Connection& state, details::ecdh_shared_secret_t& dh_key, const std::uint8_t*& remote_check )
+        {
+            // the DH key of an other connection is being calculated
+            if ( calculating_for_ != &state && !claim_dh_key_calculation( functions, state ) )
+                return false;
+
+            if ( !functions.p256_step() )
+                return false;
+
+            calculating_for_ = nullptr;
+            dh_key           = functions.p256_result();
+            remote_check     = state.remote_dhkey_check();
+
+            return true;
+        }
+
+        struct meta_type :  link_layer::details::valid_link_layer_option_meta_type,
+                            details::dh_key_calculation_meta_type {};
+
+    private:
+        template < class SecurityFunctions, class Connection >
+        bool claim_dh_key_calculation( SecurityFunctions& functions, Connection& state )
+        {
+            // the pairing, the calculation was started for, failed or its connection was closed and reused
+            if ( calculating_for_ != nullptr
+              && static_cast< const Connection* >( calculating_for_ )->state() != details::sm_pairing_state::lesc_dh_key_calculation )
+            {
+                calculating_for_ = nullptr;
+            }
+
+            if ( calculating_for_ != nullptr && calculating_for_ != &state )
+                return false;
+
+            calculating_for_ = &state;
+            functions.p256_start( state.local_private_key(), state.remote_public_key() );
+
+            return true;
+        }
+
+        // connection data of the pairing, the DH key is calculated for
+        const void* calculating_for_;
+        /** @endcond */
+    };
+
     /*
      * Implementation
      */
@@ -920,7 +1089,7 @@ namespace bluetoe {
         output[ 0 ] = static_cast< std::uint8_t >( details::sm_opcodes::pairing_public_key );
 
         out_size = public_key_exchange_size;
-        const auto& keys  = security_functions().generate_keys();
+        const auto  keys  = this->acquire_ecdh_key_pair( security_functions() );
         const auto& nonce = security_functions().select_random_nonce();
 
         state.public_key_exchanged( keys.second, keys.first, &input[ 1 ], nonce );
@@ -981,28 +1150,47 @@ namespace bluetoe {
         }
         else
         {
-            const details::ecdh_shared_secret_t dh_key = security_functions().p256( state.local_private_key(), state.remote_public_key() );
+            details::ecdh_shared_secret_t dh_key;
 
-            details::uint128_t mac_key;
-            details::uint128_t ltk;
-            static const details::uint128_t zero = {{ 0 }};
+            if ( this->start_dh_key_calculation( security_functions(), &input[ 1 ], state, dh_key ) )
+            {
+                lesc_dhkey_check( dh_key, &input[ 1 ], output, out_size, state );
+            }
+            else
+            {
+                out_size = 0;
+            }
+        }
+    }
 
-            std::tie( mac_key, ltk ) = security_functions().f5( dh_key, state.remote_nonce(), state.local_nonce(), state.remote_address(), security_functions().local_address() );
+    template < typename SecurityFunctions, template < class OtherConnectionData > class ConnectionData, typename ... Options >
+    template < class Connection >
+    void details::security_manager_base< SecurityFunctions, ConnectionData, Options... >::lesc_dhkey_check(
+        const ecdh_shared_secret_t& dh_key, const std::uint8_t* remote_check, std::uint8_t* output, std::size_t& out_size, Connection& state )
+    {
+        details::uint128_t mac_key;
+        details::uint128_t ltk;
+        static const details::uint128_t zero = {{ 0 }};
+
+        std::tie( mac_key, ltk ) = security_functions().f5( dh_key, state.remote_nonce(), state.local_nonce(), state.remote_address(), security_functions().local_address() );
 
+        if ( remote_check )
+        {
             const auto calc_ea = security_functions().f6( mac_key, state.remote_nonce(), state.local_nonce(), zero, state.remote_io_caps(), state.remote_address(), security_functions().local_address() );
 
-            if ( !std::equal( calc_ea.begin(), calc_ea.end(), &input[ 1 ] ) )
+            if ( !std::equal( calc_ea.begin(), calc_ea.end(), remote_check ) )
                 return this->error_response( details::sm_error_codes::dhkey_check_failed, output, out_size, state );
+        }
 
-            const auto eb = security_functions().f6( mac_key, state.local_nonce(), state.remote_nonce(), zero, lesc_local_io_caps(), security_functions().local_address(), state.remote_address() );
+        const auto eb = security_functions().f6( mac_key, state.local_nonce(), state.remote_nonce(), zero, lesc_local_io_caps(), security_functions().local_address(), state.remote_address() );
 
-            out_size = pairing_dhkey_check_size;
-            output[ 0 ] = static_cast< std::uint8_t >( details::sm_opcodes::pairing_dhkey_check );
-            std::copy( eb.begin(), eb.end(), &output[ 1 ] );
+        out_size = pairing_dhkey_check_size;
+        output[ 0 ] = static_cast< std::uint8_t >( details::sm_opcodes::pairing_dhkey_check );
+        std::copy( eb.begin(), eb.end(), &output[ 1 ] );
 
-            state.lesc_pairing_completed( ltk );
-            state.store_lesc_key_in_bond_db( ltk, state );
-        }
+        state.lesc_pairing_completed( ltk );
+        state.store_lesc_key_in_bond_db( ltk, state );
+        this->ecdh_key_pair_pairing_completed();
     }
 
     template < typename SecurityFunctions, template < class OtherConnectionData > class ConnectionData, typename ... Options >
@@ -1011,7 +1199,8 @@ namespace bluetoe {
     {
         return state.state() == details::sm_pairing_state::lesc_public_keys_exchanged
             || state.state() == details::sm_pairing_state::user_response_success
-            || state.state() == details::sm_pairing_state::user_response_failed;
+            || state.state() == details::sm_pairing_state::user_response_failed
+            || state.state() == details::sm_pairing_state::lesc_dh_key_calculation;
     }
 
     template < typename SecurityFunctions, template < class OtherConnectionData > class ConnectionData, typename ... Options >
@@ -1036,21 +1225,30 @@ namespace bluetoe {
         }
         else if ( state.state() == details::sm_pairing_state::user_response_success )
         {
-            const details::ecdh_shared_secret_t dh_key = security_functions().p256( state.local_private_key(), state.remote_public_key() );
-
-            details::uint128_t mac_key;
-            details::uint128_t ltk;
-            static const details::uint128_t zero = {{ 0 }};
+            details::ecdh_shared_secret_t dh_key;
 
-            std::tie( mac_key, ltk ) = security_functions().f5( dh_key, state.remote_nonce(), state.local_nonce(), state.remote_address(), security_functions().local_address() );
-            const auto eb = security_functions().f6( mac_key, state.local_nonce(), state.remote_nonce(), zero, this->lesc_local_io_caps(), security_functions().local_address(), state.remote_address() );
-
-            out_size = this->pairing_dhkey_check_size;
-            output[ 0 ] = static_cast< std::uint8_t >( details::sm_opcodes::pairing_dhkey_check );
-            std::copy( eb.begin(), eb.end(), &output[ 1 ] );
+            if ( this->start_dh_key_calculation( security_functions(), nullptr, state, dh_key ) )
+            {
+                lesc_dhkey_check( dh_key, nullptr, output, out_size, state );
+            }
+            else
+            {
+                out_size = 0;
+            }
+        }
+        else if ( state.state() == details::sm_pairing_state::lesc_dh_key_calculation )
+        {
+            details::ecdh_shared_secret_t dh_key;
+            const std::uint8_t*           remote_check = nullptr;
 
-            state.lesc_pairing_completed( ltk );
-            state.store_lesc_key_in_bond_db( ltk, state );
+            if ( this->continue_dh_key_calculation( security_functions(), state, dh_key, remote_check ) )
+            {
+                lesc_dhkey_check( dh_key, remote_check, output, out_size, state );
+            }
+            else
+            {
+                out_size = 0;
+            }
         }
         else
         {
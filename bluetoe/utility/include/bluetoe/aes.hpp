@@ -0,0 +1,87 @@
+#ifndef BLUETOE_UTILITY_AES_HPP
+#define BLUETOE_UTILITY_AES_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace bluetoe {
+namespace details {
+
+    /**
+     * @brief software implementation of the AES-128 block cipher (encryption only)
+     *
+     * key, input and output are 16 octets in the byte order of FIPS-197 (most significant octet first).
+     * input and output may point to the same block.
+     *
+     * This is meant for computations that do not depend on the availability of a hardware AES unit.
+     */
+    void aes128_encrypt( const std::uint8_t* key, const std::uint8_t* input, std::uint8_t* output );
+
+    /**
+     * @brief AES-128 block cipher (encryption only) with a key schedule, that is expanded once
+     *
+     * Blocks are encrypted with a 1kB lookup table, that combines SubBytes and MixColumns. When more than one
+     * block has to be encrypted with the same key, this is considerably faster than aes128_encrypt().
+     *
+     * key, input and output are in the byte order of FIPS-197 (most significant octet first).
+     * input and output may point to the same block.
+     */
+    class aes128
+    {
+    public:
+        static constexpr std::size_t block_size = 16;
+
+        /**
+         * @brief expands the given, 16 octet key
+         */
+        explicit aes128( const std::uint8_t* key );
+
+        /**
+         * @brief encrypts one block of 16 octets
+         */
+        void encrypt( const std::uint8_t* input, std::uint8_t* output ) const;
+
+    private:
+        static constexpr std::size_t number_of_round_keys = 44;
+
+        std::uint32_t round_keys_[ number_of_round_keys ];
+    };
+
+    /**
+     * @brief incremental AES-CMAC as defined by RFC 4493
+     *
+     * The message can be passed in arbitrary sized pieces by calling update(). finalize() calculates the
+     * 16 octet message authentication code, in the byte order of RFC 4493 (most significant octet first).
+     */
+    class aes_cmac
+    {
+    public:
+        static constexpr std::size_t block_size = 16;
+
+        /**
+         * @brief starts a new message, using the given, 16 octet key
+         */
+        explicit aes_cmac( const std::uint8_t* key );
+
+        /**
+         * @brief appends size octets to the message
+         */
+        void update( const std::uint8_t* data, std::size_t size );
+
+        /**
+         * @brief calculates the message authentication code over all octets passed to update()
+         *
+         * After calling finalize(), no further calls to update() are allowed.
+         */
+        void finalize( std::uint8_t* mac );
+
+    private:
+        aes128       cipher_;
+        std::uint8_t state_[ block_size ];
+        std::uint8_t block_[ block_size ];
+        std::size_t  block_fill_;
+    };
+}
+}
+
+#endif
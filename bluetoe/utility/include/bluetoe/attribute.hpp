@@ -30,6 +30,7 @@ namespace details {
         request_not_supported           = 0x06,
         insufficient_encryption         = 0x0f,
         insufficient_authentication     = 0x05,
+        value_not_allowed               = 0x13,
 
         // returned when access type is compare_128bit_uuid and the attribute contains a 128bit uuid and
         // the buffer in attribute_access_arguments is equal to the contained uuid.
@@ -185,20 +186,16 @@ namespace details {
     };
 
     /*
-     * Given that T is a tuple with elements that implement attribute_at< std::size_t, Service >() and number_of_attributes, the type implements
-     * attribute_at() for a list of attribute lists.
+     * Given that T is a tuple with elements that implement attribute_generators<>, the type collects the attribute generators
+     * of all elements into one tuple. The order of the resulting tuple is the order of the attributes.
      */
     template < typename T, typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename Service, typename Server >
-    struct attribute_at_list;
+    struct attribute_generators_from_list;
 
     template < typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename Service, typename Server >
-    struct attribute_at_list< std::tuple<>, CCCDIndices, ClientCharacteristicIndex, Service, Server >
+    struct attribute_generators_from_list< std::tuple<>, CCCDIndices, ClientCharacteristicIndex, Service, Server >
     {
-        static details::attribute attribute_at( std::size_t )
-        {
-            assert( !"index out of bound" );
-            return details::attribute();
-        }
+        using type = std::tuple<>;
     };
 
     template <
@@ -208,33 +205,24 @@ namespace details {
         std::size_t ClientCharacteristicIndex,
         typename Service,
         typename Server >
-    struct attribute_at_list< std::tuple< T, Ts... >, CCCDIndices, ClientCharacteristicIndex, Service, Server >
+    struct attribute_generators_from_list< std::tuple< T, Ts... >, CCCDIndices, ClientCharacteristicIndex, Service, Server >
     {
-        static details::attribute attribute_at( std::size_t index )
-        {
-            if ( index < T::number_of_attributes )
-                return T::template attribute_at< CCCDIndices, ClientCharacteristicIndex, Service, Server >( index );
-
-            typedef details::attribute_at_list< std::tuple< Ts... >, CCCDIndices, ClientCharacteristicIndex + T::number_of_client_configs, Service, Server > remaining_characteristics;
-
-            return remaining_characteristics::attribute_at( index - T::number_of_attributes );
-        }
+        using type = typename add_type<
+            typename T::template attribute_generators< CCCDIndices, ClientCharacteristicIndex, Service, Server >::type,
+            typename attribute_generators_from_list< std::tuple< Ts... >, CCCDIndices, ClientCharacteristicIndex + T::number_of_client_configs, Service, Server >::type
+        >::type;
     };
 
     /*
      * Iterating the list of services is the same, but needs less parameters
      */
     template < typename Services, typename Server, typename CCCDIndices, std::size_t ClientCharacteristicIndex = 0, typename AllServices = Services >
-    struct attribute_from_service_list;
+    struct attribute_generators_from_service_list;
 
     template < typename Server, typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename AllServices >
-    struct attribute_from_service_list< std::tuple<>, Server, CCCDIndices, ClientCharacteristicIndex, AllServices >
+    struct attribute_generators_from_service_list< std::tuple<>, Server, CCCDIndices, ClientCharacteristicIndex, AllServices >
     {
-        static details::attribute attribute_at( std::size_t )
-        {
-            assert( !"index out of bound" );
-            return details::attribute();
-        }
+        using type = std::tuple<>;
     };
 
     template <
@@ -244,22 +232,17 @@ namespace details {
         typename CCCDIndices,
         std::size_t ClientCharacteristicIndex,
         typename AllServices >
-    struct attribute_from_service_list< std::tuple< T, Ts... >, Server, CCCDIndices, ClientCharacteristicIndex, AllServices >
+    struct attribute_generators_from_service_list< std::tuple< T, Ts... >, Server, CCCDIndices, ClientCharacteristicIndex, AllServices >
     {
-        static details::attribute attribute_at( std::size_t index )
-        {
-            if ( index < T::number_of_attributes )
-                return T::template attribute_at< CCCDIndices, ClientCharacteristicIndex, AllServices, Server >( index );
-
-            typedef details::attribute_from_service_list<
+        using type = typename add_type<
+            typename T::template attribute_generators< CCCDIndices, ClientCharacteristicIndex, AllServices, Server >::type,
+            typename attribute_generators_from_service_list<
                 std::tuple< Ts... >,
                 Server,
                 CCCDIndices,
                 ClientCharacteristicIndex + T::number_of_client_configs,
-                AllServices > remaining_characteristics;
-
-            return remaining_characteristics::attribute_at( index - T::number_of_attributes );
-        }
+                AllServices >::type
+        >::type;
     };
 
     /**
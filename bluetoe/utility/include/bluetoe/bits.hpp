@@ -112,6 +112,25 @@ namespace details {
             ? positive
             : -negative;
     }
+
+    /**
+     * @brief returns the number of trailing zero bits in value
+     *
+     * @pre value != 0
+     */
+    inline unsigned count_trailing_zeros( std::uint32_t value )
+    {
+#if defined( __GNUC__ )
+        return static_cast< unsigned >( __builtin_ctz( value ) );
+#else
+        unsigned result = 0;
+
+        for ( ; ( value & 1 ) == 0; value >>= 1 )
+            ++result;
+
+        return result;
+#endif
+    }
 }
 }
 #endif
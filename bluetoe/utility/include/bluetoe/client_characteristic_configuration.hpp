@@ -4,6 +4,7 @@
 #include <cassert>
 #include <cstdint>
 #include <algorithm>
+#include <iterator>
 
 namespace bluetoe {
 namespace details {
@@ -18,11 +19,13 @@ namespace details {
     public:
         constexpr client_characteristic_configuration()
             : data_( nullptr )
+            , features_( nullptr )
         {
         }
 
-        constexpr explicit client_characteristic_configuration( std::uint8_t* data, std::size_t )
+        constexpr explicit client_characteristic_configuration( std::uint8_t* data, std::size_t, std::uint8_t* features = nullptr )
             : data_( data )
+            , features_( features )
         {
         }
 
@@ -41,6 +44,26 @@ namespace details {
             data_[ index / 4 ] = ( data_[ index / 4 ] & ~mask( index ) ) | ( ( new_flags & 0x03 ) << shift( index ) );
         }
 
+        /**
+         * @brief value of the Client Supported Features characteristic for this connection
+         *
+         * Returns 0, if there is no storage for the features.
+         */
+        std::uint8_t client_supported_features() const
+        {
+            return features_ ? *features_ : 0;
+        }
+
+        /**
+         * @brief changes the value of the Client Supported Features for this connection
+         */
+        void client_supported_features( std::uint8_t features )
+        {
+            assert( features_ );
+
+            *features_ = features;
+        }
+
         static constexpr std::size_t bits_per_config = 2;
 
     private:
@@ -55,6 +78,7 @@ namespace details {
         }
 
         std::uint8_t*   data_;
+        std::uint8_t*   features_;
     };
 
     /**
@@ -73,15 +97,34 @@ namespace details {
         static constexpr std::size_t number_of_characteristics_with_configuration = Size;
 
         client_characteristic_configurations()
+            : client_features_( 0 )
         {
             std::fill( std::begin( configs_ ), std::end( configs_ ), 0 );
         }
 
         client_characteristic_configuration client_configurations()
         {
-            return client_characteristic_configuration( &configs_[ 0 ], Size );
+            return client_characteristic_configuration( &configs_[ 0 ], Size, &client_features_ );
         };
 
+        /**
+         * @brief features, the client announced by writing to the Client Supported Features characteristic
+         */
+        std::uint8_t client_supported_features() const
+        {
+            return client_features_;
+        }
+
+        /**
+         * @brief sets the client supported features
+         *
+         * This can be used to restore the features from bonding data.
+         */
+        void client_supported_features( std::uint8_t features )
+        {
+            client_features_ = features;
+        }
+
         /**
          * @brief begin of the serialized CCCDs
          *
@@ -124,16 +167,35 @@ namespace details {
 
     private:
         std::uint8_t configs_[ ( Size * client_characteristic_configuration::bits_per_config + 7 ) / 8 ];
+        std::uint8_t client_features_;
     };
 
     template <>
     class client_characteristic_configurations< 0 >
     {
     public:
+        client_characteristic_configurations()
+            : client_features_( 0 )
+        {
+        }
+
         client_characteristic_configuration client_configurations()
         {
-            return client_characteristic_configuration();
+            return client_characteristic_configuration( nullptr, 0, &client_features_ );
         }
+
+        std::uint8_t client_supported_features() const
+        {
+            return client_features_;
+        }
+
+        void client_supported_features( std::uint8_t features )
+        {
+            client_features_ = features;
+        }
+
+    private:
+        std::uint8_t client_features_;
     };
 
 }
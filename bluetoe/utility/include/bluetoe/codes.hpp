@@ -36,7 +36,10 @@ namespace details {
         write_command               = 0x52,
         notification                = 0x1B,
         indication                  = 0x1D,
-        confirmation                = 0x1E
+        confirmation                = 0x1E,
+        read_multiple_variable_length_request  = 0x20,
+        read_multiple_variable_length_response = 0x21,
+        multiple_handle_value_notification = 0x23
 
     };
 
@@ -62,7 +65,9 @@ namespace details {
         unlikely_error,
         insufficient_encryption,
         unsupported_group_type,
-        insufficient_resources
+        insufficient_resources,
+        database_out_of_sync,
+        value_not_allowed
     };
 
     constexpr std::uint8_t bits( att_error_codes c )
@@ -85,8 +90,12 @@ namespace details {
         secondary_service                   = 0x2801,
         include                             = 0x2802,
         characteristic                      = 0x2803,
+        characteristic_extended_properties  = 0x2900,
         characteristic_user_description     = 0x2901,
         client_characteristic_configuration = 0x2902,
+        server_characteristic_configuration = 0x2903,
+        characteristic_presentation_format  = 0x2904,
+        characteristic_aggregate_format     = 0x2905,
 
         internal_128bit_uuid    = 1
     };
@@ -131,6 +140,14 @@ namespace details {
         client_characteristic_configuration_indication_enabled   = 2
     };
 
+    // bits of the Client Supported Features characteristic value
+    enum {
+        client_supported_features_robust_caching                      = 0x01,
+        client_supported_features_enhanced_att_bearer                 = 0x02,
+        client_supported_features_multiple_handle_value_notifications = 0x04,
+        client_supported_features_all                                 = 0x07
+    };
+
     inline std::uint8_t* write_opcode( std::uint8_t* out, details::att_opcodes opcode )
     {
         *out = bits( opcode );
@@ -239,6 +256,16 @@ namespace error_codes {
          */
         insufficient_resources,
 
+        /**
+         * The server requests the client to rediscover the database.
+         */
+        database_out_of_sync,
+
+        /**
+         * The attribute parameter value was not allowed.
+         */
+        value_not_allowed,
+
         /**
          * Start of range for application specific error codes
          */
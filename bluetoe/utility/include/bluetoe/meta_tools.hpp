@@ -4,6 +4,8 @@
 #include <utility>
 #include <type_traits>
 #include <tuple>
+#include <cstdint>
+#include <cstddef>
 
 /**
  * @file bluetoe/meta_tools.hpp
@@ -893,6 +895,94 @@ namespace details {
     };
 
 
+    /*
+     * compile time sequence of indices (std::index_sequence is not available before C++14)
+     *
+     * make_index_sequence< N > is instanciated with a recursion depth of log(N)
+     */
+    template < std::size_t ... Is >
+    struct index_sequence {};
+
+    template < typename A, typename B >
+    struct concat_index_sequence;
+
+    template < std::size_t ... As, std::size_t ... Bs >
+    struct concat_index_sequence< index_sequence< As... >, index_sequence< Bs... > >
+    {
+        using type = index_sequence< As..., ( sizeof...( As ) + Bs )... >;
+    };
+
+    template < std::size_t N >
+    struct make_index_sequence_impl
+    {
+        using type = typename concat_index_sequence<
+            typename make_index_sequence_impl< N / 2 >::type,
+            typename make_index_sequence_impl< N - N / 2 >::type >::type;
+    };
+
+    template <>
+    struct make_index_sequence_impl< 0 >
+    {
+        using type = index_sequence<>;
+    };
+
+    template <>
+    struct make_index_sequence_impl< 1 >
+    {
+        using type = index_sequence< 0 >;
+    };
+
+    template < std::size_t N >
+    using make_index_sequence = typename make_index_sequence_impl< N >::type;
+
+    /**
+     * compile time sequence of bytes, that is accessible at runtime as an array
+     *
+     * values contains a trailing 0 to allow empty sequences.
+     */
+    template < std::uint8_t ... Bytes >
+    struct byte_sequence
+    {
+        static constexpr std::size_t  size = sizeof...( Bytes );
+        static constexpr std::uint8_t values[ sizeof...( Bytes ) + 1 ] = { Bytes..., 0 };
+    };
+
+    template < std::uint8_t ... Bytes >
+    constexpr std::uint8_t byte_sequence< Bytes... >::values[ sizeof...( Bytes ) + 1 ];
+
+    template < typename ... Sequences >
+    struct concat_byte_sequences
+    {
+        using type = byte_sequence<>;
+    };
+
+    template < std::uint8_t ... Bytes >
+    struct concat_byte_sequences< byte_sequence< Bytes... > >
+    {
+        using type = byte_sequence< Bytes... >;
+    };
+
+    template < std::uint8_t ... As, std::uint8_t ... Bs, typename ... Sequences >
+    struct concat_byte_sequences< byte_sequence< As... >, byte_sequence< Bs... >, Sequences... >
+    {
+        using type = typename concat_byte_sequences< byte_sequence< As..., Bs... >, Sequences... >::type;
+    };
+
+    /**
+     * the first Size bytes of the byte_sequence Sequence
+     */
+    template < typename Sequence, std::size_t Size, typename = make_index_sequence< Size > >
+    struct first_bytes;
+
+    template < typename Sequence, std::size_t Size, std::size_t ... Is >
+    struct first_bytes< Sequence, Size, index_sequence< Is... > >
+    {
+        static_assert( Size <= Sequence::size, "sequence is too short" );
+
+        using type = byte_sequence< Sequence::values[ Is ]... >;
+    };
+
+
 }
 }
 
@@ -59,7 +59,7 @@ namespace details {
             };
         static constexpr bool is_128bit = true;
 
-        static std::uint16_t as_16bit() {
+        static constexpr std::uint16_t as_16bit() {
             return A & 0xffff;
         };
     };
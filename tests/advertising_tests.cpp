@@ -398,3 +398,140 @@ BOOST_FIXTURE_TEST_CASE( configured_appearance, hoverboard_server )
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( compile_time_advertising_data )
+
+static constexpr char name[] = "Test Name";
+
+using all_ads_server = bluetoe::extend_server<
+    test::small_temperature_service,
+    bluetoe::server_name< name >,
+    bluetoe::appearance::location_pod,
+    bluetoe::advertise_appearance,
+    bluetoe::list_of_16_bit_service_uuids< bluetoe::service_uuid16< 0x1234 > >,
+    bluetoe::peripheral_connection_interval_range< 0x0102, 0x203 >
+>;
+
+BOOST_FIXTURE_TEST_CASE( all_ad_types_in_legacy_payload, all_ads_server )
+{
+    expected_advertising( {
+        0x02, 0x01, 0x06,
+        0x03, 0x19, 0x43, 0x14,
+        0x0a, 0x09, 'T', 'e', 's', 't', ' ', 'N', 'a', 'm', 'e',
+        0x03, 0x03, 0x34, 0x12,
+        0x05, 0x12, 0x02, 0x01, 0x03, 0x02,
+        0x00, 0x00
+    }, *this );
+}
+
+BOOST_FIXTURE_TEST_CASE( same_as_runtime_generated_data, all_ads_server )
+{
+    std::uint8_t compile_time[ 31 ];
+    std::uint8_t runtime[ 32 ];
+
+    const std::size_t compile_time_size = advertising_data( compile_time, sizeof( compile_time ) );
+    const std::size_t runtime_size      = advertising_data( runtime, sizeof( runtime ) );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( &compile_time[ 0 ], &compile_time[ compile_time_size ], &runtime[ 0 ], &runtime[ runtime_size ] );
+}
+
+template < class Server, std::size_t Space = 0 >
+struct compare_static_with_runtime_data
+{
+    static void check( const Server& server )
+    {
+        using static_data = typename Server::template static_advertising_data< Space >;
+
+        std::uint8_t runtime[ Space + 1 ];
+        const std::size_t runtime_size = server.runtime_advertising_data( runtime, Space );
+
+        BOOST_TEST_CONTEXT( "Space: " << Space )
+        {
+            BOOST_CHECK_EQUAL_COLLECTIONS(
+                &static_data::values[ 0 ], &static_data::values[ static_data::size ],
+                &runtime[ 0 ], &runtime[ runtime_size ] );
+        }
+
+        compare_static_with_runtime_data< Server, Space + 1 >::check( server );
+    }
+};
+
+template < class Server >
+struct compare_static_with_runtime_data< Server, bluetoe::details::legacy_advertising_data_size + 1 >
+{
+    static void check( const Server& ) {}
+};
+
+static constexpr char long_name[] = "A very long name, that does not fit";
+
+using long_name_server = bluetoe::extend_server<
+    test::small_temperature_service,
+    bluetoe::server_name< long_name >
+>;
+
+BOOST_FIXTURE_TEST_CASE( shortened_name_in_legacy_payload, long_name_server )
+{
+    expected_advertising( {
+        0x02, 0x01, 0x06,
+        0x1b, 0x08,
+        'A', ' ', 'v', 'e', 'r', 'y', ' ', 'l', 'o', 'n', 'g', ' ', 'n', 'a', 'm', 'e', ',', ' ',
+        't', 'h', 'a', 't', ' ', 'd', 'o', 'e'
+    }, *this );
+}
+
+BOOST_FIXTURE_TEST_CASE( same_as_runtime_generated_data_for_every_size, all_ads_server )
+{
+    compare_static_with_runtime_data< all_ads_server >::check( *this );
+}
+
+BOOST_FIXTURE_TEST_CASE( shortened_name_same_as_runtime_generated_data_for_every_size, long_name_server )
+{
+    compare_static_with_runtime_data< long_name_server >::check( *this );
+}
+
+template < class Server >
+void compare_served_with_runtime_data( const Server& server )
+{
+    for ( std::size_t space = 0; space != 255; ++space )
+    {
+        std::uint8_t served[ 255 ];
+        std::uint8_t runtime[ 255 ];
+
+        const std::size_t served_size  = server.advertising_data( served, space );
+        const std::size_t runtime_size = server.runtime_advertising_data( runtime, space );
+
+        BOOST_TEST_CONTEXT( "Space: " << space )
+        {
+            BOOST_CHECK_EQUAL_COLLECTIONS( &served[ 0 ], &served[ served_size ], &runtime[ 0 ], &runtime[ runtime_size ] );
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE( every_buffer_size_served_from_compile_time_data, all_ads_server )
+{
+    compare_served_with_runtime_data( *this );
+}
+
+BOOST_FIXTURE_TEST_CASE( every_buffer_size_served_from_compile_time_data_with_long_name, long_name_server )
+{
+    compare_served_with_runtime_data( *this );
+}
+
+// a name, that is not a constant expression, must still be usable (examples/gpio.cpp does so)
+static const char runtime_name[] = "Test Name";
+
+using runtime_name_server = bluetoe::extend_server<
+    test::small_temperature_service,
+    bluetoe::server_name< runtime_name >
+>;
+
+BOOST_FIXTURE_TEST_CASE( non_constant_name, runtime_name_server )
+{
+    expected_advertising( {
+        0x02, 0x01, 0x06,
+        0x0a, 0x09, 'T', 'e', 's', 't', ' ', 'N', 'a', 'm', 'e',
+        0x00, 0x00
+    }, *this );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
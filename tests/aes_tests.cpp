@@ -0,0 +1,103 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <bluetoe/aes.hpp>
+
+#include <array>
+#include <vector>
+
+namespace {
+    using block = std::array< std::uint8_t, 16 >;
+
+    const block cmac_key = {{
+        0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+        0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+    }};
+
+    // RFC 4493, section 4
+    const std::vector< std::uint8_t > cmac_message = {
+        0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+        0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+        0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+        0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+    };
+
+    block cmac( std::size_t message_size, std::size_t chunk_size )
+    {
+        bluetoe::details::aes_cmac mac( cmac_key.data() );
+
+        for ( std::size_t pos = 0; pos < message_size; pos += chunk_size )
+            mac.update( &cmac_message[ pos ], std::min( chunk_size, message_size - pos ) );
+
+        block result;
+        mac.finalize( result.data() );
+
+        return result;
+    }
+}
+
+BOOST_AUTO_TEST_CASE( fips_197_example_vector )
+{
+    const block key   = {{ 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f }};
+    const block plain = {{ 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff }};
+    const block expected = {{ 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a }};
+
+    block cipher;
+    bluetoe::details::aes128_encrypt( key.data(), plain.data(), cipher.data() );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( cipher.begin(), cipher.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( encryption_in_place )
+{
+    const block key   = {{ 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f }};
+    block data        = {{ 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff }};
+    const block expected = {{ 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a }};
+
+    bluetoe::details::aes128_encrypt( key.data(), data.data(), data.data() );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( data.begin(), data.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( cmac_empty_message )
+{
+    const block expected = {{ 0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28, 0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46 }};
+    const block mac = cmac( 0, 1 );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( mac.begin(), mac.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( cmac_one_block )
+{
+    const block expected = {{ 0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44, 0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c }};
+    const block mac = cmac( 16, 16 );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( mac.begin(), mac.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( cmac_incomplete_last_block )
+{
+    const block expected = {{ 0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30, 0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27 }};
+    const block mac = cmac( 40, 40 );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( mac.begin(), mac.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( cmac_four_blocks )
+{
+    const block expected = {{ 0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92, 0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe }};
+    const block mac = cmac( 64, 64 );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( mac.begin(), mac.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( cmac_message_in_pieces )
+{
+    const block expected = {{ 0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30, 0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27 }};
+
+    for ( std::size_t chunk = 1; chunk != 41; ++chunk )
+    {
+        const block mac = cmac( 40, chunk );
+        BOOST_CHECK_EQUAL_COLLECTIONS( mac.begin(), mac.end(), expected.begin(), expected.end() );
+    }
+}
@@ -344,6 +344,175 @@ BOOST_AUTO_TEST_SUITE( access_client_characteristic_configuration )
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE( multiple_handle_value_notifications )
+
+    std::uint8_t value_a1 = 1;
+    std::uint8_t value_a2 = 2;
+    std::uint8_t value_b1 = 3;
+    std::uint8_t value_c1 = 4;
+    std::uint8_t value_c2 = 5;
+
+    template < typename ... Options >
+    using server_with_multiple_char = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x8C8B >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8B >,
+                bluetoe::bind_characteristic_value< std::uint8_t, &value_a1 >,
+                bluetoe::notify
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8C >,
+                bluetoe::bind_characteristic_value< std::uint8_t, &value_a2 >,
+                bluetoe::notify
+            >
+        >,
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x8C8C >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8D >,
+                bluetoe::bind_characteristic_value< std::uint8_t, &value_b1 >,
+                bluetoe::notify
+            >
+        >,
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x8C8D >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8E >,
+                bluetoe::bind_characteristic_value< std::uint8_t, &value_c1 >,
+                bluetoe::notify
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8F >,
+                bluetoe::bind_characteristic_value< std::uint8_t, &value_c2 >,
+                bluetoe::notify
+            >
+        >,
+        Options...
+    >;
+
+    template < typename Server >
+    struct all_enabled : test::request_with_reponse< Server >
+    {
+        all_enabled()
+        {
+            for ( const std::uint8_t cccd_handle : { 0x04, 0x07, 0x0B, 0x0F, 0x12 } )
+            {
+                this->l2cap_input( { 0x12, cccd_handle, 0x00, 0x01, 0x00 } );
+                this->expected_result( { 0x13 } );
+            }
+        }
+    };
+
+    using batching_server = all_enabled< server_with_multiple_char< bluetoe::multiple_handle_value_notifications > >;
+
+    BOOST_FIXTURE_TEST_CASE( single_notifications_without_client_support, batching_server )
+    {
+        connection.queue_notification( 0 );
+        connection.queue_notification( 2 );
+
+        expected_output( value_a1, { 0x1B, 0x03, 0x00, 0x01 } );
+        expected_output( value_b1, { 0x1B, 0x0A, 0x00, 0x03 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( single_notifications_without_server_support, all_enabled< server_with_multiple_char<> > )
+    {
+        connection.client_supported_features( bluetoe::details::client_supported_features_multiple_handle_value_notifications );
+        BOOST_CHECK( !connection.client_supports_multiple_handle_value_notifications() );
+
+        connection.queue_notification( 0 );
+        connection.queue_notification( 2 );
+
+        expected_output( value_a1, { 0x1B, 0x03, 0x00, 0x01 } );
+        expected_output( value_b1, { 0x1B, 0x0A, 0x00, 0x03 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( single_pending_notification, batching_server )
+    {
+        connection.client_supported_features( bluetoe::details::client_supported_features_multiple_handle_value_notifications );
+        connection.queue_notification( 3 );
+
+        expected_output( value_c1, { 0x1B, 0x0E, 0x00, 0x04 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( pending_notifications_combined, batching_server )
+    {
+        connection.client_supported_features( bluetoe::details::client_supported_features_multiple_handle_value_notifications );
+        connection.queue_notification( 0 );
+        connection.queue_notification( 2 );
+        connection.queue_notification( 3 );
+
+        expected_output( value_a1, {
+            0x23,
+            0x03, 0x00, 0x01, 0x00, 0x01,
+            0x0A, 0x00, 0x01, 0x00, 0x03,
+            0x0E, 0x00, 0x01, 0x00, 0x04
+        } );
+        expected_output( value_a1, {} );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( remaining_notifications_in_next_pdu, batching_server )
+    {
+        connection.client_supported_features( bluetoe::details::client_supported_features_multiple_handle_value_notifications );
+
+        for ( std::size_t index = 0; index != 5; ++index )
+            connection.queue_notification( index );
+
+        // 1 + 4 * 5 octets, fifth tuple would exceed the MTU of 23
+        expected_output( value_a1, {
+            0x23,
+            0x03, 0x00, 0x01, 0x00, 0x01,
+            0x06, 0x00, 0x01, 0x00, 0x02,
+            0x0A, 0x00, 0x01, 0x00, 0x03,
+            0x0E, 0x00, 0x01, 0x00, 0x04
+        } );
+        expected_output( value_c2, { 0x1B, 0x11, 0x00, 0x05 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( not_subscribed_characteristics_are_skipped, test::request_with_reponse< server_with_multiple_char< bluetoe::multiple_handle_value_notifications > > )
+    {
+        l2cap_input( { 0x12, 0x04, 0x00, 0x01, 0x00 } );
+        expected_result( { 0x13 } );
+        l2cap_input( { 0x12, 0x12, 0x00, 0x01, 0x00 } );
+        expected_result( { 0x13 } );
+
+        connection.client_supported_features( bluetoe::details::client_supported_features_multiple_handle_value_notifications );
+
+        for ( std::size_t index = 0; index != 5; ++index )
+            connection.queue_notification( index );
+
+        expected_output( value_a1, {
+            0x23,
+            0x03, 0x00, 0x01, 0x00, 0x01,
+            0x11, 0x00, 0x01, 0x00, 0x05
+        } );
+    }
+
+    using prioritized_batching_server = all_enabled< server_with_multiple_char<
+        bluetoe::multiple_handle_value_notifications,
+        bluetoe::higher_outgoing_priority< bluetoe::service_uuid16< 0x8C8D > >
+    > >;
+
+    BOOST_FIXTURE_TEST_CASE( priorities_are_honored, prioritized_batching_server )
+    {
+        connection.client_supported_features( bluetoe::details::client_supported_features_multiple_handle_value_notifications );
+
+        // index 0 and 1 are now the characteristics of the service with the higher priority
+        for ( std::size_t index = 0; index != 5; ++index )
+            connection.queue_notification( index );
+
+        expected_output( value_c1, {
+            0x23,
+            0x0E, 0x00, 0x01, 0x00, 0x04,
+            0x11, 0x00, 0x01, 0x00, 0x05,
+            0x03, 0x00, 0x01, 0x00, 0x01,
+            0x06, 0x00, 0x01, 0x00, 0x02
+        } );
+        expected_output( value_b1, { 0x1B, 0x0A, 0x00, 0x03 } );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE( checking_proper_configuration )
 
     struct handler
@@ -239,3 +239,72 @@ BOOST_FIXTURE_TEST_CASE( should_find_the_device_name_characteristic, test::reque
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( read_by_type_early_termination )
+
+static std::size_t number_of_reads = 0;
+
+static std::uint8_t counting_read( std::size_t read_size, std::uint8_t* out_buffer, std::size_t& out_size )
+{
+    ++number_of_reads;
+
+    static const std::uint8_t value[] = { 0x01, 0x02, 0x03, 0x04 };
+    out_size = std::min( read_size, sizeof( value ) );
+    std::copy( std::begin( value ), std::begin( value ) + out_size, out_buffer );
+
+    return bluetoe::error_codes::success;
+}
+
+template < std::uint16_t UUID >
+using counted_characteristic = bluetoe::characteristic<
+    bluetoe::characteristic_uuid16< UUID >,
+    bluetoe::free_read_handler< counting_read >
+>;
+
+using service_with_many_characteristics = bluetoe::server<
+    bluetoe::service<
+        bluetoe::service_uuid16< 0x8C8B >,
+        counted_characteristic< 0x1234 >,
+        counted_characteristic< 0x1234 >,
+        counted_characteristic< 0x1234 >,
+        counted_characteristic< 0x1234 >,
+        counted_characteristic< 0x1234 >,
+        counted_characteristic< 0x1234 >,
+        counted_characteristic< 0x1234 >,
+        counted_characteristic< 0x1234 >
+    >
+>;
+
+struct many_characteristics : test::request_with_reponse< service_with_many_characteristics >
+{
+    many_characteristics()
+    {
+        number_of_reads = 0;
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE( stop_reading_once_the_response_is_full, many_characteristics )
+{
+    l2cap_input( { 0x08, 0x01, 0x00, 0xff, 0xff, 0x34, 0x12 } );
+
+    expected_result( {
+        0x09, 0x06,
+        0x03, 0x00, 0x01, 0x02, 0x03, 0x04,
+        0x05, 0x00, 0x01, 0x02, 0x03, 0x04,
+        0x07, 0x00, 0x01, 0x02, 0x03, 0x04
+    } );
+
+    // 3 * 6 octets fit into the MTU of 23; there is no need to read the remaining 5 values
+    BOOST_CHECK_EQUAL( number_of_reads, 3u );
+}
+
+BOOST_FIXTURE_TEST_CASE( attributes_of_other_types_are_not_read, many_characteristics )
+{
+    l2cap_input( { 0x08, 0x01, 0x00, 0xff, 0xff, 0x03, 0x28 } );
+    BOOST_REQUIRE( response_size > 0 );
+    BOOST_CHECK_EQUAL( response[ 0 ], 0x09 );
+
+    BOOST_CHECK_EQUAL( number_of_reads, 0u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,114 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_servers.hpp"
+
+namespace {
+    char short_name[] = "Hello";
+    char long_name[]  = "abcdefghijklmnopqrstuvwxyz";
+
+    const std::uint8_t blob[] = { 0x01, 0x02, 0x03 };
+
+    using server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x8C8B >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8B >,
+                bluetoe::cstring_value< short_name >
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8C >,
+                bluetoe::fixed_blob_value< blob, sizeof( blob ) >
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8D >,
+                bluetoe::cstring_value< long_name >
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8E >,
+                bluetoe::bind_characteristic_value< decltype( test::temperature_value ), &test::temperature_value >,
+                bluetoe::no_read_access
+            >
+        >
+    >;
+
+    using fixture = test::request_with_reponse< server >;
+}
+
+BOOST_AUTO_TEST_SUITE( read_multiple_variable_length_errors )
+
+    BOOST_FIXTURE_TEST_CASE( pdu_to_small, fixture )
+    {
+        BOOST_CHECK( check_error_response( { 0x20, 0x03, 0x00 }, 0x20, 0x0000, 0x04 ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( pdu_half_an_handle, fixture )
+    {
+        BOOST_CHECK( check_error_response( { 0x20, 0x03, 0x00, 0x05, 0x00, 0x07 }, 0x20, 0x0000, 0x04 ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( invalid_handle, fixture )
+    {
+        BOOST_CHECK( check_error_response( { 0x20, 0x03, 0x00, 0x00, 0x00 }, 0x20, 0x0000, 0x01 ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( unknown_handle, fixture )
+    {
+        BOOST_CHECK( check_error_response( { 0x20, 0x03, 0x00, 0xf4, 0xff }, 0x20, 0xfff4, 0x01 ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( attribute_not_readable, fixture )
+    {
+        BOOST_CHECK( check_error_response( { 0x20, 0x09, 0x00, 0x03, 0x00 }, 0x20, 0x0009, 0x02 ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( attribute_not_readable_after_truncation, fixture )
+    {
+        BOOST_CHECK( check_error_response( { 0x20, 0x07, 0x00, 0x03, 0x00, 0x09, 0x00 }, 0x20, 0x0009, 0x02 ) );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( read_multiple_variable_length )
+
+    BOOST_FIXTURE_TEST_CASE( read_two_values, fixture )
+    {
+        l2cap_input( { 0x20, 0x03, 0x00, 0x05, 0x00 } );
+        expected_result( {
+            0x21,
+            0x05, 0x00, 'H', 'e', 'l', 'l', 'o',
+            0x03, 0x00, 0x01, 0x02, 0x03
+        } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( order_of_the_request_is_kept, fixture )
+    {
+        l2cap_input( { 0x20, 0x05, 0x00, 0x03, 0x00 } );
+        expected_result( {
+            0x21,
+            0x03, 0x00, 0x01, 0x02, 0x03,
+            0x05, 0x00, 'H', 'e', 'l', 'l', 'o'
+        } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( last_value_clipped_at_mtu, fixture )
+    {
+        l2cap_input( { 0x20, 0x03, 0x00, 0x07, 0x00 } );
+        expected_result( {
+            0x21,
+            0x05, 0x00, 'H', 'e', 'l', 'l', 'o',
+            0x0D, 0x00, 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm'
+        } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( no_room_for_further_values, fixture )
+    {
+        l2cap_input( { 0x20, 0x07, 0x00, 0x03, 0x00 } );
+        expected_result( {
+            0x21,
+            0x14, 0x00, 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j',
+                        'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't'
+        } );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -896,3 +896,102 @@ BOOST_FIXTURE_TEST_SUITE( mapping_server_with_additional_descriptors, fixture< s
 
 
 BOOST_AUTO_TEST_SUITE_END()
+
+using server_with_small_gap = bluetoe::server<
+    bluetoe::no_gap_service_for_gatt_servers,
+    bluetoe::service<
+        bluetoe::service_uuid16< 0x0815 >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid16< 0x0816 >,
+            bluetoe::fixed_uint8_value< 0x42 >
+        >,
+        bluetoe::characteristic<
+            bluetoe::attribute_handle< 0x0006 >,
+            bluetoe::characteristic_uuid16< 0x0817 >,
+            bluetoe::fixed_uint8_value< 0x43 >
+        >
+    >
+>;
+
+BOOST_AUTO_TEST_SUITE( mapping_strategies )
+
+    template < typename Server >
+    using mapping_t = typename bluetoe::details::handle_index_mapping< Server >::mapping;
+
+    template < typename Server >
+    using iterator_t = typename bluetoe::details::handle_index_mapping< Server >::iterator;
+
+    BOOST_AUTO_TEST_CASE( without_fixed_handles_no_table_is_used )
+    {
+        using server = server_with_single_not_fixed_service;
+
+        BOOST_CHECK( ( std::is_same<
+            mapping_t< server >,
+            bluetoe::details::contiguous_handle_mapping< iterator_t< server >, 3, 1 > >::value ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( fixed_handles_without_gaps_need_no_table )
+    {
+        using server = server_with_single_fixed_service;
+
+        BOOST_CHECK( ( std::is_same<
+            mapping_t< server >,
+            bluetoe::details::contiguous_handle_mapping< iterator_t< server >, 3, 0x100 > >::value ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( small_gaps_use_direct_mapping )
+    {
+        using server = server_with_small_gap;
+
+        BOOST_CHECK( ( std::is_same<
+            mapping_t< server >,
+            bluetoe::details::direct_handle_mapping< iterator_t< server >, 5, 7 > >::value ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( large_gaps_use_binary_search )
+    {
+        using server = server_with_multiple_fixed_services;
+
+        BOOST_CHECK( ( std::is_same<
+            mapping_t< server >,
+            bluetoe::details::binary_search_handle_mapping< iterator_t< server >, 11 > >::value ) );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_FIXTURE_TEST_SUITE( mapping_with_small_gap, fixture< server_with_small_gap > )
+
+    BOOST_AUTO_TEST_CASE( all_handles )
+    {
+        BOOST_CHECK_EQUAL( handle_by_index( 0 ), 1u );
+        BOOST_CHECK_EQUAL( handle_by_index( 1 ), 2u );
+        BOOST_CHECK_EQUAL( handle_by_index( 2 ), 3u );
+        BOOST_CHECK_EQUAL( handle_by_index( 3 ), 6u );
+        BOOST_CHECK_EQUAL( handle_by_index( 4 ), 7u );
+        BOOST_CHECK_EQUAL( handle_by_index( 5 ), bluetoe::details::invalid_attribute_handle );
+    }
+
+    BOOST_AUTO_TEST_CASE( handle_to_first_index )
+    {
+        BOOST_CHECK_EQUAL( first_index_by_handle( 0x00 ), 0u );
+        BOOST_CHECK_EQUAL( first_index_by_handle( 0x01 ), 0u );
+        BOOST_CHECK_EQUAL( first_index_by_handle( 0x03 ), 2u );
+        BOOST_CHECK_EQUAL( first_index_by_handle( 0x04 ), 3u );
+        BOOST_CHECK_EQUAL( first_index_by_handle( 0x05 ), 3u );
+        BOOST_CHECK_EQUAL( first_index_by_handle( 0x06 ), 3u );
+        BOOST_CHECK_EQUAL( first_index_by_handle( 0x07 ), 4u );
+        BOOST_CHECK_EQUAL( first_index_by_handle( 0x08 ), bluetoe::details::invalid_attribute_index );
+        BOOST_CHECK_EQUAL( first_index_by_handle( 0xffff ), bluetoe::details::invalid_attribute_index );
+    }
+
+    BOOST_AUTO_TEST_CASE( handle_to_index )
+    {
+        BOOST_CHECK_EQUAL( index_by_handle( 0x03 ), 2u );
+        BOOST_CHECK_EQUAL( index_by_handle( 0x04 ), bluetoe::details::invalid_attribute_index );
+        BOOST_CHECK_EQUAL( index_by_handle( 0x05 ), bluetoe::details::invalid_attribute_index );
+        BOOST_CHECK_EQUAL( index_by_handle( 0x06 ), 3u );
+        BOOST_CHECK_EQUAL( index_by_handle( 0x07 ), 4u );
+        BOOST_CHECK_EQUAL( index_by_handle( 0x08 ), bluetoe::details::invalid_attribute_index );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
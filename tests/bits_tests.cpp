@@ -42,3 +42,11 @@ BOOST_AUTO_TEST_CASE( negative_distance_n )
     BOOST_TEST( ( bluetoe::details::distance_n< 24u, std::uint32_t >( 0x7a, 0xffffff ) ) == -0x7b );
     BOOST_TEST( ( bluetoe::details::distance_n< 24u, std::uint32_t >( 0x0, 0x800001 ) ) == -0x7fffff );
 }
+
+BOOST_AUTO_TEST_CASE( count_trailing_zeros )
+{
+    BOOST_TEST( bluetoe::details::count_trailing_zeros( 1u ) == 0u );
+    BOOST_TEST( bluetoe::details::count_trailing_zeros( 0x18u ) == 3u );
+    BOOST_TEST( bluetoe::details::count_trailing_zeros( 0x80000000u ) == 31u );
+    BOOST_TEST( bluetoe::details::count_trailing_zeros( 0xffffffffu ) == 0u );
+}
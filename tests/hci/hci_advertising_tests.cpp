@@ -5,6 +5,7 @@
 #include <bluetoe/service.hpp>
 #include <bluetoe/characteristic.hpp>
 #include <bluetoe/link_layer.hpp>
+#include <bluetoe/user_channel_transport.hpp>
 #include "transport.hpp"
 
 std::uint16_t value = 0x0815;
@@ -21,7 +22,130 @@ using simple_gatt_server = bluetoe::server<
 
 using link_layer = bluetoe::hci::link_layer< simple_gatt_server, test::transport >;
 
+BOOST_FIXTURE_TEST_CASE( starts_with_a_reset, link_layer )
+{
+    run();
+
+    const auto commands = controller_received();
+    BOOST_REQUIRE_EQUAL( commands.size(), 1u );
+    BOOST_CHECK( commands[ 0 ] == test::hci_packet( { 0x01, 0x03, 0x0C, 0x00 } ) );
+
+    // no further command without command complete event
+    run();
+    BOOST_CHECK( controller_received().empty() );
+}
+
+BOOST_FIXTURE_TEST_CASE( unsolicited_command_complete_does_not_advance_the_setup, link_layer )
+{
+    run();
+    BOOST_REQUIRE_EQUAL( test::command_opcode( controller_received().at( 0 ) ), 0x0C03 );
+
+    // NOP Command Complete, as sent by many controllers after power up
+    controller_send( test::command_complete( 0x0000, {} ) );
+    run();
+    BOOST_CHECK( controller_received().empty() );
+
+    controller_send( test::command_complete( 0x0C03 ) );
+    run();
+
+    const auto commands = controller_received();
+    BOOST_REQUIRE_EQUAL( commands.size(), 1u );
+    BOOST_CHECK_EQUAL( test::command_opcode( commands[ 0 ] ), 0x0C01 );
+
+    // a Command Complete of an other command, while Set Event Mask is outstanding
+    controller_send( test::command_complete( 0x2002, { 0x00, 0x1b, 0x00, 0x04 } ) );
+    run();
+    BOOST_CHECK( controller_received().empty() );
+}
+
+BOOST_FIXTURE_TEST_CASE( setup_waits_for_command_credits, link_layer )
+{
+    run();
+    controller_received();
+
+    // Reset completed, but the controller does not accept further commands yet
+    controller_send( { 0x04, 0x0E, 0x04, 0x00, 0x03, 0x0C, 0x00 } );
+    run();
+    BOOST_CHECK( controller_received().empty() );
+
+    // NOP Command Complete grants a credit
+    controller_send( test::command_complete( 0x0000, {} ) );
+    run();
+
+    const auto commands = controller_received();
+    BOOST_REQUIRE_EQUAL( commands.size(), 1u );
+    BOOST_CHECK_EQUAL( test::command_opcode( commands[ 0 ] ), 0x0C01 );
+}
+
 BOOST_FIXTURE_TEST_CASE( starts_advertising, link_layer )
 {
+    const auto commands = test::complete_setup( *this );
+
+    std::vector< std::uint16_t > opcodes;
+    for ( const auto& command : commands )
+        opcodes.push_back( test::command_opcode( command ) );
+
+    const std::vector< std::uint16_t > expected = { 0x0C03, 0x0C01, 0x2002, 0x1009, 0x0C33, 0x0C31, 0x2006, 0x2008, 0x2009, 0x200A };
+    BOOST_CHECK_EQUAL_COLLECTIONS( opcodes.begin(), opcodes.end(), expected.begin(), expected.end() );
+
+    // connectable undirected advertising on all channels
+    const auto& parameters = commands[ 6 ];
+    BOOST_REQUIRE_EQUAL( parameters.size(), 4u + 15u );
+    BOOST_CHECK_EQUAL( parameters[ 8 ], 0x00 );
+    BOOST_CHECK_EQUAL( parameters[ 17 ], 0x07 );
+
+    // advertising data from the server
+    std::uint8_t advertising[ 31 ];
+    const std::size_t advertising_size = advertising_data( advertising, sizeof( advertising ) );
+
+    const auto& data = commands[ 7 ];
+    BOOST_REQUIRE_EQUAL( data.size(), 4u + 32u );
+    BOOST_CHECK_EQUAL( data[ 4 ], advertising_size );
+    BOOST_CHECK_EQUAL_COLLECTIONS( &data[ 5 ], &data[ 5 + advertising_size ], &advertising[ 0 ], &advertising[ advertising_size ] );
+
+    BOOST_CHECK( commands[ 9 ] == test::hci_packet( { 0x01, 0x0A, 0x20, 0x01, 0x01 } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( enables_host_flow_control, link_layer )
+{
+    const auto commands = test::complete_setup( *this );
+
+    // 1021 bytes ACL data, no synchronous data, 2 ACL data packets
+    BOOST_CHECK( commands[ 4 ] == test::hci_packet( { 0x01, 0x33, 0x0C, 0x07, 0xfd, 0x03, 0x00, 0x02, 0x00, 0x00, 0x00 } ) );
+    BOOST_CHECK( commands[ 5 ] == test::hci_packet( { 0x01, 0x31, 0x0C, 0x01, 0x01 } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( local_address_is_read_from_the_controller, link_layer )
+{
+    test::complete_setup( *this );
+
+    BOOST_CHECK_EQUAL( local_address(), bluetoe::link_layer::public_device_address( { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( falls_back_to_shared_buffers, link_layer )
+{
+    for ( std::uint16_t opcode : { 0x0C03, 0x0C01 } )
+    {
+        run();
+        BOOST_REQUIRE_EQUAL( test::command_opcode( controller_received().at( 0 ) ), opcode );
+        controller_send( test::command_complete( opcode ) );
+    }
+
+    run();
+    BOOST_REQUIRE_EQUAL( test::command_opcode( controller_received().at( 0 ) ), 0x2002 );
+    controller_send( test::command_complete( 0x2002, { 0x00, 0x00, 0x00, 0x00 } ) );
+
+    run();
+    BOOST_REQUIRE_EQUAL( test::command_opcode( controller_received().at( 0 ) ), 0x1005 );
+    controller_send( test::command_complete( 0x1005, { 0x00, 0xfd, 0x03, 0x40, 0x08, 0x00, 0x01, 0x00 } ) );
+
+    run();
+    BOOST_CHECK_EQUAL( test::command_opcode( controller_received().at( 0 ) ), 0x1009 );
+}
+
+BOOST_AUTO_TEST_CASE( user_channel_of_unknown_controller_can_not_be_opened )
+{
+    bluetoe::hci::link_layer< simple_gatt_server, bluetoe::hci::user_channel_transport > link_layer;
 
-}
\ No newline at end of file
+    BOOST_CHECK( !link_layer.open( 0xfffe ) );
+}
@@ -0,0 +1,385 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <bluetoe/server.hpp>
+#include <bluetoe/service.hpp>
+#include <bluetoe/characteristic.hpp>
+#include <bluetoe/link_layer.hpp>
+#include "transport.hpp"
+
+#include <numeric>
+#include <algorithm>
+
+namespace {
+
+    std::uint16_t value = 0x0815;
+    std::uint8_t  large_value[ 100 ];
+
+    using gatt_server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x4766 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x2021 >,
+                bluetoe::bind_characteristic_value< std::uint16_t, &value >
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x2022 >,
+                bluetoe::bind_characteristic_value< decltype( large_value ), &large_value >
+            >
+        >,
+        bluetoe::max_mtu_size< 100 >
+    >;
+
+    const std::uint16_t handle = 0x0042;
+
+    test::hci_packet l2cap_packet( std::uint16_t channel, const std::vector< std::uint8_t >& sdu )
+    {
+        const std::size_t size = sdu.size() + 4;
+        test::hci_packet acl = {
+            0x02, handle & 0xff, ( handle >> 8 ) | 0x20,
+            static_cast< std::uint8_t >( size & 0xff ), static_cast< std::uint8_t >( size >> 8 ),
+            static_cast< std::uint8_t >( sdu.size() & 0xff ), static_cast< std::uint8_t >( sdu.size() >> 8 ),
+            static_cast< std::uint8_t >( channel & 0xff ), static_cast< std::uint8_t >( channel >> 8 ) };
+
+        acl.insert( acl.end(), sdu.begin(), sdu.end() );
+
+        return acl;
+    }
+
+    struct connected_link_layer : bluetoe::hci::link_layer< gatt_server, test::transport >
+    {
+        explicit connected_link_layer( std::uint16_t acl_size = 27, std::uint8_t acl_packets = 4 )
+            : reported_packets( 0 )
+        {
+            std::iota( std::begin( large_value ), std::end( large_value ), 0 );
+
+            test::complete_setup( *this, acl_size, acl_packets );
+
+            // LE Connection Complete
+            controller_send( {
+                0x04, 0x3E, 0x13, 0x01, 0x00, handle & 0xff, handle >> 8, 0x01, 0x00,
+                0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x18, 0x00, 0x00, 0x00, 0xc8, 0x00, 0x00 } );
+            run();
+        }
+
+        void l2cap_send( std::uint16_t channel, const std::vector< std::uint8_t >& sdu )
+        {
+            controller_send( l2cap_packet( channel, sdu ) );
+            run();
+        }
+
+        void completed_packets( std::uint16_t count )
+        {
+            controller_send( { 0x04, 0x13, 0x05, 0x01, handle & 0xff, handle >> 8,
+                static_cast< std::uint8_t >( count & 0xff ), static_cast< std::uint8_t >( count >> 8 ) } );
+            run();
+        }
+
+        std::vector< test::hci_packet > acl_packets()
+        {
+            std::vector< test::hci_packet > result;
+
+            for ( const auto& packet : controller_received() )
+            {
+                if ( packet[ 0 ] == 0x02 )
+                    result.push_back( packet );
+
+                // Host Number Of Completed Packets
+                if ( test::command_opcode( packet ) == 0x0C35 && packet.size() == 9u && packet[ 4 ] == 1 )
+                {
+                    BOOST_CHECK_EQUAL( packet[ 5 ] | ( packet[ 6 ] << 8 ), handle );
+                    reported_packets += packet[ 7 ] | ( packet[ 8 ] << 8 );
+                }
+            }
+
+            return result;
+        }
+
+        // number of ACL data packets, reported to the controller as completed
+        unsigned reported_packets;
+
+        // reassembles the payload of all given ACL packets
+        static std::vector< std::uint8_t > payload( const std::vector< test::hci_packet >& packets )
+        {
+            std::vector< std::uint8_t > result;
+
+            for ( const auto& packet : packets )
+                result.insert( result.end(), packet.begin() + 5, packet.end() );
+
+            return result;
+        }
+    };
+
+    struct small_controller_buffers : connected_link_layer
+    {
+        small_controller_buffers() : connected_link_layer( 27, 2 ) {}
+    };
+
+    struct single_controller_buffer : connected_link_layer
+    {
+        single_controller_buffer() : connected_link_layer( 27, 1 ) {}
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( connection_is_established, connected_link_layer )
+{
+    BOOST_CHECK( connected() );
+}
+
+BOOST_FIXTURE_TEST_CASE( read_request_is_answered, connected_link_layer )
+{
+    l2cap_send( 0x0004, { 0x0A, 0x03, 0x00 } );
+
+    const auto packets = acl_packets();
+    BOOST_REQUIRE_EQUAL( packets.size(), 1u );
+
+    const test::hci_packet expected = {
+        0x02, 0x42, 0x00, 0x07, 0x00,   // first fragment, 7 bytes
+        0x03, 0x00, 0x04, 0x00,         // ATT channel, 3 bytes
+        0x0B, 0x15, 0x08 };
+
+    BOOST_CHECK( packets[ 0 ] == expected );
+}
+
+BOOST_FIXTURE_TEST_CASE( fragmented_request_is_reassembled, connected_link_layer )
+{
+    // Read Request split into two ACL packets
+    controller_send( { 0x02, 0x42, 0x20, 0x05, 0x00, 0x03, 0x00, 0x04, 0x00, 0x0A } );
+    controller_send( { 0x02, 0x42, 0x10, 0x02, 0x00, 0x03, 0x00 } );
+    run();
+
+    const auto packets = acl_packets();
+    BOOST_REQUIRE_EQUAL( packets.size(), 1u );
+    BOOST_CHECK_EQUAL( packets[ 0 ][ 9 ], 0x0B );
+}
+
+BOOST_FIXTURE_TEST_CASE( pairing_is_not_supported, connected_link_layer )
+{
+    l2cap_send( 0x0006, { 0x01, 0x03, 0x00, 0x01, 0x10, 0x07, 0x07 } );
+
+    const auto packets = acl_packets();
+    BOOST_REQUIRE_EQUAL( packets.size(), 1u );
+    BOOST_CHECK( packets[ 0 ] == test::hci_packet( { 0x02, 0x42, 0x00, 0x06, 0x00, 0x02, 0x00, 0x06, 0x00, 0x05, 0x05 } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( large_response_is_fragmented_in_a_batch, connected_link_layer )
+{
+    // MTU exchange, followed by a read of the large value
+    l2cap_send( 0x0004, { 0x02, 0x64, 0x00 } );
+    acl_packets();
+    completed_packets( 1 );
+
+    l2cap_send( 0x0004, { 0x0A, 0x05, 0x00 } );
+
+    const auto packets = acl_packets();
+    BOOST_REQUIRE_EQUAL( packets.size(), 4u );
+
+    for ( std::size_t i = 0; i != packets.size(); ++i )
+    {
+        BOOST_CHECK_EQUAL( packets[ i ][ 2 ], i == 0 ? 0x00 : 0x10 );
+        BOOST_CHECK_LE( packets[ i ].size(), 5u + 27u );
+    }
+
+    const auto sdu = payload( packets );
+    BOOST_REQUIRE_EQUAL( sdu.size(), 4u + 1u + 99u );
+    BOOST_CHECK_EQUAL( sdu[ 4 ], 0x0B );
+    BOOST_CHECK( std::equal( &large_value[ 0 ], &large_value[ 99 ], &sdu[ 5 ] ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( fragments_wait_for_completed_packets, small_controller_buffers )
+{
+    l2cap_send( 0x0004, { 0x02, 0x64, 0x00 } );
+    acl_packets();
+    completed_packets( 1 );
+
+    l2cap_send( 0x0004, { 0x0A, 0x05, 0x00 } );
+
+    // only two controller buffers
+    auto packets = acl_packets();
+    BOOST_CHECK_EQUAL( packets.size(), 2u );
+
+    completed_packets( 1 );
+    const auto third = acl_packets();
+    BOOST_CHECK_EQUAL( third.size(), 1u );
+    packets.insert( packets.end(), third.begin(), third.end() );
+
+    completed_packets( 2 );
+    const auto last = acl_packets();
+    BOOST_CHECK_EQUAL( last.size(), 1u );
+    packets.insert( packets.end(), last.begin(), last.end() );
+
+    BOOST_CHECK_EQUAL( payload( packets ).size(), 4u + 1u + 99u );
+}
+
+BOOST_FIXTURE_TEST_CASE( completed_packets_of_several_handles, small_controller_buffers )
+{
+    l2cap_send( 0x0004, { 0x02, 0x64, 0x00 } );
+    acl_packets();
+    completed_packets( 1 );
+
+    l2cap_send( 0x0004, { 0x0A, 0x05, 0x00 } );
+    BOOST_CHECK_EQUAL( acl_packets().size(), 2u );
+
+    // 5 packets of an other connection and 1 packet of this connection
+    controller_send( { 0x04, 0x13, 0x09, 0x02, 0x43, 0x00, 0x05, 0x00, handle & 0xff, handle >> 8, 0x01, 0x00 } );
+    run();
+
+    BOOST_CHECK_EQUAL( acl_packets().size(), 1u );
+}
+
+BOOST_FIXTURE_TEST_CASE( failed_transmit_keeps_fragments_and_controller_buffers, small_controller_buffers )
+{
+    fail_transmits( true );
+    l2cap_send( 0x0004, { 0x0A, 0x03, 0x00 } );
+    BOOST_CHECK( acl_packets().empty() );
+
+    fail_transmits( false );
+    run();
+
+    const auto packets = acl_packets();
+    BOOST_REQUIRE_EQUAL( packets.size(), 1u );
+    BOOST_CHECK_EQUAL( packets[ 0 ][ 9 ], 0x0B );
+
+    // the second controller buffer is still available
+    l2cap_send( 0x0004, { 0x0A, 0x03, 0x00 } );
+    BOOST_CHECK_EQUAL( acl_packets().size(), 1u );
+}
+
+BOOST_FIXTURE_TEST_CASE( partially_transmitted_batch_is_continued, connected_link_layer )
+{
+    l2cap_send( 0x0004, { 0x02, 0x64, 0x00 } );
+    acl_packets();
+    completed_packets( 1 );
+
+    // the transport takes the Host Number Of Completed Packets command and only the first 2 of the 4 fragments
+    accept_packets( 3 );
+    l2cap_send( 0x0004, { 0x0A, 0x05, 0x00 } );
+
+    auto packets = acl_packets();
+    BOOST_CHECK_EQUAL( packets.size(), 2u );
+
+    fail_transmits( false );
+    run();
+
+    // the remaining 2 fragments, without the already transmitted ones
+    const auto rest = acl_packets();
+    BOOST_CHECK_EQUAL( rest.size(), 2u );
+    packets.insert( packets.end(), rest.begin(), rest.end() );
+
+    const auto sdu = payload( packets );
+    BOOST_REQUIRE_EQUAL( sdu.size(), 4u + 1u + 99u );
+    BOOST_CHECK( std::equal( &large_value[ 0 ], &large_value[ 99 ], &sdu[ 5 ] ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( write_command_is_not_lost_while_output_is_blocked, single_controller_buffer )
+{
+    // the first response occupies the only controller buffer, the next 4 fill the output queue and the last one can not be handled
+    for ( int request = 0; request != 6; ++request )
+        controller_send( l2cap_packet( 0x0004, { 0x0A, 0x03, 0x00 } ) );
+
+    controller_send( l2cap_packet( 0x0004, { 0x52, 0x03, 0x00, 0x34, 0x12 } ) );
+    run();
+
+    BOOST_CHECK_EQUAL( acl_packets().size(), 1u );
+    BOOST_CHECK_EQUAL( value, 0x0815 );
+
+    for ( int response = 0; response != 5; ++response )
+    {
+        completed_packets( 1 );
+        BOOST_CHECK_EQUAL( acl_packets().size(), 1u );
+    }
+
+    BOOST_CHECK_EQUAL( value, 0x1234 );
+    value = 0x0815;
+}
+
+BOOST_FIXTURE_TEST_CASE( events_are_handled_while_acl_data_is_held, single_controller_buffer )
+{
+    // the first response occupies the only controller buffer, the next 4 fill the output queue, the next request is pending
+    for ( int request = 0; request != 6; ++request )
+        controller_send( l2cap_packet( 0x0004, { 0x0A, 0x03, 0x00 } ) );
+
+    // both slots for ACL data are used
+    controller_send( l2cap_packet( 0x0004, { 0x52, 0x03, 0x00, 0x34, 0x12 } ) );
+    controller_send( l2cap_packet( 0x0004, { 0x52, 0x03, 0x00, 0x78, 0x56 } ) );
+
+    // Number Of Completed Packets, that have to be received to get the held data handled
+    for ( int completed = 0; completed != 3; ++completed )
+        controller_send( { 0x04, 0x13, 0x05, 0x01, handle & 0xff, handle >> 8, 0x01, 0x00 } );
+
+    run();
+
+    BOOST_CHECK_EQUAL( acl_packets().size(), 4u );
+    BOOST_CHECK_EQUAL( value, 0x5678 );
+    value = 0x0815;
+}
+
+BOOST_FIXTURE_TEST_CASE( consumed_acl_data_is_reported_to_the_controller, connected_link_layer )
+{
+    l2cap_send( 0x0004, { 0x0A, 0x03, 0x00 } );
+
+    const auto commands = controller_received();
+    BOOST_CHECK( std::find( commands.begin(), commands.end(),
+        test::hci_packet( { 0x01, 0x35, 0x0C, 0x05, 0x01, 0x42, 0x00, 0x01, 0x00 } ) ) != commands.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( held_acl_data_is_reported_once_consumed, single_controller_buffer )
+{
+    // the first response occupies the only controller buffer, the next 4 fill the output queue, the next request is pending
+    for ( int request = 0; request != 6; ++request )
+        controller_send( l2cap_packet( 0x0004, { 0x0A, 0x03, 0x00 } ) );
+
+    // both slots for ACL data are used
+    controller_send( l2cap_packet( 0x0004, { 0x52, 0x03, 0x00, 0x34, 0x12 } ) );
+    controller_send( l2cap_packet( 0x0004, { 0x52, 0x03, 0x00, 0x78, 0x56 } ) );
+    run();
+
+    acl_packets();
+    BOOST_CHECK_EQUAL( reported_packets, 6u );
+
+    for ( int completed = 0; completed != 5; ++completed )
+    {
+        completed_packets( 1 );
+        acl_packets();
+    }
+
+    BOOST_CHECK_EQUAL( reported_packets, 8u );
+    BOOST_CHECK_EQUAL( value, 0x5678 );
+    value = 0x0815;
+}
+
+BOOST_FIXTURE_TEST_CASE( disconnect_sends_command, connected_link_layer )
+{
+    disconnect();
+    run();
+
+    const auto commands = controller_received();
+    BOOST_REQUIRE_EQUAL( commands.size(), 1u );
+    BOOST_CHECK( commands[ 0 ] == test::hci_packet( { 0x01, 0x06, 0x04, 0x03, 0x42, 0x00, 0x13 } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( advertising_restarts_after_disconnection, connected_link_layer )
+{
+    // Disconnection Complete
+    controller_send( { 0x04, 0x05, 0x04, 0x00, 0x42, 0x00, 0x13 } );
+    run();
+
+    BOOST_CHECK( !connected() );
+
+    const auto commands = controller_received();
+    BOOST_REQUIRE_EQUAL( commands.size(), 1u );
+    BOOST_CHECK( commands[ 0 ] == test::hci_packet( { 0x01, 0x0A, 0x20, 0x01, 0x01 } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( requests_connection_parameter_update, connected_link_layer )
+{
+    BOOST_CHECK( connection_parameter_update_request( 6, 12, 0, 400 ) );
+    run();
+
+    const auto packets = acl_packets();
+    BOOST_REQUIRE_EQUAL( packets.size(), 1u );
+    BOOST_CHECK( packets[ 0 ] == test::hci_packet( {
+        0x02, 0x42, 0x00, 0x10, 0x00,
+        0x0C, 0x00, 0x05, 0x00,
+        0x12, 0x01, 0x08, 0x00, 0x06, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x90, 0x01 } ) );
+}
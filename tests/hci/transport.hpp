@@ -1,13 +1,176 @@
 #ifndef TESTS_HCI_TRANSPORT_HPP
 #define TESTS_HCI_TRANSPORT_HPP
 
+#include <bluetoe/h4_transport.hpp>
+
+#include <cstdint>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <fcntl.h>
+
 namespace test
 {
+    using hci_packet = std::vector< std::uint8_t >;
+
+    /*
+     * H4 transport over one end of a socketpair, the other end is used to simulate the controller
+     */
     template < typename LinkLayer >
-    class transport
+    class transport : public bluetoe::hci::h4_transport< LinkLayer >
     {
+    public:
+        transport()
+            : accepted_packets_( unlimited )
+        {
+            int fds[ 2 ];
+
+            if ( ::socketpair( AF_UNIX, SOCK_STREAM, 0, fds ) != 0 )
+                throw std::runtime_error( "socketpair() failed" );
+
+            this->attach( fds[ 0 ] );
+            this->receive_timeout( 0 );
+
+            controller_ = fds[ 1 ];
+            ::fcntl( controller_, F_SETFL, O_NONBLOCK );
+        }
+
+        ~transport()
+        {
+            ::close( controller_ );
+        }
+
+        /*
+         * all complete packets, the host has sent to the controller since the last call
+         */
+        std::vector< hci_packet > controller_received()
+        {
+            std::uint8_t buffer[ 4096 ];
+
+            for ( ssize_t size = ::read( controller_, buffer, sizeof( buffer ) ); size > 0; size = ::read( controller_, buffer, sizeof( buffer ) ) )
+                stream_.insert( stream_.end(), &buffer[ 0 ], &buffer[ size ] );
+
+            std::vector< hci_packet > result;
+
+            for ( std::size_t size = next_packet_size(); size != 0 && size <= stream_.size(); size = next_packet_size() )
+            {
+                result.emplace_back( stream_.begin(), stream_.begin() + size );
+                stream_.erase( stream_.begin(), stream_.begin() + size );
+            }
+
+            return result;
+        }
+
+        void controller_send( const hci_packet& data )
+        {
+            if ( ::write( controller_, data.data(), data.size() ) != static_cast< ssize_t >( data.size() ) )
+                throw std::runtime_error( "write() failed" );
+        }
+
+        /*
+         * let all transmissions of the host fail, as if the controller was not writable
+         */
+        void fail_transmits( bool fail )
+        {
+            accepted_packets_ = fail ? 0 : unlimited;
+        }
+
+        /*
+         * let the host transmit only the given number of packets, as if the controller was not writable afterwards
+         */
+        void accept_packets( std::size_t count )
+        {
+            accepted_packets_ = count;
+        }
+
+        std::size_t transmit_packets( const std::uint8_t* buffer, const std::size_t* sizes, std::size_t count )
+        {
+            const std::size_t written = bluetoe::hci::h4_transport< LinkLayer >::transmit_packets( buffer, sizes, std::min( count, accepted_packets_ ) );
+
+            if ( accepted_packets_ != unlimited )
+                accepted_packets_ -= written;
+
+            return written;
+        }
 
+    private:
+        std::size_t next_packet_size() const
+        {
+            return stream_.empty() ? 0 : bluetoe::hci::details::h4_packet_size( stream_.data(), stream_.size() );
+        }
+
+        static constexpr std::size_t unlimited = ~std::size_t( 0 );
+
+        int         controller_;
+        hci_packet  stream_;
+        std::size_t accepted_packets_;
     };
+
+    inline hci_packet command_complete( std::uint16_t opcode, const std::vector< std::uint8_t >& return_parameters = { 0x00 } )
+    {
+        hci_packet result = {
+            0x04, 0x0E, static_cast< std::uint8_t >( 3 + return_parameters.size() ),
+            0x01, static_cast< std::uint8_t >( opcode & 0xff ), static_cast< std::uint8_t >( opcode >> 8 ) };
+
+        result.insert( result.end(), return_parameters.begin(), return_parameters.end() );
+
+        return result;
+    }
+
+    inline std::uint16_t command_opcode( const hci_packet& command )
+    {
+        return command.size() >= 4 && command[ 0 ] == 0x01
+            ? static_cast< std::uint16_t >( command[ 1 ] | ( command[ 2 ] << 8 ) )
+            : 0;
+    }
+
+    /*
+     * answers all commands of the setup sequence with success and returns the commands
+     */
+    template < class LinkLayer >
+    std::vector< hci_packet > complete_setup( LinkLayer& link_layer, std::uint16_t acl_size = 27, std::uint8_t acl_packets = 4 )
+    {
+        std::vector< hci_packet > commands;
+
+        for ( bool done = false; !done; )
+        {
+            link_layer.run();
+
+            const auto received = link_layer.controller_received();
+
+            if ( received.empty() )
+                throw std::runtime_error( "setup stalled" );
+
+            for ( const auto& command : received )
+            {
+                const std::uint16_t opcode = command_opcode( command );
+                commands.push_back( command );
+
+                if ( opcode == 0x2002 )
+                {
+                    link_layer.controller_send( command_complete( opcode, {
+                        0x00, static_cast< std::uint8_t >( acl_size & 0xff ), static_cast< std::uint8_t >( acl_size >> 8 ), acl_packets } ) );
+                }
+                else if ( opcode == 0x1009 )
+                {
+                    link_layer.controller_send( command_complete( opcode, { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 } ) );
+                }
+                else
+                {
+                    link_layer.controller_send( command_complete( opcode ) );
+                }
+
+                done = opcode == 0x200A;
+            }
+        }
+
+        link_layer.run();
+
+        return commands;
+    }
 }
 
 #endif
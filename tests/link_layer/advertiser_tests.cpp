@@ -63,6 +63,8 @@ struct link_layer_base
     bool advertisment_scheduled;
 
     using radio_t = test::radio< 100, 100, link_layer_base< Connect, Respond > >;
+
+    static constexpr bool channel_selection_algorithm_2_supported = false;
 };
 
 struct single_advertiser_without_white_list :
@@ -199,3 +199,62 @@ BOOST_FIXTURE_TEST_CASE( real_life_example, all_channels_but_25 )
     BOOST_CHECK_EQUAL( data_channel( 30 ), 1u );
     BOOST_CHECK_EQUAL( data_channel( 35 ), 31u );
 }
+
+/*
+ * Channel Selection Algorithm #2, sample data from the core specification (Vol 6, Part C, 3)
+ */
+static constexpr std::uint32_t sample_access_address = 0x8E89BED6;
+
+static constexpr std::uint8_t nine_channels_map[] = { 0x00, 0x06, 0xE0, 0x00, 0x1E };
+
+BOOST_FIXTURE_TEST_CASE( algorithm_2_all_channels_used, bluetoe::link_layer::channel_map )
+{
+    BOOST_REQUIRE( reset_algorithm_2( all_channel_map, sample_access_address ) );
+
+    BOOST_CHECK_EQUAL( data_channel( 0, 0 ), 25u );
+    BOOST_CHECK_EQUAL( data_channel( 0, 1 ), 20u );
+    BOOST_CHECK_EQUAL( data_channel( 0, 2 ), 6u );
+    BOOST_CHECK_EQUAL( data_channel( 0, 3 ), 21u );
+}
+
+BOOST_FIXTURE_TEST_CASE( algorithm_2_nine_channels_used, bluetoe::link_layer::channel_map )
+{
+    BOOST_REQUIRE( reset_algorithm_2( nine_channels_map, sample_access_address ) );
+
+    BOOST_CHECK_EQUAL( data_channel( 0, 6 ), 23u );
+    BOOST_CHECK_EQUAL( data_channel( 0, 7 ), 9u );
+    BOOST_CHECK_EQUAL( data_channel( 0, 8 ), 34u );
+}
+
+BOOST_FIXTURE_TEST_CASE( algorithm_2_channel_does_not_depend_on_index, bluetoe::link_layer::channel_map )
+{
+    BOOST_REQUIRE( reset_algorithm_2( all_channel_map, sample_access_address ) );
+
+    BOOST_CHECK_EQUAL( data_channel( 17, 1 ), 20u );
+    BOOST_CHECK_EQUAL( data_channel( 36, 1 ), 20u );
+}
+
+BOOST_FIXTURE_TEST_CASE( algorithm_2_invalid_map, bluetoe::link_layer::channel_map )
+{
+    static constexpr std::uint8_t one_channel_map[] = { 0x01, 0x00, 0x00, 0x00, 0x00 };
+    BOOST_CHECK( !reset_algorithm_2( one_channel_map, sample_access_address ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( algorithm_2_is_kept_with_channel_map_update, bluetoe::link_layer::channel_map )
+{
+    BOOST_REQUIRE( reset_algorithm_2( all_channel_map, sample_access_address ) );
+    BOOST_REQUIRE( reset( nine_channels_map ) );
+
+    BOOST_CHECK_EQUAL( data_channel( 0, 6 ), 23u );
+    BOOST_CHECK_EQUAL( data_channel( 0, 7 ), 9u );
+    BOOST_CHECK_EQUAL( data_channel( 0, 8 ), 34u );
+}
+
+BOOST_FIXTURE_TEST_CASE( algorithm_1_after_algorithm_2, bluetoe::link_layer::channel_map )
+{
+    BOOST_REQUIRE( reset_algorithm_2( nine_channels_map, sample_access_address ) );
+    BOOST_REQUIRE( reset( all_channel_map, 5 ) );
+
+    BOOST_CHECK_EQUAL( data_channel( 0, 6 ), 5u );
+    BOOST_CHECK_EQUAL( data_channel( 1, 7 ), 10u );
+}
@@ -0,0 +1,223 @@
+#include <bluetoe/connection_scheduler.hpp>
+
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+namespace bll = bluetoe::link_layer;
+
+namespace {
+
+    struct scheduler : bll::connection_scheduler< 3 >
+    {
+        scheduler()
+            : bll::connection_scheduler< 3 >( bll::delta_time::usec( 2500 ) )
+        {
+        }
+
+        static bll::delta_time us( std::uint32_t value )
+        {
+            return bll::delta_time::usec( value );
+        }
+
+        void connection( unsigned slot, std::uint32_t start_us, std::uint32_t end_us, std::uint32_t timeout_ms = 1000 )
+        {
+            request_connection_event( slot, us( start_us ), us( end_us ), bll::delta_time::msec( timeout_ms ) );
+        }
+
+        void advertising( unsigned slot, std::uint32_t when_us )
+        {
+            request_advertising_event( slot, us( when_us ) );
+        }
+
+        void check_event( event::kind_t kind, unsigned slot )
+        {
+            const event e = next_event();
+
+            BOOST_CHECK_EQUAL( e.kind, kind );
+            BOOST_CHECK_EQUAL( e.slot, slot );
+        }
+
+        void check_event( event::kind_t kind, unsigned slot, std::uint32_t start_us, std::uint32_t end_us )
+        {
+            const event e = next_event();
+
+            BOOST_CHECK_EQUAL( e.kind, kind );
+            BOOST_CHECK_EQUAL( e.slot, slot );
+            BOOST_CHECK_EQUAL( e.start.usec(), start_us );
+            BOOST_CHECK_EQUAL( e.end.usec(), end_us );
+        }
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( no_event_without_request, scheduler )
+{
+    check_event( event::none, invalid_slot );
+    BOOST_CHECK_EQUAL( dispatched(), invalid_slot );
+}
+
+BOOST_FIXTURE_TEST_CASE( single_connection_event, scheduler )
+{
+    connection( 1, 10000, 10200 );
+
+    check_event( event::connection_event, 1, 10000, 10200 );
+    BOOST_CHECK_EQUAL( dispatched(), 1u );
+}
+
+BOOST_FIXTURE_TEST_CASE( no_event_while_the_radio_is_busy, scheduler )
+{
+    connection( 0, 10000, 10200 );
+    advertising( 1, 30000 );
+
+    check_event( event::connection_event, 0 );
+    check_event( event::none, invalid_slot );
+
+    connection_event_timed_out();
+    check_event( event::advertising_event, 1, 30000, 30000 );
+}
+
+BOOST_FIXTURE_TEST_CASE( earlier_event_first, scheduler )
+{
+    connection( 0, 30000, 30200 );
+    advertising( 1, 5000 );
+    connection( 2, 20000, 20200 );
+
+    check_event( event::advertising_event, 1, 5000, 5000 );
+    advertising_event_done();
+
+    check_event( event::connection_event, 2, 15000, 15200 );
+    connection_event_timed_out();
+
+    check_event( event::connection_event, 0, 25000, 25200 );
+}
+
+BOOST_FIXTURE_TEST_CASE( advertising_yields_to_connection_events, scheduler )
+{
+    advertising( 0, 9000 );
+    connection( 1, 10000, 10100 );
+
+    check_event( event::skipped_advertising_event, 0 );
+    check_event( event::connection_event, 1 );
+}
+
+BOOST_FIXTURE_TEST_CASE( skipped_advertising_keeps_the_advertising_interval, scheduler )
+{
+    advertising( 0, 9000 );
+    connection( 1, 10000, 10100 );
+
+    check_event( event::skipped_advertising_event, 0 );
+    advertising( 0, 20000 );
+
+    check_event( event::connection_event, 1, 10000, 10100 );
+    connection_event_timed_out();
+
+    check_event( event::advertising_event, 0, 29000, 29000 );
+}
+
+BOOST_FIXTURE_TEST_CASE( event_length_is_reserved, scheduler )
+{
+    connection( 0, 10000, 10100 );
+    connection( 1, 12600, 12700 );
+
+    check_event( event::connection_event, 0 );
+    connection_event_timed_out();
+    check_event( event::connection_event, 1 );
+}
+
+BOOST_FIXTURE_TEST_CASE( connection_closer_to_supervision_timeout_wins, scheduler )
+{
+    // 30% of the supervision timeout vs. 3%
+    connection( 0, 30000, 30000, 100 );
+    connection( 1, 31000, 31000, 1000 );
+
+    check_event( event::skipped_connection_event, 1 );
+    check_event( event::connection_event, 0 );
+}
+
+BOOST_FIXTURE_TEST_CASE( later_connection_closer_to_supervision_timeout_wins, scheduler )
+{
+    connection( 0, 30000, 30000, 1000 );
+    connection( 1, 31000, 31000, 100 );
+
+    check_event( event::skipped_connection_event, 0 );
+    check_event( event::connection_event, 1 );
+}
+
+BOOST_FIXTURE_TEST_CASE( earlier_connection_wins_with_same_urgency, scheduler )
+{
+    connection( 1, 30000, 30000, 300 );
+    connection( 2, 31000, 31000, 310 );
+
+    check_event( event::skipped_connection_event, 2 );
+    check_event( event::connection_event, 1 );
+}
+
+BOOST_FIXTURE_TEST_CASE( connection_event_moves_the_anchor, scheduler )
+{
+    connection( 0, 10000, 10200 );
+    connection( 1, 20000, 20000 );
+
+    check_event( event::connection_event, 0, 10000, 10200 );
+    connection_event_ended();
+
+    // the anchor of slot 0 is in the middle of the receive window: 100µs uncertainty
+    check_event( event::connection_event, 1, 9800, 10000 );
+    connection_event_ended();
+
+    // now, slot 0 has an uncertainty of 100µs
+    connection( 0, 10000, 10000 );
+    check_event( event::connection_event, 0, 0, 200 );
+}
+
+BOOST_FIXTURE_TEST_CASE( advertising_moves_the_anchor, scheduler )
+{
+    advertising( 0, 5000 );
+    connection( 1, 20000, 20000 );
+
+    check_event( event::advertising_event, 0 );
+    advertising_event_done();
+
+    check_event( event::connection_event, 1, 15000, 15000 );
+}
+
+BOOST_FIXTURE_TEST_CASE( connection_event_in_the_past_is_skipped, scheduler )
+{
+    connection( 1, 10000, 10000 );
+
+    check_event( event::connection_event, 1 );
+    connection_event_ended();
+
+    connection( 0, 1000, 1000 );
+    check_event( event::skipped_connection_event, 0 );
+    check_event( event::none, invalid_slot );
+}
+
+BOOST_FIXTURE_TEST_CASE( withdrawn_event, scheduler )
+{
+    connection( 0, 10000, 10000 );
+    check_event( event::connection_event, 0 );
+
+    withdraw();
+    BOOST_CHECK_EQUAL( dispatched(), invalid_slot );
+    check_event( event::none, invalid_slot );
+}
+
+BOOST_FIXTURE_TEST_CASE( cancel_request, scheduler )
+{
+    connection( 0, 10000, 10000 );
+    cancel( 0 );
+
+    check_event( event::none, invalid_slot );
+}
+
+BOOST_FIXTURE_TEST_CASE( time_translation, scheduler )
+{
+    advertising( 0, 4000 );
+    connection( 1, 20000, 20000 );
+
+    check_event( event::advertising_event, 0 );
+    advertising_event_done();
+
+    BOOST_CHECK_EQUAL( slot_to_radio_time( 1, us( 20000 ) ).usec(), 16000u );
+    BOOST_CHECK_EQUAL( radio_to_slot_time( 1, us( 1000 ) ).usec(), 5000u );
+    BOOST_CHECK_EQUAL( radio_to_slot_time( 0, us( 1000 ) ).usec(), 1000u );
+}
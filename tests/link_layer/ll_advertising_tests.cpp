@@ -13,6 +13,7 @@
 #include "test_servers.hpp"
 
 #include <map>
+#include <numeric>
 
 namespace {
 
@@ -539,6 +540,77 @@ BOOST_FIXTURE_TEST_CASE( is_not_connectable_from_other_addresses, started_direct
     BOOST_CHECK( connection_events().empty() );
 }
 
+struct started_directed_advertising_with_resolving_list : bluetoe::link_layer::link_layer< test::small_temperature_service, test::radio,
+    bluetoe::link_layer::connectable_directed_advertising, bluetoe::link_layer::resolving_list< 4 > >
+{
+    started_directed_advertising_with_resolving_list()
+    {
+        const bluetoe::link_layer::public_device_address identity( { 0x00, 0x00, 0x00, 0x01, 0x0f, 0xc0 } );
+
+        // IRK of Core Spec Vol 3, Part H, D.7, least significant octet first
+        add_to_resolving_list( identity, {{
+            0x9b, 0x7d, 0x39, 0x0a, 0xa6, 0x10, 0x10, 0x34,
+            0x05, 0xad, 0xc8, 0x57, 0xa3, 0x34, 0x02, 0xec } } );
+
+        directed_advertising_address( identity );
+        this->run();
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE( is_connectable_from_resolvable_private_address_of_directed_address, started_directed_advertising_with_resolving_list )
+{
+    BOOST_REQUIRE( connection_events().empty() );
+
+    respond_to(
+        37,
+        {
+            0xc5, 0x22,                         // header
+            0xaa, 0xfb, 0x0d, 0x94, 0x81, 0x70, // InitA: 70:81:94:0d:fb:aa (random, resolvable to c0:0f:01:00:00:00)
+            0x47, 0x11, 0x08, 0x15, 0x0f, 0xc0, // AdvA:  c0:0f:15:08:11:47 (random)
+            0x5a, 0xb3, 0x9a, 0xaf,             // Access Address
+            0x08, 0x81, 0xf6,                   // CRC Init
+            0x03,                               // transmit window size
+            0x0b, 0x00,                         // window offset
+            0x18, 0x00,                         // interval
+            0x00, 0x00,                         // peripheral latency
+            0x48, 0x00,                         // connection timeout
+            0xff, 0xff, 0xff, 0xff, 0x1f,       // used channel map
+            0xaa                                // hop increment and sleep clock accuracy
+        }
+    );
+
+    end_of_simulation( bluetoe::link_layer::delta_time::seconds( 20 ) );
+    run();
+
+    BOOST_CHECK( !connection_events().empty() );
+}
+
+BOOST_FIXTURE_TEST_CASE( is_not_connectable_from_other_resolvable_private_address, started_directed_advertising_with_resolving_list )
+{
+    respond_to(
+        37,
+        {
+            0xc5, 0x22,                         // header
+            0xab, 0xfb, 0x0d, 0x94, 0x81, 0x70, // InitA: 70:81:94:0d:fb:ab (random, not resolvable)
+            0x47, 0x11, 0x08, 0x15, 0x0f, 0xc0, // AdvA:  c0:0f:15:08:11:47 (random)
+            0x5a, 0xb3, 0x9a, 0xaf,             // Access Address
+            0x08, 0x81, 0xf6,                   // CRC Init
+            0x03,                               // transmit window size
+            0x0b, 0x00,                         // window offset
+            0x18, 0x00,                         // interval
+            0x00, 0x00,                         // peripheral latency
+            0x48, 0x00,                         // connection timeout
+            0xff, 0xff, 0xff, 0xff, 0x1f,       // used channel map
+            0xaa                                // hop increment and sleep clock accuracy
+        }
+    );
+
+    end_of_simulation( bluetoe::link_layer::delta_time::seconds( 20 ) );
+    run();
+
+    BOOST_CHECK( connection_events().empty() );
+}
+
 BOOST_FIXTURE_TEST_CASE( no_response_to_scan_request, started_directed_advertising )
 {
     respond_to(
@@ -1134,3 +1206,473 @@ BOOST_AUTO_TEST_SUITE( advertising_custom_data )
     }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( runtime_advertising_data )
+
+    static const std::uint8_t sensor_data_1[] = {
+        0x05, 0x16, 0x1a, 0x18, 0x12, 0x34
+    };
+
+    static const std::uint8_t sensor_data_2[] = {
+        0x05, 0x16, 0x1a, 0x18, 0x56, 0x78
+    };
+
+    struct runtime_data : bluetoe::link_layer::link_layer<
+        test::small_temperature_service, test::radio,
+        test::buffer_sizes,
+        bluetoe::link_layer::runtime_advertising_data<> >
+    {
+        static bool contains( const test::advertising_data& data, const std::uint8_t* payload, std::size_t size )
+        {
+            const auto& pdu = data.transmitted_data;
+
+            return pdu.size() == 8 + size && std::equal( &pdu[ 8 ], &pdu[ 8 ] + size, payload );
+        }
+    };
+
+    BOOST_FIXTURE_TEST_CASE( server_data_is_used_until_data_is_set, runtime_data )
+    {
+        run();
+
+        std::uint8_t        gap[ 31 ];
+        const std::size_t   gap_size = advertising_data( &gap[ 0 ], sizeof( gap ) );
+
+        check_scheduling(
+            [&]( const test::advertising_data& data )
+            {
+                return contains( data, gap, gap_size );
+            },
+            "server_data_is_used_until_data_is_set"
+        );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( data_set_before_start_is_used, runtime_data )
+    {
+        BOOST_CHECK( set_advertising_data( sensor_data_1, sizeof( sensor_data_1 ) ) );
+        run();
+
+        check_scheduling(
+            [&]( const test::advertising_data& data )
+            {
+                return contains( data, sensor_data_1, sizeof( sensor_data_1 ) );
+            },
+            "data_set_before_start_is_used"
+        );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( too_large_data_is_rejected, runtime_data )
+    {
+        const std::uint8_t large[ 32 ] = { 0 };
+
+        BOOST_CHECK( !set_advertising_data( large, sizeof( large ) ) );
+        BOOST_CHECK( set_advertising_data( large, 31 ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( new_data_is_used_from_the_next_advertising_event_on, runtime_data )
+    {
+        set_advertising_data( sensor_data_1, sizeof( sensor_data_1 ) );
+        end_of_simulation( bluetoe::link_layer::delta_time::seconds( 1 ) );
+        run();
+
+        const std::size_t first_run = advertisings().size();
+        BOOST_REQUIRE_GT( first_run, 0u );
+
+        set_advertising_data( sensor_data_2, sizeof( sensor_data_2 ) );
+        end_of_simulation( bluetoe::link_layer::delta_time::seconds( 2 ) );
+        run();
+
+        const auto& pdus = advertisings();
+        BOOST_REQUIRE_GT( pdus.size(), first_run + 3 );
+
+        bool switched = false;
+
+        for ( std::size_t i = 0; i != pdus.size(); ++i )
+        {
+            // the payload is changed at the start of an advertising event only
+            switched = switched || ( i >= first_run && pdus[ i ].channel == 37 );
+
+            BOOST_CHECK( switched
+                ? contains( pdus[ i ], sensor_data_2, sizeof( sensor_data_2 ) )
+                : contains( pdus[ i ], sensor_data_1, sizeof( sensor_data_1 ) ) );
+        }
+
+        BOOST_CHECK( switched );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( extended_advertising )
+
+    template < typename ... Options >
+    struct extended_advertising_base : bluetoe::link_layer::link_layer<
+        test::small_temperature_service, test::radio,
+        bluetoe::link_layer::non_connectable_extended_advertising,
+        bluetoe::link_layer::buffer_sizes< 300u, 300u >,
+        Options... >
+    {
+        extended_advertising_base()
+        {
+            this->end_of_simulation( bluetoe::link_layer::delta_time::seconds( 1 ) );
+            this->run();
+        }
+
+        static bool is_primary( const test::advertising_data& data )
+        {
+            return data.channel >= 37;
+        }
+
+        static unsigned aux_channel( const test::advertising_data& primary )
+        {
+            return primary.transmitted_data[ 6 ] & 0x3f;
+        }
+
+        static std::uint32_t aux_offset_us( const test::advertising_data& primary )
+        {
+            const auto& pdu = primary.transmitted_data;
+
+            return ( pdu[ 7 ] | ( ( pdu[ 8 ] & 0x1f ) << 8 ) ) * 30u;
+        }
+    };
+
+    using extended_advertising = extended_advertising_base<>;
+
+    BOOST_FIXTURE_TEST_CASE( three_primary_and_one_auxiliary_pdu_per_event, extended_advertising )
+    {
+        const auto& pdus = advertisings();
+        BOOST_REQUIRE_GE( pdus.size(), 8u );
+
+        for ( std::size_t i = 0; i != pdus.size(); ++i )
+        {
+            if ( i % 4 == 3 )
+            {
+                BOOST_CHECK_LT( pdus[ i ].channel, 37u );
+            }
+            else
+            {
+                BOOST_CHECK_EQUAL( pdus[ i ].channel, 37u + i % 4 );
+            }
+        }
+
+        BOOST_CHECK_NE( pdus[ 3 ].channel, pdus[ 7 ].channel );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( primary_pdus_point_to_the_auxiliary_pdu, extended_advertising )
+    {
+        const auto& pdus = advertisings();
+        BOOST_REQUIRE_GE( pdus.size(), 8u );
+
+        for ( std::size_t i = 0; i + 4 <= pdus.size(); i += 4 )
+        {
+            const auto& aux = pdus[ i + 3 ];
+
+            for ( std::size_t p = i; p != i + 3; ++p )
+            {
+                const auto& pdu = pdus[ p ].transmitted_data;
+
+                BOOST_REQUIRE_EQUAL( pdu.size(), 9u );
+                BOOST_CHECK_EQUAL( pdu[ 0 ], 0x07 );    // ADV_EXT_IND, no TxAdd
+                BOOST_CHECK_EQUAL( pdu[ 1 ], 7 );
+                BOOST_CHECK_EQUAL( pdu[ 2 ], 6 );       // AdvMode: non-connectable, non-scannable
+                BOOST_CHECK_EQUAL( pdu[ 3 ], 0x18 );    // ADI and AuxPtr
+
+                // same ADI in all PDUs of an event
+                BOOST_CHECK_EQUAL( pdu[ 4 ], aux.transmitted_data[ 10 ] );
+                BOOST_CHECK_EQUAL( pdu[ 5 ], aux.transmitted_data[ 11 ] );
+
+                BOOST_CHECK_EQUAL( aux_channel( pdus[ p ] ), aux.channel );
+                BOOST_CHECK_EQUAL( aux_offset_us( pdus[ p ] ), ( aux.on_air_time - pdus[ p ].on_air_time ).usec() );
+            }
+        }
+    }
+
+    BOOST_FIXTURE_TEST_CASE( auxiliary_pdu_contains_address_and_advertising_data, extended_advertising )
+    {
+        std::uint8_t        gap[ 31 ];
+        const std::size_t   gap_size = advertising_data( &gap[ 0 ], sizeof( gap ) );
+
+        check_scheduling(
+            []( const test::advertising_data& data )
+            {
+                return !is_primary( data );
+            },
+            [&]( const test::advertising_data& data )
+            {
+                static const std::uint8_t expected_header[] = {
+                    0x47,                               // AUX_ADV_IND, TxAdd random
+                    0x00,                               // length, checked below
+                    0x09,                               // extended header length, AdvMode 0
+                    0x09,                               // AdvA and ADI
+                    0x47, 0x11, 0x08, 0x15, 0x0f, 0xc0  // AdvA:  c0:0f:15:08:11:47 (random)
+                };
+
+                const auto& pdu = data.transmitted_data;
+
+                return pdu.size() == 12 + gap_size
+                    && pdu[ 1 ] == 10 + gap_size
+                    && pdu[ 0 ] == expected_header[ 0 ]
+                    && std::equal( &expected_header[ 2 ], &expected_header[ sizeof( expected_header ) ], &pdu[ 2 ] )
+                    && std::equal( &gap[ 0 ], &gap[ gap_size ], &pdu[ 12 ] );
+            },
+            "auxiliary_pdu_contains_address_and_advertising_data"
+        );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( advertising_interval_is_kept, extended_advertising )
+    {
+        const auto& pdus = advertisings();
+        BOOST_REQUIRE_GE( pdus.size(), 8u );
+
+        for ( std::size_t i = 4; i < pdus.size(); i += 4 )
+        {
+            const auto interval = pdus[ i ].on_air_time - pdus[ i - 4 ].on_air_time;
+
+            BOOST_CHECK_GE( interval, bluetoe::link_layer::delta_time::msec( 100 ) );
+            BOOST_CHECK_LE( interval, bluetoe::link_layer::delta_time::msec( 110 ) );
+        }
+    }
+
+    // scheduled_radio::schedule_advertisment() requires a receive buffer with room for at least two bytes
+    BOOST_FIXTURE_TEST_CASE( all_pdus_are_scheduled_with_a_receive_buffer, extended_advertising )
+    {
+        const auto& pdus = advertisings();
+        BOOST_REQUIRE_GE( pdus.size(), 8u );
+
+        for ( const auto& pdu : pdus )
+        {
+            BOOST_CHECK( pdu.receive_buffer.buffer != nullptr );
+            BOOST_CHECK_GE( pdu.receive_buffer.size, 2u );
+        }
+    }
+
+    using large_payload = extended_advertising_base< bluetoe::link_layer::runtime_advertising_data< 245 > >;
+
+    BOOST_FIXTURE_TEST_CASE( large_payload_in_auxiliary_pdu, large_payload )
+    {
+        std::uint8_t payload[ 245 ];
+        payload[ 0 ] = sizeof( payload ) - 1;
+        payload[ 1 ] = 0xff;
+        std::iota( &payload[ 2 ], &payload[ sizeof( payload ) ], 0 );
+
+        BOOST_REQUIRE( set_advertising_data( payload, sizeof( payload ) ) );
+
+        end_of_simulation( bluetoe::link_layer::delta_time::seconds( 2 ) );
+        run();
+
+        const auto& pdus = advertisings();
+        const auto  last_aux = std::find_if( pdus.rbegin(), pdus.rend(), []( const test::advertising_data& data )
+        {
+            return !is_primary( data );
+        } );
+
+        BOOST_REQUIRE( last_aux != pdus.rend() );
+        BOOST_REQUIRE_EQUAL( last_aux->transmitted_data.size(), 257u );
+        BOOST_CHECK_EQUAL( last_aux->transmitted_data[ 1 ], 255u );
+        BOOST_CHECK( std::equal( &payload[ 0 ], &payload[ sizeof( payload ) ], &last_aux->transmitted_data[ 12 ] ) );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( periodic_advertising )
+
+    static constexpr std::uint32_t advertising_access_address = 0x8E89BED6;
+
+    template < typename ... Options >
+    struct periodic_advertising_base : bluetoe::link_layer::link_layer<
+        test::small_temperature_service, test::radio,
+        bluetoe::link_layer::non_connectable_extended_advertising,
+        bluetoe::link_layer::periodic_advertising< 50, 100 >,
+        bluetoe::link_layer::buffer_sizes< 300u, 300u >,
+        Options... >
+    {
+        periodic_advertising_base()
+        {
+            this->end_of_simulation( bluetoe::link_layer::delta_time::seconds( 1 ) );
+            this->run();
+        }
+
+        static bool is_sync( const test::advertising_data& data )
+        {
+            return data.access_address != advertising_access_address;
+        }
+
+        static bool is_aux( const test::advertising_data& data )
+        {
+            return !is_sync( data ) && data.channel < 37;
+        }
+
+        std::vector< test::advertising_data > syncs() const
+        {
+            std::vector< test::advertising_data > result;
+            std::copy_if( this->advertisings().begin(), this->advertisings().end(), std::back_inserter( result ), is_sync );
+
+            return result;
+        }
+    };
+
+    using periodic_advertising = periodic_advertising_base<>;
+
+    BOOST_FIXTURE_TEST_CASE( sync_pdus_are_sent_with_a_fixed_interval, periodic_advertising )
+    {
+        const auto pdus = syncs();
+        BOOST_REQUIRE_GE( pdus.size(), 15u );
+
+        for ( std::size_t i = 1; i != pdus.size(); ++i )
+        {
+            BOOST_CHECK_EQUAL( pdus[ i ].on_air_time - pdus[ i - 1 ].on_air_time, bluetoe::link_layer::delta_time::msec( 50 ) );
+            BOOST_CHECK_LT( pdus[ i ].channel, 37u );
+        }
+    }
+
+    BOOST_FIXTURE_TEST_CASE( sync_pdus_do_not_overlap_with_advertising_events, periodic_advertising )
+    {
+        const auto& pdus = advertisings();
+
+        for ( std::size_t i = 1; i < pdus.size(); ++i )
+            BOOST_CHECK_GE( pdus[ i ].on_air_time - pdus[ i - 1 ].on_air_time, bluetoe::link_layer::delta_time::usec( 2400 ) );
+
+        // the advertising events are still sent
+        BOOST_CHECK_GE( std::count_if( pdus.begin(), pdus.end(), is_aux ), 8 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( auxiliary_pdu_contains_sync_info, periodic_advertising )
+    {
+        const auto& pdus = advertisings();
+
+        unsigned checked = 0;
+
+        for ( auto aux = std::find_if( pdus.begin(), pdus.end(), is_aux ); aux != pdus.end(); aux = std::find_if( std::next( aux ), pdus.end(), is_aux ) )
+        {
+            const auto next_sync = std::find_if( aux, pdus.end(), is_sync );
+
+            if ( next_sync == pdus.end() )
+                break;
+
+            const auto& pdu = aux->transmitted_data;
+            BOOST_REQUIRE_GE( pdu.size(), 30u );
+            BOOST_CHECK_EQUAL( pdu[ 2 ], 27u );         // extended header length, AdvMode 0
+            BOOST_CHECK_EQUAL( pdu[ 3 ], 0x29 );        // AdvA, ADI and SyncInfo
+
+            const std::uint8_t* const sync_info = &pdu[ 12 ];
+            const std::uint16_t offset   = sync_info[ 0 ] | ( ( sync_info[ 1 ] & 0x1f ) << 8 );
+            const std::uint32_t unit     = ( sync_info[ 1 ] & 0x20 ) ? 300 : 30;
+            const auto          expected = ( next_sync->on_air_time - aux->on_air_time ).usec();
+
+            BOOST_CHECK_LE( offset * unit, expected );
+            BOOST_CHECK_GT( offset * unit + unit, expected );
+
+            BOOST_CHECK_EQUAL( sync_info[ 2 ] | ( sync_info[ 3 ] << 8 ), 40 );
+            BOOST_CHECK_EQUAL( sync_info[ 9 ] | ( sync_info[ 10 ] << 8 ) | ( sync_info[ 11 ] << 16 ) | ( std::uint32_t( sync_info[ 12 ] ) << 24 ), next_sync->access_address );
+            BOOST_CHECK_EQUAL( sync_info[ 13 ] | ( sync_info[ 14 ] << 8 ) | ( sync_info[ 15 ] << 16 ), next_sync->crc_init );
+
+            const auto counter = std::count_if( pdus.begin(), next_sync, is_sync );
+            BOOST_CHECK_EQUAL( sync_info[ 16 ] | ( sync_info[ 17 ] << 8 ), counter );
+
+            ++checked;
+        }
+
+        BOOST_CHECK_GE( checked, 8u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( all_pdus_are_scheduled_with_a_receive_buffer, periodic_advertising )
+    {
+        const auto& pdus = advertisings();
+        BOOST_REQUIRE( !syncs().empty() );
+
+        for ( const auto& pdu : pdus )
+        {
+            BOOST_CHECK( pdu.receive_buffer.buffer != nullptr );
+            BOOST_CHECK_GE( pdu.receive_buffer.size, 2u );
+        }
+    }
+
+    BOOST_FIXTURE_TEST_CASE( sync_pdus_use_a_valid_access_address, periodic_advertising )
+    {
+        const auto pdus = syncs();
+        BOOST_REQUIRE( !pdus.empty() );
+
+        BOOST_CHECK( bluetoe::link_layer::details::valid_access_address( pdus.front().access_address ) );
+
+        for ( const auto& pdu : pdus )
+        {
+            BOOST_CHECK_EQUAL( pdu.access_address, pdus.front().access_address );
+            BOOST_CHECK_EQUAL( pdu.crc_init, pdus.front().crc_init );
+        }
+    }
+
+    using other_device = periodic_advertising_base<
+        bluetoe::link_layer::static_address< 0xc0, 0x12, 0x34, 0x56, 0x78, 0x9a > >;
+
+    BOOST_AUTO_TEST_CASE( devices_with_different_addresses_use_different_trains )
+    {
+        const periodic_advertising first;
+        const other_device         second;
+
+        BOOST_REQUIRE( !first.syncs().empty() );
+        BOOST_REQUIRE( !second.syncs().empty() );
+
+        BOOST_CHECK_NE( first.syncs().front().access_address, second.syncs().front().access_address );
+        BOOST_CHECK_NE( first.syncs().front().crc_init, second.syncs().front().crc_init );
+    }
+
+    BOOST_AUTO_TEST_CASE( access_address_rules )
+    {
+        using bluetoe::link_layer::details::valid_access_address;
+
+        BOOST_CHECK( valid_access_address( 0xaf9ab35a ) );
+
+        // advertising access address or differs in only one bit from it
+        BOOST_CHECK( !valid_access_address( 0x8E89BED6 ) );
+        BOOST_CHECK( !valid_access_address( 0x8E89BED7 ) );
+
+        // all four octets equal
+        BOOST_CHECK( !valid_access_address( 0x5a5a5a5a ) );
+
+        // more than six consecutive zeros or ones
+        BOOST_CHECK( !valid_access_address( 0xaf9a805a ) );
+        BOOST_CHECK( !valid_access_address( 0xaf9aff5a ) );
+
+        // more than 24 transitions
+        BOOST_CHECK( !valid_access_address( 0x55555553 ) );
+
+        // less than two transitions in the six most significant bits
+        BOOST_CHECK( !valid_access_address( 0x079ab35a ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( empty_sync_pdus_without_data, periodic_advertising )
+    {
+        for ( const auto& pdu : syncs() )
+        {
+            const std::vector< std::uint8_t > expected = { 0x07, 0x01, 0x00 };
+            BOOST_CHECK( pdu.transmitted_data == expected );
+        }
+    }
+
+    BOOST_FIXTURE_TEST_CASE( committed_data_is_sent, periodic_advertising )
+    {
+        std::uint8_t* const buffer = periodic_advertising_buffer();
+        BOOST_REQUIRE( buffer );
+
+        static const std::uint8_t data[] = { 0x04, 0xff, 0x01, 0x02, 0x03 };
+        std::copy( std::begin( data ), std::end( data ), buffer );
+        commit_periodic_advertising_data( sizeof( data ) );
+
+        // not yet picked up by the link layer
+        BOOST_CHECK( periodic_advertising_buffer() == nullptr );
+
+        const std::size_t old_count = syncs().size();
+        end_of_simulation( bluetoe::link_layer::delta_time::seconds( 2 ) );
+        run();
+
+        const auto pdus = syncs();
+        BOOST_REQUIRE_GT( pdus.size(), old_count );
+
+        for ( std::size_t i = old_count; i != pdus.size(); ++i )
+        {
+            const std::vector< std::uint8_t > expected = { 0x07, 0x06, 0x00, 0x04, 0xff, 0x01, 0x02, 0x03 };
+            BOOST_CHECK( pdus[ i ].transmitted_data == expected );
+        }
+
+        BOOST_CHECK( periodic_advertising_buffer() != nullptr );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
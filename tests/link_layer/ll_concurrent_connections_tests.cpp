@@ -0,0 +1,224 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include "connected.hpp"
+#include "buffer_io.hpp"
+
+namespace {
+
+    static constexpr std::uint32_t first_access_address  = 0xaf9ab35a;
+    static constexpr std::uint32_t second_access_address = 0x12345678;
+
+    template < typename ... Options >
+    struct concurrent_connections_base :
+        unconnected_base< bluetoe::link_layer::buffer_sizes< 61u, 61u >, Options... >
+    {
+        void respond_with_connection_request( std::uint32_t access_address, std::uint16_t interval = 0x18, std::uint16_t window_offset = 0x0b )
+        {
+            const std::vector< std::uint8_t > pdu =
+            {
+                0xc5, 0x22,                         // header
+                0x3c, 0x1c, 0x62, 0x92, 0xf0, 0x48, // InitA: 48:f0:92:62:1c:3c (random)
+                0x47, 0x11, 0x08, 0x15, 0x0f, 0xc0, // AdvA:  c0:0f:15:08:11:47 (random)
+                static_cast< std::uint8_t >( access_address ),
+                static_cast< std::uint8_t >( access_address >> 8 ),
+                static_cast< std::uint8_t >( access_address >> 16 ),
+                static_cast< std::uint8_t >( access_address >> 24 ),
+                0x08, 0x81, 0xf6,                   // CRC Init
+                0x03,                               // transmit window size
+                static_cast< std::uint8_t >( window_offset & 0xff ),
+                static_cast< std::uint8_t >( window_offset >> 8 ),
+                static_cast< std::uint8_t >( interval & 0xff ),
+                static_cast< std::uint8_t >( interval >> 8 ),
+                0x00, 0x00,                         // peripheral latency
+                0x48, 0x00,                         // connection timeout (720ms)
+                0xff, 0xff, 0xff, 0xff, 0x1f,       // used channel map
+                0xaa                                // hop increment and sleep clock accuracy (10 and 50ppm)
+            };
+
+            this->respond_to( 37, pdu );
+        }
+
+        void add_empty_pdus( std::uint32_t access_address, unsigned count )
+        {
+            for ( ; count; --count )
+                this->add_connection_event_respond( access_address, { 0x01, 0x00 } );
+        }
+
+        std::vector< test::connection_event > events_of( std::uint32_t access_address ) const
+        {
+            std::vector< test::connection_event > result;
+
+            for ( const auto& event: this->connection_events() )
+            {
+                if ( event.access_address == access_address )
+                    result.push_back( event );
+            }
+
+            return result;
+        }
+
+        unsigned advertising_scheduled_between( bluetoe::link_layer::delta_time begin, bluetoe::link_layer::delta_time end ) const
+        {
+            return this->count_data( [begin, end]( const test::advertising_data& data ) -> bool {
+                return data.schedule_time > begin && data.schedule_time < end;
+            } );
+        }
+
+        bool transmitted( const test::connection_event& event, std::initializer_list< std::uint8_t > pdu ) const
+        {
+            for ( const auto& transmitted : event.transmitted_data )
+            {
+                if ( transmitted.data.size() == pdu.size()
+                  && std::equal( pdu.begin() + 1, pdu.end(), transmitted.data.begin() + 1 )
+                  && ( transmitted.data[ 0 ] & 0x03 ) == ( *pdu.begin() & 0x03 ) )
+                    return true;
+            }
+
+            return false;
+        }
+    };
+
+    using two_connections = concurrent_connections_base< bluetoe::link_layer::max_concurrent_connections< 2 > >;
+
+    struct first_connection_established : two_connections
+    {
+        first_connection_established()
+        {
+            respond_with_connection_request( first_access_address );
+            add_empty_pdus( first_access_address, 10 );
+
+            this->end_of_simulation( bluetoe::link_layer::delta_time::seconds( 1 ) );
+            run();
+        }
+    };
+
+    struct both_connections_established : two_connections
+    {
+        both_connections_established()
+        {
+            respond_with_connection_request( first_access_address );
+            respond_with_connection_request( second_access_address, 0x18, 0x02 );
+            add_empty_pdus( first_access_address, 40 );
+            add_empty_pdus( second_access_address, 40 );
+
+            this->end_of_simulation( bluetoe::link_layer::delta_time::seconds( 1 ) );
+            run( 4 );
+        }
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( keeps_advertising_after_the_first_connection, first_connection_established )
+{
+    const auto events = events_of( first_access_address );
+    BOOST_REQUIRE( !events.empty() );
+
+    BOOST_CHECK_GT( advertising_scheduled_between( events.front().schedule_time, bluetoe::link_layer::delta_time::seconds( 10 ) ), 0u );
+}
+
+BOOST_FIXTURE_TEST_CASE( connection_events_of_a_single_connection_are_unchanged, first_connection_established )
+{
+    const auto events = events_of( first_access_address );
+    BOOST_REQUIRE_GE( events.size(), 2u );
+
+    // transmit window offset (11 * 1.25ms + 1.25ms) and size (3 * 1.25ms), widened by 550ppm
+    BOOST_CHECK_EQUAL( events[ 0 ].start_receive, bluetoe::link_layer::delta_time::usec( 15000 - 8 ) );
+    BOOST_CHECK_EQUAL( events[ 0 ].end_receive, bluetoe::link_layer::delta_time::usec( 18750 + 10 ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( second_connection_established, both_connections_established )
+{
+    BOOST_CHECK_GE( events_of( first_access_address ).size(), 10u );
+    BOOST_CHECK_GE( events_of( second_access_address ).size(), 10u );
+}
+
+BOOST_FIXTURE_TEST_CASE( no_advertising_while_all_connections_are_established, both_connections_established )
+{
+    const auto first  = events_of( first_access_address );
+    const auto second = events_of( second_access_address );
+    BOOST_REQUIRE( !first.empty() );
+    BOOST_REQUIRE( !second.empty() );
+
+    // both connections are served with empty PDUs for more than 10 connection events
+    BOOST_CHECK_EQUAL( advertising_scheduled_between( second.front().schedule_time, second[ 10 ].schedule_time ), 0u );
+}
+
+BOOST_FIXTURE_TEST_CASE( advertising_resumes_after_a_disconnect, two_connections )
+{
+    respond_with_connection_request( first_access_address );
+    respond_with_connection_request( second_access_address, 0x18, 0x02 );
+    add_empty_pdus( first_access_address, 5 );
+    add_empty_pdus( second_access_address, 100 );
+
+    end_of_simulation( bluetoe::link_layer::delta_time::seconds( 3 ) );
+    run( 6 );
+
+    const auto first = events_of( first_access_address );
+    BOOST_REQUIRE( !first.empty() );
+
+    // the first connection timed out
+    BOOST_CHECK_GT( advertising_scheduled_between( first.back().schedule_time, bluetoe::link_layer::delta_time::seconds( 10 ) ), 0u );
+}
+
+BOOST_FIXTURE_TEST_CASE( connections_have_independent_data, two_connections )
+{
+    respond_with_connection_request( first_access_address );
+    respond_with_connection_request( second_access_address, 0x18, 0x02 );
+
+    // LL_PING_REQ on the first, LL_VERSION_IND on the second connection
+    add_connection_event_respond( first_access_address, { 0x03, 0x01, 0x12 } );
+    add_empty_pdus( first_access_address, 20 );
+    add_empty_pdus( second_access_address, 2 );
+    add_connection_event_respond( second_access_address, { 0x03, 0x06, 0x0c, 0x08, 0x0f, 0x00, 0x09, 0x06 } );
+    add_empty_pdus( second_access_address, 20 );
+
+    end_of_simulation( bluetoe::link_layer::delta_time::seconds( 1 ) );
+    run( 4 );
+
+    bool ping_response   = false;
+    bool version_response = false;
+
+    for ( const auto& event: events_of( first_access_address ) )
+    {
+        ping_response = ping_response || transmitted( event, { 0x03, 0x01, 0x13 } );
+        BOOST_CHECK( !transmitted( event, { 0x03, 0x06, 0x0c, 0x09, 0x69, 0x02, 0x00, 0x00 } ) );
+    }
+
+    for ( const auto& event: events_of( second_access_address ) )
+    {
+        version_response = version_response || transmitted( event, { 0x03, 0x06, 0x0c, 0x09, 0x69, 0x02, 0x00, 0x00 } );
+        BOOST_CHECK( !transmitted( event, { 0x03, 0x01, 0x13 } ) );
+    }
+
+    BOOST_CHECK( ping_response );
+    BOOST_CHECK( version_response );
+}
+
+BOOST_FIXTURE_TEST_CASE( colliding_connections_stay_connected, two_connections )
+{
+    // 7.5ms and 30ms connection interval
+    respond_with_connection_request( first_access_address, 0x06, 0x02 );
+    respond_with_connection_request( second_access_address, 0x18, 0x02 );
+    add_empty_pdus( first_access_address, 400 );
+    add_empty_pdus( second_access_address, 100 );
+
+    end_of_simulation( bluetoe::link_layer::delta_time::seconds( 2 ) );
+    run( 6 );
+
+    const auto first  = events_of( first_access_address );
+    const auto second = events_of( second_access_address );
+
+    BOOST_REQUIRE( !first.empty() );
+    BOOST_REQUIRE( !second.empty() );
+
+    // none of the connections was lost due to a supervision timeout
+    const auto end_of_test = bluetoe::link_layer::delta_time::seconds( 2 ) - bluetoe::link_layer::delta_time::msec( 100 );
+    BOOST_CHECK_GT( first.back().schedule_time, end_of_test );
+    BOOST_CHECK_GT( second.back().schedule_time, end_of_test );
+}
+
+BOOST_AUTO_TEST_CASE( single_connection_is_the_default )
+{
+    BOOST_CHECK_EQUAL( bluetoe::link_layer::details::concurrent_connections_option<>::connections, 1u );
+    BOOST_CHECK_EQUAL( ( bluetoe::link_layer::details::concurrent_connections_option< bluetoe::link_layer::max_concurrent_connections< 3 > >::connections ), 3u );
+}
@@ -546,3 +546,96 @@ BOOST_FIXTURE_TEST_CASE( response_to_an_feature_request, unconnected )
 
     BOOST_CHECK_EQUAL_COLLECTIONS( std::begin( response ), std::end( response ), std::begin( expected_response ), std::end( expected_response ) );
 }
+
+/*
+ * Channel Selection Algorithm #2
+ */
+template < std::uint8_t Header >
+struct connected_with_channel_selection_algorithm : unconnected_base<
+    bluetoe::link_layer::buffer_sizes< 61u, 61u >,
+    bluetoe::link_layer::channel_selection_algorithm_2 >
+{
+    connected_with_channel_selection_algorithm()
+    {
+        respond_to( 37, {
+            Header, 0x22,                       // header
+            0x3c, 0x1c, 0x62, 0x92, 0xf0, 0x48, // InitA: 48:f0:92:62:1c:3c (random)
+            0x47, 0x11, 0x08, 0x15, 0x0f, 0xc0, // AdvA:  c0:0f:15:08:11:47 (random)
+            0xd6, 0xbe, 0x89, 0x8e,             // Access Address
+            0x08, 0x81, 0xf6,                   // CRC Init
+            0x03,                               // transmit window size
+            0x0b, 0x00,                         // window offset
+            0x18, 0x00,                         // interval (30ms)
+            0x00, 0x00,                         // peripheral latency
+            0x48, 0x00,                         // connection timeout (720ms)
+            0xff, 0xff, 0xff, 0xff, 0x1f,       // used channel map
+            0xaa                                // hop increment and sleep clock accuracy (10 and 50ppm)
+        } );
+
+        ll_empty_pdus( 4 );
+
+        run();
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE( channel_selection_algorithm_2_is_indicated_when_advertising, connected_with_channel_selection_algorithm< 0xe5 > )
+{
+    BOOST_REQUIRE( !advertisings().empty() );
+    BOOST_CHECK( advertisings().front().transmitted_data[ 0 ] & 0x20 );
+}
+
+BOOST_FIXTURE_TEST_CASE( channel_selection_algorithm_2_is_not_indicated_by_default, only_one_pdu_from_central )
+{
+    BOOST_REQUIRE( !advertisings().empty() );
+    BOOST_CHECK( ( advertisings().front().transmitted_data[ 0 ] & 0x20 ) == 0 );
+}
+
+BOOST_FIXTURE_TEST_CASE( channel_selection_algorithm_2_selected_by_central, connected_with_channel_selection_algorithm< 0xe5 > )
+{
+    // sample data from the core specification
+    static constexpr unsigned expected_channels[] = { 25, 20, 6, 21 };
+
+    for ( unsigned i = 0; i != sizeof( expected_channels ) / sizeof( expected_channels[ 0 ] ); ++i )
+    {
+        BOOST_CHECK_EQUAL( connection_events().at( i ).channel, expected_channels[ i ] );
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE( channel_selection_algorithm_1_if_not_selected_by_central, connected_with_channel_selection_algorithm< 0xc5 > )
+{
+    static constexpr unsigned expected_hop_sequence[] = { 10, 20, 30, 3 };
+
+    for ( unsigned i = 0; i != sizeof( expected_hop_sequence ) / sizeof( expected_hop_sequence[ 0 ] ); ++i )
+    {
+        BOOST_CHECK_EQUAL( connection_events().at( i ).channel, expected_hop_sequence[ i ] );
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE( channel_selection_algorithm_2_bit_is_ignored_if_not_supported, unconnected )
+{
+    respond_to( 37, {
+        0xe5, 0x22,                         // header with ChSel set
+        0x3c, 0x1c, 0x62, 0x92, 0xf0, 0x48, // InitA: 48:f0:92:62:1c:3c (random)
+        0x47, 0x11, 0x08, 0x15, 0x0f, 0xc0, // AdvA:  c0:0f:15:08:11:47 (random)
+        0xd6, 0xbe, 0x89, 0x8e,             // Access Address
+        0x08, 0x81, 0xf6,                   // CRC Init
+        0x03,                               // transmit window size
+        0x0b, 0x00,                         // window offset
+        0x18, 0x00,                         // interval (30ms)
+        0x00, 0x00,                         // peripheral latency
+        0x48, 0x00,                         // connection timeout (720ms)
+        0xff, 0xff, 0xff, 0xff, 0x1f,       // used channel map
+        0xaa                                // hop increment and sleep clock accuracy (10 and 50ppm)
+    } );
+
+    ll_empty_pdus( 4 );
+
+    run();
+
+    static constexpr unsigned expected_hop_sequence[] = { 10, 20, 30, 3 };
+
+    for ( unsigned i = 0; i != sizeof( expected_hop_sequence ) / sizeof( expected_hop_sequence[ 0 ] ); ++i )
+    {
+        BOOST_CHECK_EQUAL( connection_events().at( i ).channel, expected_hop_sequence[ i ] );
+    }
+}
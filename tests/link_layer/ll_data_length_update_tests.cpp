@@ -0,0 +1,375 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <bluetoe/link_layer.hpp>
+
+#include "connected.hpp"
+
+template < typename ... Options >
+struct connected_with_options : unconnected_base_t<
+    test::small_temperature_service,
+    test::radio,
+    Options... >
+{
+    connected_with_options()
+    {
+        this->respond_to( 37, valid_connection_request_pdu );
+    }
+};
+
+using large_buffers = connected_with_options<
+    bluetoe::link_layer::buffer_sizes< 300, 300 >,
+    bluetoe::link_layer::data_length_extension<> >;
+
+using small_buffers = connected_with_options<
+    bluetoe::link_layer::buffer_sizes< 61, 61 >,
+    bluetoe::link_layer::data_length_extension<> >;
+
+using limited_by_option = connected_with_options<
+    bluetoe::link_layer::buffer_sizes< 300, 300 >,
+    bluetoe::link_layer::data_length_extension< 100, 200 > >;
+
+template < typename ... Options >
+struct connected_with_2mbit : unconnected_base_t<
+    test::small_temperature_service,
+    test::radio_with_2mbit,
+    Options... >
+{
+    connected_with_2mbit()
+    {
+        this->respond_to( 37, valid_connection_request_pdu );
+    }
+};
+
+using large_buffers_with_2mbit = connected_with_2mbit<
+    bluetoe::link_layer::buffer_sizes< 300, 300 >,
+    bluetoe::link_layer::data_length_extension<> >;
+
+using without_data_length_extension = connected_with_options<
+    bluetoe::link_layer::buffer_sizes< 300, 300 > >;
+
+using test::X;
+
+BOOST_FIXTURE_TEST_SUITE( data_length_update_procedure, large_buffers )
+
+    BOOST_AUTO_TEST_CASE( feature_is_announced )
+    {
+        ll_control_pdu(
+            {
+                0x08,                    // LL_FEATURE_REQ
+                0xff, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00
+            } );
+
+        ll_empty_pdu();
+
+        run( 5 );
+
+        check_outgoing_ll_control_pdu(
+            {
+                0x09,                   // LL_FEATURE_RSP
+                0x36, X, X, X,
+                X, X, X, X
+            }
+        );
+    }
+
+    BOOST_AUTO_TEST_CASE( peripheral_requests_larger_pdus )
+    {
+        ll_empty_pdus( 3 );
+
+        run( 5 );
+
+        check_outgoing_ll_control_pdu(
+            {
+                0x14,                   // LL_LENGTH_REQ
+                0xFB, 0x00,             // MaxRxOctets
+                0x48, 0x08,             // MaxRxTime
+                0xFB, 0x00,             // MaxTxOctets
+                0x48, 0x08              // MaxTxTime
+            }
+        );
+    }
+
+    BOOST_AUTO_TEST_CASE( no_request_if_central_does_not_support_the_feature )
+    {
+        ll_control_pdu(
+            {
+                0x08,                    // LL_FEATURE_REQ
+                0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00
+            } );
+
+        ll_empty_pdus( 3 );
+
+        run( 5 );
+
+        check_connection_events( [&]( const test::connection_event& ev ) -> bool
+            {
+                for ( const auto& pdu : ev.transmitted_data )
+                {
+                    if ( pdu.data.size() > 2 && ( pdu.data[ 0 ] & 0x03 ) == 0x03 && pdu.data[ 2 ] == 0x14 )
+                        return false;
+                }
+
+                return true;
+            }, "no LL_LENGTH_REQ expected" );
+    }
+
+    BOOST_AUTO_TEST_CASE( respond_to_length_request )
+    {
+        ll_control_pdu(
+            {
+                0x14,                   // LL_LENGTH_REQ
+                0xFB, 0x00,             // MaxRxOctets
+                0x48, 0x08,             // MaxRxTime
+                0xFB, 0x00,             // MaxTxOctets
+                0x48, 0x08              // MaxTxTime
+            } );
+
+        ll_empty_pdu();
+
+        run( 5 );
+
+        check_outgoing_ll_control_pdu(
+            {
+                0x15,                   // LL_LENGTH_RSP
+                0xFB, 0x00,             // MaxRxOctets
+                0x48, 0x08,             // MaxRxTime
+                0xFB, 0x00,             // MaxTxOctets
+                0x48, 0x08              // MaxTxTime
+            }
+        );
+    }
+
+    BOOST_AUTO_TEST_CASE( default_lengths )
+    {
+        ll_function_call( [&]()
+        {
+            BOOST_CHECK_EQUAL( connection_max_tx_octets(), 27u );
+            BOOST_CHECK_EQUAL( connection_max_tx_time(), 328u );
+            BOOST_CHECK_EQUAL( connection_max_rx_octets(), 27u );
+            BOOST_CHECK_EQUAL( connection_max_rx_time(), 328u );
+            BOOST_CHECK_EQUAL( max_tx_size(), 29u );
+            BOOST_CHECK_EQUAL( max_rx_size(), 29u );
+        } );
+
+        run( 2 );
+    }
+
+    BOOST_AUTO_TEST_CASE( negotiated_lengths_are_applied )
+    {
+        ll_control_pdu(
+            {
+                0x14,                   // LL_LENGTH_REQ
+                0x64, 0x00,             // MaxRxOctets = 100
+                0x90, 0x03,             // MaxRxTime = 912
+                0xFB, 0x00,             // MaxTxOctets
+                0x48, 0x08              // MaxTxTime
+            } );
+
+        ll_empty_pdu();
+        ll_function_call( [&]()
+        {
+            BOOST_CHECK_EQUAL( connection_max_tx_octets(), 100u );
+            BOOST_CHECK_EQUAL( connection_max_tx_time(), 912u );
+            BOOST_CHECK_EQUAL( connection_max_rx_octets(), 251u );
+            BOOST_CHECK_EQUAL( connection_max_rx_time(), 2120u );
+            BOOST_CHECK_EQUAL( max_tx_size(), 102u );
+            BOOST_CHECK_EQUAL( max_rx_size(), 253u );
+        } );
+
+        run( 5 );
+    }
+
+    BOOST_AUTO_TEST_CASE( length_response_is_applied )
+    {
+        ll_control_pdu(
+            {
+                0x15,                   // LL_LENGTH_RSP
+                0x50, 0x00,             // MaxRxOctets = 80
+                0x48, 0x08,             // MaxRxTime
+                0x40, 0x00,             // MaxTxOctets = 64
+                0x48, 0x08              // MaxTxTime
+            } );
+
+        ll_empty_pdu();
+        ll_function_call( [&]()
+        {
+            BOOST_CHECK_EQUAL( connection_max_tx_octets(), 80u );
+            BOOST_CHECK_EQUAL( connection_max_rx_octets(), 64u );
+        } );
+
+        run( 5 );
+    }
+
+    BOOST_AUTO_TEST_CASE( tx_octets_are_limited_by_remote_rx_time )
+    {
+        ll_control_pdu(
+            {
+                0x14,                   // LL_LENGTH_REQ
+                0xFB, 0x00,             // MaxRxOctets
+                0xE8, 0x03,             // MaxRxTime = 1000µs
+                0xFB, 0x00,             // MaxTxOctets
+                0x48, 0x08              // MaxTxTime
+            } );
+
+        ll_empty_pdu();
+        ll_function_call( [&]()
+        {
+            BOOST_CHECK_EQUAL( connection_max_tx_octets(), 111u );
+            BOOST_CHECK_EQUAL( connection_max_tx_time(), 1000u );
+        } );
+
+        run( 5 );
+    }
+
+    BOOST_AUTO_TEST_CASE( invalid_values_are_treated_as_minimum )
+    {
+        ll_control_pdu(
+            {
+                0x14,                   // LL_LENGTH_REQ
+                0x10, 0x00,             // MaxRxOctets = 16
+                0x00, 0x01,             // MaxRxTime = 256µs
+                0xFB, 0x00,             // MaxTxOctets
+                0x48, 0x08              // MaxTxTime
+            } );
+
+        ll_empty_pdu();
+        ll_function_call( [&]()
+        {
+            BOOST_CHECK_EQUAL( connection_max_tx_octets(), 27u );
+            BOOST_CHECK_EQUAL( connection_max_tx_time(), 328u );
+        } );
+
+        run( 5 );
+    }
+
+    BOOST_AUTO_TEST_CASE( lengths_are_reset_with_a_new_connection )
+    {
+        ll_control_pdu(
+            {
+                0x14,                   // LL_LENGTH_REQ
+                0xFB, 0x00,             // MaxRxOctets
+                0x48, 0x08,             // MaxRxTime
+                0xFB, 0x00,             // MaxTxOctets
+                0x48, 0x08              // MaxTxTime
+            } );
+
+        ll_control_pdu(
+            {
+                0x02, 0x12              // LL_TERMINATE_IND
+            } );
+
+        run( 2 );
+
+        respond_to( 37, valid_connection_request_pdu );
+        ll_function_call( [&]()
+        {
+            BOOST_CHECK_EQUAL( connection_max_tx_octets(), 27u );
+            BOOST_CHECK_EQUAL( max_tx_size(), 29u );
+        } );
+
+        run( 2 );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_FIXTURE_TEST_CASE( supported_lengths_are_limited_by_buffer_sizes, small_buffers )
+{
+    ll_empty_pdus( 3 );
+
+    run( 5 );
+
+    check_outgoing_ll_control_pdu(
+        {
+            0x14,                   // LL_LENGTH_REQ
+            0x39, 0x00,             // MaxRxOctets = 61 - 2 (layout overhead) - 2 (header)
+            0x38, 0x02,             // MaxRxTime = 568µs
+            0x39, 0x00,             // MaxTxOctets = 57
+            0x38, 0x02              // MaxTxTime = 568µs
+        }
+    );
+}
+
+BOOST_FIXTURE_TEST_CASE( supported_lengths_are_limited_by_option, limited_by_option )
+{
+    ll_empty_pdus( 3 );
+
+    run( 5 );
+
+    check_outgoing_ll_control_pdu(
+        {
+            0x14,                   // LL_LENGTH_REQ
+            0xC8, 0x00,             // MaxRxOctets = 200
+            0xB0, 0x06,             // MaxRxTime = 1712µs
+            0x64, 0x00,             // MaxTxOctets = 100
+            0x90, 0x03              // MaxTxTime = 912µs
+        }
+    );
+}
+
+BOOST_FIXTURE_TEST_CASE( length_request_is_unknown_without_the_option, without_data_length_extension )
+{
+    ll_control_pdu(
+        {
+            0x14,                   // LL_LENGTH_REQ
+            0xFB, 0x00,             // MaxRxOctets
+            0x48, 0x08,             // MaxRxTime
+            0xFB, 0x00,             // MaxTxOctets
+            0x48, 0x08              // MaxTxTime
+        } );
+
+    ll_empty_pdu();
+
+    run( 5 );
+
+    check_outgoing_ll_control_pdu(
+        {
+            0x07,                   // LL_UNKNOWN_RSP
+            0x14                    // LL_LENGTH_REQ
+        }
+    );
+}
+
+BOOST_FIXTURE_TEST_CASE( lengths_are_recalculated_after_a_phy_update, large_buffers_with_2mbit )
+{
+    ll_control_pdu(
+        {
+            0x14,                   // LL_LENGTH_REQ
+            0xFB, 0x00,             // MaxRxOctets
+            0xE8, 0x03,             // MaxRxTime = 1000µs
+            0xFB, 0x00,             // MaxTxOctets
+            0xE8, 0x03              // MaxTxTime = 1000µs
+        } );
+
+    ll_control_pdu(
+        {
+            0x18,                   // LL_PHY_UPDATE_IND
+            0x02,                   // Central -> Peripheral: 2MBit
+            0x02,                   // Peripheral -> Central: 2MBit
+            0x04, 0x00              // Instance: 0x0004
+        } );
+
+    ll_function_call( [&]()
+    {
+        // LE 1M PHY: 1000µs / 8 - 14
+        BOOST_CHECK_EQUAL( connection_max_tx_octets(), 111u );
+        BOOST_CHECK_EQUAL( connection_max_rx_octets(), 111u );
+    } );
+
+    ll_empty_pdus( 3 );
+
+    ll_function_call( [&]()
+    {
+        // LE 2M PHY: 1000µs / 4 - 15
+        BOOST_CHECK_EQUAL( connection_max_tx_octets(), 235u );
+        BOOST_CHECK_EQUAL( connection_max_tx_time(), 1000u );
+        BOOST_CHECK_EQUAL( connection_max_rx_octets(), 235u );
+        BOOST_CHECK_EQUAL( connection_max_rx_time(), 1000u );
+        BOOST_CHECK_EQUAL( max_tx_size(), 237u );
+        BOOST_CHECK_EQUAL( max_rx_size(), 237u );
+    } );
+
+    run( 8 );
+}
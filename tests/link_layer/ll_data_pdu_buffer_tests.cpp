@@ -929,3 +929,86 @@ BOOST_AUTO_TEST_SUITE( packet_counter_tests )
     }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+/*
+ * With lock_free_pdu_buffers, the radio does not have to provide a lock_guard
+ */
+template < std::size_t TransmitSize, std::size_t ReceiveSize >
+struct lock_free_mock_radio : bluetoe::link_layer::ll_data_pdu_buffer<
+    TransmitSize, ReceiveSize, lock_free_mock_radio< TransmitSize, ReceiveSize >, bluetoe::link_layer::lock_free_pdu_buffers >
+{
+    void increment_receive_packet_counter() {}
+    void increment_transmit_packet_counter() {}
+};
+
+BOOST_AUTO_TEST_SUITE( lock_free_buffer_tests )
+
+    using lock_free_running_mode = running_mode_impl< 100, 100, lock_free_mock_radio >;
+
+    BOOST_AUTO_TEST_CASE( locked_by_default )
+    {
+        BOOST_CHECK( !buffer::lock_free );
+        BOOST_CHECK( lock_free_running_mode::lock_free );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( sequence_numbers_are_assigned_with_the_first_transmission, lock_free_running_mode )
+    {
+        transmit_pdu( { 1 } );
+        transmit_pdu( { 2 } );
+
+        auto first = next_transmit();
+        BOOST_CHECK_EQUAL( first.buffer[ 0 ] & 0x1f, 1 | 0x10 );
+        BOOST_CHECK_EQUAL( first.buffer[ 2 ], 1u );
+
+        // not acknowledged: retransmission with the same sequence number
+        receive_pdu( {}, false, false );
+        first = next_transmit();
+        BOOST_CHECK_EQUAL( first.buffer[ 0 ] & 0x1f, 1 | 0x10 | 0x04 );
+        BOOST_CHECK_EQUAL( first.buffer[ 2 ], 1u );
+
+        // acknowledged: next PDU with the next sequence number and without more data flag
+        receive_pdu( {}, true, true );
+        auto second = next_transmit();
+        BOOST_CHECK_EQUAL( second.buffer[ 0 ] & 0x1f, 1 | 0x08 );
+        BOOST_CHECK_EQUAL( second.buffer[ 2 ], 2u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( receiving_data, lock_free_running_mode )
+    {
+        receive_pdu( { 1, 2, 3 }, false, false );
+        receive_pdu( { 4, 5 }, true, false );
+
+        auto pdu = next_received();
+        BOOST_REQUIRE_EQUAL( pdu.buffer[ 1 ], 3u );
+        BOOST_CHECK_EQUAL( pdu.buffer[ 2 ], 1u );
+        free_received();
+
+        pdu = next_received();
+        BOOST_REQUIRE_EQUAL( pdu.buffer[ 1 ], 2u );
+        BOOST_CHECK_EQUAL( pdu.buffer[ 2 ], 4u );
+        free_received();
+
+        BOOST_CHECK_EQUAL( next_received().size, 0u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( transmit_buffer_wraps_around, lock_free_running_mode )
+    {
+        // every received PDU acknowledges the last transmitted PDU
+        bool sequence_number = false;
+
+        for ( std::uint8_t i = 0; i != 100; ++i )
+        {
+            transmit_pdu( { i, i, i, i, i, i, i, i, i, i, i, i, i, i, i, i, i, i, i, i } );
+            receive_pdu( {}, sequence_number, sequence_number );
+            sequence_number = !sequence_number;
+
+            const auto pdu = next_transmit();
+            BOOST_REQUIRE_EQUAL( pdu.buffer[ 1 ], 20u );
+            BOOST_REQUIRE_EQUAL( pdu.buffer[ 2 ], i );
+        }
+
+        receive_pdu( {}, sequence_number, sequence_number );
+        BOOST_CHECK( !pending_outgoing_data_available() );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
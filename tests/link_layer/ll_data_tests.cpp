@@ -32,3 +32,81 @@ BOOST_FIXTURE_TEST_CASE( response_to_att_request, unconnected )
 
     BOOST_CHECK_EQUAL_COLLECTIONS( std::begin( response ), std::end( response ), std::begin( expected_response ), std::end( expected_response ) );
 }
+
+namespace {
+    std::uint8_t long_value[ 60 ] = { 0 };
+
+    /*
+     * 0x0001 Service
+     * 0x0002 Characteristic declaration
+     * 0x0003 Characteristic value
+     */
+    using server_with_long_value = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x8C8B >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8C >,
+                bluetoe::bind_characteristic_value< decltype( long_value ), &long_value >,
+                bluetoe::no_write_access
+            >
+        >,
+        bluetoe::max_mtu_size< 100 >
+    >;
+
+    // the LL transmit buffer can not take all fragments of the read response at once
+    struct unconnected_with_long_value : unconnected_base_t< server_with_long_value, test::radio, bluetoe::link_layer::buffer_sizes< 61u, 105u > >
+    {
+        // the L2CAP payload of all LL data PDUs, the link layer transmitted
+        std::vector< std::uint8_t > transmitted_l2cap_data() const
+        {
+            std::vector< std::uint8_t > result;
+
+            for ( const auto& event : connection_events() )
+            {
+                for ( const auto& pdu : event.transmitted_data )
+                {
+                    const auto llid = pdu[ 0 ] & 0x03;
+
+                    if ( ( llid == 0x01 || llid == 0x02 ) && pdu.size() > 2 )
+                        result.insert( result.end(), pdu.begin() + 2, pdu.end() );
+                }
+            }
+
+            return result;
+        }
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( staged_sdu_is_sent_after_run, unconnected_with_long_value )
+{
+    respond_to( 37, valid_connection_request_pdu );
+    ll_data_pdu(
+        {
+            0x03, 0x00,         // length
+            0x04, 0x00,         // Channel
+            0x02, 0x64, 0x00    // Exchange MTU Request
+        } );
+    ll_empty_pdu();
+    ll_data_pdu(
+        {
+            0x03, 0x00,         // length
+            0x04, 0x00,         // Channel
+            0x0A, 0x03, 0x00    // Read Request
+        } );
+    ll_empty_pdus( 10 );
+
+    // after the end of the simulation, every call to run() simulates a single connection event
+    end_of_simulation( bluetoe::link_layer::delta_time::msec( 50 ) );
+    run( 10 );
+
+    std::vector< std::uint8_t > expected = {
+        0x03, 0x00, 0x04, 0x00, // l2cap header
+        0x03, 0x64, 0x00,       // Exchange MTU Response
+        0x3D, 0x00, 0x04, 0x00, // l2cap header
+        0x0B                    // Read Response
+    };
+    expected.insert( expected.end(), std::begin( long_value ), std::end( long_value ) );
+
+    const auto transmitted = transmitted_l2cap_data();
+    BOOST_CHECK_EQUAL_COLLECTIONS( transmitted.begin(), transmitted.end(), expected.begin(), expected.end() );
+}
@@ -424,3 +424,230 @@ BOOST_FIXTURE_TEST_CASE( pause_encryption, link_layer_with_encryption )
     BOOST_CHECK( !connection_events().at( 7 ).receive_encryption_at_start_of_event );
     BOOST_CHECK( !connection_events().at( 7 ).transmit_encryption_at_start_of_event );
 }
+
+/*
+ * A radio with the software_encryption and a central, that is simulated with the CCM directly. The connection
+ * is encrypted with the "start encryption" sample data from the core spec (Vol. 6; Part C; 1).
+ */
+struct link_layer_with_software_encryption : unconnected_base_t< test::secret_service, test::radio_with_software_encryption, test::security_manager, test::buffer_sizes >
+{
+    using ccm = bluetoe::link_layer::details::ll_ccm;
+
+    link_layer_with_software_encryption()
+    {
+        // LTK = 0x4C68384139F574D836BCF34E9DFB01BF in little endian
+        static const bluetoe::details::uint128_t long_term_key = { {
+            0xBF, 0x01, 0xFB, 0x9D,
+            0x4E, 0xF3, 0xBC, 0x36,
+            0xD8, 0x74, 0xF5, 0x39,
+            0x41, 0x38, 0x68, 0x4C
+        } };
+
+        respond_to( 37, valid_connection_request_pdu );
+        test::key_vault = std::make_pair( true, long_term_key );
+        setup_encryption_response( 0x0213243546576879, 0xDEAFBABE );
+
+        std::uint8_t session_key[ ccm::block_size ];
+        ccm::session_key( long_term_key.data(), 0xACBDCEDFE0F10213, 0x0213243546576879, session_key );
+        central_ = ccm( session_key, 0xDEAFBABEBADCAB24 );
+
+        ll_control_pdu({
+            0x03,                                   // LL_ENC_REQ
+            0x90, 0x78, 0x56, 0x34,                 // Rand
+            0x12, 0xef, 0xcd, 0xab,
+            0x74, 0x24,                             // EDIV
+            0x13, 0x02, 0xf1, 0xe0,                 // SKDm
+            0xdf, 0xce, 0xbd, 0xac,
+            0x24, 0xab, 0xdc, 0xba                  // IVm
+        });
+        ll_empty_pdu();
+
+        // LL_START_ENC_RSP, encrypted with packet counter 0
+        central_pdu( { 0x03, 0x05, 0x9F, 0xCD, 0xA7, 0xF4, 0x48 } );
+        ll_empty_pdu();
+    }
+
+    void central_pdu( const std::vector< std::uint8_t >& pdu )
+    {
+        add_connection_event_respond( test::connection_event_response( test::pdu_list_t( 1, test::pdu_t( pdu ) ) ) );
+        ll_empty_pdu();
+    }
+
+    std::vector< std::uint8_t > encrypted_l2cap_pdu( std::vector< std::uint8_t > payload, std::uint64_t packet_counter ) const
+    {
+        const std::size_t size = payload.size();
+
+        std::uint8_t stream[ ccm::max_key_stream_blocks * ccm::block_size ];
+        central_.key_stream( packet_counter, true, 0, ccm::key_stream_blocks( size ), stream );
+
+        payload.resize( size + ccm::mic_size );
+        central_.encrypt( 0x02, payload.data(), size, packet_counter, true, stream );
+
+        std::vector< std::uint8_t > pdu = { 0x02, static_cast< std::uint8_t >( payload.size() ) };
+        pdu.insert( pdu.end(), payload.begin(), payload.end() );
+
+        return pdu;
+    }
+
+    // all PDUs with payload, that where transmitted encrypted, without retransmissions
+    std::vector< test::pdu_t > encrypted_pdus() const
+    {
+        std::vector< test::pdu_t > result;
+
+        for ( const auto& event : connection_events() )
+        {
+            for ( const auto& pdu : event.transmitted_data )
+            {
+                if ( pdu.encrypted && pdu.size() > 2 && ( result.empty() || result.back().data != pdu.data ) )
+                    result.push_back( pdu );
+            }
+        }
+
+        return result;
+    }
+
+    std::vector< std::uint8_t > decrypt( const test::pdu_t& pdu, std::uint64_t packet_counter ) const
+    {
+        BOOST_REQUIRE_GE( pdu.size(), 2u + ccm::mic_size );
+
+        const std::size_t size = pdu.size() - 2 - ccm::mic_size;
+
+        std::uint8_t stream[ ccm::max_key_stream_blocks * ccm::block_size ];
+        central_.key_stream( packet_counter, false, 0, ccm::key_stream_blocks( size ), stream );
+
+        std::vector< std::uint8_t > payload( pdu.begin() + 2, pdu.end() );
+        BOOST_CHECK( central_.decrypt( pdu[ 0 ], payload.data(), size, packet_counter, false, stream ) );
+        payload.resize( size );
+
+        return payload;
+    }
+
+    ccm central_;
+};
+
+BOOST_FIXTURE_TEST_CASE( software_encryption_start_encryption_example, link_layer_with_software_encryption )
+{
+    run();
+
+    const auto pdus = encrypted_pdus();
+    BOOST_REQUIRE_EQUAL( pdus.size(), 1u );
+
+    // LL_START_ENC_RSP, encrypted with packet counter 0
+    static const std::uint8_t expected[] = { 0x05, 0xA3, 0x4C, 0x13, 0xA4, 0x15 };
+    BOOST_CHECK_EQUAL( pdus[ 0 ][ 0 ] & 0x03, 0x03 );
+    BOOST_CHECK_EQUAL_COLLECTIONS( pdus[ 0 ].begin() + 1, pdus[ 0 ].end(), std::begin( expected ), std::end( expected ) );
+
+    const auto payload = decrypt( pdus[ 0 ], 0 );
+    BOOST_CHECK( payload == std::vector< std::uint8_t >( { 0x06 } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( software_encryption_exchanges_encrypted_data, link_layer_with_software_encryption )
+{
+    test::secret_value = 0x1234;
+
+    // ATT Read Request for the secret value
+    central_pdu( encrypted_l2cap_pdu( { 0x03, 0x00, 0x04, 0x00, 0x0A, 0x03, 0x00 }, 1 ) );
+    central_pdu( encrypted_l2cap_pdu( { 0x03, 0x00, 0x04, 0x00, 0x0A, 0x03, 0x00 }, 2 ) );
+
+    run();
+
+    const auto pdus = encrypted_pdus();
+    BOOST_REQUIRE_EQUAL( pdus.size(), 3u );
+
+    const std::vector< std::uint8_t > expected = { 0x03, 0x00, 0x04, 0x00, 0x0B, 0x34, 0x12 };
+    BOOST_CHECK( decrypt( pdus[ 1 ], 1 ) == expected );
+    BOOST_CHECK( decrypt( pdus[ 2 ], 2 ) == expected );
+}
+
+BOOST_FIXTURE_TEST_CASE( software_encryption_pdu_with_mic_failure_is_not_handled, link_layer_with_software_encryption )
+{
+    test::secret_value = 0x1234;
+
+    auto corrupted = encrypted_l2cap_pdu( { 0x03, 0x00, 0x04, 0x00, 0x0A, 0x03, 0x00 }, 1 );
+    corrupted.back() ^= 0x01;
+
+    central_pdu( corrupted );
+    central_pdu( encrypted_l2cap_pdu( { 0x03, 0x00, 0x04, 0x00, 0x0A, 0x03, 0x00 }, 1 ) );
+
+    run();
+
+    const auto pdus = encrypted_pdus();
+    BOOST_REQUIRE_EQUAL( pdus.size(), 2u );
+    BOOST_CHECK( decrypt( pdus[ 1 ], 1 ) == std::vector< std::uint8_t >( { 0x03, 0x00, 0x04, 0x00, 0x0B, 0x34, 0x12 } ) );
+}
+
+namespace test {
+    unsigned    precomputed_key_pairs;
+    bool        pairing_running;
+
+    /**
+     * The mocked security manager, with a pool of ECDH key pairs, that counts the
+     * key pairs, the link layer asks to precompute.
+     */
+    struct key_pool_security_manager
+    {
+        template < typename ... Options >
+        class impl : public security_manager::impl< Options... >
+        {
+        public:
+            bool precompute_security_keys()
+            {
+                ++precomputed_key_pairs;
+
+                return true;
+            }
+
+            template < class Connection >
+            bool pairing_in_progress( const Connection& ) const
+            {
+                return pairing_running;
+            }
+        };
+
+        struct meta_type :
+            bluetoe::details::security_manager_meta_type,
+            bluetoe::link_layer::details::valid_link_layer_option_meta_type {};
+    };
+}
+
+struct link_layer_with_key_pool : unconnected_base_t< test::secret_service, test::radio_with_encryption,
+    test::key_pool_security_manager, bluetoe::ecdh_key_pool< 1 >, test::buffer_sizes >
+{
+    link_layer_with_key_pool()
+    {
+        test::precomputed_key_pairs = 0;
+        test::pairing_running       = false;
+
+        respond_to( 37, valid_connection_request_pdu );
+        end_of_simulation( bluetoe::link_layer::delta_time::msec( 500 ) );
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE( key_pairs_are_precomputed_in_an_idle_connection, link_layer_with_key_pool )
+{
+    add_empty_pdus( 50 );
+    run( 2 );
+
+    BOOST_CHECK_EQUAL( test::precomputed_key_pairs, 2u );
+}
+
+BOOST_FIXTURE_TEST_CASE( no_key_pairs_are_precomputed_while_pairing, link_layer_with_key_pool )
+{
+    test::pairing_running = true;
+
+    add_empty_pdus( 50 );
+    run( 2 );
+
+    BOOST_CHECK_EQUAL( test::precomputed_key_pairs, 0u );
+}
+
+BOOST_FIXTURE_TEST_CASE( no_key_pairs_are_precomputed_while_a_control_procedure_is_pending, link_layer_with_key_pool )
+{
+    // the instant of the connection update is not reached during the simulation
+    add_connection_update_request( 5, 6, 40, 1, 200, 0x1000 );
+    add_empty_pdus( 50 );
+
+    run( 2 );
+
+    BOOST_CHECK_EQUAL( test::precomputed_key_pairs, 0u );
+}
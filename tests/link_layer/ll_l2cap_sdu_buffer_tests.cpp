@@ -5,6 +5,7 @@
 
 #include "test_layout.hpp"
 
+#include <algorithm>
 #include <initializer_list>
 
 using namespace boost::test_tools;
@@ -15,11 +16,14 @@ namespace {
     public:
         radio_mock_t()
             : available_transmit_buffers_( 0 )
+            , max_tx_size_( 29 )
         {
         }
 
         static constexpr std::size_t header_size = 2;
         static constexpr std::size_t layout_overhead = 1;
+        static constexpr std::size_t min_buffer_size = 29;
+        static constexpr std::size_t transmit_size = 256;
 
         using layout = test::layout_with_overhead< layout_overhead >;
 
@@ -67,6 +71,11 @@ namespace {
             received_pdus_.push_back( pdu_t{ incomming_pdu.begin(), incomming_pdu.end() } );
         }
 
+        void add_received_pdu( const std::vector< std::uint8_t >& incomming_pdu )
+        {
+            received_pdus_.push_back( incomming_pdu );
+        }
+
         bool receive_buffer_empty() const
         {
             return received_pdus_.empty();
@@ -79,7 +88,12 @@ namespace {
 
         std::size_t max_tx_size() const
         {
-            return 29 + layout_overhead;
+            return max_tx_size_;
+        }
+
+        void max_tx_size( std::size_t size )
+        {
+            max_tx_size_ = size;
         }
 
         std::vector< std::uint8_t > next_transmitted_pdu()
@@ -103,16 +117,18 @@ namespace {
         using pdu_t = std::vector< std::uint8_t >;
         std::vector< pdu_t > received_pdus_;
         std::size_t          available_transmit_buffers_;
+        std::size_t          max_tx_size_;
         std::vector< pdu_t > tranmitted_pdus_;
-        std::uint8_t         transmit_buffer_[256];
+        std::uint8_t         transmit_buffer_[ transmit_size ];
     };
 
-    class buffer_under_test : public bluetoe::link_layer::ll_l2cap_sdu_buffer< radio_mock_t, 100 >
+    template < typename ... Options >
+    class buffer_under_test_impl : public bluetoe::link_layer::ll_l2cap_sdu_buffer< radio_mock_t, 100, Options... >
     {
     public:
         void expect_next_received( std::initializer_list< std::uint8_t > expected )
         {
-            const auto received = next_ll_l2cap_received();
+            const auto received = this->next_ll_l2cap_received();
 
             if ( received.size == 0 || received.buffer == nullptr || expected.size() == 0 )
             {
@@ -128,9 +144,13 @@ namespace {
 
         void write_l2cap_size( bluetoe::link_layer::read_buffer buffer, std::size_t size )
         {
-            bluetoe::details::write_16bit( layout::body( buffer ).first, size );
+            bluetoe::details::write_16bit( radio_mock_t::layout::body( buffer ).first, size );
         }
     };
+
+    using buffer_under_test = buffer_under_test_impl<>;
+    using in_place_buffer_under_test = buffer_under_test_impl< bluetoe::link_layer::in_place_l2cap_fragmentation >;
+    using queued_buffer_under_test = buffer_under_test_impl< bluetoe::link_layer::l2cap_transmit_queue< 2 > >;
 }
 
 // All Tests are done with a layout that has an extra byte between header and body
@@ -354,6 +374,67 @@ BOOST_AUTO_TEST_SUITE( receive_buffer_for_mtu_size_larger_than_23_bytes )
         expect_next_received( {} );
 
     }
+
+    // with the data length extension, a central can send LL PDUs with up to 251 bytes of payload
+    std::vector< std::uint8_t > large_ll_pdu( std::uint8_t llid, std::initializer_list< std::uint8_t > body_start )
+    {
+        std::vector< std::uint8_t > pdu = { llid, 0xfb, 0xaa };
+        pdu.insert( pdu.end(), body_start.begin(), body_start.end() );
+        pdu.resize( 251 + 3, 0x55 );
+
+        return pdu;
+    }
+
+    BOOST_FIXTURE_TEST_CASE( continuation_pdu_without_start_pdu_is_dropped, buffer_under_test )
+    {
+        add_received_pdu( large_ll_pdu( 0x01, {} ) );
+        add_received_pdu( { 0x03, 0x03, 0xaa, 0x01, 0x02, 0x03 } );
+
+        expect_next_received( { 0x03, 0x03, 0xaa, 0x01, 0x02, 0x03 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( oversized_continuation_pdu, buffer_under_test )
+    {
+        add_received_pdu(
+            {
+                0x02, 0x1D, 0xaa, 0x18, 0x00, 0x04, 0x00,       // Header: L2CAP length 24
+                0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, // 23 bytes of data
+                0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+                0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27
+            }
+        );
+
+        // 251 bytes, where only a single byte remains of the SDU
+        add_received_pdu( large_ll_pdu( 0x01, { 0x28 } ) );
+
+        expect_next_received(
+            {
+                0x02, 0x1D, 0xaa, 0x18, 0x00, 0x04, 0x00,       // Header: L2CAP length 24
+                0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, // 24 bytes of data
+                0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+                0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28
+            }
+        );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( oversized_start_pdu_is_dropped, buffer_under_test )
+    {
+        // L2CAP length 24 in a start fragment with 247 bytes of L2CAP payload
+        add_received_pdu( large_ll_pdu( 0x02, { 0x18, 0x00, 0x04, 0x00 } ) );
+        add_received_pdu( { 0x01, 0x01, 0xaa, 0x28 } );
+        add_received_pdu( { 0x03, 0x03, 0xaa, 0x01, 0x02, 0x03 } );
+
+        expect_next_received( { 0x03, 0x03, 0xaa, 0x01, 0x02, 0x03 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( start_pdu_abandons_incomplete_sdu, buffer_under_test )
+    {
+        add_received_pdu( { 0x02, 0x0b, 0xaa, 0x18, 0x00, 0x04, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 } );
+        add_received_pdu( { 0x02, 0x08, 0xaa, 0x05, 0x00, 0x04, 0x00, 0x11, 0x12, 0x13 } );
+        add_received_pdu( { 0x01, 0x02, 0xaa, 0x14, 0x15 } );
+
+        expect_next_received( { 0x02, 0x08, 0xaa, 0x05, 0x00, 0x04, 0x00, 0x11, 0x12, 0x13, 0x14, 0x15 } );
+    }
 BOOST_AUTO_TEST_SUITE_END()
 
 // All Tests are done with a layout that has an extra byte between header and body
@@ -537,6 +618,50 @@ BOOST_AUTO_TEST_SUITE( transmit_l2cap_sdus )
         }), per_element() );
     }
 
+
+    BOOST_FIXTURE_TEST_CASE( fragmented_sdu_with_larger_ll_pdus, buffer_under_test )
+    {
+        // LL header + 60 bytes payload, as negotiated by the data length update procedure
+        max_tx_size( 62 );
+        add_free_ll_pdus(2);
+        const auto buffer = allocate_l2cap_transmit_buffer( 100 );
+        BOOST_REQUIRE( buffer.size == 107);
+
+        fill_buffer( buffer, {
+            0x00, 0x00, 0x00,
+            0x48, 0x00, 0x04, 0x00,
+            0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+            0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+            0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27,
+            0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+            0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+            0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57,
+            0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67,
+            0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77,
+            0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87
+        } );
+
+        commit_l2cap_transmit_buffer( buffer );
+
+        BOOST_TEST( next_transmitted_pdu() == std::vector< std::uint8_t >({
+            0x02, 0x3C, 0x00,
+            0x48, 0x00, 0x04, 0x00,
+            0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+            0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+            0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27,
+            0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+            0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+            0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57,
+            0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67
+        }), per_element() );
+
+        BOOST_TEST( next_transmitted_pdu() == std::vector< std::uint8_t >({
+            0x01, 0x10, 0x00,
+            0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77,
+            0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87
+        }), per_element() );
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE( transmit_ll_pdus )
@@ -559,3 +684,192 @@ BOOST_AUTO_TEST_SUITE( transmit_ll_pdus )
     }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( transmit_l2cap_sdus_in_place )
+
+    BOOST_AUTO_TEST_CASE( buffered_by_default )
+    {
+        BOOST_CHECK( !buffer_under_test::in_place_fragmentation );
+        BOOST_CHECK( in_place_buffer_under_test::in_place_fragmentation );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( no_free_ll_pdu_no_l2cap_buffer, in_place_buffer_under_test )
+    {
+        BOOST_CHECK_EQUAL( allocate_l2cap_transmit_buffer( 50 ).size, 0u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( room_for_all_ll_headers_is_reserved, in_place_buffer_under_test )
+    {
+        // 104 bytes SDU in 4 fragments of 27 bytes
+        add_free_ll_pdus(1);
+        const auto buffer = allocate_l2cap_transmit_buffer( 100 );
+
+        BOOST_CHECK_EQUAL( buffer.size, 100u + 4u + 3u );
+        BOOST_CHECK_EQUAL( buffer.buffer, allocate_transmit_buffer( 0 ).buffer + 3 * 3 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( unfragmented_sdu_is_written_into_the_ll_pdu, in_place_buffer_under_test )
+    {
+        add_free_ll_pdus(1);
+        const auto buffer = allocate_l2cap_transmit_buffer( 23 );
+        BOOST_REQUIRE( buffer.size == 30 );
+        BOOST_CHECK_EQUAL( buffer.buffer, allocate_transmit_buffer( 0 ).buffer );
+
+        fill_buffer( buffer, {
+            0x00, 0x00, 0x00,
+            0x08, 0x00, 0x04, 0x00,
+            0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07
+        } );
+
+        commit_l2cap_transmit_buffer( buffer );
+
+        BOOST_TEST( next_transmitted_pdu() == std::vector< std::uint8_t >({
+            0x02, 0x0C, 0x00,
+            0x08, 0x00, 0x04, 0x00,
+            0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07
+        }), per_element() );
+
+        BOOST_TEST( next_transmitted_pdu() == std::vector< std::uint8_t >());
+    }
+
+    BOOST_FIXTURE_TEST_CASE( fragmented_sdu, in_place_buffer_under_test )
+    {
+        add_free_ll_pdus(3);
+        const auto buffer = allocate_l2cap_transmit_buffer( 100 );
+        BOOST_REQUIRE( buffer.size == 107);
+
+        fill_buffer( buffer, {
+            0x00, 0x00, 0x00,
+            0x48, 0x00, 0x04, 0x00,
+            0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+            0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+            0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27,
+            0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+            0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+            0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57,
+            0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67,
+            0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77,
+            0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87
+        } );
+
+        // the SDU is only 76 bytes long and thus requires only 3 of the 4 reserved fragments
+        commit_l2cap_transmit_buffer( buffer );
+
+        BOOST_TEST( next_transmitted_pdu() == std::vector< std::uint8_t >({
+            0x02, 0x1B, 0x00,
+            0x48, 0x00, 0x04, 0x00,
+            0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+            0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+            0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26
+        }), per_element() );
+
+        BOOST_TEST( next_transmitted_pdu() == std::vector< std::uint8_t >({
+            0x01, 0x1B, 0x00,
+                                                      0x27,
+            0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+            0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+            0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57,
+            0x60, 0x61
+        }), per_element() );
+
+        BOOST_TEST( next_transmitted_pdu() == std::vector< std::uint8_t >({
+            0x01, 0x16, 0x00,
+                        0x62, 0x63, 0x64, 0x65, 0x66, 0x67,
+            0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77,
+            0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87
+        }), per_element() );
+
+        BOOST_TEST( next_transmitted_pdu() == std::vector< std::uint8_t >());
+    }
+
+    BOOST_FIXTURE_TEST_CASE( large_ll_pdus_avoid_fragmentation, in_place_buffer_under_test )
+    {
+        // LL header + 104 bytes payload: the whole SDU fits into a single LL PDU and is not moved
+        max_tx_size( 106 );
+        add_free_ll_pdus(1);
+        const auto buffer = allocate_l2cap_transmit_buffer( 100 );
+        BOOST_REQUIRE( buffer.size == 107);
+        BOOST_CHECK_EQUAL( buffer.buffer, allocate_transmit_buffer( 0 ).buffer );
+
+        write_l2cap_size( buffer, 100 );
+        commit_l2cap_transmit_buffer( buffer );
+
+        const auto pdu = next_transmitted_pdu();
+        BOOST_REQUIRE_EQUAL( pdu.size(), 107u );
+        BOOST_CHECK_EQUAL( pdu[ 0 ], 0x02 );
+        BOOST_CHECK_EQUAL( pdu[ 1 ], 104 );
+
+        BOOST_TEST( next_transmitted_pdu() == std::vector< std::uint8_t >());
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( transmit_l2cap_sdu_queue )
+
+    BOOST_AUTO_TEST_CASE( one_sdu_by_default )
+    {
+        BOOST_CHECK_EQUAL( buffer_under_test::transmit_queue_depth, 1u );
+        BOOST_CHECK_EQUAL( queued_buffer_under_test::transmit_queue_depth, 2u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( sdus_are_staged_until_the_queue_is_full, queued_buffer_under_test )
+    {
+        const auto first = allocate_l2cap_transmit_buffer( 100 );
+        BOOST_REQUIRE_EQUAL( first.size, 107u );
+        write_l2cap_size( first, 100 );
+        commit_l2cap_transmit_buffer( first );
+
+        const auto second = allocate_l2cap_transmit_buffer( 100 );
+        BOOST_REQUIRE_EQUAL( second.size, 107u );
+        BOOST_CHECK( second.buffer != first.buffer );
+        write_l2cap_size( second, 100 );
+        commit_l2cap_transmit_buffer( second );
+
+        BOOST_CHECK_EQUAL( allocate_l2cap_transmit_buffer( 23 ).size, 0u );
+
+        // 3 of 4 fragments of the first SDU
+        add_free_ll_pdus( 3 );
+        commit_pending_l2cap_transmit_buffers();
+        BOOST_CHECK_EQUAL( allocate_l2cap_transmit_buffer( 23 ).size, 0u );
+
+        // last fragment of the first SDU
+        add_free_ll_pdus( 1 );
+        commit_pending_l2cap_transmit_buffers();
+        BOOST_CHECK_EQUAL( allocate_l2cap_transmit_buffer( 23 ).size, 30u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( staged_sdus_are_transmitted_in_order, queued_buffer_under_test )
+    {
+        for ( std::uint8_t value : { 0x11, 0x22 } )
+        {
+            const auto buffer = allocate_l2cap_transmit_buffer( 30 );
+            BOOST_REQUIRE_EQUAL( buffer.size, 37u );
+            std::fill( buffer.buffer, buffer.buffer + buffer.size, value );
+            write_l2cap_size( buffer, 30 );
+            commit_l2cap_transmit_buffer( buffer );
+        }
+
+        add_free_ll_pdus( 4 );
+        commit_pending_l2cap_transmit_buffers();
+
+        for ( std::uint8_t value : { 0x11, 0x22 } )
+        {
+            BOOST_TEST( next_transmitted_pdu() == std::vector< std::uint8_t >({
+                0x02, 0x1B, value,
+                0x1E, 0x00, value, value,
+                value, value, value, value, value, value, value, value,
+                value, value, value, value, value, value, value, value,
+                value, value, value, value, value, value, value
+            }), per_element() );
+
+            const auto continuation = next_transmitted_pdu();
+            BOOST_REQUIRE_EQUAL( continuation.size(), 10u );
+            BOOST_CHECK_EQUAL( continuation[ 0 ], 0x01 );
+            BOOST_CHECK_EQUAL( continuation[ 1 ], 0x07 );
+            BOOST_CHECK( std::all_of( continuation.begin() + 3, continuation.end(), [value]( std::uint8_t b ){ return b == value; } ) );
+        }
+
+        BOOST_TEST( next_transmitted_pdu() == std::vector< std::uint8_t >());
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
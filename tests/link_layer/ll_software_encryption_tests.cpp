@@ -0,0 +1,303 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <bluetoe/software_encryption.hpp>
+#include <bluetoe/default_pdu_layout.hpp>
+
+#include "test_radio.hpp"
+
+#include <array>
+#include <vector>
+
+namespace {
+    using block = std::array< std::uint8_t, 16 >;
+    using pdu_t = std::vector< std::uint8_t >;
+
+    // Core Spec Vol 6, Part C, 1: Encryption sample data (little endian)
+    const block long_term_key = {{
+        0xBF, 0x01, 0xFB, 0x9D, 0x4E, 0xF3, 0xBC, 0x36,
+        0xD8, 0x74, 0xF5, 0x39, 0x41, 0x38, 0x68, 0x4C
+    }};
+
+    const std::uint64_t skdm = 0xACBDCEDFE0F10213;
+    const std::uint64_t skds = 0x0213243546576879;
+    const std::uint32_t ivm  = 0xBADCAB24;
+    const std::uint32_t ivs  = 0xDEAFBABE;
+
+    const std::uint64_t iv   = static_cast< std::uint64_t >( ivm ) | ( static_cast< std::uint64_t >( ivs ) << 32 );
+
+    template < class Layout >
+    struct peripheral : bluetoe::link_layer::software_encryption< Layout >
+    {
+        peripheral()
+        {
+            const auto response = this->setup_session( long_term_key.data(), skdm, ivm, skds, ivs );
+
+            BOOST_CHECK_EQUAL( response.first, skds );
+            BOOST_CHECK_EQUAL( response.second, ivs );
+        }
+
+        pdu_t transmit( const pdu_t& pdu )
+        {
+            std::uint8_t encrypted[ Layout::data_channel_pdu_memory_size( 251 + 4 ) ];
+
+            const auto result = this->encrypt(
+                bluetoe::link_layer::write_buffer{ pdu.data(), pdu.size() },
+                bluetoe::link_layer::read_buffer{ encrypted, sizeof( encrypted ) } );
+
+            return pdu_t( result.buffer, result.buffer + result.size );
+        }
+
+        bool receive( pdu_t& pdu )
+        {
+            const bool result = this->decrypt( bluetoe::link_layer::read_buffer{ pdu.data(), pdu.size() } );
+            pdu.resize( Layout::data_channel_pdu_memory_size( Layout::header( pdu.data() ) >> 8 ) );
+
+            return result;
+        }
+    };
+
+    struct encrypted_peripheral : peripheral< bluetoe::link_layer::default_pdu_layout >
+    {
+        encrypted_peripheral()
+        {
+            start_receive_encrypted();
+            start_transmit_encrypted();
+        }
+    };
+
+    // LL_START_ENC_RSP with counter 0 in both directions
+    const pdu_t start_enc_rsp_central               = { 0x0F, 0x01, 0x06 };
+    const pdu_t encrypted_start_enc_rsp_central     = { 0x0F, 0x05, 0x9F, 0xCD, 0xA7, 0xF4, 0x48 };
+    const pdu_t start_enc_rsp_peripheral            = { 0x07, 0x01, 0x06 };
+    const pdu_t encrypted_start_enc_rsp_peripheral  = { 0x07, 0x05, 0xA3, 0x4C, 0x13, 0xA4, 0x15 };
+
+    pdu_t large_pdu( std::size_t size )
+    {
+        pdu_t result = { 0x02, static_cast< std::uint8_t >( size ) };
+
+        for ( std::size_t i = 0; i != size; ++i )
+            result.push_back( static_cast< std::uint8_t >( i * 7 ) );
+
+        return result;
+    }
+}
+
+BOOST_AUTO_TEST_CASE( session_key_derivation )
+{
+    static const block expected = {{
+        0x66, 0xC6, 0xC2, 0x27, 0x8E, 0x3B, 0x8E, 0x05,
+        0x3E, 0x7E, 0xA3, 0x26, 0x52, 0x1B, 0xAD, 0x99
+    }};
+
+    block key;
+    bluetoe::link_layer::details::ll_ccm::session_key( long_term_key.data(), skdm, skds, key.data() );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( key.begin(), key.end(), expected.begin(), expected.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( encrypt_sample_data, encrypted_peripheral )
+{
+    const pdu_t pdu = transmit( start_enc_rsp_peripheral );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( pdu.begin(), pdu.end(), encrypted_start_enc_rsp_peripheral.begin(), encrypted_start_enc_rsp_peripheral.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( decrypt_sample_data, encrypted_peripheral )
+{
+    pdu_t pdu = encrypted_start_enc_rsp_central;
+
+    BOOST_CHECK( receive( pdu ) );
+    BOOST_CHECK_EQUAL_COLLECTIONS( pdu.begin(), pdu.end(), start_enc_rsp_central.begin(), start_enc_rsp_central.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( transmitted_pdu_is_not_changed, encrypted_peripheral )
+{
+    const pdu_t original = large_pdu( 100 );
+    pdu_t       pdu      = original;
+
+    const pdu_t first  = transmit( pdu );
+    const pdu_t second = transmit( pdu );
+
+    BOOST_CHECK( pdu == original );
+    BOOST_CHECK( first == second );
+    BOOST_CHECK_EQUAL( first.size(), original.size() + 4 );
+}
+
+BOOST_FIXTURE_TEST_CASE( empty_pdus_are_not_encrypted, encrypted_peripheral )
+{
+    const pdu_t empty = { 0x05, 0x00 };
+
+    BOOST_CHECK( transmit( empty ) == empty );
+
+    pdu_t received = empty;
+    BOOST_CHECK( receive( received ) );
+    BOOST_CHECK( received == empty );
+}
+
+BOOST_FIXTURE_TEST_CASE( no_encryption_before_started, peripheral< bluetoe::link_layer::default_pdu_layout > )
+{
+    BOOST_CHECK( transmit( start_enc_rsp_peripheral ) == start_enc_rsp_peripheral );
+
+    start_transmit_encrypted();
+    BOOST_CHECK( transmit( start_enc_rsp_peripheral ) == encrypted_start_enc_rsp_peripheral );
+
+    pdu_t pdu = start_enc_rsp_central;
+    BOOST_CHECK( receive( pdu ) );
+    BOOST_CHECK( pdu == start_enc_rsp_central );
+
+    stop_transmit_encrypted();
+    BOOST_CHECK( transmit( start_enc_rsp_peripheral ) == start_enc_rsp_peripheral );
+}
+
+BOOST_FIXTURE_TEST_CASE( modified_pdu_fails_mic_check, encrypted_peripheral )
+{
+    pdu_t pdu = encrypted_start_enc_rsp_central;
+    pdu[ 2 ] ^= 0x01;
+
+    BOOST_CHECK( !receive( pdu ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( modified_header_fails_mic_check, encrypted_peripheral )
+{
+    // LLID is authenticated
+    pdu_t pdu = encrypted_start_enc_rsp_central;
+    pdu[ 0 ] = 0x0E;
+
+    BOOST_CHECK( !receive( pdu ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( sequence_numbers_and_more_data_are_not_authenticated, encrypted_peripheral )
+{
+    pdu_t pdu = encrypted_start_enc_rsp_central;
+    pdu[ 0 ] = 0x13;
+
+    BOOST_CHECK( receive( pdu ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( packet_counter_is_part_of_the_nonce, encrypted_peripheral )
+{
+    increment_receive_packet_counter();
+    increment_transmit_packet_counter();
+
+    pdu_t pdu = encrypted_start_enc_rsp_central;
+    BOOST_CHECK( !receive( pdu ) );
+
+    BOOST_CHECK( transmit( start_enc_rsp_peripheral ) != encrypted_start_enc_rsp_peripheral );
+}
+
+BOOST_FIXTURE_TEST_CASE( new_session_resets_packet_counters, encrypted_peripheral )
+{
+    increment_receive_packet_counter();
+    increment_transmit_packet_counter();
+    setup_session( long_term_key.data(), skdm, ivm, skds, ivs );
+
+    pdu_t pdu = encrypted_start_enc_rsp_central;
+    BOOST_CHECK( receive( pdu ) );
+    BOOST_CHECK( transmit( start_enc_rsp_peripheral ) == encrypted_start_enc_rsp_peripheral );
+}
+
+BOOST_AUTO_TEST_CASE( prepared_key_stream_gives_same_result )
+{
+    encrypted_peripheral on_demand;
+    encrypted_peripheral prepared;
+
+    for ( std::size_t size = 1; size <= 251; size += 25 )
+    {
+        prepared.prepare( 10, 251 );
+
+        const pdu_t pdu = large_pdu( size );
+        BOOST_CHECK( on_demand.transmit( pdu ) == prepared.transmit( pdu ) );
+
+        on_demand.increment_transmit_packet_counter();
+        prepared.increment_transmit_packet_counter();
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE( maximum_payload_size, encrypted_peripheral )
+{
+    const pdu_t original = large_pdu( 251 );
+    const pdu_t pdu      = transmit( original );
+
+    BOOST_REQUIRE_EQUAL( pdu.size(), 2u + 251u + 4u );
+    BOOST_CHECK_EQUAL( pdu[ 1 ], 255 );
+
+    // peripheral -> central
+    using ccm = bluetoe::link_layer::details::ll_ccm;
+
+    block session_key;
+    ccm::session_key( long_term_key.data(), skdm, skds, session_key.data() );
+    const ccm central( session_key.data(), iv );
+
+    std::uint8_t stream[ ccm::max_key_stream_blocks * ccm::block_size ];
+    central.key_stream( 0, false, 0, ccm::key_stream_blocks( 251 ), stream );
+
+    pdu_t payload( pdu.begin() + 2, pdu.end() );
+    BOOST_CHECK( central.decrypt( pdu[ 0 ], payload.data(), 251, 0, false, stream ) );
+    BOOST_CHECK( std::equal( original.begin() + 2, original.end(), payload.begin() ) );
+
+    // central -> peripheral
+    central.key_stream( 0, true, 0, ccm::key_stream_blocks( 251 ), stream );
+
+    pdu_t received = { 0x02, 255 };
+    received.insert( received.end(), original.begin() + 2, original.end() );
+    received.resize( 2 + 255 );
+    central.encrypt( 0x02, received.data() + 2, 251, 0, true, stream );
+
+    BOOST_CHECK( receive( received ) );
+    BOOST_CHECK( received == original );
+}
+
+/*
+ * The central side is simulated with the CCM directly
+ */
+BOOST_FIXTURE_TEST_CASE( exchange_large_pdus_with_test_layout, peripheral< test::pdu_layout > )
+{
+    using layout = test::pdu_layout;
+    using ccm    = bluetoe::link_layer::details::ll_ccm;
+
+    block session_key;
+    ccm::session_key( long_term_key.data(), skdm, skds, session_key.data() );
+    const ccm central( session_key.data(), iv );
+
+    start_receive_encrypted();
+    start_transmit_encrypted();
+
+    for ( std::uint64_t counter = 0; counter != 3; ++counter )
+    {
+        const std::size_t size = 249 + counter;
+        const pdu_t       data = large_pdu( size );
+
+        std::uint8_t stream[ ccm::max_key_stream_blocks * ccm::block_size ];
+        central.key_stream( counter, true, 0, ccm::key_stream_blocks( size ), stream );
+
+        // central -> peripheral
+        pdu_t received( layout::data_channel_pdu_memory_size( size + ccm::mic_size ) );
+        layout::header( received.data(), static_cast< std::uint16_t >( 0x02 | ( ( size + ccm::mic_size ) << 8 ) ) );
+        std::copy( data.begin() + 2, data.end(), layout::body( bluetoe::link_layer::read_buffer{ received.data(), received.size() } ).first );
+        central.encrypt( 0x02, layout::body( bluetoe::link_layer::read_buffer{ received.data(), received.size() } ).first, size, counter, true, stream );
+
+        BOOST_CHECK( receive( received ) );
+        BOOST_CHECK_EQUAL( layout::header( received.data() ), 0x02 | ( size << 8 ) );
+
+        const auto body = layout::body( bluetoe::link_layer::read_buffer{ received.data(), received.size() } );
+        BOOST_CHECK_EQUAL_COLLECTIONS( body.first, body.second, data.begin() + 2, data.end() );
+
+        // peripheral -> central
+        pdu_t transmitted( layout::data_channel_pdu_memory_size( size ) );
+        layout::header( transmitted.data(), static_cast< std::uint16_t >( 0x02 | ( size << 8 ) ) );
+        std::copy( data.begin() + 2, data.end(), layout::body( bluetoe::link_layer::read_buffer{ transmitted.data(), transmitted.size() } ).first );
+
+        pdu_t encrypted = transmit( transmitted );
+        BOOST_CHECK_EQUAL( layout::header( encrypted.data() ), 0x02 | ( ( size + ccm::mic_size ) << 8 ) );
+
+        central.key_stream( counter, false, 0, ccm::key_stream_blocks( size ), stream );
+        const auto payload = layout::body( bluetoe::link_layer::read_buffer{ encrypted.data(), encrypted.size() } ).first;
+
+        BOOST_CHECK( central.decrypt( 0x02, payload, size, counter, false, stream ) );
+        BOOST_CHECK_EQUAL_COLLECTIONS( payload, payload + size, data.begin() + 2, data.end() );
+
+        increment_receive_packet_counter();
+        increment_transmit_packet_counter();
+    }
+}
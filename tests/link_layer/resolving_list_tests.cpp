@@ -0,0 +1,332 @@
+#include <bluetoe/resolving_list.hpp>
+#include <bluetoe/white_list.hpp>
+
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <array>
+#include <vector>
+#include <algorithm>
+
+using irk_t = bluetoe::details::identity_resolving_key_t;
+
+// Core Spec Vol 3, Part H, D.7: ah( irk, 0x708194 ) = 0x0dfbaa; IRK least significant octet first
+const irk_t sample_irk = {{
+    0x9b, 0x7d, 0x39, 0x0a, 0xa6, 0x10, 0x10, 0x34,
+    0x05, 0xad, 0xc8, 0x57, 0xa3, 0x34, 0x02, 0xec
+}};
+
+const bluetoe::link_layer::random_device_address sample_rpa( { 0xaa, 0xfb, 0x0d, 0x94, 0x81, 0x70 } );
+
+bluetoe::link_layer::public_device_address identity1( { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 } );
+bluetoe::link_layer::random_device_address identity2( { 0x01, 0x02, 0x03, 0x04, 0x05, 0xc6 } );
+bluetoe::link_layer::public_device_address identity3( { 0x02, 0x02, 0x03, 0x04, 0x05, 0x06 } );
+
+irk_t irk( std::uint8_t seed )
+{
+    irk_t result;
+
+    for ( std::size_t i = 0; i != result.size(); ++i )
+        result[ i ] = static_cast< std::uint8_t >( seed * 31 + i * 7 );
+
+    return result;
+}
+
+// resolvable private address, generated with the given IRK and prand
+bluetoe::link_layer::random_device_address rpa( const irk_t& key, std::uint32_t prand )
+{
+    prand = ( prand & 0x3fffff ) | 0x400000;
+
+    std::uint8_t reversed_key[ 16 ];
+    std::reverse_copy( key.begin(), key.end(), reversed_key );
+
+    std::uint8_t block[ 16 ] = { 0 };
+    block[ 13 ] = static_cast< std::uint8_t >( prand >> 16 );
+    block[ 14 ] = static_cast< std::uint8_t >( prand >> 8 );
+    block[ 15 ] = static_cast< std::uint8_t >( prand );
+
+    bluetoe::details::aes128_encrypt( reversed_key, block, block );
+
+    return bluetoe::link_layer::random_device_address( {
+        block[ 15 ], block[ 14 ], block[ 13 ],
+        static_cast< std::uint8_t >( prand ), static_cast< std::uint8_t >( prand >> 8 ), static_cast< std::uint8_t >( prand >> 16 ) } );
+}
+
+struct radio_without_resolving_list_support {
+    static constexpr std::size_t radio_maximum_white_list_entries = 0;
+};
+
+/*
+ * resolves every address, that is in the list of address to resolve
+ */
+template < std::size_t Size >
+class mock_radio_with_resolving_list_support
+{
+public:
+    static constexpr std::size_t radio_maximum_white_list_entries      = 0;
+    static constexpr std::size_t radio_maximum_resolving_list_entries  = Size;
+
+    std::size_t radio_resolving_list_free_size() const
+    {
+        return Size - entries_.size();
+    }
+
+    void radio_clear_resolving_list()
+    {
+        entries_.clear();
+    }
+
+    bool radio_add_to_resolving_list( const bluetoe::link_layer::device_address& identity, const irk_t& key )
+    {
+        radio_remove_from_resolving_list( identity );
+
+        if ( entries_.size() == Size )
+            return false;
+
+        entries_.emplace_back( identity, bluetoe::link_layer::details::address_resolver( key.data() ) );
+
+        return true;
+    }
+
+    bool radio_remove_from_resolving_list( const bluetoe::link_layer::device_address& identity )
+    {
+        const auto pos = find( identity );
+
+        if ( pos == entries_.end() )
+            return false;
+
+        entries_.erase( pos );
+
+        return true;
+    }
+
+    bool radio_is_in_resolving_list( const bluetoe::link_layer::device_address& identity ) const
+    {
+        return find( identity ) != entries_.end();
+    }
+
+    std::pair< bool, bluetoe::link_layer::device_address > radio_resolve_address( const bluetoe::link_layer::device_address& addr ) const
+    {
+        if ( !addr.is_random_resolvable() )
+            return { false, addr };
+
+        std::uint8_t block[ 16 ];
+        bluetoe::link_layer::details::address_resolver::prand_block( addr, block );
+
+        for ( const auto& entry : entries_ )
+        {
+            if ( entry.second.resolves( block, addr ) )
+                return { true, entry.first };
+        }
+
+        return { false, addr };
+    }
+
+private:
+    using entry_t = std::pair< bluetoe::link_layer::device_address, bluetoe::link_layer::details::address_resolver >;
+
+    typename std::vector< entry_t >::const_iterator find( const bluetoe::link_layer::device_address& identity ) const
+    {
+        return std::find_if( entries_.begin(), entries_.end(), [&]( const entry_t& e ){
+            return e.first == identity;
+        } );
+    }
+
+    std::vector< entry_t > entries_;
+};
+
+/*
+ * The resolving list can either be implemented by hardware or by software
+ */
+
+struct only_software
+    : radio_without_resolving_list_support
+    , bluetoe::link_layer::resolving_list< 4 >::impl< radio_without_resolving_list_support, only_software >
+{
+};
+
+struct only_hardware
+    : mock_radio_with_resolving_list_support< 4 >
+    , bluetoe::link_layer::resolving_list< 4 >::impl< mock_radio_with_resolving_list_support< 4 >, only_hardware >
+{
+};
+
+typedef boost::mpl::list<
+    only_software,
+    only_hardware
+> test_types;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( maximum_resolving_list_entries_is_provided, T, test_types )
+{
+    BOOST_CHECK_EQUAL( std::size_t( T::maximum_resolving_list_entries ), 4u );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( empty_after_default_constructed, T, test_types )
+{
+    T list;
+    BOOST_CHECK_EQUAL( list.resolving_list_free_size(), 4u );
+    BOOST_CHECK( !list.is_in_resolving_list( identity1 ) );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( adding_and_removing_devices, T, test_types )
+{
+    T list;
+    BOOST_CHECK( list.add_to_resolving_list( identity1, irk( 1 ) ) );
+    BOOST_CHECK( list.add_to_resolving_list( identity2, irk( 2 ) ) );
+    BOOST_CHECK( list.add_to_resolving_list( identity1, irk( 3 ) ) );
+
+    BOOST_CHECK_EQUAL( list.resolving_list_free_size(), 2u );
+    BOOST_CHECK( list.is_in_resolving_list( identity1 ) );
+    BOOST_CHECK( list.is_in_resolving_list( identity2 ) );
+    BOOST_CHECK( !list.is_in_resolving_list( identity3 ) );
+
+    BOOST_CHECK( list.remove_from_resolving_list( identity1 ) );
+    BOOST_CHECK( !list.remove_from_resolving_list( identity1 ) );
+    BOOST_CHECK( !list.is_in_resolving_list( identity1 ) );
+    BOOST_CHECK( list.is_in_resolving_list( identity2 ) );
+    BOOST_CHECK_EQUAL( list.resolving_list_free_size(), 3u );
+
+    list.clear_resolving_list();
+    BOOST_CHECK_EQUAL( list.resolving_list_free_size(), 4u );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( adding_to_full_list, T, test_types )
+{
+    T list;
+
+    for ( std::uint8_t id = 0; id != 4; ++id )
+        BOOST_CHECK( list.add_to_resolving_list( bluetoe::link_layer::public_device_address( { id, 0, 0, 0, 0, 0 } ), irk( id ) ) );
+
+    BOOST_CHECK( !list.add_to_resolving_list( identity1, irk( 4 ) ) );
+    BOOST_CHECK_EQUAL( list.resolving_list_free_size(), 0u );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( resolves_sample_data, T, test_types )
+{
+    T list;
+    list.add_to_resolving_list( identity1, sample_irk );
+
+    const auto result = list.resolve_address( sample_rpa );
+
+    BOOST_CHECK( result.first );
+    BOOST_CHECK_EQUAL( result.second, identity1 );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( resolves_to_the_matching_identity, T, test_types )
+{
+    T list;
+    list.add_to_resolving_list( identity1, irk( 1 ) );
+    list.add_to_resolving_list( identity2, irk( 2 ) );
+    list.add_to_resolving_list( identity3, irk( 3 ) );
+
+    for ( std::uint32_t prand = 0; prand != 50; ++prand )
+    {
+        BOOST_CHECK_EQUAL( list.resolve_address( rpa( irk( 1 ), prand * 4711 ) ).second, identity1 );
+        BOOST_CHECK_EQUAL( list.resolve_address( rpa( irk( 2 ), prand * 4711 ) ).second, identity2 );
+        BOOST_CHECK_EQUAL( list.resolve_address( rpa( irk( 3 ), prand * 4711 ) ).second, identity3 );
+
+        const auto unknown = rpa( irk( 4 ), prand * 4711 );
+        const auto result  = list.resolve_address( unknown );
+
+        BOOST_CHECK( !result.first );
+        BOOST_CHECK_EQUAL( result.second, unknown );
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( only_resolvable_private_addresses_are_resolved, T, test_types )
+{
+    T list;
+    list.add_to_resolving_list( identity1, sample_irk );
+
+    // same octets, but public
+    const bluetoe::link_layer::public_device_address public_address( { 0xaa, 0xfb, 0x0d, 0x94, 0x81, 0x70 } );
+
+    BOOST_CHECK( !list.resolve_address( public_address ).first );
+    BOOST_CHECK( !list.resolve_address( identity2 ).first );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( changes_of_the_list_invalidate_cached_results, T, test_types )
+{
+    T list;
+    list.add_to_resolving_list( identity2, irk( 2 ) );
+
+    BOOST_CHECK( !list.resolve_address( sample_rpa ).first );
+
+    list.add_to_resolving_list( identity1, sample_irk );
+    BOOST_CHECK( list.resolve_address( sample_rpa ).first );
+
+    list.remove_from_resolving_list( identity1 );
+    BOOST_CHECK( !list.resolve_address( sample_rpa ).first );
+
+    list.add_to_resolving_list( identity1, sample_irk );
+    BOOST_CHECK( list.resolve_address( sample_rpa ).first );
+
+    // replaced IRK
+    list.add_to_resolving_list( identity1, irk( 1 ) );
+    BOOST_CHECK( !list.resolve_address( sample_rpa ).first );
+
+    list.add_to_resolving_list( identity1, sample_irk );
+    list.clear_resolving_list();
+    BOOST_CHECK( !list.resolve_address( sample_rpa ).first );
+}
+
+BOOST_AUTO_TEST_CASE( many_irks_and_cache_collisions )
+{
+    struct large_list
+        : radio_without_resolving_list_support
+        , bluetoe::link_layer::resolving_list< 32, 2 >::impl< radio_without_resolving_list_support, large_list >
+    {
+    } list;
+
+    for ( std::uint8_t id = 0; id != 32; ++id )
+        BOOST_CHECK( list.add_to_resolving_list( bluetoe::link_layer::public_device_address( { id, 0, 0, 0, 0, 0 } ), irk( id ) ) );
+
+    for ( int round = 0; round != 2; ++round )
+    {
+        for ( std::uint8_t id = 0; id != 32; ++id )
+        {
+            const auto result = list.resolve_address( rpa( irk( id ), id * 13 ) );
+
+            BOOST_CHECK( result.first );
+            BOOST_CHECK_EQUAL( result.second, bluetoe::link_layer::public_device_address( { id, 0, 0, 0, 0, 0 } ) );
+        }
+    }
+}
+
+/*
+ * white list with resolvable private addresses
+ */
+struct white_list_with_resolving_list
+    : radio_without_resolving_list_support
+    , bluetoe::link_layer::white_list< 4 >::impl< radio_without_resolving_list_support, white_list_with_resolving_list >
+    , bluetoe::link_layer::resolving_list< 4 >::impl< radio_without_resolving_list_support, white_list_with_resolving_list >
+{
+    white_list_with_resolving_list()
+    {
+        add_to_resolving_list( identity1, sample_irk );
+        add_to_resolving_list( identity2, irk( 2 ) );
+        add_to_white_list( identity1 );
+        connection_request_filter( true );
+        scan_request_filter( true );
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE( resolvable_address_of_white_listed_device_passes_filter, white_list_with_resolving_list )
+{
+    BOOST_CHECK( is_connection_request_in_filter( identity1 ) );
+    BOOST_CHECK( is_connection_request_in_filter( sample_rpa ) );
+    BOOST_CHECK( is_scan_request_in_filter( sample_rpa ) );
+    BOOST_CHECK( !is_in_white_list( sample_rpa ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( resolvable_address_of_other_devices_do_not_pass_filter, white_list_with_resolving_list )
+{
+    // resolvable, but not in the white list
+    BOOST_CHECK( !is_connection_request_in_filter( rpa( irk( 2 ), 42 ) ) );
+    BOOST_CHECK( !is_scan_request_in_filter( rpa( irk( 2 ), 42 ) ) );
+
+    // not resolvable
+    BOOST_CHECK( !is_connection_request_in_filter( rpa( irk( 3 ), 42 ) ) );
+}
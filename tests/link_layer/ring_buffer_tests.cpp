@@ -3,6 +3,11 @@
 #define BOOST_TEST_MODULE
 #include <boost/test/included/unit_test.hpp>
 
+#include <deque>
+#include <random>
+#include <thread>
+#include <utility>
+
 struct small_ring : bluetoe::link_layer::pdu_ring_buffer< 50 >
 {
     small_ring() : bluetoe::link_layer::pdu_ring_buffer< 50 >( &buffer[ 0 ] )
@@ -205,3 +210,196 @@ BOOST_FIXTURE_TEST_CASE( nearly_max_alloc_from_empty_buffer, splitted_at_end )
     BOOST_CHECK_EQUAL( alloc_front( buffer, 50 ).size, 0u );
     BOOST_CHECK_EQUAL( alloc_front( buffer, 49 ).size, 49u );
 }
+
+/*
+ * spsc_pdu_ring_buffer
+ */
+BOOST_AUTO_TEST_SUITE( spsc_ring )
+
+    struct small_spsc_ring : bluetoe::link_layer::spsc_pdu_ring_buffer< 50 >
+    {
+        small_spsc_ring() : bluetoe::link_layer::spsc_pdu_ring_buffer< 50 >( &buffer[ 0 ] )
+        {
+        }
+
+        std::uint8_t buffer[ size ];
+    };
+
+    BOOST_FIXTURE_TEST_CASE( newly_constructed_is_empty, small_spsc_ring )
+    {
+        BOOST_CHECK_EQUAL( next_end().size, 0u );
+        BOOST_CHECK( !more_than_one() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( wrapping_around_when_empty, small_spsc_ring )
+    {
+        auto p1 = alloc_front( buffer, 20 );
+        p1.buffer[ 1 ] = 16;
+        push_front( buffer, p1 );
+
+        auto p2 = alloc_front( buffer, 20 );
+        p2.buffer[ 1 ] = 16;
+        push_front( buffer, p2 );
+
+        pop_end( buffer );
+        pop_end( buffer );
+
+        // ring is empty and splitted at 36; a large PDU has to be allocated at the beginning
+        auto p3 = alloc_front( buffer, 35 );
+        BOOST_REQUIRE_EQUAL( p3.buffer, &buffer[ 0 ] );
+        p3.buffer[ 1 ] = 33;
+        push_front( buffer, p3 );
+
+        BOOST_CHECK_EQUAL( next_end().buffer, &buffer[ 0 ] );
+        BOOST_CHECK_EQUAL( next_end().size, 35u );
+        BOOST_CHECK( !more_than_one() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( wrapping_around_when_not_empty, small_spsc_ring )
+    {
+        auto p1 = alloc_front( buffer, 20 );
+        p1.buffer[ 1 ] = 16;
+        push_front( buffer, p1 );
+
+        auto p2 = alloc_front( buffer, 20 );
+        p2.buffer[ 1 ] = 16;
+        push_front( buffer, p2 );
+
+        pop_end( buffer );
+
+        auto p3 = alloc_front( buffer, 17 );
+        BOOST_REQUIRE_EQUAL( p3.buffer, &buffer[ 0 ] );
+        p3.buffer[ 1 ] = 15;
+        push_front( buffer, p3 );
+
+        BOOST_CHECK( more_than_one() );
+        BOOST_CHECK_EQUAL( next_end().buffer, &buffer[ 18 ] );
+
+        pop_end( buffer );
+        BOOST_CHECK_EQUAL( next_end().buffer, &buffer[ 0 ] );
+        BOOST_CHECK_EQUAL( next_end().size, 17u );
+        BOOST_CHECK( !more_than_one() );
+
+        pop_end( buffer );
+        BOOST_CHECK_EQUAL( next_end().size, 0u );
+    }
+
+    /*
+     * Random sequence of pushes and pops, with the contents compared against a std::deque
+     */
+    BOOST_AUTO_TEST_CASE( random_push_and_pop )
+    {
+        std::uint8_t memory[ 100 ];
+        bluetoe::link_layer::spsc_pdu_ring_buffer< sizeof( memory ) > ring( memory );
+
+        std::deque< std::pair< std::size_t, std::uint8_t > > expected;
+
+        std::mt19937                            random( 42 );
+        std::uniform_int_distribution< int >    size( 3, 40 );
+
+        for ( int i = 0; i != 10000; ++i )
+        {
+            if ( random() % 2 )
+            {
+                const std::size_t pdu_size = size( random );
+                auto pdu = ring.alloc_front( memory, pdu_size );
+
+                // with up to 40 bytes PDUs, there must be room in a 100 bytes ring for at least one
+                BOOST_REQUIRE( pdu.size != 0 || !expected.empty() );
+
+                if ( pdu.size )
+                {
+                    BOOST_REQUIRE_EQUAL( pdu.size, pdu_size );
+                    BOOST_REQUIRE( pdu.buffer >= memory && pdu.buffer + pdu.size <= memory + sizeof( memory ) );
+
+                    pdu.buffer[ 1 ] = static_cast< std::uint8_t >( pdu_size - 2 );
+                    pdu.buffer[ 2 ] = static_cast< std::uint8_t >( i );
+                    ring.push_front( memory, pdu );
+
+                    expected.emplace_back( pdu_size, static_cast< std::uint8_t >( i ) );
+                }
+            }
+            else if ( !expected.empty() )
+            {
+                const auto pdu = ring.next_end();
+
+                BOOST_REQUIRE_EQUAL( pdu.size, expected.front().first );
+                BOOST_REQUIRE_EQUAL( pdu.buffer[ 2 ], expected.front().second );
+                BOOST_REQUIRE_EQUAL( ring.more_than_one(), expected.size() > 1 );
+
+                ring.pop_end( memory );
+                expected.pop_front();
+            }
+            else
+            {
+                BOOST_REQUIRE_EQUAL( ring.next_end().size, 0u );
+            }
+        }
+    }
+
+    /*
+     * producer and consumer running in different threads
+     */
+    BOOST_AUTO_TEST_CASE( concurrent_producer_and_consumer )
+    {
+        static constexpr int            number_of_pdus = 100000;
+        static constexpr std::size_t    max_pdu_size   = 30;
+
+        std::uint8_t memory[ 128 ];
+        bluetoe::link_layer::spsc_pdu_ring_buffer< sizeof( memory ) > ring( memory );
+
+        std::thread producer( [&]()
+        {
+            for ( int i = 0; i != number_of_pdus; )
+            {
+                const std::size_t pdu_size = 3 + i % ( max_pdu_size - 3 );
+                auto pdu = ring.alloc_front( memory, pdu_size );
+
+                if ( pdu.size == 0 )
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                pdu.buffer[ 0 ] = 0;
+                pdu.buffer[ 1 ] = static_cast< std::uint8_t >( pdu_size - 2 );
+
+                for ( std::size_t b = 2; b != pdu_size; ++b )
+                    pdu.buffer[ b ] = static_cast< std::uint8_t >( i + b );
+
+                ring.push_front( memory, pdu );
+                ++i;
+            }
+        } );
+
+        int errors = 0;
+
+        for ( int i = 0; i != number_of_pdus; )
+        {
+            const auto pdu = ring.next_end();
+
+            if ( pdu.size == 0 )
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            const std::size_t pdu_size = 3 + i % ( max_pdu_size - 3 );
+
+            if ( pdu.size != pdu_size )
+                ++errors;
+
+            for ( std::size_t b = 2; b != pdu.size; ++b )
+                errors += pdu.buffer[ b ] != static_cast< std::uint8_t >( i + b );
+
+            ring.pop_end( memory );
+            ++i;
+        }
+
+        producer.join();
+
+        BOOST_CHECK_EQUAL( errors, 0 );
+        BOOST_CHECK_EQUAL( ring.next_end().size, 0u );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
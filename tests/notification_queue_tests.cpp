@@ -10,6 +10,7 @@ namespace {
 using queue17 = bluetoe::notification_queue< std::tuple< std::integral_constant< int, 17u > >, empty_fixture >;
 using queue3 = bluetoe::notification_queue< std::tuple< std::integral_constant< int, 3u > >, empty_fixture >;
 using queue8 = bluetoe::notification_queue< std::tuple< std::integral_constant< int, 8u > >, empty_fixture >;
+using queue70 = bluetoe::notification_queue< std::tuple< std::integral_constant< int, 70u > >, empty_fixture >;
 
 BOOST_AUTO_TEST_SUITE( single_prio_notifications )
 
@@ -119,6 +120,80 @@ BOOST_AUTO_TEST_SUITE( single_prio_indications )
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE( multi_word_queue )
+
+    BOOST_FIXTURE_TEST_CASE( entries_in_different_words, queue70 )
+    {
+        BOOST_CHECK( queue_notification( 69u ) );
+        BOOST_CHECK( queue_notification( 5u ) );
+        BOOST_CHECK( queue_notification( 40u ) );
+        BOOST_CHECK( queue_notification( 31u ) );
+        BOOST_CHECK( queue_notification( 32u ) );
+
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 5u } ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 31u } ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 32u } ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 40u } ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 69u } ) );
+        BOOST_CHECK( dequeue_indication_or_confirmation().first == entry_type::empty );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( round_robin_across_words, queue70 )
+    {
+        BOOST_CHECK( queue_notification( 40u ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 40u } ) );
+
+        BOOST_CHECK( queue_notification( 3u ) );
+        BOOST_CHECK( queue_notification( 40u ) );
+        BOOST_CHECK( queue_notification( 35u ) );
+        BOOST_CHECK( queue_notification( 66u ) );
+
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 66u } ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 3u } ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 35u } ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 40u } ) );
+        BOOST_CHECK( dequeue_indication_or_confirmation().first == entry_type::empty );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( wrap_around_from_last_entry, queue70 )
+    {
+        BOOST_CHECK( queue_notification( 69u ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 69u } ) );
+
+        BOOST_CHECK( queue_notification( 69u ) );
+        BOOST_CHECK( queue_notification( 0u ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 0u } ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 69u } ) );
+        BOOST_CHECK( dequeue_indication_or_confirmation().first == entry_type::empty );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( no_indication_until_confirmed, queue70 )
+    {
+        BOOST_CHECK( queue_indication( 10u ) );
+        BOOST_CHECK( queue_indication( 50u ) );
+        BOOST_CHECK( queue_notification( 65u ) );
+
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::indication, 10u } ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 65u } ) );
+        BOOST_CHECK( dequeue_indication_or_confirmation().first == entry_type::empty );
+
+        indication_confirmed();
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::indication, 50u } ) );
+        BOOST_CHECK( dequeue_indication_or_confirmation().first == entry_type::empty );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( clear_all, queue70 )
+    {
+        BOOST_CHECK( queue_notification( 1u ) );
+        BOOST_CHECK( queue_indication( 33u ) );
+        BOOST_CHECK( queue_notification( 68u ) );
+
+        clear_indications_and_confirmations();
+        BOOST_CHECK( dequeue_indication_or_confirmation().first == entry_type::empty );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE( single_prio_clearing )
 
     BOOST_FIXTURE_TEST_CASE( still_empty, queue8 )
@@ -262,6 +337,18 @@ BOOST_AUTO_TEST_SUITE( mixed_priorities )
         BOOST_CHECK( ( dequeue_indication_or_confirmation().first == entry_type::empty ) );
     }
 
+    BOOST_FIXTURE_TEST_CASE( dequeue_notification_keeps_indications, queue1_2 )
+    {
+        BOOST_CHECK( queue_indication( 0 ) );
+        BOOST_CHECK( queue_notification( 2 ) );
+
+        BOOST_CHECK( ( dequeue_notification()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 2 } ) );
+        BOOST_CHECK( ( dequeue_notification().first == entry_type::empty ) );
+
+        // the indication is still pending and does not wait for a confirmation
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::indication, 0 } ) );
+    }
+
     // there was a bug in the implementation, where a class derived from all the elements
     using queue1_1_2 = bluetoe::notification_queue<
     std::tuple<
@@ -356,3 +356,210 @@ BOOST_AUTO_TEST_CASE_TEMPLATE( sync_numeric_compairson_fail, Manager, test::lesc
     fixture.l2cap_output( buffer, size , fixture.connection_data_ );
     BOOST_CHECK( size == 0 );
 }
+
+template < class Manager >
+struct incremental_dh_key_calculation : test::lesc_pairing_random_exchanged< Manager, bluetoe::incremental_dh_key_calculation >
+{
+    // calls l2cap_output() until the security manager responds and returns the response
+    std::vector< std::uint8_t > finish_dh_key_calculation()
+    {
+        std::uint8_t buffer[ 65 ];
+        std::size_t  size = 0;
+
+        for ( int calls = 0; size == 0 && calls != 100; ++calls )
+        {
+            size = sizeof( buffer );
+            this->l2cap_output( buffer, size, this->connection_data_ );
+        }
+
+        return std::vector< std::uint8_t >( &buffer[ 0 ], &buffer[ size ] );
+    }
+};
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( incremental_dh_key_calculation_defers_response, Manager, test::lesc_managers )
+{
+    incremental_dh_key_calculation< Manager > fixture;
+
+    fixture.expected(
+        {
+            0x0D,           // DHKey Check
+            0x68, 0xd6, 0x70, 0x63,
+            0xae, 0x09, 0x87, 0x88,
+            0xa0, 0x19, 0x56, 0xa0,
+            0xca, 0xf0, 0x5d, 0x9d
+        },
+        {}
+    );
+
+    BOOST_CHECK( fixture.connection_data().state() == bluetoe::details::sm_pairing_state::lesc_dh_key_calculation );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( incremental_dh_key_calculation_success, Manager, test::lesc_managers )
+{
+    incremental_dh_key_calculation< Manager > fixture;
+
+    fixture.expected(
+        {
+            0x0D,           // DHKey Check
+            0x68, 0xd6, 0x70, 0x63,
+            0xae, 0x09, 0x87, 0x88,
+            0xa0, 0x19, 0x56, 0xa0,
+            0xca, 0xf0, 0x5d, 0x9d
+        },
+        {}
+    );
+
+    const std::vector< std::uint8_t > response = fixture.finish_dh_key_calculation();
+    const std::vector< std::uint8_t > expected = {
+        0x0D,           // DHKey Check
+        0xd4, 0x5b, 0xa2, 0x51,
+        0x11, 0x44, 0xd4, 0x69,
+        0x30, 0x2a, 0xe6, 0x43,
+        0x1d, 0x9a, 0x44, 0x1a
+    };
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( response.begin(), response.end(), expected.begin(), expected.end() );
+    BOOST_CHECK_GT( fixture.p256_steps, 1 );
+    BOOST_CHECK( fixture.connection_data().state() == bluetoe::details::sm_pairing_state::pairing_completed );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( incremental_dh_key_calculation_failed, Manager, test::lesc_managers )
+{
+    incremental_dh_key_calculation< Manager > fixture;
+
+    fixture.expected(
+        {
+            0x0D,           // DHKey Check
+            0x8a, 0x66, 0x11, 0x68,
+            0x49, 0xca, 0x39, 0x2d,
+            0x5d, 0x9b, 0xe1, 0x1e,
+            0x42, 0x38, 0xef, 0xd8  // <- last byte is of by 1
+        },
+        {}
+    );
+
+    const std::vector< std::uint8_t > response = fixture.finish_dh_key_calculation();
+    const std::vector< std::uint8_t > expected = {
+        0x05,           // Pairing Failed
+        0x0b,           // DHKey check failed
+    };
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( response.begin(), response.end(), expected.begin(), expected.end() );
+    BOOST_CHECK( fixture.connection_data().state() == bluetoe::details::sm_pairing_state::idle );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( incremental_dh_key_calculations_of_two_connections, Manager, test::lesc_managers )
+{
+    incremental_dh_key_calculation< Manager > fixture;
+
+    // a second connection, in the same pairing state
+    auto second_connection = fixture.connection_data_;
+
+    const std::uint8_t valid_check[] = {
+        0x0D,           // DHKey Check
+        0x68, 0xd6, 0x70, 0x63,
+        0xae, 0x09, 0x87, 0x88,
+        0xa0, 0x19, 0x56, 0xa0,
+        0xca, 0xf0, 0x5d, 0x9d
+    };
+
+    const std::uint8_t invalid_check[] = {
+        0x0D,           // DHKey Check
+        0x68, 0xd6, 0x70, 0x63,
+        0xae, 0x09, 0x87, 0x88,
+        0xa0, 0x19, 0x56, 0xa0,
+        0xca, 0xf0, 0x5d, 0x9e  // <- last byte is of by 1
+    };
+
+    std::uint8_t buffer[ 65 ];
+    std::size_t  size = sizeof( buffer );
+
+    fixture.l2cap_input( valid_check, sizeof( valid_check ), buffer, size, fixture.connection_data_ );
+    BOOST_CHECK_EQUAL( size, 0u );
+
+    size = sizeof( buffer );
+    fixture.l2cap_input( invalid_check, sizeof( invalid_check ), buffer, size, second_connection );
+    BOOST_CHECK_EQUAL( size, 0u );
+
+    // the link layer asks both connections alternately for output
+    std::vector< std::uint8_t > first_response;
+    std::vector< std::uint8_t > second_response;
+
+    for ( int calls = 0; ( first_response.empty() || second_response.empty() ) && calls != 200; ++calls )
+    {
+        size = sizeof( buffer );
+        fixture.l2cap_output( buffer, size, fixture.connection_data_ );
+
+        if ( size )
+            first_response.assign( &buffer[ 0 ], &buffer[ size ] );
+
+        size = sizeof( buffer );
+        fixture.l2cap_output( buffer, size, second_connection );
+
+        if ( size )
+            second_response.assign( &buffer[ 0 ], &buffer[ size ] );
+    }
+
+    const std::vector< std::uint8_t > expected_first = {
+        0x0D,           // DHKey Check
+        0xd4, 0x5b, 0xa2, 0x51,
+        0x11, 0x44, 0xd4, 0x69,
+        0x30, 0x2a, 0xe6, 0x43,
+        0x1d, 0x9a, 0x44, 0x1a
+    };
+
+    const std::vector< std::uint8_t > expected_second = {
+        0x05,           // Pairing Failed
+        0x0b,           // DHKey check failed
+    };
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( first_response.begin(), first_response.end(), expected_first.begin(), expected_first.end() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( second_response.begin(), second_response.end(), expected_second.begin(), expected_second.end() );
+    BOOST_CHECK( fixture.connection_data().state() == bluetoe::details::sm_pairing_state::pairing_completed );
+    BOOST_CHECK( second_connection.state() == bluetoe::details::sm_pairing_state::idle );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( incremental_dh_key_calculation_of_a_failed_pairing_is_released, Manager, test::lesc_managers )
+{
+    incremental_dh_key_calculation< Manager > fixture;
+
+    auto second_connection = fixture.connection_data_;
+
+    fixture.expected(
+        {
+            0x0D,           // DHKey Check
+            0x68, 0xd6, 0x70, 0x63,
+            0xae, 0x09, 0x87, 0x88,
+            0xa0, 0x19, 0x56, 0xa0,
+            0xca, 0xf0, 0x5d, 0x9d
+        },
+        {}
+    );
+
+    // the first pairing fails, before its DH key was calculated
+    fixture.connection_data_.error_reset();
+
+    const std::uint8_t check[] = {
+        0x0D,           // DHKey Check
+        0x68, 0xd6, 0x70, 0x63,
+        0xae, 0x09, 0x87, 0x88,
+        0xa0, 0x19, 0x56, 0xa0,
+        0xca, 0xf0, 0x5d, 0x9d
+    };
+
+    std::uint8_t buffer[ 65 ];
+    std::size_t  size = sizeof( buffer );
+    fixture.l2cap_input( check, sizeof( check ), buffer, size, second_connection );
+
+    std::vector< std::uint8_t > response;
+
+    for ( int calls = 0; response.empty() && calls != 100; ++calls )
+    {
+        size = sizeof( buffer );
+        fixture.l2cap_output( buffer, size, second_connection );
+        response.assign( &buffer[ 0 ], &buffer[ size ] );
+    }
+
+    BOOST_CHECK_EQUAL( response.size(), 17u );
+    BOOST_CHECK( second_connection.state() == bluetoe::details::sm_pairing_state::pairing_completed );
+}
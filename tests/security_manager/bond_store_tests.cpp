@@ -0,0 +1,521 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <bluetoe/bond_store.hpp>
+#include <bluetoe/file_page_storage.hpp>
+#include <bluetoe/resolving_list.hpp>
+#include <bluetoe/aes.hpp>
+
+#include "test_sm.hpp"
+
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+    const char storage_file_name[] = "bond_store_tests.bin";
+
+    using storage_t = bluetoe::file_page_storage< 256, 4 >;
+
+    // bond record is 44 octets with 3 octets of cccds, 4 bonds + 1 fit into a page
+    using store_t   = bluetoe::bond_store< storage_t, 4, 12 >;
+
+    struct connection_t
+    {
+        explicit connection_t( std::uint8_t id, bool random = true )
+            : address_( random
+                ? bluetoe::link_layer::device_address( bluetoe::link_layer::random_device_address( { id, 0x11, 0x22, 0x33, 0x44, 0xc5 } ) )
+                : bluetoe::link_layer::device_address( bluetoe::link_layer::public_device_address( { id, 0x11, 0x22, 0x33, 0x44, 0x55 } ) ) )
+            , identity_( address_ )
+            , cccds_{ { 0 } }
+        {
+        }
+
+        explicit connection_t( const bluetoe::link_layer::device_address& address )
+            : address_( address )
+            , identity_( address )
+            , cccds_{ { 0 } }
+        {
+        }
+
+        const bluetoe::link_layer::device_address& remote_address() const
+        {
+            return address_;
+        }
+
+        void remote_identity_resolved( const bluetoe::link_layer::device_address& identity )
+        {
+            identity_ = identity;
+        }
+
+        const bluetoe::link_layer::device_address& remote_identity_address() const
+        {
+            return identity_;
+        }
+
+        std::uint8_t* serialized_cccds_begin()
+        {
+            return cccds_.data();
+        }
+
+        std::uint8_t* serialized_cccds_end()
+        {
+            return cccds_.data() + cccds_.size();
+        }
+
+        const std::uint8_t* serialized_cccds_begin() const
+        {
+            return cccds_.data();
+        }
+
+        const std::uint8_t* serialized_cccds_end() const
+        {
+            return cccds_.data() + cccds_.size();
+        }
+
+        bluetoe::link_layer::device_address address_;
+        bluetoe::link_layer::device_address identity_;
+        std::array< std::uint8_t, 3 >       cccds_;
+    };
+
+    bluetoe::details::longterm_key_t key( std::uint8_t id, std::uint16_t ediv, std::uint64_t rand )
+    {
+        bluetoe::details::longterm_key_t result;
+        result.longterm_key.fill( id );
+        result.ediv = ediv;
+        result.rand = rand;
+
+        return result;
+    }
+
+    bluetoe::details::uint128_t key_value( std::uint8_t id )
+    {
+        bluetoe::details::uint128_t result;
+        result.fill( id );
+
+        return result;
+    }
+
+    struct empty_store
+    {
+        empty_store()
+        {
+            std::remove( storage_file_name );
+            reopen();
+        }
+
+        ~empty_store()
+        {
+            store.reset();
+            storage.reset();
+            std::remove( storage_file_name );
+        }
+
+        void reopen()
+        {
+            store.reset();
+            storage.reset();
+
+            storage.reset( new storage_t( storage_file_name ) );
+            store.reset( new store_t( *storage ) );
+            store->open();
+        }
+
+        bool has_key( std::uint16_t ediv, std::uint64_t rand, std::uint8_t id, const connection_t& connection = connection_t( 0xff ) )
+        {
+            const auto result = store->find_key( ediv, rand, connection.remote_identity_address() );
+
+            return result.first && result.second == key_value( id );
+        }
+
+        // overwrites the octet at the given position in the file
+        void corrupt( std::size_t position, std::uint8_t value )
+        {
+            storage.reset();
+
+            std::FILE* file = std::fopen( storage_file_name, "r+b" );
+            std::fseek( file, static_cast< long >( position ), SEEK_SET );
+            std::fputc( value, file );
+            std::fclose( file );
+
+            storage.reset( new storage_t( storage_file_name ) );
+            store.reset( new store_t( *storage ) );
+            store->open();
+        }
+
+        std::unique_ptr< storage_t >    storage;
+        std::unique_ptr< store_t >      store;
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( empty_store_finds_nothing, empty_store )
+{
+    BOOST_CHECK_EQUAL( store->number_of_bonds(), 0u );
+    BOOST_CHECK( !store->find_key( 0x1234, 0x1122334455667788, connection_t( 1 ).remote_address() ).first );
+    BOOST_CHECK( !store->find_key( 0, 0, connection_t( 1 ).remote_address() ).first );
+}
+
+BOOST_FIXTURE_TEST_CASE( find_legacy_key_by_ediv_and_rand, empty_store )
+{
+    store->store_bond( key( 1, 0x1234, 0x1122334455667788 ), connection_t( 1 ) );
+    store->store_bond( key( 2, 0x1234, 0x1122334455667789 ), connection_t( 2 ) );
+    store->store_bond( key( 3, 0x1235, 0x1122334455667788 ), connection_t( 3 ) );
+
+    BOOST_CHECK_EQUAL( store->number_of_bonds(), 3u );
+    BOOST_CHECK( has_key( 0x1234, 0x1122334455667788, 1 ) );
+    BOOST_CHECK( has_key( 0x1234, 0x1122334455667789, 2 ) );
+    BOOST_CHECK( has_key( 0x1235, 0x1122334455667788, 3 ) );
+    BOOST_CHECK( !store->find_key( 0x1235, 0x1122334455667789, connection_t( 3 ).remote_address() ).first );
+}
+
+BOOST_FIXTURE_TEST_CASE( find_secure_connections_key_by_address, empty_store )
+{
+    store->store_bond( key( 1, 0, 0 ), connection_t( 1 ) );
+    store->store_bond( key( 2, 0, 0 ), connection_t( 2 ) );
+    store->store_bond( key( 3, 0, 0 ), connection_t( 1, false ) );
+
+    BOOST_CHECK( has_key( 0, 0, 1, connection_t( 1 ) ) );
+    BOOST_CHECK( has_key( 0, 0, 2, connection_t( 2 ) ) );
+    BOOST_CHECK( has_key( 0, 0, 3, connection_t( 1, false ) ) );
+    BOOST_CHECK( !store->find_key( 0, 0, connection_t( 4 ).remote_address() ).first );
+}
+
+BOOST_FIXTURE_TEST_CASE( bonds_are_persistent, empty_store )
+{
+    store->store_bond( key( 1, 0x1234, 0x1122334455667788 ), connection_t( 1 ) );
+    store->store_bond( key( 2, 0, 0 ), connection_t( 2 ) );
+
+    reopen();
+
+    BOOST_CHECK_EQUAL( store->number_of_bonds(), 2u );
+    BOOST_CHECK( has_key( 0x1234, 0x1122334455667788, 1 ) );
+    BOOST_CHECK( has_key( 0, 0, 2, connection_t( 2 ) ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( new_bond_with_same_device_replaces_old_bond, empty_store )
+{
+    store->store_bond( key( 1, 0x1234, 0x1122334455667788 ), connection_t( 1 ) );
+    store->store_bond( key( 2, 0x4711, 0x0000000000000001 ), connection_t( 1 ) );
+
+    BOOST_CHECK_EQUAL( store->number_of_bonds(), 1u );
+    BOOST_CHECK( !store->find_key( 0x1234, 0x1122334455667788, connection_t( 1 ).remote_address() ).first );
+    BOOST_CHECK( has_key( 0x4711, 0x0000000000000001, 2 ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( oldest_bond_is_replaced, empty_store )
+{
+    for ( std::uint8_t id = 1; id != 6; ++id )
+        store->store_bond( key( id, id, id ), connection_t( id ) );
+
+    BOOST_CHECK_EQUAL( store->number_of_bonds(), 4u );
+    BOOST_CHECK( !store->find_key( 1, 1, connection_t( 1 ).remote_address() ).first );
+
+    for ( std::uint8_t id = 2; id != 6; ++id )
+        BOOST_CHECK( has_key( id, id, id ) );
+
+    reopen();
+    store->store_bond( key( 6, 6, 6 ), connection_t( 6 ) );
+
+    BOOST_CHECK( !store->find_key( 2, 2, connection_t( 2 ).remote_address() ).first );
+    BOOST_CHECK( has_key( 6, 6, 6 ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( remove_bond, empty_store )
+{
+    store->store_bond( key( 1, 1, 1 ), connection_t( 1 ) );
+    store->store_bond( key( 2, 2, 2 ), connection_t( 2 ) );
+
+    BOOST_CHECK( store->remove_bond( connection_t( 1 ).remote_address() ) );
+    BOOST_CHECK( !store->remove_bond( connection_t( 1 ).remote_address() ) );
+    BOOST_CHECK( !store->remove_bond( connection_t( 3 ).remote_address() ) );
+
+    reopen();
+
+    BOOST_CHECK_EQUAL( store->number_of_bonds(), 1u );
+    BOOST_CHECK( !store->find_key( 1, 1, connection_t( 1 ).remote_address() ).first );
+    BOOST_CHECK( has_key( 2, 2, 2 ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( cccds_are_restored, empty_store )
+{
+    connection_t connection( 1 );
+    store->store_bond( key( 1, 1, 1 ), connection );
+
+    connection.cccds_ = {{ 0x12, 0x34, 0x56 }};
+    store->store_cccds( connection );
+
+    reopen();
+
+    connection_t restored( 1 );
+    store->restore_cccds( restored );
+    BOOST_CHECK( restored.cccds_ == connection.cccds_ );
+
+    // unknown devices are not touched
+    connection_t unknown( 2 );
+    unknown.cccds_ = {{ 0xaa, 0xbb, 0xcc }};
+    store->restore_cccds( unknown );
+    BOOST_CHECK( ( unknown.cccds_ == std::array< std::uint8_t, 3 >{{ 0xaa, 0xbb, 0xcc }} ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( new_pairing_keeps_cccds, empty_store )
+{
+    connection_t connection( 1 );
+    store->store_bond( key( 1, 1, 1 ), connection );
+
+    connection.cccds_ = {{ 0x01, 0x00, 0x04 }};
+    store->store_cccds( connection );
+    store->store_bond( key( 2, 2, 2 ), connection_t( 1 ) );
+
+    connection_t restored( 1 );
+    store->restore_cccds( restored );
+    BOOST_CHECK( restored.cccds_ == connection.cccds_ );
+}
+
+BOOST_FIXTURE_TEST_CASE( unchanged_cccds_are_not_written, empty_store )
+{
+    connection_t connection( 1 );
+    store->store_bond( key( 1, 1, 1 ), connection );
+
+    // page size 256, header 8, bond record 44, cccd record 8: with every write stored, a compaction would erase pages
+    for ( int i = 0; i != 100; ++i )
+        store->store_cccds( connection );
+
+    for ( std::size_t page = 0; page != storage_t::number_of_pages; ++page )
+        BOOST_CHECK_EQUAL( storage->erase_count( page ), 0u );
+}
+
+BOOST_FIXTURE_TEST_CASE( compaction_keeps_state_and_levels_wear, empty_store )
+{
+    connection_t connections[] = { connection_t( 1 ), connection_t( 2 ), connection_t( 3 ), connection_t( 4 ) };
+
+    for ( std::uint8_t id = 1; id != 5; ++id )
+        store->store_bond( key( id, id, id ), connections[ id - 1 ] );
+
+    for ( int round = 0; round != 500; ++round )
+    {
+        auto& connection = connections[ round % 4 ];
+        connection.cccds_[ 0 ] = static_cast< std::uint8_t >( round );
+        store->store_cccds( connection );
+    }
+
+    std::size_t min_erase = ~std::size_t( 0 );
+    std::size_t max_erase = 0;
+
+    for ( std::size_t page = 0; page != storage_t::number_of_pages; ++page )
+    {
+        min_erase = std::min( min_erase, storage->erase_count( page ) );
+        max_erase = std::max( max_erase, storage->erase_count( page ) );
+    }
+
+    BOOST_CHECK_GT( min_erase, 0u );
+    BOOST_CHECK_LE( max_erase - min_erase, 1u );
+
+    reopen();
+
+    BOOST_CHECK_EQUAL( store->number_of_bonds(), 4u );
+
+    for ( std::uint8_t id = 1; id != 5; ++id )
+    {
+        BOOST_CHECK( has_key( id, id, id ) );
+
+        connection_t restored( id );
+        store->restore_cccds( restored );
+        BOOST_CHECK( restored.cccds_ == connections[ id - 1 ].cccds_ );
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE( torn_record_is_ignored, empty_store )
+{
+    connection_t connection( 1 );
+    store->store_bond( key( 1, 1, 1 ), connection );
+
+    connection.cccds_ = {{ 0x12, 0x34, 0x56 }};
+    store->store_cccds( connection );
+
+    // the cccd record follows the page header and the bond record of 44 octets
+    corrupt( 8 + 44 + 3, 0x00 );
+
+    BOOST_CHECK( has_key( 1, 1, 1 ) );
+
+    connection_t restored( 1 );
+    store->restore_cccds( restored );
+    BOOST_CHECK( ( restored.cccds_ == std::array< std::uint8_t, 3 >{{ 0, 0, 0 }} ) );
+
+    // the store keeps working and the changes are persistent
+    store->store_cccds( connection );
+    store->store_bond( key( 2, 2, 2 ), connection_t( 2 ) );
+
+    reopen();
+
+    BOOST_CHECK( has_key( 1, 1, 1 ) );
+    BOOST_CHECK( has_key( 2, 2, 2 ) );
+    store->restore_cccds( restored );
+    BOOST_CHECK( restored.cccds_ == connection.cccds_ );
+}
+
+BOOST_FIXTURE_TEST_CASE( corrupted_page_header_is_erased, empty_store )
+{
+    store->store_bond( key( 1, 1, 1 ), connection_t( 1 ) );
+    corrupt( 0, 0x00 );
+
+    BOOST_CHECK_EQUAL( store->number_of_bonds(), 0u );
+
+    store->store_bond( key( 2, 2, 2 ), connection_t( 2 ) );
+    reopen();
+
+    BOOST_CHECK( has_key( 2, 2, 2 ) );
+}
+
+namespace {
+    struct radio_without_resolving_list_support {};
+
+    struct resolving_list_t : bluetoe::link_layer::resolving_list< 2 >::impl< radio_without_resolving_list_support, resolving_list_t >
+    {
+    };
+
+    const bluetoe::details::identity_resolving_key_t peer_irk = {{
+        0x9b, 0x7d, 0x39, 0x0a, 0xa6, 0x10, 0x10, 0x34,
+        0x05, 0xad, 0xc8, 0x57, 0xa3, 0x34, 0x02, 0xec
+    }};
+
+    const bluetoe::link_layer::public_device_address peer_identity( { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 } );
+
+    // resolvable private address of the peer, generated with the given prand
+    bluetoe::link_layer::random_device_address peer_rpa( std::uint32_t prand )
+    {
+        prand = ( prand & 0x3fffff ) | 0x400000;
+
+        std::uint8_t reversed_key[ 16 ];
+        std::reverse_copy( peer_irk.begin(), peer_irk.end(), reversed_key );
+
+        std::uint8_t block[ 16 ] = { 0 };
+        block[ 13 ] = static_cast< std::uint8_t >( prand >> 16 );
+        block[ 14 ] = static_cast< std::uint8_t >( prand >> 8 );
+        block[ 15 ] = static_cast< std::uint8_t >( prand );
+
+        bluetoe::details::aes128_encrypt( reversed_key, block, block );
+
+        return bluetoe::link_layer::random_device_address( {
+            block[ 15 ], block[ 14 ], block[ 13 ],
+            static_cast< std::uint8_t >( prand ), static_cast< std::uint8_t >( prand >> 8 ), static_cast< std::uint8_t >( prand >> 16 ) } );
+    }
+
+    // a new connection from the peer, with the address resolved, like the link layer does
+    connection_t peer_connection( const resolving_list_t& list, std::uint32_t prand )
+    {
+        connection_t connection( peer_rpa( prand ) );
+        bluetoe::link_layer::details::resolve_remote_identity( list, connection, connection.remote_address() );
+
+        return connection;
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE( bond_is_found_after_the_peer_rotated_its_address, empty_store )
+{
+    resolving_list_t list;
+    list.add_to_resolving_list( peer_identity, peer_irk );
+
+    connection_t first = peer_connection( list, 0x1234 );
+    BOOST_CHECK_EQUAL( first.remote_identity_address(), peer_identity );
+
+    first.cccds_ = {{ 0x12, 0x34, 0x05 }};
+    store->store_bond( key( 3, 0, 0 ), first );
+    store->store_cccds( first );
+
+    connection_t second = peer_connection( list, 0x5678 );
+    BOOST_REQUIRE( second.remote_address() != first.remote_address() );
+
+    BOOST_CHECK( has_key( 0, 0, 3, second ) );
+
+    store->restore_cccds( second );
+    BOOST_CHECK( second.cccds_ == first.cccds_ );
+
+    // without the IRK, the rotated address is an unknown device
+    list.clear_resolving_list();
+    BOOST_CHECK( !has_key( 0, 0, 3, peer_connection( list, 0x9abc ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( no_cccds )
+{
+    std::remove( storage_file_name );
+
+    {
+        bluetoe::file_page_storage< 256, 2 > storage( storage_file_name );
+        bluetoe::bond_store< bluetoe::file_page_storage< 256, 2 >, 2 > store( storage );
+        store.open();
+
+        connection_t connection( 1 );
+        store.store_bond( key( 1, 1, 1 ), connection );
+        store.store_cccds( connection );
+        store.restore_cccds( connection );
+
+        BOOST_CHECK( store.find_key( 1, 1, connection.remote_address() ).first );
+    }
+
+    std::remove( storage_file_name );
+}
+
+namespace {
+    std::unique_ptr< storage_t > integration_storage;
+    std::unique_ptr< store_t >   integration_store;
+
+    struct store_reference
+    {
+        template < class Radio >
+        bluetoe::details::longterm_key_t create_new_bond( Radio& radio, const bluetoe::link_layer::device_address& mac )
+        {
+            return integration_store->create_new_bond( radio, mac );
+        }
+
+        template < class Connection >
+        void store_bond( const bluetoe::details::longterm_key_t& key, const Connection& connection )
+        {
+            integration_store->store_bond( key, connection );
+        }
+
+        std::pair< bool, bluetoe::details::uint128_t > find_key( std::uint16_t ediv, std::uint64_t rand, const bluetoe::link_layer::device_address& remote_address ) const
+        {
+            return integration_store->find_key( ediv, rand, remote_address );
+        }
+
+        template < class Connection >
+        void restore_cccds( Connection& connection )
+        {
+            integration_store->restore_cccds( connection );
+        }
+    } store_ref;
+
+    struct use_bond_store : test::legacy_security_manager<
+        100u,
+        bluetoe::bonding_data_base< store_reference, store_ref > >
+    {
+        use_bond_store()
+        {
+            std::remove( storage_file_name );
+            integration_storage.reset( new storage_t( storage_file_name ) );
+            integration_store.reset( new store_t( *integration_storage ) );
+            integration_store->open();
+        }
+
+        ~use_bond_store()
+        {
+            integration_store.reset();
+            integration_storage.reset();
+            std::remove( storage_file_name );
+        }
+
+        using connection_data = channel_data_t< bluetoe::details::no_such_type >;
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( used_as_bonding_data_base, use_bond_store )
+{
+    integration_store->store_bond( key( 7, 0x1234, 0x1122334455667788 ), connection_t( 1 ) );
+
+    connection_data connection;
+    const auto result = connection.find_key( 0x1234, 0x1122334455667788 );
+
+    BOOST_CHECK( result.first );
+    BOOST_CHECK( result.second == key_value( 7 ) );
+    BOOST_CHECK( !connection.find_key( 0x1234, 0x1122334455667789 ).first );
+}
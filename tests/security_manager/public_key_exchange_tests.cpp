@@ -192,3 +192,190 @@ BOOST_AUTO_TEST_CASE_TEMPLATE( not_expected_key_exchanged, Manager, test::lesc_m
         }
     );
 }
+
+namespace {
+    struct counting_security_functions : test::all_security_functions
+    {
+        counting_security_functions()
+            : generated_key_pairs( 0 )
+        {
+        }
+
+        std::pair< bluetoe::details::ecdh_public_key_t, bluetoe::details::ecdh_private_key_t > generate_keys()
+        {
+            ++generated_key_pairs;
+
+            return test::all_security_functions::generate_keys();
+        }
+
+        int generated_key_pairs;
+    };
+
+    template < class Manager, typename ... Options >
+    struct key_pool_fixture : test::security_manager_base< Manager, counting_security_functions, 65, Options... >
+    {
+        void input( std::initializer_list< std::uint8_t > pdu )
+        {
+            std::uint8_t buffer[ 65 ];
+            std::size_t  size = sizeof( buffer );
+
+            this->l2cap_input( pdu.begin(), pdu.size(), &buffer[ 0 ], size, this->connection_data_ );
+        }
+
+        // starts a pairing and returns the public key, the device responded with
+        bluetoe::details::ecdh_public_key_t exchange_public_keys()
+        {
+            input( { 0x01, 0x01, 0x00, 0x08, 0x10, 0x07, 0x07 } );
+
+            static const std::uint8_t public_key[] = {
+                0x0C,
+                0xe6, 0x9d, 0x35, 0x0e, 0x48, 0x01, 0x03, 0xcc,
+                0xdb, 0xfd, 0xf4, 0xac, 0x11, 0x91, 0xf4, 0xef,
+                0xb9, 0xa5, 0xf9, 0xe9, 0xa7, 0x83, 0x2c, 0x5e,
+                0x2c, 0xbe, 0x97, 0xf2, 0xd2, 0x03, 0xb0, 0x20,
+                0x8b, 0xd2, 0x89, 0x15, 0xd0, 0x8e, 0x1c, 0x74,
+                0x24, 0x30, 0xed, 0x8f, 0xc2, 0x45, 0x63, 0x76,
+                0x5c, 0x15, 0x52, 0x5a, 0xbf, 0x9a, 0x32, 0x63,
+                0x6d, 0xeb, 0x2a, 0x65, 0x49, 0x9c, 0x80, 0xdc
+            };
+
+            std::uint8_t buffer[ 65 ];
+            std::size_t  size = sizeof( buffer );
+
+            this->l2cap_input( &public_key[ 0 ], sizeof( public_key ), &buffer[ 0 ], size, this->connection_data_ );
+
+            BOOST_REQUIRE_EQUAL( size, 65u );
+            BOOST_REQUIRE_EQUAL( buffer[ 0 ], 0x0C );
+
+            bluetoe::details::ecdh_public_key_t result;
+            std::copy( &buffer[ 1 ], &buffer[ 65 ], result.begin() );
+
+            return result;
+        }
+
+        void pairing_failed()
+        {
+            input( { 0x05, 0x08 } );
+        }
+
+        void disconnect()
+        {
+            this->connection_data_ = typename key_pool_fixture::connection_data_t();
+        }
+    };
+}
+
+BOOST_AUTO_TEST_SUITE( precomputed_key_pairs )
+
+    BOOST_AUTO_TEST_CASE_TEMPLATE( keys_generated_on_demand_by_default, Manager, test::lesc_managers )
+    {
+        key_pool_fixture< Manager > fixture;
+
+        BOOST_CHECK( !fixture.precompute_security_keys() );
+        BOOST_CHECK_EQUAL( fixture.generated_key_pairs, 0 );
+
+        fixture.exchange_public_keys();
+        BOOST_CHECK_EQUAL( fixture.generated_key_pairs, 1 );
+    }
+
+    BOOST_AUTO_TEST_CASE_TEMPLATE( pool_is_filled_one_key_pair_per_call, Manager, test::lesc_managers )
+    {
+        key_pool_fixture< Manager, bluetoe::ecdh_key_pool< 2 > > fixture;
+
+        BOOST_CHECK( fixture.precompute_security_keys() );
+        BOOST_CHECK_EQUAL( fixture.generated_key_pairs, 1 );
+
+        BOOST_CHECK( fixture.precompute_security_keys() );
+        BOOST_CHECK_EQUAL( fixture.generated_key_pairs, 2 );
+
+        BOOST_CHECK( !fixture.precompute_security_keys() );
+        BOOST_CHECK_EQUAL( fixture.generated_key_pairs, 2 );
+    }
+
+    BOOST_AUTO_TEST_CASE_TEMPLATE( pairing_uses_precomputed_key_pair, Manager, test::lesc_managers )
+    {
+        key_pool_fixture< Manager, bluetoe::ecdh_key_pool< 1 > > fixture;
+        fixture.precompute_security_keys();
+
+        const auto key = fixture.exchange_public_keys();
+        BOOST_CHECK_EQUAL( fixture.generated_key_pairs, 1 );
+
+        const auto expected = fixture.generate_keys().first;
+        BOOST_CHECK_EQUAL_COLLECTIONS( key.begin(), key.end(), expected.begin(), expected.end() );
+    }
+
+    BOOST_AUTO_TEST_CASE_TEMPLATE( empty_pool_generates_on_demand, Manager, test::lesc_managers )
+    {
+        key_pool_fixture< Manager, bluetoe::ecdh_key_pool< 1 > > fixture;
+
+        fixture.exchange_public_keys();
+        BOOST_CHECK_EQUAL( fixture.generated_key_pairs, 1 );
+    }
+
+    BOOST_AUTO_TEST_CASE_TEMPLATE( every_pairing_consumes_a_key_pair, Manager, test::lesc_managers )
+    {
+        key_pool_fixture< Manager, bluetoe::ecdh_key_pool< 1 > > fixture;
+        fixture.precompute_security_keys();
+
+        fixture.exchange_public_keys();
+        fixture.pairing_failed();
+
+        BOOST_CHECK( fixture.precompute_security_keys() );
+        BOOST_CHECK_EQUAL( fixture.generated_key_pairs, 2 );
+
+        fixture.exchange_public_keys();
+        BOOST_CHECK_EQUAL( fixture.generated_key_pairs, 2 );
+    }
+
+    BOOST_AUTO_TEST_CASE_TEMPLATE( reused_key_pair_replaced_after_failed_pairings, Manager, test::lesc_managers )
+    {
+        key_pool_fixture< Manager, bluetoe::ecdh_key_pool< 1, true > > fixture;
+        fixture.precompute_security_keys();
+
+        // S + 3F: 3, 6, 9
+        for ( int pairing = 0; pairing != 3; ++pairing )
+        {
+            fixture.exchange_public_keys();
+            fixture.pairing_failed();
+
+            BOOST_CHECK( !fixture.precompute_security_keys() );
+            BOOST_CHECK_EQUAL( fixture.generated_key_pairs, 1 );
+        }
+
+        fixture.exchange_public_keys();
+        BOOST_CHECK_EQUAL( fixture.generated_key_pairs, 2 );
+    }
+
+    BOOST_AUTO_TEST_CASE_TEMPLATE( pairing_aborted_by_disconnect_counts_as_failed, Manager, test::lesc_managers )
+    {
+        key_pool_fixture< Manager, bluetoe::ecdh_key_pool< 1, true > > fixture;
+        fixture.precompute_security_keys();
+
+        // S + 3F: 3, 6, 9
+        for ( int pairing = 0; pairing != 3; ++pairing )
+        {
+            fixture.exchange_public_keys();
+            fixture.disconnect();
+
+            BOOST_CHECK( !fixture.precompute_security_keys() );
+            BOOST_CHECK_EQUAL( fixture.generated_key_pairs, 1 );
+        }
+
+        fixture.exchange_public_keys();
+        BOOST_CHECK_EQUAL( fixture.generated_key_pairs, 2 );
+    }
+
+    // the link layer does not precompute key pairs, while a pairing is in progress
+    BOOST_AUTO_TEST_CASE_TEMPLATE( pairing_in_progress_until_the_pairing_ends, Manager, test::lesc_managers )
+    {
+        key_pool_fixture< Manager, bluetoe::ecdh_key_pool< 1 > > fixture;
+        BOOST_CHECK( !fixture.pairing_in_progress( fixture.connection_data_ ) );
+
+        fixture.exchange_public_keys();
+        BOOST_CHECK( fixture.pairing_in_progress( fixture.connection_data_ ) );
+
+        fixture.pairing_failed();
+        BOOST_CHECK( !fixture.pairing_in_progress( fixture.connection_data_ ) );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
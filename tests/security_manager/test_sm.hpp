@@ -280,6 +280,43 @@ namespace test {
             return result;
         }
 
+        void p256_start( const std::uint8_t* private_key, const std::uint8_t* public_key )
+        {
+            bluetoe::details::ecdh_private_key_t priv_key;
+            bluetoe::details::ecdh_public_key_t  pub_key;
+            std::reverse_copy( public_key, public_key + 32, pub_key.begin() );
+            std::reverse_copy( public_key + 32, public_key + 64, pub_key.begin() + 32 );
+            std::reverse_copy( private_key, private_key + 32, priv_key.begin() );
+
+            uECC_shared_secret_start( pub_key.data(), priv_key.data() );
+            p256_steps = 0;
+        }
+
+        bool p256_step()
+        {
+            ++p256_steps;
+
+            if ( !uECC_shared_secret_step( 64 ) )
+                return false;
+
+            bluetoe::details::ecdh_private_key_t shared_secret;
+            const int rc = uECC_shared_secret_finish( shared_secret.data() );
+            static_cast< void >( rc );
+            assert( rc == 1 );
+
+            std::reverse_copy( shared_secret.begin(), shared_secret.end(), p256_result_.begin() );
+
+            return true;
+        }
+
+        bluetoe::details::ecdh_shared_secret_t p256_result() const
+        {
+            return p256_result_;
+        }
+
+        int                                     p256_steps;
+        bluetoe::details::ecdh_shared_secret_t  p256_result_;
+
         bluetoe::details::uint128_t f4( const std::uint8_t* u, const std::uint8_t* v, const std::array< std::uint8_t, 16 >& k, std::uint8_t z )
         {
             const bluetoe::details::uint128_t m4 = {{
@@ -619,8 +656,8 @@ namespace test {
         }
     };
 
-    template < class Manager >
-    struct lesc_pairing_features_exchanged : security_manager_base< Manager, test::all_security_functions, 65 >
+    template < class Manager, typename ... Options >
+    struct lesc_pairing_features_exchanged : security_manager_base< Manager, test::all_security_functions, 65, Options... >
     {
         lesc_pairing_features_exchanged()
         {
@@ -722,8 +759,8 @@ namespace test {
         }
     };
 
-    template < class Manager >
-    struct lesc_public_key_exchanged : lesc_pairing_features_exchanged< Manager >
+    template < class Manager, typename ... Options >
+    struct lesc_public_key_exchanged : lesc_pairing_features_exchanged< Manager, Options... >
     {
         lesc_public_key_exchanged()
         {
@@ -774,8 +811,8 @@ namespace test {
         }
     };
 
-    template < class Manager >
-    struct lesc_pairing_confirmed : lesc_public_key_exchanged< Manager >
+    template < class Manager, typename ... Options >
+    struct lesc_pairing_confirmed : lesc_public_key_exchanged< Manager, Options... >
     {
         lesc_pairing_confirmed()
         {
@@ -791,8 +828,8 @@ namespace test {
         }
     };
 
-    template < class Manager >
-    struct lesc_pairing_random_exchanged : lesc_pairing_confirmed< Manager >
+    template < class Manager, typename ... Options >
+    struct lesc_pairing_random_exchanged : lesc_pairing_confirmed< Manager, Options... >
     {
         lesc_pairing_random_exchanged()
         {
@@ -329,3 +329,74 @@ BOOST_FIXTURE_TEST_CASE( no_cb_call_on_none_changeing_write, test::request_with_
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+/*
+ * The server flattens all attributes of all services into one table at compile time.
+ */
+BOOST_AUTO_TEST_SUITE( flat_attribute_table )
+
+    std::uint8_t value1 = 1;
+    std::uint8_t value2 = 2;
+
+    using service1 = bluetoe::service<
+        bluetoe::service_uuid16< 0x0815 >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid16< 0x0816 >,
+            bluetoe::bind_characteristic_value< std::uint8_t, &value1 >,
+            bluetoe::notify
+        >
+    >;
+
+    using service2 = bluetoe::service<
+        bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >,
+            bluetoe::bind_characteristic_value< std::uint8_t, &value2 >,
+            bluetoe::indicate
+        >
+    >;
+
+    using server_t = bluetoe::server<
+        bluetoe::no_gap_service_for_gatt_servers,
+        service1,
+        service2
+    >;
+
+    using services     = server_t::services;
+    using cccd_indices = server_t::cccd_indices;
+
+BOOST_AUTO_TEST_CASE( table_contains_all_attributes )
+{
+    BOOST_CHECK_EQUAL( std::size_t( server_t::attribute_table::size ), service1::number_of_attributes + service2::number_of_attributes );
+}
+
+BOOST_AUTO_TEST_CASE( table_contains_expected_handles_and_uuids )
+{
+    static const struct {
+        std::uint16_t handle;
+        std::uint16_t uuid;
+    } expected[] = {
+        { 0x0001, 0x2800 }, // primary service
+        { 0x0002, 0x2803 }, // characteristic declaration
+        { 0x0003, 0x0816 }, // characteristic value
+        { 0x0004, 0x2902 }, // CCCD
+        { 0x0005, 0x2800 }, // primary service
+        { 0x0006, 0x2803 }, // characteristic declaration
+        { 0x0007, 0x0001 }, // characteristic value with 128 bit UUID
+        { 0x0008, 0x2902 }  // CCCD
+    };
+
+    BOOST_REQUIRE_EQUAL( std::size_t( server_t::attribute_table::size ), sizeof( expected ) / sizeof( expected[ 0 ] ) );
+
+    for ( std::size_t index = 0; index != server_t::attribute_table::size; ++index )
+    {
+        BOOST_TEST_CONTEXT( "index: " << index )
+        {
+            BOOST_CHECK_EQUAL( server_t::handle_mapping::handle_by_index( index ), expected[ index ].handle );
+            BOOST_CHECK_EQUAL( server_t::attribute_table::attributes[ index ].uuid, expected[ index ].uuid );
+            BOOST_CHECK_EQUAL( server_t::attribute_at( index ).uuid, expected[ index ].uuid );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -152,11 +152,12 @@ BOOST_FIXTURE_TEST_CASE( read_by_group_type_response_buffer_to_small, test::serv
 }
 
 typedef std::tuple< test::cycling_speed_and_cadence_service > cycling_speed_and_cadence_service_list;
+using server_with_cycling_speed_and_cadence_service = bluetoe::server< test::cycling_speed_and_cadence_service >;
 
 BOOST_FIXTURE_TEST_CASE( read_by_group_type_response_for_16bit_uuid, test::cycling_speed_and_cadence_service )
 {
     std::uint8_t    buffer[ 100 ];
-    server_with_3_characteristics_list server;
+    server_with_cycling_speed_and_cadence_service server;
 
     std::uint8_t* const end = read_primary_service_response< std::tuple<>, 0, cycling_speed_and_cadence_service_list >( std::begin( buffer ), std::end( buffer ), 0u, false, server );
 
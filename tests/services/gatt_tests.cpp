@@ -0,0 +1,303 @@
+#include <bluetoe/services/gatt.hpp>
+#include <bluetoe/server.hpp>
+
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_servers.hpp"
+
+namespace {
+    using server = bluetoe::server<
+        bluetoe::gatt::service_with_caching
+    >;
+
+    using server_with_multiple_notifications = bluetoe::server<
+        bluetoe::gatt::service_with_caching,
+        bluetoe::multiple_handle_value_notifications
+    >;
+
+    /*
+     * 0x0001 GATT service
+     * 0x0002 Service Changed declaration
+     * 0x0003 Service Changed value
+     * 0x0004 Service Changed CCCD
+     * 0x0005 Client Supported Features declaration
+     * 0x0006 Client Supported Features value
+     * 0x0007 Database Hash declaration
+     * 0x0008 Database Hash value
+     * 0x0009 GAP service
+     * 0x000A Device Name declaration
+     * 0x000B Device Name value
+     * 0x000C Appearance declaration
+     * 0x000D Appearance value
+     */
+    struct caching_server : test::request_with_reponse< server >
+    {
+        void enable_robust_caching()
+        {
+            l2cap_input( { 0x12, 0x06, 0x00, 0x01 } );
+            expected_result( { 0x13 } );
+        }
+    };
+
+    struct change_unaware_client : caching_server
+    {
+        change_unaware_client()
+        {
+            enable_robust_caching();
+            connection.client_change_unaware();
+        }
+    };
+
+    std::uint8_t indicated_value = 0x42;
+
+    /*
+     * 0x0001 - 0x0008 GATT service as above
+     * 0x0009 Service
+     * 0x000A Characteristic declaration
+     * 0x000B Characteristic value
+     * 0x000C Characteristic CCCD
+     */
+    using server_with_indication = bluetoe::server<
+        bluetoe::gatt::service_with_caching,
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x8C8B >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8C >,
+                bluetoe::bind_characteristic_value< std::uint8_t, &indicated_value >,
+                bluetoe::indicate
+            >
+        >
+    >;
+
+    struct change_unaware_client_with_indications : test::request_with_reponse< server_with_indication >
+    {
+        change_unaware_client_with_indications()
+        {
+            // robust caching and indications of Service Changed and of the other characteristic
+            l2cap_input( { 0x12, 0x06, 0x00, 0x01 } );
+            expected_result( { 0x13 } );
+            l2cap_input( { 0x12, 0x04, 0x00, 0x02, 0x00 } );
+            expected_result( { 0x13 } );
+            l2cap_input( { 0x12, 0x0C, 0x00, 0x02, 0x00 } );
+            expected_result( { 0x13 } );
+
+            connection.client_change_unaware();
+        }
+    };
+}
+
+BOOST_AUTO_TEST_SUITE( database_hash )
+
+    /*
+     * The expected hash was computed independently of bluetoe, with
+     * openssl mac -cipher AES-128-CBC -macopt hexkey:00000000000000000000000000000000 CMAC
+     * which yields CE1EE07D53CA7AFE95000D00A234A301 (transmitted least significant octet first)
+     * over:
+     * 01 00 00 28 01 18
+     * 02 00 03 28 22 03 00 05 2A
+     * 04 00 02 29
+     * 05 00 03 28 0A 06 00 29 2B
+     * 07 00 03 28 02 08 00 2A 2B
+     * 09 00 00 28 00 18
+     * 0A 00 03 28 02 0B 00 00 2A
+     * 0C 00 03 28 02 0D 00 01 2A
+     */
+    BOOST_FIXTURE_TEST_CASE( read_hash, caching_server )
+    {
+        l2cap_input( { 0x0A, 0x08, 0x00 } );
+        expected_result( {
+            0x0B,
+            0x01, 0xA3, 0x34, 0xA2, 0x00, 0x0D, 0x00, 0x95,
+            0xFE, 0x7A, 0xCA, 0x53, 0x7D, 0xE0, 0x1E, 0xCE
+        } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( read_hash_by_type, caching_server )
+    {
+        l2cap_input( { 0x08, 0x01, 0x00, 0xFF, 0xFF, 0x2A, 0x2B } );
+        expected_result( {
+            0x09, 0x12, 0x08, 0x00,
+            0x01, 0xA3, 0x34, 0xA2, 0x00, 0x0D, 0x00, 0x95,
+            0xFE, 0x7A, 0xCA, 0x53, 0x7D, 0xE0, 0x1E, 0xCE
+        } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( hash_is_read_only, caching_server )
+    {
+        BOOST_CHECK( check_error_response( { 0x12, 0x08, 0x00, 0x01 }, 0x12, 0x0008, 0x03 ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( hash_depends_on_database, caching_server )
+    {
+        using other_server = bluetoe::server<
+            bluetoe::gatt::service_with_caching,
+            bluetoe::service<
+                bluetoe::service_uuid16< 0x8C8B >,
+                bluetoe::characteristic<
+                    bluetoe::characteristic_uuid16< 0x8C8C >,
+                    bluetoe::fixed_uint8_value< 0x42 >
+                >
+            >
+        >;
+
+        BOOST_CHECK( !std::equal( server::database_hash(), server::database_hash() + 16, other_server::database_hash() ) );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( client_supported_features )
+
+    BOOST_FIXTURE_TEST_CASE( no_features_by_default, caching_server )
+    {
+        l2cap_input( { 0x0A, 0x06, 0x00 } );
+        expected_result( { 0x0B, 0x00 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( set_features, caching_server )
+    {
+        l2cap_input( { 0x12, 0x06, 0x00, 0x05 } );
+        expected_result( { 0x13 } );
+
+        l2cap_input( { 0x0A, 0x06, 0x00 } );
+        expected_result( { 0x0B, 0x05 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( unknown_features_are_ignored, caching_server )
+    {
+        l2cap_input( { 0x12, 0x06, 0x00, 0xFF, 0xFF } );
+        expected_result( { 0x13 } );
+
+        l2cap_input( { 0x0A, 0x06, 0x00 } );
+        expected_result( { 0x0B, 0x07 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( features_can_not_be_cleared, caching_server )
+    {
+        l2cap_input( { 0x12, 0x06, 0x00, 0x05 } );
+        expected_result( { 0x13 } );
+
+        BOOST_CHECK( check_error_response( { 0x12, 0x06, 0x00, 0x04 }, 0x12, 0x0006, 0x13 ) );
+
+        l2cap_input( { 0x0A, 0x06, 0x00 } );
+        expected_result( { 0x0B, 0x05 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( features_are_stored_per_connection, caching_server )
+    {
+        l2cap_input( { 0x12, 0x06, 0x00, 0x03 } );
+        expected_result( { 0x13 } );
+
+        connection_t other_connection;
+        l2cap_input( { 0x0A, 0x06, 0x00 }, other_connection );
+        expected_result( { 0x0B, 0x00 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( enables_multiple_handle_value_notifications, test::request_with_reponse< server_with_multiple_notifications > )
+    {
+        BOOST_CHECK( !connection.client_supports_multiple_handle_value_notifications() );
+
+        l2cap_input( { 0x12, 0x06, 0x00, 0x04 } );
+        expected_result( { 0x13 } );
+
+        BOOST_CHECK( connection.client_supports_multiple_handle_value_notifications() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( multiple_handle_value_notifications_require_server_support, caching_server )
+    {
+        l2cap_input( { 0x12, 0x06, 0x00, 0x04 } );
+        expected_result( { 0x13 } );
+
+        BOOST_CHECK( !connection.client_supports_multiple_handle_value_notifications() );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( robust_caching )
+
+    BOOST_FIXTURE_TEST_CASE( client_is_change_aware_by_default, caching_server )
+    {
+        enable_robust_caching();
+        BOOST_CHECK( connection.client_change_aware() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( without_robust_caching_client_is_always_change_aware, caching_server )
+    {
+        connection.client_change_unaware();
+        BOOST_CHECK( connection.client_change_aware() );
+
+        l2cap_input( { 0x0A, 0x06, 0x00 } );
+        expected_result( { 0x0B, 0x00 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( request_is_answered_with_database_out_of_sync, change_unaware_client )
+    {
+        BOOST_CHECK( !connection.client_change_aware() );
+        BOOST_CHECK( check_error_response( { 0x0A, 0x06, 0x00 }, 0x0A, 0x0000, 0x12 ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( next_request_is_served, change_unaware_client )
+    {
+        BOOST_CHECK( check_error_response( { 0x0A, 0x06, 0x00 }, 0x0A, 0x0000, 0x12 ) );
+
+        l2cap_input( { 0x0A, 0x06, 0x00 } );
+        expected_result( { 0x0B, 0x01 } );
+
+        BOOST_CHECK( connection.client_change_aware() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( commands_are_ignored, change_unaware_client )
+    {
+        l2cap_input( { 0x52, 0x06, 0x00, 0x07 } );
+        expected_result( {} );
+
+        BOOST_CHECK( !connection.client_change_aware() );
+        BOOST_CHECK( connection.client_supported_features() == 0x01 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( reading_the_hash_makes_the_client_change_aware, change_unaware_client )
+    {
+        l2cap_input( { 0x08, 0x01, 0x00, 0xFF, 0xFF, 0x2A, 0x2B } );
+        BOOST_CHECK_EQUAL( response[ 0 ], 0x09 );
+        BOOST_CHECK( connection.client_change_aware() );
+
+        l2cap_input( { 0x0A, 0x06, 0x00 } );
+        expected_result( { 0x0B, 0x01 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( reading_the_hash_by_handle_makes_the_client_change_aware, change_unaware_client )
+    {
+        l2cap_input( { 0x0A, 0x08, 0x00 } );
+        BOOST_CHECK_EQUAL( response[ 0 ], 0x0B );
+        BOOST_CHECK( connection.client_change_aware() );
+
+        l2cap_input( { 0x0A, 0x06, 0x00 } );
+        expected_result( { 0x0B, 0x01 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( mtu_exchange_is_served, change_unaware_client )
+    {
+        l2cap_input( { 0x02, 0x17, 0x00 } );
+        BOOST_CHECK_EQUAL( response[ 0 ], 0x03 );
+        BOOST_CHECK( !connection.client_change_aware() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( confirmation_makes_the_client_change_aware, change_unaware_client_with_indications )
+    {
+        indicate< bluetoe::gatt::service_changed_uuid >();
+        expected_output( notification, { 0x1D, 0x03, 0x00, 0x01, 0x00, 0xFF, 0xFF } );
+
+        l2cap_input( { 0x1E } );
+        BOOST_CHECK( connection.client_change_aware() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( confirming_an_other_indication_keeps_the_client_change_unaware, change_unaware_client_with_indications )
+    {
+        indicate< bluetoe::characteristic_uuid16< 0x8C8C > >();
+        expected_output( notification, { 0x1D, 0x0B, 0x00, 0x42 } );
+
+        l2cap_input( { 0x1E } );
+        BOOST_CHECK( !connection.client_change_aware() );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -280,6 +280,7 @@ namespace test {
         , receiving_encoding_( bluetoe::link_layer::details::phy_ll_encoding::le_1m_phy )
         , transmiting_encoding_( bluetoe::link_layer::details::phy_ll_encoding::le_1m_phy )
         , eos_( bluetoe::link_layer::delta_time::seconds( 10 ) )
+        , max_pdus_per_event_( 0 )
     {
     }
 
@@ -595,6 +596,36 @@ namespace test {
         add_connection_event_respond( connection_event_response() );
     }
 
+    void radio_base::add_connection_event_respond( std::uint32_t access_address, const connection_event_response& resp )
+    {
+        connection_events_response_by_access_address_[ access_address ].push_back( resp );
+    }
+
+    void radio_base::add_connection_event_respond( std::uint32_t access_address, std::initializer_list< std::uint8_t > pdu )
+    {
+        add_connection_event_respond( access_address,
+            connection_event_response( pdu_list_t( 1, pdu ) ) );
+    }
+
+    void radio_base::add_connection_event_respond_timeout( std::uint32_t access_address )
+    {
+        add_connection_event_respond( access_address, connection_event_response() );
+    }
+
+    connection_event_response radio_base::next_connection_event_response( std::uint32_t access_address )
+    {
+        connection_event_response_list& bound = connection_events_response_by_access_address_[ access_address ];
+        connection_event_response_list& list  = bound.empty() ? connection_events_response_ : bound;
+
+        if ( list.empty() )
+            return connection_event_response();
+
+        const connection_event_response result = list.front();
+        list.erase( list.begin() );
+
+        return result;
+    }
+
     void radio_base::check_connection_events( const std::function< bool ( const connection_event& ) >& filter, const std::function< bool ( const connection_event& ) >& check, const char* message )
     {
         for ( const auto& event : connection_events_ )
@@ -709,6 +740,21 @@ namespace test {
         eos_ = eos;
     }
 
+    void radio_base::max_pdus_per_connection_event( unsigned count )
+    {
+        max_pdus_per_event_ = count;
+    }
+
+    void radio_base::simulate_pdu_loss( const std::function< bool () >& lost )
+    {
+        pdu_lost_ = lost;
+    }
+
+    bool radio_base::link_simulation() const
+    {
+        return max_pdus_per_event_ != 0 || static_cast< bool >( pdu_lost_ );
+    }
+
 
     radio_base::lock_guard::lock_guard()
     {
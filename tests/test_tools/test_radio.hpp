@@ -6,8 +6,10 @@
 #include <bluetoe/ll_data_pdu_buffer.hpp>
 #include <bluetoe/link_layer.hpp>
 #include <bluetoe/connection_events.hpp>
+#include <bluetoe/software_encryption.hpp>
 
 #include <vector>
+#include <map>
 #include <functional>
 #include <iosfwd>
 #include <initializer_list>
@@ -281,6 +283,15 @@ namespace test {
         void add_connection_event_respond( std::function< void() > );
         void add_connection_event_respond_timeout();
 
+        /**
+         * @brief responses to connection events of the connection with the given access address
+         *
+         * These responses take precedence over the responses, that are not bound to a connection.
+         */
+        void add_connection_event_respond( std::uint32_t access_address, const connection_event_response& );
+        void add_connection_event_respond( std::uint32_t access_address, std::initializer_list< std::uint8_t > );
+        void add_connection_event_respond_timeout( std::uint32_t access_address );
+
         void check_connection_events( const std::function< bool ( const connection_event& ) >& filter, const std::function< bool ( const connection_event& ) >& check, const char* message );
         void check_connection_events( const std::function< bool ( const connection_event& ) >& check, const char* message );
 
@@ -308,6 +319,35 @@ namespace test {
 
         void end_of_simulation( bluetoe::link_layer::delta_time );
 
+        /**
+         * @brief limits the number of PDUs, the link layer can send within a single connection event
+         *
+         * 0, the default, means no limit. PDUs that the central has still to send, when the limit is reached, are dropped.
+         *
+         * @sa link_simulation()
+         */
+        void max_pdus_per_connection_event( unsigned count );
+
+        /**
+         * @brief function that is called for every PDU, that the link layer sends in a connection event
+         *
+         * If the function returns true, the PDU is lost: the central does not acknowledge the PDU and
+         * closes the connection event.
+         *
+         * @sa link_simulation()
+         */
+        void simulate_pdu_loss( const std::function< bool () >& lost );
+
+        /**
+         * @brief true, if max_pdus_per_connection_event() or simulate_pdu_loss() was used
+         *
+         * Only then, the simulated central behaves like a real one: it keeps the connection event open, while it has
+         * PDUs to send, it does not acknowledge a PDU, when the link layer has no receive buffer and it acknowledges
+         * only PDUs with the expected sequence number. Otherwise, the central acknowledges every PDU of the link
+         * layer, that answers a received PDU, which is what most tests rely on.
+         */
+        bool link_simulation() const;
+
         class lock_guard
         {
         public:
@@ -322,9 +362,6 @@ namespace test {
 
         static constexpr std::size_t radio_maximum_white_list_entries = 0;
 
-        void increment_receive_packet_counter() {}
-        void increment_transmit_packet_counter() {}
-
         void radio_set_phy(
             bluetoe::link_layer::details::phy_ll_encoding::phy_ll_encoding_t receiving_encoding,
             bluetoe::link_layer::details::phy_ll_encoding::phy_ll_encoding_t transmiting_c_encoding );
@@ -341,6 +378,7 @@ namespace test {
 
         typedef std::vector< connection_event_response > connection_event_response_list;
         connection_event_response_list connection_events_response_;
+        std::map< std::uint32_t, connection_event_response_list > connection_events_response_by_access_address_;
 
         typedef std::vector< scheduled_user_timer > scheduled_user_timers_list;
         scheduled_user_timers_list scheduled_user_timers_;
@@ -348,8 +386,15 @@ namespace test {
         std::uint32_t   access_address_;
         std::uint32_t   crc_init_;
         bool            access_address_and_crc_valid_;
-        std::uint8_t    central_sequence_number_    = 0;
-        std::uint8_t    central_ne_sequence_number_ = 0;
+
+        // sequence numbers of the central, per connection access address
+        struct central_sequence_numbers
+        {
+            std::uint8_t sequence_number    = 0;
+            std::uint8_t ne_sequence_number = 0;
+        };
+
+        std::map< std::uint32_t, central_sequence_numbers > central_sequence_numbers_;
 
         bluetoe::link_layer::details::phy_ll_encoding::phy_ll_encoding_t    receiving_encoding_;
         bluetoe::link_layer::details::phy_ll_encoding::phy_ll_encoding_t    transmiting_encoding_;
@@ -359,6 +404,9 @@ namespace test {
         // end of simulations
         bluetoe::link_layer::delta_time eos_;
 
+        unsigned                        max_pdus_per_event_;
+        std::function< bool () >        pdu_lost_;
+
         advertising_list::const_iterator next( std::vector< advertising_data >::const_iterator, const std::function< bool ( const advertising_data& ) >& filter ) const;
 
         void pair_wise_check(
@@ -367,6 +415,32 @@ namespace test {
             const std::function< void ( advertising_list::const_iterator first, advertising_list::const_iterator next ) >&    fail ) const;
 
         std::pair< bool, advertising_response > find_response( const advertising_data& );
+
+        connection_event_response next_connection_event_response( std::uint32_t access_address );
+    };
+
+    /**
+     * @brief PDUs are exchanged as they are; encryption is only flagged in the recorded connection events
+     *
+     * A radio_impl passes every received PDU to decrypt(), every PDU to be transmitted to encrypt()
+     * and calls prepare() after every connection event.
+     */
+    struct unencrypted_pdus
+    {
+        void increment_receive_packet_counter() {}
+        void increment_transmit_packet_counter() {}
+
+        bool decrypt( const bluetoe::link_layer::read_buffer& )
+        {
+            return true;
+        }
+
+        bluetoe::link_layer::write_buffer encrypt( const bluetoe::link_layer::write_buffer& pdu, const bluetoe::link_layer::read_buffer& )
+        {
+            return pdu;
+        }
+
+        void prepare( std::size_t, std::size_t ) {}
     };
 
     /**
@@ -374,13 +448,15 @@ namespace test {
      */
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack,
         bool Phy2MBitSupported,
-        bool SynchronizedUserTimerSupported >
+        bool SynchronizedUserTimerSupported,
+        typename Encryption = unencrypted_pdus >
     class radio_impl :
         public radio_base,
+        public Encryption,
         public bluetoe::link_layer::ll_data_pdu_buffer<
             TransmitSize, ReceiveSize,
             radio_impl<
-                TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported
+                TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption
             >
         >
     {
@@ -446,6 +522,9 @@ namespace test {
         void simulate_connection_event_response();
         bluetoe::link_layer::delta_time simulate_user_timer_response( bluetoe::link_layer::delta_time start, bluetoe::link_layer::delta_time end );
 
+        // the largest encrypted PDU in the largest layout used in tests
+        std::uint8_t encrypted_pdu_[ 4 + 255 ];
+
         // make sure, there is only one action scheduled
         bool idle_;
         bool advertising_response_;
@@ -561,6 +640,25 @@ namespace test {
             this->transmition_encrypted_ = false;
         }
 
+        // encryption state of a single connection
+        struct encryption_context
+        {
+            bool reception_encrypted   = false;
+            bool transmition_encrypted = false;
+        };
+
+        void store_encryption_context( encryption_context& context ) const
+        {
+            context.reception_encrypted   = this->reception_encrypted_;
+            context.transmition_encrypted = this->transmition_encrypted_;
+        }
+
+        void restore_encryption_context( const encryption_context& context )
+        {
+            this->reception_encrypted_   = context.reception_encrypted;
+            this->transmition_encrypted_ = context.transmition_encrypted;
+        }
+
         // access to data provided for testing
         bluetoe::details::uint128_t encryption_key() const
         {
@@ -585,6 +683,89 @@ namespace test {
         std::uint32_t               ivs_;
     };
 
+    struct pdu_layout;
+
+    /**
+     * @brief radio that encrypts and decrypts PDUs with the software_encryption
+     *
+     * The recorded connection events contain the PDUs as they are send over the air. Received PDUs
+     * are expected to be encrypted by the central. PDUs with a failing MIC are not acknowledged.
+     */
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
+    class radio_with_software_encryption :
+        public radio_impl< TransmitSize, ReceiveSize, CallBack, false, false, bluetoe::link_layer::software_encryption< pdu_layout > >
+    {
+    public:
+        static constexpr bool hardware_supports_encryption = true;
+
+        using encryption = bluetoe::link_layer::software_encryption< pdu_layout >;
+
+        radio_with_software_encryption()
+            : skds_( 0x3fac22107855aa56ul )
+            , ivs_( 0x78563412 )
+        {
+        }
+
+        void setup_encryption_response( std::uint64_t SKDs, std::uint32_t IVs)
+        {
+            skds_ = SKDs;
+            ivs_  = IVs;
+        }
+
+        std::pair< std::uint64_t, std::uint32_t > setup_encryption( bluetoe::details::uint128_t k, std::uint64_t skdm, std::uint32_t ivm )
+        {
+            return this->setup_session( k.data(), skdm, ivm, skds_, ivs_ );
+        }
+
+        void start_receive_encrypted()
+        {
+            encryption::start_receive_encrypted();
+            this->reception_encrypted_ = true;
+        }
+
+        void start_transmit_encrypted()
+        {
+            encryption::start_transmit_encrypted();
+            this->transmition_encrypted_ = true;
+        }
+
+        void stop_receive_encrypted()
+        {
+            encryption::stop_receive_encrypted();
+            this->reception_encrypted_ = false;
+        }
+
+        void stop_transmit_encrypted()
+        {
+            encryption::stop_transmit_encrypted();
+            this->transmition_encrypted_ = false;
+        }
+
+        struct encryption_context : encryption::encryption_context
+        {
+            bool reception_encrypted   = false;
+            bool transmition_encrypted = false;
+        };
+
+        void store_encryption_context( encryption_context& context ) const
+        {
+            encryption::store_encryption_context( context );
+            context.reception_encrypted   = this->reception_encrypted_;
+            context.transmition_encrypted = this->transmition_encrypted_;
+        }
+
+        void restore_encryption_context( const encryption_context& context )
+        {
+            encryption::restore_encryption_context( context );
+            this->reception_encrypted_   = context.reception_encrypted;
+            this->transmition_encrypted_ = context.transmition_encrypted;
+        }
+
+    private:
+        std::uint64_t               skds_;
+        std::uint32_t               ivs_;
+    };
+
     // implementation
     template < class Accu >
     Accu radio_base::sum_data( std::function< Accu ( const advertising_data&, Accu start_value ) > f, Accu start_value ) const
@@ -595,8 +776,8 @@ namespace test {
         return start_value;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::radio_impl()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::radio_impl()
         : now_( bluetoe::link_layer::delta_time::now() )
         , idle_( true )
         , advertising_response_( false )
@@ -608,8 +789,8 @@ namespace test {
     {
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::schedule_advertisment(
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::schedule_advertisment(
             unsigned                                    channel,
             const bluetoe::link_layer::write_buffer&    transmit,
             const bluetoe::link_layer::write_buffer&,
@@ -638,8 +819,8 @@ namespace test {
         advertised_data_.push_back( data );
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    bluetoe::link_layer::delta_time radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::schedule_connection_event(
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    bluetoe::link_layer::delta_time radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::schedule_connection_event(
         unsigned                                    channel,
         bluetoe::link_layer::delta_time             start_receive,
         bluetoe::link_layer::delta_time             end_receive,
@@ -669,8 +850,8 @@ namespace test {
         return bluetoe::link_layer::delta_time();
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    std::pair< bool, bluetoe::link_layer::delta_time > radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::disarm_connection_event()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    std::pair< bool, bluetoe::link_layer::delta_time > radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::disarm_connection_event()
     {
         assert( !connection_events_.empty() );
         connection_events_.pop_back();
@@ -678,8 +859,8 @@ namespace test {
         return { true, bluetoe::link_layer::delta_time() };
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    bool radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::schedule_synchronized_user_timer(
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    bool radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::schedule_synchronized_user_timer(
         bluetoe::link_layer::delta_time time, bluetoe::link_layer::delta_time )
     {
         assert( !timer_set_ );
@@ -692,8 +873,8 @@ namespace test {
         return true;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    bool radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::cancel_synchronized_user_timer()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    bool radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::cancel_synchronized_user_timer()
     {
         const bool result = timer_set_;
 
@@ -706,18 +887,16 @@ namespace test {
         return result;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::wake_up()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::wake_up()
     {
         ++wake_ups_;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::run()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::run()
     {
         bool new_scheduling_added = false;
-        central_sequence_number_    = 0;
-        central_ne_sequence_number_ = 0;
 
         do
         {
@@ -744,8 +923,8 @@ namespace test {
             --wake_ups_;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::simulate_advertising_response()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::simulate_advertising_response()
     {
         assert( !advertised_data_.empty() );
 
@@ -766,6 +945,13 @@ namespace test {
                 if ( current.receive_buffer.size > 0 )
                     copy_air_to_memory( response.second.received_data, current.receive_buffer );
 
+                // a new connection starts with both sequence numbers being 0
+                static constexpr std::size_t connect_ind_access_address_offset = 14;
+
+                if ( response.second.received_data.size() >= connect_ind_access_address_offset + 4 )
+                    central_sequence_numbers_.erase(
+                        bluetoe::details::read_32bit( &response.second.received_data[ connect_ind_access_address_offset ] ) );
+
                 idle_ = true;
                 static_cast< CallBack* >( this )->adv_received( current.receive_buffer );
             }
@@ -778,22 +964,17 @@ namespace test {
         }
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::simulate_connection_event_response()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::simulate_connection_event_response()
     {
-        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported > >::pdu_layout;
-
-        connection_event_response response = connection_events_response_.empty()
-            ? connection_event_response()
-            : connection_events_response_.front();
+        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption > >::pdu_layout;
 
         assert( !connection_events_.empty() );
         auto& event = connection_events_.back();
 
-        if ( !connection_events_response_.empty() )
-        {
-            connection_events_response_.erase( connection_events_response_.begin() );
-        }
+        const connection_event_response response = next_connection_event_response( event.access_address );
+        std::uint8_t& central_sequence_number    = central_sequence_numbers_[ event.access_address ].sequence_number;
+        std::uint8_t& central_ne_sequence_number = central_sequence_numbers_[ event.access_address ].ne_sequence_number;
 
         if ( response.timeout )
         {
@@ -816,6 +997,9 @@ namespace test {
                 pdus = response.func();
 
             bluetoe::link_layer::connection_event_events events;
+            const bool simulated      = this->link_simulation();
+            unsigned   exchanged_pdus = 0;
+            bool       lost           = false;
 
             do
             {
@@ -842,10 +1026,10 @@ namespace test {
 
                     std::uint16_t header = layout::header( receive_buffer );
                     header &= ~( sn_flag | nesn_flag );
-                    header |= central_sequence_number_ | central_ne_sequence_number_;
+                    header |= central_sequence_number | central_ne_sequence_number;
                     layout::header( receive_buffer, header );
 
-                    central_sequence_number_    ^= sn_flag;
+                    central_sequence_number    ^= sn_flag;
                 }
 
                 if ( more_data && receive_buffer.size )
@@ -854,25 +1038,49 @@ namespace test {
                     layout::header( receive_buffer, header );
                 }
 
-                auto response = this->received( receive_buffer );
+                // in a link simulation, a PDU without a receive buffer is not acknowledged and the link layer repeats
+                // its last PDU. A PDU that fails the MIC check is always handled the same way, as it is most likely a
+                // retransmission of a PDU, for which the receive packet counter was already incremented.
+                const bool decrypted = receive_buffer.size && this->decrypt( receive_buffer );
 
-                more_data = more_data || ( layout::header( response ) & more_data_flag );
-                central_ne_sequence_number_ ^= nesn_flag;
+                // the central resends the not acknowledged PDU with the same sequence number
+                if ( receive_buffer.size && !decrypted )
+                    central_sequence_number ^= sn_flag;
 
-                event.received_data.push_back(
-                    memory_to_air( bluetoe::link_layer::write_buffer( receive_buffer ) ) );
+                const bool not_acknowledged = receive_buffer.size ? !decrypted : simulated;
+
+                auto response = not_acknowledged
+                    ? this->next_transmit()
+                    : this->received( receive_buffer );
+
+                more_data = more_data || ( simulated && !pdus.empty() ) || ( layout::header( response ) & more_data_flag );
+                lost      = pdu_lost_ && pdu_lost_();
+
+                // a lost PDU is not acknowledged and thus retransmitted by the link layer
+                const bool new_pdu = ( !simulated && !not_acknowledged )
+                    || static_cast< bool >( layout::header( response ) & sn_flag ) == static_cast< bool >( central_ne_sequence_number );
+
+                if ( !lost && new_pdu )
+                    central_ne_sequence_number ^= nesn_flag;
+
+                ++exchanged_pdus;
+
+                event.received_data.push_back( receive_buffer.size || !simulated
+                    ? pdu_t( memory_to_air( bluetoe::link_layer::write_buffer( receive_buffer ) ) )
+                    : pdu_t( std::vector< std::uint8_t >() ) );
 
                 event.transmitted_data.push_back(
-                    pdu_t( memory_to_air( response ), transmition_encrypted_ ) );
+                    pdu_t( memory_to_air( this->encrypt( response, bluetoe::link_layer::read_buffer{ encrypted_pdu_, sizeof( encrypted_pdu_ ) } ) ), transmition_encrypted_ ) );
 
-            } while ( more_data );
+            } while ( more_data && !lost && ( max_pdus_per_event_ == 0 || exchanged_pdus < max_pdus_per_event_ ) );
 
             static_cast< CallBack* >( this )->end_event( events );
+            this->prepare( this->max_tx_size() - ll_header_size, this->max_rx_size() - ll_header_size );
         }
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    bluetoe::link_layer::delta_time radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::simulate_user_timer_response( bluetoe::link_layer::delta_time /* start */, bluetoe::link_layer::delta_time end )
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    bluetoe::link_layer::delta_time radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::simulate_user_timer_response( bluetoe::link_layer::delta_time /* start */, bluetoe::link_layer::delta_time end )
     {
         while ( timer_set_ && scheduled_user_timers_.back().schedule_time + scheduled_user_timers_.back().delay <= end )
         {
@@ -884,10 +1092,10 @@ namespace test {
         return end;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::copy_memory_to_air( const std::vector< std::uint8_t >& in_memory, bluetoe::link_layer::read_buffer& over_the_air )
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::copy_memory_to_air( const std::vector< std::uint8_t >& in_memory, bluetoe::link_layer::read_buffer& over_the_air )
     {
-        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported > >::pdu_layout;
+        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption > >::pdu_layout;
 
         const auto          body      = layout::body( bluetoe::link_layer::write_buffer( in_memory.data(), in_memory.size() ) );
         const std::uint16_t header    = layout::header( in_memory.data() );
@@ -899,10 +1107,10 @@ namespace test {
         over_the_air.size = body_size + ll_header_size;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::copy_air_to_memory( const std::vector< std::uint8_t >& over_the_air, bluetoe::link_layer::read_buffer& in_memory )
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::copy_air_to_memory( const std::vector< std::uint8_t >& over_the_air, bluetoe::link_layer::read_buffer& in_memory )
     {
-        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported > >::pdu_layout;
+        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption > >::pdu_layout;
 
         const std::uint16_t header = bluetoe::details::read_16bit( over_the_air.data() );
         const std::size_t   size   = std::min< std::size_t >( header >> 8, over_the_air.size() - ll_header_size );
@@ -914,10 +1122,10 @@ namespace test {
         in_memory.size = layout::data_channel_pdu_memory_size( size );
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    std::vector< std::uint8_t > radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::air_to_memory( bluetoe::link_layer::write_buffer air )
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    std::vector< std::uint8_t > radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::air_to_memory( bluetoe::link_layer::write_buffer air )
     {
-        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported > >::pdu_layout;
+        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption > >::pdu_layout;
 
         const std::uint16_t header = bluetoe::details::read_16bit( air.buffer );
         const std::size_t   size   = header >> 8;
@@ -932,10 +1140,10 @@ namespace test {
         return result;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    std::vector< std::uint8_t > radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::memory_to_air( bluetoe::link_layer::write_buffer memory )
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    std::vector< std::uint8_t > radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::memory_to_air( bluetoe::link_layer::write_buffer memory )
     {
-        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported > >::pdu_layout;
+        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption > >::pdu_layout;
 
         const std::uint16_t header    = layout::header( memory );
         const auto          body      = layout::body( memory );
@@ -1003,6 +1211,18 @@ namespace bluetoe {
         {
             using pdu_layout = test::pdu_layout;
         };
+
+        template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
+        struct pdu_layout_by_radio< test::radio_impl< TransmitSize, ReceiveSize, CallBack, false, false, software_encryption< test::pdu_layout > > >
+        {
+            using pdu_layout = test::pdu_layout;
+        };
+
+        template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
+        struct pdu_layout_by_radio< test::radio_with_software_encryption< TransmitSize, ReceiveSize, CallBack > >
+        {
+            using pdu_layout = test::pdu_layout;
+        };
    }
 }
 
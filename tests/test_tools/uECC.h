@@ -124,6 +124,22 @@ int uECC_shared_secret(const uint8_t public_key[uECC_BYTES*2],
                        const uint8_t private_key[uECC_BYTES],
                        uint8_t secret[uECC_BYTES]);
 
+/* uECC_shared_secret_start(), uECC_shared_secret_step() and uECC_shared_secret_finish() functions.
+Incremental version of uECC_shared_secret(), for applications that can not afford to block for
+the whole computation. Only one computation can be in progress at a time.
+
+uECC_shared_secret_start() takes the same keys as uECC_shared_secret(). uECC_shared_secret_step()
+processes at most max_bits bits of the scalar multiplication and has to be called until it returns 1.
+uECC_shared_secret_finish() then writes the shared secret.
+
+Returns 1 if the shared secret was computed successfully, 0 otherwise.
+*/
+int uECC_shared_secret_start(const uint8_t public_key[uECC_BYTES*2],
+                             const uint8_t private_key[uECC_BYTES]);
+int uECC_shared_secret_step(unsigned max_bits);
+int uECC_shared_secret_finish(uint8_t secret[uECC_BYTES]);
+
+
 /* uECC_sign() function.
 Generate an ECDSA signature for a given hash value.
 